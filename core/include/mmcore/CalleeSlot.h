@@ -160,6 +160,47 @@ public:
         this->callbacks.Add(cb);
     }
 
+    /**
+     * Declares a callback as safe to be called on a worker thread,
+     * concurrently to modules outside of the module graph branch it pulls
+     * data from. This allows callers to fetch independent inputs in
+     * parallel (see 'ParallelCalls'). The callback must neither require a
+     * rendering context nor touch state shared with other modules. Must be
+     * called after the callback has been set and before the slot is made
+     * available.
+     *
+     * @param callName The class name of the call.
+     * @param funcName The name of the function.
+     */
+    void SetCallbackConcurrencySafe(const char* callName, const char* funcName) {
+        if (this->GetStatus() != AbstractSlot::STATUS_UNAVAILABLE) {
+            throw vislib::IllegalStateException("You may not declare "
+                                                "callbacks after the slot has been enabled.",
+                __FILE__, __LINE__);
+        }
+
+        vislib::StringA cn(callName);
+        vislib::StringA fn(funcName);
+        for (unsigned int i = 0; i < this->callbacks.Count(); i++) {
+            if (cn.Equals(this->callbacks[i]->CallName(), false) && fn.Equals(this->callbacks[i]->FuncName(), false)) {
+                this->callbacks[i]->SetConcurrencySafe(true);
+                return;
+            }
+        }
+        throw vislib::IllegalParamException("callName funcName", __FILE__, __LINE__);
+    }
+
+    /**
+     * Answers whether the callback receiving function 'func' of 'call' has
+     * been declared safe to be called concurrently.
+     *
+     * @param call A call connected to this slot.
+     * @param func The function of the call.
+     *
+     * @return 'true' if the callback is concurrency safe.
+     */
+    bool IsCallbackConcurrencySafe(const Call& call, unsigned int func) const;
+
     /**
      * Answers whether the given parameter is relevant for this view.
      *
@@ -281,12 +322,33 @@ private:
             return this->funcName;
         }
 
+        /**
+         * Answers whether the callback may be called concurrently.
+         *
+         * @return 'true' if the callback is concurrency safe.
+         */
+        inline bool IsConcurrencySafe(void) const {
+            return this->concurrencySafe;
+        }
+
+        /**
+         * Sets whether the callback may be called concurrently.
+         *
+         * @param safe The new value.
+         */
+        inline void SetConcurrencySafe(bool safe) {
+            this->concurrencySafe = safe;
+        }
+
     private:
         /** the class name of the call */
         vislib::StringA callName;
 
         /** the name of the function */
         vislib::StringA funcName;
+
+        /** Flag whether the callback may be called concurrently */
+        bool concurrencySafe = false;
     };
 
     /**
@@ -3,6 +3,7 @@
 #include <functional>
 #include <list>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "FrontendResource.h"
@@ -23,6 +24,8 @@ namespace megamol {
 namespace core {
 
 class MegaMolGraph {
+    friend class MegaMolGraph_Snapshot;
+
 public:
     MegaMolGraph(megamol::core::CoreInstance& core, factories::ModuleDescriptionManager const& moduleProvider,
         factories::CallDescriptionManager const& callProvider);
@@ -65,6 +68,32 @@ public:
 
     megamol::core::param::ParamSlot* FindParameterSlot(std::string const& paramName) const;
 
+    /*
+     * Parameter handles resolve the name of a parameter once, so scripts setting many values, e.g. animating a camera
+     * or sweeping a threshold, skip the lookup of the module and slot and, using the typed setters, the parsing of the
+     * value. A handle stays valid until the module of the parameter is deleted, afterwards setting it fails.
+     */
+    using ParameterHandle = int;
+
+    static constexpr ParameterHandle InvalidParameterHandle = -1;
+
+    ParameterHandle GetParameterHandle(std::string const& paramName);
+
+    megamol::core::param::ParamSlot* ResolveParameterHandle(ParameterHandle handle) const;
+
+    // sets bool, int, enum and float parameters
+    bool SetParameter(ParameterHandle handle, float value);
+
+    bool SetParameter(ParameterHandle handle, std::string const& value);
+
+    /*
+     * Parameters set by handle between BeginParameterBatch() and EndParameterBatch() do not notify their modules
+     * until the batch ends, and then only once per parameter. Values set as string are applied immediately.
+     */
+    void BeginParameterBatch();
+
+    void EndParameterBatch();
+
     std::vector<megamol::core::param::AbstractParam*> EnumerateModuleParameters(std::string const& moduleName) const;
 
     std::vector<megamol::core::param::ParamSlot*> EnumerateModuleParameterSlots(std::string const& moduleName) const;
@@ -134,15 +163,27 @@ private:
 
     MegaMolGraph_Convenience convenience_functions;
 
+    // slots resolved by GetParameterHandle(), indexed by handle, nullptr once the module got deleted
+    std::vector<param::ParamSlot*> parameter_handles_;
+
+    // handles set during the running parameter batch, marked to notify each slot only once
+    bool parameter_batch_running_ = false;
+    std::vector<ParameterHandle> parameter_batch_;
+    std::vector<bool> parameter_batch_marks_;
+
     frontend_resources::MegaMolGraph_SubscriptionRegistry graph_subscribers;
 
     // module params may change their internal value on their own
     // the graph uses the AbstractParam::indicateChange() mechanism to inject
     // a callback that notifies the graph of param changes.
     // these parameter changes get collected in the following queue and are issued to graph subscribers when possible.
+    // a parameter changing many times per frame is queued only once, subscribers get its latest value anyway.
     std::vector<core::param::AbstractParamSlot*> module_param_changes_queue;
+    std::unordered_set<core::param::AbstractParamSlot*> module_param_changes_queued;
     core::param::AbstractParam::ParamChangeCallback param_change_callback = [&](core::param::AbstractParamSlot* slot) {
-        module_param_changes_queue.push_back(slot);
+        if (module_param_changes_queued.insert(slot).second) {
+            module_param_changes_queue.push_back(slot);
+        }
         return true;
     };
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace core {
+
+class MegaMolGraph;
+
+/**
+ * Binary snapshot of a MegaMolGraph, holding the module instances, the calls and the parameter values. Restoring a
+ * snapshot creates the graph in bulk without running the Lua project file, i.e. without parsing the Lua calls and
+ * looking up each parameter by its full name.
+ *
+ * The snapshot consists of a header, fixed-size records of the modules, calls and parameters and a blob of all
+ * strings, which the records reference by offset. A snapshot is only valid for the build and the set of module and
+ * call classes it has been saved with. Project files are expected to fall back to creating the graph themselves if
+ * restoring fails, e.g.:
+ *
+ *     if not mmLoadGraphSnapshot("project.mmgs") then
+ *         -- create the graph as usual
+ *         mmSaveGraphSnapshot("project.mmgs")
+ *     end
+ */
+class MegaMolGraph_Snapshot {
+public:
+    /**
+     * Serializes a graph.
+     *
+     * @param graph The graph.
+     *
+     * @return The snapshot.
+     */
+    static std::vector<char> Save(MegaMolGraph const& graph);
+
+    /**
+     * Checks whether a snapshot is intact and matches the build and the available module and call classes.
+     *
+     * @param graph The graph the snapshot is going to be restored into.
+     * @param snapshot The snapshot.
+     * @param reason Receives the reason if the snapshot is not valid.
+     *
+     * @return 'true' if the snapshot can be restored.
+     */
+    static bool Validate(MegaMolGraph const& graph, std::vector<char> const& snapshot, std::string& reason);
+
+    /**
+     * Restores a snapshot into an empty graph. If restoring fails, the graph is cleared again.
+     *
+     * @param graph The graph, which must be empty.
+     * @param snapshot The snapshot.
+     *
+     * @return 'true' on success.
+     */
+    static bool Restore(MegaMolGraph& graph, std::vector<char> const& snapshot);
+
+private:
+    /**
+     * Hashes the class names of all modules and calls available to a graph.
+     */
+    static uint64_t classFingerprint(MegaMolGraph const& graph);
+};
+
+} /* namespace core */
+} // namespace megamol
@@ -0,0 +1,67 @@
+/**
+ * MegaMol
+ * Copyright (c) 2022, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "mmcore/Call.h"
+
+namespace megamol::core {
+
+class Module;
+
+/**
+ * Issues several calls of a module to its inputs together, e.g. the two
+ * tables of a join. The calls whose upstream branches are independent are
+ * executed in parallel on a shared pool of worker threads.
+ *
+ * A branch is only moved to a worker thread if every callback it reaches
+ * has been declared safe with 'CalleeSlot::SetCallbackConcurrencySafe', no
+ * call within requires OpenGL and it shares no module with the other
+ * branches. Otherwise all calls are issued one after the other on the
+ * calling thread, exactly like calling them directly.
+ */
+class ParallelCalls {
+public:
+    /**
+     * Adds a call to be issued.
+     *
+     * @param call The call, which may be nullptr to fail the batch.
+     * @param func The function to be called.
+     *
+     * @return A reference to this.
+     */
+    ParallelCalls& Add(Call* call, unsigned int func = 0);
+
+    /**
+     * Issues all calls and waits for their completion. In sequential
+     * execution, the calls following a failed one are not issued. An
+     * exception thrown by a callback is rethrown after all calls returned.
+     *
+     * @return 'true' if all calls succeeded.
+     */
+    bool operator()(void);
+
+private:
+    /**
+     * Collects the modules of the branch pulled by a function of a call.
+     *
+     * @param call The call.
+     * @param func The function, or -1 for all functions of the call.
+     * @param modules Receives the modules of the branch.
+     *
+     * @return 'true' if the whole branch may be executed concurrently.
+     */
+    static bool collectBranch(const Call& call, int func, std::set<const Module*>& modules);
+
+    /** The calls and their functions */
+    std::vector<std::pair<Call*, unsigned int>> calls;
+};
+
+} // namespace megamol::core
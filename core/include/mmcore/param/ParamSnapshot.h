@@ -0,0 +1,105 @@
+/*
+ * ParamSnapshot.h
+ *
+ * Copyright (C) 2022 by Universitaet Stuttgart (VIS).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace megamol::core {
+
+class Module;
+
+namespace param {
+
+class ParamSlot;
+
+/**
+ * Immutable copy of the parameter values of a module.
+ *
+ * Parameters are changed by the main thread at any time, so computations running on worker threads must not read
+ * them from their slots. Instead, a module captures a snapshot in one of its callbacks and hands it to its workers,
+ * which can read it concurrently for as long as they hold it.
+ *
+ * The hash of a snapshot only depends on the parameter names and values, so snapshots of equal parameter values
+ * have equal hashes, also across runs, and can be used to key cached results. The version increases with every
+ * capture and tells which of two snapshots is the more recent one.
+ */
+class ParamSnapshot {
+public:
+    using Value = std::variant<std::monostate, bool, int, float, std::string>;
+
+    /**
+     * Captures the values of all parameters of a module. Must be called by the thread that changes parameters, i.e.
+     * from a callback of the module.
+     *
+     * @param module The module.
+     * @param excluded Parameter slots not to capture, e.g. ones not affecting the computation.
+     *
+     * @return The snapshot.
+     */
+    static std::shared_ptr<const ParamSnapshot> Capture(
+        Module& module, std::vector<ParamSlot const*> const& excluded = {});
+
+    /**
+     * Answers whether the snapshot holds a parameter.
+     *
+     * @param name The name of the parameter slot.
+     */
+    bool Contains(std::string const& name) const {
+        return this->values.count(name) > 0;
+    }
+
+    /**
+     * Gets the value of a parameter. Bool, int, enum and float parameters are available as their type, any
+     * parameter is available as the string of its value.
+     *
+     * @param name The name of the parameter slot.
+     *
+     * @return The value of the parameter.
+     *
+     * @throws std::out_of_range if there is no such parameter.
+     * @throws std::bad_variant_access if the parameter is not of type T.
+     */
+    template<typename T>
+    T const& Get(std::string const& name) const {
+        auto const& entry = this->values.at(name);
+        if constexpr (std::is_same_v<T, std::string>) {
+            return entry.second;
+        } else {
+            return std::get<T>(entry.first);
+        }
+    }
+
+    /** Answers the hash of the parameter values */
+    inline uint64_t Hash() const {
+        return this->hash;
+    }
+
+    /** Answers the version of the snapshot */
+    inline uint64_t Version() const {
+        return this->version;
+    }
+
+private:
+    ParamSnapshot() = default;
+
+    /** The typed value and the value string per parameter slot name */
+    std::map<std::string, std::pair<Value, std::string>> values;
+
+    uint64_t hash = 0;
+
+    uint64_t version = 0;
+};
+
+} // namespace param
+} // namespace megamol::core
@@ -123,6 +123,17 @@ bool CalleeSlot::InCall(unsigned int func, Call& call) {
 }
 
 
+/*
+ * CalleeSlot::IsCallbackConcurrencySafe
+ */
+bool CalleeSlot::IsCallbackConcurrencySafe(const Call& call, unsigned int func) const {
+    if ((call.callee != this) || (func >= call.GetCallbackCount()))
+        return false;
+    unsigned int idx = call.funcMap[func];
+    return (idx < this->callbacks.Count()) && this->callbacks[idx]->IsConcurrencySafe();
+}
+
+
 /*
  * CalleeSlot::ClearCleanupMark
  */
@@ -1,11 +1,16 @@
 #include "mmcore/MegaMolGraph.h"
 #include "mmcore/AbstractSlot.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/view/AbstractView_EventConsumption.h"
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <iostream>
 #include <numeric> // std::accumulate
 #include <string>
@@ -231,6 +236,86 @@ bool megamol::core::MegaMolGraph::SetParameter(std::string const& paramName, std
     return true;
 }
 
+megamol::core::MegaMolGraph::ParameterHandle megamol::core::MegaMolGraph::GetParameterHandle(
+    std::string const& paramName) {
+    auto param_slot_ptr = FindParameterSlot(paramName);
+    if (!getParameterFromParamSlot(param_slot_ptr))
+        return InvalidParameterHandle;
+
+    auto handle_it = std::find(parameter_handles_.begin(), parameter_handles_.end(), param_slot_ptr);
+    if (handle_it != parameter_handles_.end())
+        return static_cast<ParameterHandle>(std::distance(parameter_handles_.begin(), handle_it));
+
+    parameter_handles_.push_back(param_slot_ptr);
+    parameter_batch_marks_.push_back(false);
+    return static_cast<ParameterHandle>(parameter_handles_.size() - 1);
+}
+
+megamol::core::param::ParamSlot* megamol::core::MegaMolGraph::ResolveParameterHandle(ParameterHandle handle) const {
+    if (handle < 0 || static_cast<size_t>(handle) >= parameter_handles_.size())
+        return nullptr;
+
+    return parameter_handles_[handle];
+}
+
+bool megamol::core::MegaMolGraph::SetParameter(ParameterHandle handle, float value) {
+    auto param_slot_ptr = ResolveParameterHandle(handle);
+    if (!param_slot_ptr) {
+        log_error("error. parameter handle is not valid: " + std::to_string(handle));
+        return false;
+    }
+
+    // during a batch, the slot gets dirty when the batch ends
+    const bool set_dirty = !parameter_batch_running_;
+
+    if (auto float_param = param_slot_ptr->Param<param::FloatParam>()) {
+        float_param->SetValue(value, set_dirty);
+    } else if (auto int_param = param_slot_ptr->Param<param::IntParam>()) {
+        int_param->SetValue(static_cast<int>(std::lround(value)), set_dirty);
+    } else if (auto enum_param = param_slot_ptr->Param<param::EnumParam>()) {
+        enum_param->SetValue(static_cast<int>(std::lround(value)), set_dirty);
+    } else if (auto bool_param = param_slot_ptr->Param<param::BoolParam>()) {
+        bool_param->SetValue(value != 0.0f, set_dirty);
+    } else {
+        log_error("error. parameter can not be set to a number: " + std::string(param_slot_ptr->Name().PeekBuffer()));
+        return false;
+    }
+
+    if (!set_dirty && !parameter_batch_marks_[handle]) {
+        parameter_batch_marks_[handle] = true;
+        parameter_batch_.push_back(handle);
+    }
+
+    return true;
+}
+
+bool megamol::core::MegaMolGraph::SetParameter(ParameterHandle handle, std::string const& value) {
+    auto param_ptr = getParameterFromParamSlot(ResolveParameterHandle(handle));
+    if (!param_ptr) {
+        log_error("error. parameter handle is not valid: " + std::to_string(handle));
+        return false;
+    }
+
+    return param_ptr->ParseValue(value);
+}
+
+void megamol::core::MegaMolGraph::BeginParameterBatch() {
+    parameter_batch_running_ = true;
+}
+
+void megamol::core::MegaMolGraph::EndParameterBatch() {
+    parameter_batch_running_ = false;
+
+    for (auto handle : parameter_batch_) {
+        parameter_batch_marks_[handle] = false;
+        // the slot of a module deleted during the batch is gone
+        if (auto param_slot_ptr = parameter_handles_[handle]) {
+            param_slot_ptr->ForceSetDirty();
+        }
+    }
+    parameter_batch_.clear();
+}
+
 bool megamol::core::MegaMolGraph::Broadcast_graph_subscribers_parameter_changes() {
     for (auto& subscriber : graph_subscribers.subscribers) {
 
@@ -261,6 +346,7 @@ bool megamol::core::MegaMolGraph::Broadcast_graph_subscribers_parameter_changes(
     }
 
     module_param_changes_queue.clear();
+    module_param_changes_queued.clear();
 
     return true;
 }
@@ -488,6 +574,7 @@ void megamol::core::MegaMolGraph::Clear() {
     module_list_.clear();
     graph_entry_points.clear();
     module_param_changes_queue.clear();
+    module_param_changes_queued.clear();
 }
 
 /*
@@ -776,6 +863,13 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
     std::vector<ParamSlotPtr> param_ptrs = module_ptr->GetSlots<std::remove_pointer<ParamSlotPtr>::type>();
     for (auto& param_ptr : param_ptrs) {
         assert(param_ptr != nullptr);
+        std::replace(parameter_handles_.begin(), parameter_handles_.end(), param_ptr,
+            static_cast<param::ParamSlot*>(nullptr));
+        if (module_param_changes_queued.erase(param_ptr) > 0) {
+            module_param_changes_queue.erase(
+                std::remove(module_param_changes_queue.begin(), module_param_changes_queue.end(), param_ptr),
+                module_param_changes_queue.end());
+        }
     }
 
     if (auto result = graph_subscribers.tell_all([&](auto& s) { return s.RemoveParameters(param_ptrs); });
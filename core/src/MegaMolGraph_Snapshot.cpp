@@ -0,0 +1,361 @@
+#include "mmcore/MegaMolGraph_Snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+#include "mmcore/MegaMolGraph.h"
+#include "mmcore/param/ButtonParam.h"
+#include "mmcore/utility/buildinfo/BuildInfo.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::core;
+
+static void log(std::string text) {
+    const std::string msg = "MegaMolGraph_Snapshot: " + text;
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo(msg.c_str());
+}
+
+static void log_warning(std::string text) {
+    const std::string msg = "MegaMolGraph_Snapshot: " + text;
+    megamol::core::utility::log::Log::DefaultLog.WriteWarn(msg.c_str());
+}
+
+static void err(std::string text) {
+    const std::string msg = "MegaMolGraph_Snapshot: " + text;
+    megamol::core::utility::log::Log::DefaultLog.WriteError(msg.c_str());
+}
+
+namespace {
+
+constexpr char snapshot_magic[8] = {'M', 'M', 'G', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t snapshot_version = 1;
+
+// the records are written as they are in memory, so a snapshot is only valid on machines with the same byte order,
+// which the build hash implies
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t module_count;
+    uint64_t class_fingerprint;
+    uint64_t checksum; // of everything following the header
+    uint32_t call_count;
+    uint32_t param_count;
+    uint32_t string_bytes;
+    uint32_t reserved;
+    StringRef build;
+};
+
+struct ModuleRecord {
+    StringRef class_name;
+    StringRef id;
+    uint32_t entry_point;
+};
+
+struct CallRecord {
+    StringRef class_name;
+    StringRef from;
+    StringRef to;
+};
+
+struct ParamRecord {
+    uint32_t module;
+    StringRef name;
+    StringRef value;
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<ModuleRecord> &&
+                  std::is_trivially_copyable_v<CallRecord> && std::is_trivially_copyable_v<ParamRecord>,
+    "snapshot records must be trivially copyable");
+
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** Collects the strings of a snapshot, storing repeated strings once */
+class StringTable {
+public:
+    StringRef add(std::string const& str) {
+        auto it = refs.find(str);
+        if (it != refs.end()) {
+            return it->second;
+        }
+        StringRef ref{static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(str.size())};
+        blob += str;
+        refs.emplace(str, ref);
+        return ref;
+    }
+
+    std::string const& data() const {
+        return blob;
+    }
+
+private:
+    std::string blob;
+    std::unordered_map<std::string, StringRef> refs;
+};
+
+template<typename T>
+void append(std::vector<char>& out, T const* data, size_t count) {
+    const auto* bytes = reinterpret_cast<const char*>(data);
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+}
+
+/** Reads records from an unaligned position */
+template<typename T>
+std::vector<T> read(const char*& pos, size_t count) {
+    std::vector<T> records(count);
+    if (count > 0) {
+        std::memcpy(records.data(), pos, count * sizeof(T));
+    }
+    pos += count * sizeof(T);
+    return records;
+}
+
+/** The parsed parts of a snapshot */
+struct Contents {
+    Header header;
+    std::vector<ModuleRecord> modules;
+    std::vector<CallRecord> calls;
+    std::vector<ParamRecord> params;
+    const char* strings = nullptr;
+
+    std::string str(StringRef ref) const {
+        return std::string(strings + ref.offset, ref.length);
+    }
+};
+
+bool parse(std::vector<char> const& snapshot, Contents& contents, std::string& reason) {
+    if (snapshot.size() < sizeof(Header)) {
+        reason = "truncated header";
+        return false;
+    }
+    std::memcpy(&contents.header, snapshot.data(), sizeof(Header));
+    auto const& header = contents.header;
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) != 0) {
+        reason = "not a graph snapshot";
+        return false;
+    }
+    if (header.version != snapshot_version) {
+        reason = "unsupported version " + std::to_string(header.version);
+        return false;
+    }
+    const uint64_t expected_size = sizeof(Header) + sizeof(ModuleRecord) * uint64_t(header.module_count) +
+                                   sizeof(CallRecord) * uint64_t(header.call_count) +
+                                   sizeof(ParamRecord) * uint64_t(header.param_count) + header.string_bytes;
+    if (snapshot.size() != expected_size) {
+        reason = "truncated or oversized file";
+        return false;
+    }
+    if (fnv1a(snapshot.data() + sizeof(Header), snapshot.size() - sizeof(Header)) != header.checksum) {
+        reason = "checksum mismatch";
+        return false;
+    }
+
+    const char* pos = snapshot.data() + sizeof(Header);
+    contents.modules = read<ModuleRecord>(pos, header.module_count);
+    contents.calls = read<CallRecord>(pos, header.call_count);
+    contents.params = read<ParamRecord>(pos, header.param_count);
+    contents.strings = pos;
+
+    const auto in_range = [&header](StringRef ref) {
+        return uint64_t(ref.offset) + ref.length <= header.string_bytes;
+    };
+    bool refs_ok = in_range(header.build);
+    for (auto const& m : contents.modules) {
+        refs_ok = refs_ok && in_range(m.class_name) && in_range(m.id);
+    }
+    for (auto const& c : contents.calls) {
+        refs_ok = refs_ok && in_range(c.class_name) && in_range(c.from) && in_range(c.to);
+    }
+    for (auto const& p : contents.params) {
+        refs_ok = refs_ok && (p.module < header.module_count) && in_range(p.name) && in_range(p.value);
+    }
+    if (!refs_ok) {
+        reason = "invalid string references";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+
+std::vector<char> MegaMolGraph_Snapshot::Save(MegaMolGraph const& graph) {
+    StringTable strings;
+    std::vector<ModuleRecord> modules;
+    std::vector<CallRecord> calls;
+    std::vector<ParamRecord> params;
+
+    // the graph lists modules and calls newest first, they are stored in the order of their creation
+    auto const& module_list = graph.ListModules();
+    for (auto it = module_list.rbegin(); it != module_list.rend(); ++it) {
+        const auto module_idx = static_cast<uint32_t>(modules.size());
+        modules.push_back(ModuleRecord{
+            strings.add(it->request.className), strings.add(it->request.id), it->isGraphEntryPoint ? 1U : 0U});
+
+        for (auto child = it->modulePtr->ChildList_Begin(); child != it->modulePtr->ChildList_End(); ++child) {
+            auto slot = dynamic_cast<param::ParamSlot*>(child->get());
+            // button params have no value, see MegaMolGraph_Convenience::SerializeModuleParameters
+            if ((slot == nullptr) || (slot->Parameter() == nullptr) ||
+                (slot->Param<param::ButtonParam>() != nullptr)) {
+                continue;
+            }
+            params.push_back(ParamRecord{module_idx, strings.add(slot->Name().PeekBuffer()),
+                strings.add(slot->Parameter()->ValueString())});
+        }
+    }
+    auto const& call_list = graph.ListCalls();
+    for (auto it = call_list.rbegin(); it != call_list.rend(); ++it) {
+        calls.push_back(CallRecord{
+            strings.add(it->request.className), strings.add(it->request.from), strings.add(it->request.to)});
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+    header.version = snapshot_version;
+    header.module_count = static_cast<uint32_t>(modules.size());
+    header.call_count = static_cast<uint32_t>(calls.size());
+    header.param_count = static_cast<uint32_t>(params.size());
+    header.class_fingerprint = classFingerprint(graph);
+    header.build = strings.add(utility::buildinfo::MEGAMOL_GIT_HASH());
+    header.string_bytes = static_cast<uint32_t>(strings.data().size());
+
+    std::vector<char> snapshot;
+    snapshot.reserve(sizeof(Header) + modules.size() * sizeof(ModuleRecord) + calls.size() * sizeof(CallRecord) +
+                     params.size() * sizeof(ParamRecord) + strings.data().size());
+    append(snapshot, &header, 1);
+    append(snapshot, modules.data(), modules.size());
+    append(snapshot, calls.data(), calls.size());
+    append(snapshot, params.data(), params.size());
+    append(snapshot, strings.data().data(), strings.data().size());
+
+    header.checksum = fnv1a(snapshot.data() + sizeof(Header), snapshot.size() - sizeof(Header));
+    std::memcpy(snapshot.data(), &header, sizeof(Header));
+
+    return snapshot;
+}
+
+
+bool MegaMolGraph_Snapshot::Validate(
+    MegaMolGraph const& graph, std::vector<char> const& snapshot, std::string& reason) {
+    Contents contents;
+    if (!parse(snapshot, contents, reason)) {
+        return false;
+    }
+    if (contents.str(contents.header.build) != utility::buildinfo::MEGAMOL_GIT_HASH()) {
+        reason = "saved by build " + contents.str(contents.header.build);
+        return false;
+    }
+    if (contents.header.class_fingerprint != classFingerprint(graph)) {
+        reason = "the available module or call classes have changed";
+        return false;
+    }
+    return true;
+}
+
+
+bool MegaMolGraph_Snapshot::Restore(MegaMolGraph& graph, std::vector<char> const& snapshot) {
+    std::string reason;
+    if (!Validate(graph, snapshot, reason)) {
+        log_warning("cannot restore snapshot: " + reason);
+        return false;
+    }
+    if (!graph.ListModules().empty() || !graph.ListCalls().empty()) {
+        err("cannot restore snapshot into a graph which is not empty");
+        return false;
+    }
+    Contents contents;
+    parse(snapshot, contents, reason);
+
+    const auto fail = [&graph](std::string const& msg) {
+        err(msg);
+        graph.Clear();
+        return false;
+    };
+
+    for (auto const& m : contents.modules) {
+        const auto id = contents.str(m.id);
+        if (!graph.CreateModule(contents.str(m.class_name), id)) {
+            return fail("could not create module " + id);
+        }
+        if ((m.entry_point != 0) && !graph.SetGraphEntryPoint(id)) {
+            return fail("could not set graph entry point " + id);
+        }
+    }
+    for (auto const& c : contents.calls) {
+        if (!graph.CreateCall(contents.str(c.class_name), contents.str(c.from), contents.str(c.to))) {
+            return fail("could not create call " + contents.str(c.from) + " -> " + contents.str(c.to));
+        }
+    }
+
+    // parameters are looked up per module instead of by their full names
+    std::unordered_map<std::string, Module*> modules_by_id;
+    for (auto const& m : graph.ListModules()) {
+        modules_by_id.emplace(m.request.id, m.modulePtr.get());
+    }
+    std::vector<Module*> modules;
+    modules.reserve(contents.modules.size());
+    for (auto const& m : contents.modules) {
+        auto it = modules_by_id.find(contents.str(m.id));
+        modules.push_back((it != modules_by_id.end()) ? it->second : nullptr);
+    }
+    uint32_t slots_module = contents.header.module_count;
+    std::unordered_map<std::string, param::ParamSlot*> slots;
+    for (auto const& p : contents.params) {
+        if (modules[p.module] == nullptr) {
+            continue;
+        }
+        if (p.module != slots_module) {
+            slots_module = p.module;
+            slots.clear();
+            for (auto child = modules[p.module]->ChildList_Begin(); child != modules[p.module]->ChildList_End();
+                 ++child) {
+                if (auto slot = dynamic_cast<param::ParamSlot*>(child->get())) {
+                    slots.emplace(slot->Name().PeekBuffer(), slot);
+                }
+            }
+        }
+        const auto name = contents.str(p.name);
+        auto it = slots.find(name);
+        if ((it == slots.end()) || (it->second->Parameter() == nullptr) ||
+            !it->second->Parameter()->ParseValue(contents.str(p.value))) {
+            log_warning(
+                "could not set parameter " + name + " of module " + contents.str(contents.modules[p.module].id));
+        }
+    }
+
+    log("restored " + std::to_string(contents.modules.size()) + " modules, " + std::to_string(contents.calls.size()) +
+        " calls and " + std::to_string(contents.params.size()) + " parameters");
+    return true;
+}
+
+
+uint64_t MegaMolGraph_Snapshot::classFingerprint(MegaMolGraph const& graph) {
+    std::vector<std::string> names;
+    for (auto const& desc : *graph.moduleProvider_ptr) {
+        names.push_back(std::string("module:") + desc->ClassName());
+    }
+    for (auto const& desc : *graph.callProvider_ptr) {
+        names.push_back(std::string("call:") + desc->ClassName());
+    }
+    // the order depends on the order the plugins are loaded in
+    std::sort(names.begin(), names.end());
+    uint64_t hash = fnv1a(nullptr, 0);
+    for (auto const& n : names) {
+        hash = fnv1a(n.c_str(), n.size() + 1, hash);
+    }
+    return hash;
+}
@@ -0,0 +1,238 @@
+/**
+ * MegaMol
+ * Copyright (c) 2022, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/ParallelCalls.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+
+using namespace megamol::core;
+
+namespace {
+
+/**
+ * Pool of worker threads shared by all batches. Threads waiting for their
+ * tasks execute queued tasks meanwhile, so branches issuing batches
+ * themselves cannot starve the pool.
+ */
+class WorkerPool {
+public:
+    static WorkerPool& Instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(this->queueLock);
+            this->stopping = true;
+        }
+        this->queueSignal.notify_all();
+        for (auto& t : this->workers) {
+            t.join();
+        }
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(this->queueLock);
+            if (this->workers.empty()) {
+                const unsigned int cnt = (std::max)(1U, std::thread::hardware_concurrency()) - 1;
+                for (unsigned int i = 0; i < (std::max)(1U, cnt); ++i) {
+                    this->workers.emplace_back(&WorkerPool::work, this);
+                }
+            }
+            this->queue.push_back(std::move(task));
+        }
+        this->queueSignal.notify_one();
+    }
+
+    /** Runs one queued task on the calling thread, answers 'false' if there is none */
+    bool RunPending() {
+        std::function<void()> task;
+        {
+            std::lock_guard<std::mutex> lock(this->queueLock);
+            if (this->queue.empty()) {
+                return false;
+            }
+            task = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+        task();
+        return true;
+    }
+
+private:
+    WorkerPool() = default;
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(this->queueLock);
+                this->queueSignal.wait(lock, [this]() { return this->stopping || !this->queue.empty(); });
+                if (this->queue.empty()) {
+                    return;
+                }
+                task = std::move(this->queue.front());
+                this->queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex queueLock;
+    std::condition_variable queueSignal;
+    bool stopping = false;
+};
+
+} // namespace
+
+
+/*
+ * ParallelCalls::Add
+ */
+ParallelCalls& ParallelCalls::Add(Call* call, unsigned int func) {
+    this->calls.emplace_back(call, func);
+    return *this;
+}
+
+
+/*
+ * ParallelCalls::operator()
+ */
+bool ParallelCalls::operator()(void) {
+    // which calls may run on worker threads
+    std::vector<bool> concurrent(this->calls.size(), false);
+    size_t concurrentCnt = 0;
+#ifndef MEGAMOL_USE_PROFILING // the performance queries of the calls are not thread safe
+    const bool complete = std::none_of(
+        this->calls.begin(), this->calls.end(), [](auto const& c) { return c.first == nullptr; });
+    if (complete && (this->calls.size() > 1)) {
+        std::vector<std::set<const Module*>> branches(this->calls.size());
+        for (size_t i = 0; i < this->calls.size(); ++i) {
+            concurrent[i] = collectBranch(*this->calls[i].first, static_cast<int>(this->calls[i].second), branches[i]);
+        }
+        // a branch sharing a module with any other branch stays on the calling thread
+        for (size_t i = 0; i < this->calls.size(); ++i) {
+            for (size_t j = 0; (j < this->calls.size()) && concurrent[i]; ++j) {
+                if (i == j) {
+                    continue;
+                }
+                concurrent[i] = std::none_of(branches[i].begin(), branches[i].end(),
+                    [&other = branches[j]](const Module* m) { return other.count(m) > 0; });
+            }
+        }
+        concurrentCnt = std::count(concurrent.begin(), concurrent.end(), true);
+    }
+#endif /* MEGAMOL_USE_PROFILING */
+
+    if (concurrentCnt < 2) {
+        for (auto& c : this->calls) {
+            if ((c.first == nullptr) || !(*c.first)(c.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::future<bool>> results(this->calls.size());
+    bool local = true; // the first concurrent branch is executed by the calling thread itself
+    for (size_t i = 0; i < this->calls.size(); ++i) {
+        if (!concurrent[i]) {
+            continue;
+        }
+        if (local) {
+            local = false;
+            continue;
+        }
+        auto task = std::make_shared<std::packaged_task<bool()>>(
+            [c = this->calls[i]]() -> bool { return (*c.first)(c.second); });
+        results[i] = task->get_future();
+        WorkerPool::Instance().Submit([task]() { (*task)(); });
+    }
+
+    bool retval = true;
+    std::exception_ptr error;
+    for (size_t i = 0; i < this->calls.size(); ++i) {
+        if (results[i].valid()) {
+            continue;
+        }
+        try {
+            retval = (*this->calls[i].first)(this->calls[i].second) && retval;
+        } catch (...) {
+            error = std::current_exception();
+            retval = false;
+        }
+    }
+    for (auto& r : results) {
+        if (!r.valid()) {
+            continue;
+        }
+        while (r.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!WorkerPool::Instance().RunPending()) {
+                r.wait_for(std::chrono::milliseconds(1));
+            }
+        }
+        try {
+            retval = r.get() && retval;
+        } catch (...) {
+            error = std::current_exception();
+            retval = false;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return retval;
+}
+
+
+/*
+ * ParallelCalls::collectBranch
+ */
+bool ParallelCalls::collectBranch(const Call& call, int func, std::set<const Module*>& modules) {
+    const CalleeSlot* callee = call.PeekCalleeSlot();
+    if (callee == nullptr) {
+        return false;
+    }
+    bool safe = !call.GetCapabilities().OpenGLRequired() && (call.GetCallbackCount() > 0);
+    for (unsigned int f = 0; f < call.GetCallbackCount(); ++f) {
+        if ((func < 0) || (static_cast<unsigned int>(func) == f)) {
+            safe = safe && callee->IsCallbackConcurrencySafe(call, f);
+        }
+    }
+
+    // the whole branch is collected even if it is not safe, so that other branches can be tested against it
+    Module* module = const_cast<Module*>(reinterpret_cast<const Module*>(callee->Owner()));
+    if (module == nullptr) {
+        return false;
+    }
+    if (!modules.insert(module).second) {
+        return safe; // the inputs of the module have already been visited
+    }
+    // the module may call any function of its inputs
+    for (CallerSlot* slot : module->GetSlots<CallerSlot>()) {
+        const Call* input = slot->CallAs<Call>();
+        if (input != nullptr) {
+            safe = collectBranch(*input, -1, modules) && safe;
+        }
+    }
+    return safe;
+}
@@ -0,0 +1,79 @@
+/*
+ * ParamSnapshot.cpp
+ *
+ * Copyright (C) 2022 by Universitaet Stuttgart (VIS).
+ * Alle Rechte vorbehalten.
+ */
+
+#include "mmcore/param/ParamSnapshot.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "mmcore/Module.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/ButtonParam.h"
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/ParamSlot.h"
+
+using namespace megamol::core::param;
+
+
+namespace {
+
+// FNV-1a, as std::hash is not required to be equal across runs
+void hashBytes(uint64_t& hash, std::string const& str) {
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    // terminate the string, so "ab", "c" and "a", "bc" differ
+    hash ^= 0xffu;
+    hash *= 0x100000001b3ull;
+}
+
+} // namespace
+
+
+/*
+ * ParamSnapshot::Capture
+ */
+std::shared_ptr<const ParamSnapshot> ParamSnapshot::Capture(
+    Module& module, std::vector<ParamSlot const*> const& excluded) {
+    static std::atomic<uint64_t> versions{0};
+
+    std::shared_ptr<ParamSnapshot> snapshot(new ParamSnapshot());
+    for (ParamSlot* slot : module.GetSlots<ParamSlot>()) {
+        auto const& param = slot->Parameter();
+        if (param.IsNull() || slot->Param<ButtonParam>() != nullptr ||
+            std::find(excluded.begin(), excluded.end(), slot) != excluded.end()) {
+            continue;
+        }
+
+        Value value;
+        if (auto const* float_param = slot->Param<FloatParam>()) {
+            value = float_param->Value();
+        } else if (auto const* int_param = slot->Param<IntParam>()) {
+            value = int_param->Value();
+        } else if (auto const* enum_param = slot->Param<EnumParam>()) {
+            value = enum_param->Value();
+        } else if (auto const* bool_param = slot->Param<BoolParam>()) {
+            value = bool_param->Value();
+        } else {
+            value = param->ValueString();
+        }
+        snapshot->values.emplace(slot->Name().PeekBuffer(), std::make_pair(std::move(value), param->ValueString()));
+    }
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto const& [name, value] : snapshot->values) {
+        hashBytes(hash, name);
+        hashBytes(hash, value.second);
+    }
+    snapshot->hash = hash;
+    snapshot->version = ++versions;
+
+    return snapshot;
+}
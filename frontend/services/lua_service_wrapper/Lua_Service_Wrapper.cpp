@@ -24,9 +24,13 @@
 
 // local logging wrapper for your convenience until central MegaMol logger established
 #include "GUIRegisterWindow.h"
+#include "mmcore/MegaMolGraph_Snapshot.h"
 #include "mmcore/utility/buildinfo/BuildInfo.h"
 #include "mmcore/utility/log/Log.h"
 
+#include <fstream>
+#include <iterator>
+
 static void log(const char* text) {
     const std::string msg = "Lua_Service_Wrapper: " + std::string(text) + "\n";
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(msg.c_str());
@@ -471,6 +475,8 @@ void Lua_Service_Wrapper::fill_graph_manipulation_callbacks(void* callbacks_coll
     using StringResult = megamol::frontend_resources::LuaCallbacksCollection::StringResult;
     using VoidResult = megamol::frontend_resources::LuaCallbacksCollection::VoidResult;
     using DoubleResult = megamol::frontend_resources::LuaCallbacksCollection::DoubleResult;
+    using BoolResult = megamol::frontend_resources::LuaCallbacksCollection::BoolResult;
+    using LongResult = megamol::frontend_resources::LuaCallbacksCollection::LongResult;
 
     auto& callbacks = *reinterpret_cast<LuaCallbacksCollection*>(callbacks_collection_ptr);
     auto& graph = const_cast<megamol::core::MegaMolGraph&>(
@@ -548,6 +554,31 @@ void Lua_Service_Wrapper::fill_graph_manipulation_callbacks(void* callbacks_coll
             return VoidResult{};
         }});
 
+    callbacks.add<VoidResult, std::string>("mmSaveGraphSnapshot",
+        "(string filename)\n\tSave the modules, calls and parameter values of the graph as binary snapshot, which "
+        "mmLoadGraphSnapshot restores faster than a project file.",
+        {[&](std::string filename) -> VoidResult {
+            auto const snapshot = megamol::core::MegaMolGraph_Snapshot::Save(graph);
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+            if (!file) {
+                return Error{"could not write graph snapshot: " + filename};
+            }
+            return VoidResult{};
+        }});
+
+    callbacks.add<BoolResult, std::string>("mmLoadGraphSnapshot",
+        "(string filename)\n\tRestore a graph snapshot into the empty graph. Returns false if the snapshot is missing "
+        "or does not match the build or the available plugins, in which case the graph should be created as usual.",
+        {[&](std::string filename) -> BoolResult {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file) {
+                return BoolResult(false);
+            }
+            const std::vector<char> snapshot{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+            return BoolResult(megamol::core::MegaMolGraph_Snapshot::Restore(graph, snapshot));
+        }});
+
     callbacks.add<StringResult, std::string>("mmGetModuleParams",
         "(string name)\n\tReturns a 0x1-separated list of module name and all parameters.\n\tFor each parameter the "
         "name, description, definition, and value are returned.",
@@ -608,6 +639,53 @@ void Lua_Service_Wrapper::fill_graph_manipulation_callbacks(void* callbacks_coll
             return VoidResult{};
         }});
 
+    callbacks.add<LongResult, std::string>("mmGetParamHandle",
+        "(string name)\n\tReturn a handle of a parameter slot for mmSetParamHandleValue, which avoids looking up the "
+        "parameter each time it is set.",
+        {[&](std::string paramName) -> LongResult {
+            const auto handle = graph.GetParameterHandle(paramName);
+            if (handle == core::MegaMolGraph::InvalidParameterHandle) {
+                return Error{"graph could not find parameter: " + paramName};
+            }
+
+            return LongResult{handle};
+        }});
+
+    callbacks.add<VoidResult, int, float>("mmSetParamHandleValue",
+        "(int handle, float value)\n\tSet the value of a bool, int, enum or float parameter by handle.",
+        {[&](int handle, float value) -> VoidResult {
+            if (!graph.SetParameter(handle, value)) {
+                return Error{"parameter could not be set to value: " + std::to_string(handle) + " : " +
+                             std::to_string(value)};
+            }
+
+            return VoidResult{};
+        }});
+
+    callbacks.add<VoidResult, int, std::string>("mmSetParamHandleString",
+        "(int handle, string value)\n\tSet the value of a parameter by handle.",
+        {[&](int handle, std::string value) -> VoidResult {
+            if (!graph.SetParameter(handle, value)) {
+                return Error{"parameter could not be set to value: " + std::to_string(handle) + " : " + value};
+            }
+
+            return VoidResult{};
+        }});
+
+    callbacks.add<VoidResult>("mmBeginParamBatch",
+        "()\n\tDefer notifying modules of values set by mmSetParamHandleValue until mmEndParamBatch.",
+        {[&]() -> VoidResult {
+            graph.BeginParameterBatch();
+            return VoidResult{};
+        }});
+
+    callbacks.add<VoidResult>("mmEndParamBatch",
+        "()\n\tNotify modules once of all values set by mmSetParamHandleValue since mmBeginParamBatch.",
+        {[&]() -> VoidResult {
+            graph.EndParameterBatch();
+            return VoidResult{};
+        }});
+
     callbacks.add<VoidResult, std::string>("mmCreateParamGroup",
         "(string name, string size)\n\tGenerate a param group that can only be set at once. Sets are queued until size "
         "is reached.",
@@ -0,0 +1,150 @@
+/*
+ * BenchmarkReport.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "BenchmarkReport.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+
+namespace megamol {
+namespace frontend {
+
+void BenchmarkReport::reset() {
+    call_samples.clear();
+    module_samples.clear();
+    frames = 0;
+}
+
+void BenchmarkReport::push_frame(PerformanceManager& perf_man, PerformanceManager::frame_info const& frame) {
+    std::map<std::string, double> self_times;
+    std::set<std::string> callees;
+    for (auto const& e : frame.entries) {
+        if (e.type != PerformanceManager::entry_type::DURATION) {
+            continue;
+        }
+        auto const& source = lookup(perf_man, e.handle);
+        const double ms = std::chrono::duration<double, std::milli>(e.timestamp.time_since_epoch()).count();
+        call_samples[source.call].push_back(ms);
+
+        if (source.cpu && !source.callee.empty()) {
+            self_times[source.callee] += ms;
+            callees.insert(source.callee);
+            if (!source.caller.empty()) {
+                self_times[source.caller] -= ms;
+            }
+        }
+    }
+    for (auto const& [module, ms] : self_times) {
+        // views are invoked without a call, so their own time is not measured and their balance is negative
+        if (callees.count(module) > 0) {
+            module_samples[module].push_back(std::max(ms, 0.0));
+        }
+    }
+    ++frames;
+}
+
+void BenchmarkReport::forget(PerformanceManager::handle_vector const& handles) {
+    for (auto h : handles) {
+        sources.erase(h);
+    }
+}
+
+nlohmann::json BenchmarkReport::summarize() const {
+    nlohmann::json report;
+    report["frames"] = frames;
+    report["calls"] = nlohmann::json::object();
+    for (auto const& [name, samples] : call_samples) {
+        report["calls"][name] = statistics(samples);
+    }
+    report["modules"] = nlohmann::json::object();
+    for (auto const& [name, samples] : module_samples) {
+        report["modules"][name] = statistics(samples);
+    }
+    return report;
+}
+
+std::vector<std::string> BenchmarkReport::compare(
+    nlohmann::json const& report, nlohmann::json const& baseline, double tolerance, double noise_floor_ms) {
+    std::vector<std::string> regressions;
+    for (auto const* section : {"calls", "modules"}) {
+        if (!baseline.contains(section) || !report.contains(section)) {
+            continue;
+        }
+        for (auto const& [name, base] : baseline[section].items()) {
+            if (!report[section].contains(name)) {
+                continue;
+            }
+            auto const& current = report[section][name];
+            for (auto const* metric : {"median", "p95"}) {
+                const double was = base.value(metric, 0.0);
+                const double is = current.value(metric, 0.0);
+                if (is > was * (1.0 + tolerance) && is - was > noise_floor_ms) {
+                    std::stringstream msg;
+                    msg << section << " " << name << ": " << metric << " " << is << " ms, baseline " << was << " ms";
+                    regressions.push_back(msg.str());
+                }
+            }
+        }
+    }
+    return regressions;
+}
+
+BenchmarkReport::Source const& BenchmarkReport::lookup(
+    PerformanceManager& perf_man, PerformanceManager::handle_type handle) {
+    auto it = sources.find(handle);
+    if (it != sources.end()) {
+        return it->second;
+    }
+
+    Source source;
+    auto const conf = perf_man.lookup_config(handle);
+    source.cpu = conf.api == PerformanceManager::query_api::CPU;
+    source.call = perf_man.lookup_parent(handle) + "::" + conf.name + " (" +
+                  PerformanceManager::query_api_string(conf.api) + ")";
+    if (conf.parent_type == PerformanceManager::parent_type::CALL) {
+        auto const call = static_cast<core::Call const*>(conf.parent_pointer);
+        if (auto const callee = call->PeekCalleeSlot(); callee != nullptr && callee->Parent() != nullptr) {
+            source.callee = callee->Parent()->FullName().PeekBuffer();
+        }
+        if (auto const caller = call->PeekCallerSlot(); caller != nullptr && caller->Parent() != nullptr) {
+            source.caller = caller->Parent()->FullName().PeekBuffer();
+        }
+    } else {
+        // module timers measure regions within the module, which are already part of its callbacks
+        source.cpu = false;
+    }
+    return sources.emplace(handle, std::move(source)).first->second;
+}
+
+nlohmann::json BenchmarkReport::statistics(std::vector<double> samples) {
+    nlohmann::json stats;
+    stats["count"] = samples.size();
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto const rank = [&samples](double q) {
+        auto const idx = static_cast<size_t>(std::ceil(q * static_cast<double>(samples.size())));
+        return samples[std::clamp<size_t>(idx, 1, samples.size()) - 1];
+    };
+    stats["mean"] = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    stats["median"] = rank(0.5);
+    stats["p95"] = rank(0.95);
+    stats["max"] = samples.back();
+    return stats;
+}
+
+} // namespace frontend
+} // namespace megamol
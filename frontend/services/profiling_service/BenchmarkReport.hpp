@@ -0,0 +1,80 @@
+/*
+ * BenchmarkReport.hpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "PerformanceManager.h"
+
+namespace megamol {
+namespace frontend {
+
+/**
+ * Collects the durations measured by the PerformanceManager during a benchmark run and summarizes them per call
+ * callback and per module. Modules are attributed the CPU time spent in their callbacks minus the time of the calls
+ * they issue themselves, so a slowed-down module does not show up in all modules downstream of it.
+ *
+ * The report is a JSON object holding the number of recorded frames and, for the sections "calls" and "modules",
+ * the statistics of each entry in milliseconds: "count", "mean", "median", "p95" and "max".
+ */
+class BenchmarkReport {
+public:
+    using PerformanceManager = frontend_resources::PerformanceManager;
+
+    /** Drops all samples */
+    void reset();
+
+    /** Adds the timer entries of a frame */
+    void push_frame(PerformanceManager& perf_man, PerformanceManager::frame_info const& frame);
+
+    /** Forgets the cached names of timers, which must be called before their handles are reused */
+    void forget(PerformanceManager::handle_vector const& handles);
+
+    /** Answers the statistics of all samples recorded since the last reset */
+    nlohmann::json summarize() const;
+
+    /**
+     * Compares a report against a baseline. An entry regresses if its median or p95 exceeds the one of the baseline
+     * by more than the relative tolerance and by more than the absolute noise floor.
+     *
+     * @param report The report
+     * @param baseline The baseline report
+     * @param tolerance The relative tolerance, e.g. 0.1 for 10%
+     * @param noise_floor_ms The smallest difference in milliseconds which is considered a regression
+     *
+     * @return One message per regression, empty if there is none
+     */
+    static std::vector<std::string> compare(
+        nlohmann::json const& report, nlohmann::json const& baseline, double tolerance, double noise_floor_ms);
+
+private:
+    /** The names a timer is reported under */
+    struct Source {
+        std::string call;
+        std::string callee;
+        std::string caller;
+        bool cpu = true;
+    };
+
+    Source const& lookup(PerformanceManager& perf_man, PerformanceManager::handle_type handle);
+
+    static nlohmann::json statistics(std::vector<double> samples);
+
+    std::unordered_map<PerformanceManager::handle_type, Source> sources;
+    std::map<std::string, std::vector<double>> call_samples;
+    std::map<std::string, std::vector<double>> module_samples;
+    uint32_t frames = 0;
+};
+
+} // namespace frontend
+} // namespace megamol
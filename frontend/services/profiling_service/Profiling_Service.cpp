@@ -40,6 +40,11 @@ bool Profiling_Service::init(void* configPtr) {
             }
         });
     }
+    _perf_man.subscribe_to_updates([&](const frontend_resources::PerformanceManager::frame_info& fi) {
+        if (_benchmark_running) {
+            _benchmark.push_frame(_perf_man, fi);
+        }
+    });
 #endif
 
     _requestedResourcesNames = {"RegisterLuaCallbacks", "MegaMolGraph", "RenderNextFrame",
@@ -72,8 +77,10 @@ void Profiling_Service::setRequestedResources(std::vector<FrontendResource> reso
     profiling_manager_subscription.DeleteCall = [&](core::CallInstance_t const& call_inst) {
         auto the_call = call_inst.callPtr.get();
         _perf_man.remove_timers(the_call->cpu_queries);
+        _benchmark.forget(the_call->cpu_queries);
         if (the_call->GetCapabilities().OpenGLRequired()) {
             _perf_man.remove_timers(the_call->gl_queries);
+            _benchmark.forget(the_call->gl_queries);
         }
         return true;
     };
@@ -178,6 +185,65 @@ void Profiling_Service::fill_lua_callbacks() {
         }});
 
 
+    callbacks.add<frontend_resources::LuaCallbacksCollection::VoidResult>("mmBenchmarkStart",
+        "()\n\tStart collecting the durations of all calls and modules for a benchmark report.",
+        {[&]() -> frontend_resources::LuaCallbacksCollection::VoidResult {
+#ifdef MEGAMOL_USE_PROFILING
+            _benchmark.reset();
+            _benchmark_running = true;
+            return frontend_resources::LuaCallbacksCollection::VoidResult{};
+#else
+            return frontend_resources::LuaCallbacksCollection::Error{"MegaMol was built without profiling"};
+#endif
+        }});
+
+
+    callbacks.add<frontend_resources::LuaCallbacksCollection::StringResult, std::string>("mmBenchmarkStop",
+        "(string report_file)\n\tStop collecting and write the per-call and per-module statistics as JSON to the "
+        "file, if given. Returns the report.",
+        {[&](std::string report_file) -> frontend_resources::LuaCallbacksCollection::StringResult {
+            _benchmark_running = false;
+            auto const report = _benchmark.summarize().dump(2);
+            if (!report_file.empty()) {
+                std::ofstream file(report_file, std::ofstream::trunc);
+                file << report << std::endl;
+                if (!file) {
+                    return frontend_resources::LuaCallbacksCollection::Error{
+                        "could not write benchmark report " + report_file};
+                }
+            }
+            return frontend_resources::LuaCallbacksCollection::StringResult{report};
+        }});
+
+
+    callbacks.add<frontend_resources::LuaCallbacksCollection::StringResult, std::string, std::string, float, float>(
+        "mmBenchmarkCompare",
+        "(string report_file, string baseline_file, float tolerance, float noise_floor_ms)\n\tCompare a benchmark "
+        "report against a baseline report. Fails if the median or p95 of a call or module grew by more than the "
+        "relative tolerance and more than the noise floor.",
+        {[&](std::string report_file, std::string baseline_file, float tolerance,
+             float noise_floor_ms) -> frontend_resources::LuaCallbacksCollection::StringResult {
+            nlohmann::json report, baseline;
+            try {
+                std::ifstream(report_file) >> report;
+                std::ifstream(baseline_file) >> baseline;
+            } catch (nlohmann::json::exception const& ex) {
+                return frontend_resources::LuaCallbacksCollection::Error{
+                    std::string("could not read benchmark reports: ") + ex.what()};
+            }
+            auto const regressions = BenchmarkReport::compare(report, baseline, tolerance, noise_floor_ms);
+            std::string result;
+            for (auto const& r : regressions) {
+                result += r + "\n";
+            }
+            if (!regressions.empty()) {
+                return frontend_resources::LuaCallbacksCollection::Error{
+                    std::to_string(regressions.size()) + " performance regressions:\n" + result};
+            }
+            return frontend_resources::LuaCallbacksCollection::StringResult{"no performance regressions"};
+        }});
+
+
     auto& register_callbacks =
         _requestedResourcesReferences[0]
             .getResource<std::function<void(frontend_resources::LuaCallbacksCollection const&)>>();
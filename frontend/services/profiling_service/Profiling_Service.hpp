@@ -10,6 +10,7 @@
 #include <fstream>
 
 #include "AbstractFrontendService.hpp"
+#include "BenchmarkReport.hpp"
 #include "PerformanceManager.h"
 
 namespace megamol {
@@ -50,6 +51,9 @@ private:
 
     megamol::frontend_resources::PerformanceManager _perf_man;
     std::ofstream log_file;
+
+    BenchmarkReport _benchmark;
+    bool _benchmark_running = false;
 };
 
 } // namespace frontend
@@ -6,6 +6,7 @@
  */
 
 #include "CinematicView.h"
+#include "MPI_Context.h"
 #include "cinematic/CallKeyframeKeeper.h"
 #include "mmcore/MegaMolGraph.h"
 #include "mmcore/param/BoolParam.h"
@@ -45,6 +46,12 @@ CinematicView::CinematicView(void)
         , frameFolderParam("cinematic::frameFolder", "Specify folder where the frame files should be stored.")
         , addSBSideToNameParam(
               "cinematic::addSBSideToName", "Toggle whether skybox side should be added to output filename")
+        , workerCountParam("cinematic::workerCount",
+              "Number of workers sharing the frames to render, each rendering one contiguous chunk (0 uses the MPI "
+              "ranks if available).")
+        , workerIndexParam("cinematic::workerIndex", "Index of this worker, ignored if the MPI ranks are used.")
+        , resumeParam("cinematic::resume",
+              "Skip frames already written to the frame folder, e.g. to continue an interrupted rendering.")
         , png_data()
         , utils()
         , deltaAnimTime(clock())
@@ -108,6 +115,15 @@ CinematicView::CinematicView(void)
 
     this->addSBSideToNameParam << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->addSBSideToNameParam);
+
+    this->workerCountParam.SetParameter(new param::IntParam(1, 0));
+    this->MakeSlotAvailable(&this->workerCountParam);
+
+    this->workerIndexParam.SetParameter(new param::IntParam(0, 0));
+    this->MakeSlotAvailable(&this->workerIndexParam);
+
+    this->resumeParam << new param::BoolParam(false);
+    this->MakeSlotAvailable(&this->resumeParam);
 }
 
 
@@ -575,8 +591,31 @@ bool CinematicView::render_to_file_setup() {
             lastFrame);
         firstFrame = lastFrame;
     }
-
-    this->png_data.cnt = firstFrame;
+    lastFrame = std::min(lastFrame, maxFrame);
+
+    // Split the frames into contiguous chunks, so every worker only needs the simulation frames of its own chunk
+    unsigned int workerCount = static_cast<unsigned int>(this->workerCountParam.Param<param::IntParam>()->Value());
+    unsigned int workerIndex = static_cast<unsigned int>(this->workerIndexParam.Param<param::IntParam>()->Value());
+    if (workerCount == 0) {
+        workerCount = 1;
+        workerIndex = 0;
+        auto const mpi = this->frontend_resources.getOptional<frontend_resources::MPI_Context>();
+        if (mpi.has_value() && (mpi.value().get().mpi_comm_size > 1)) {
+            workerCount = static_cast<unsigned int>(mpi.value().get().mpi_comm_size);
+            workerIndex = static_cast<unsigned int>(mpi.value().get().rank);
+        }
+    }
+    if (workerIndex >= workerCount) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "[CINEMATIC VIEW] [render_to_file_setup] Worker index %u exceeds worker count %u.", workerIndex,
+            workerCount);
+        this->rendering = false;
+        return false;
+    }
+    const uint64_t chunkSize = (static_cast<uint64_t>(lastFrame) - firstFrame + workerCount) / workerCount;
+    const uint64_t chunkStart = firstFrame + workerIndex * chunkSize;
+    this->png_data.cnt = static_cast<unsigned int>(std::min<uint64_t>(chunkStart, lastFrame + 1ull));
+    this->png_data.last_frame = static_cast<unsigned int>(std::min<uint64_t>(chunkStart + chunkSize - 1, lastFrame));
     this->png_data.animTime = (float)this->png_data.cnt / (float)this->fps;
 
     // Calculate pre-decimal point positions for frame counter in filename
@@ -598,8 +637,14 @@ bool CinematicView::render_to_file_setup() {
 #else  /* defined(_WIN32) && (_MSC_VER >= 1400) */
     now = localtime(&t);
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
-    frameFolder.Format("frames_%i%02i%02i-%02i%02i%02i_%02ifps", (now->tm_year + 1900), (now->tm_mon + 1), now->tm_mday,
-        now->tm_hour, now->tm_min, now->tm_sec, this->fps);
+    if (this->resumeParam.Param<param::BoolParam>()->Value() || (workerCount > 1)) {
+        // resuming needs the same folder in every run, and all workers must write into the same folder, while their
+        // clocks may tick over to the next second at different times
+        frameFolder.Format("frames_%02ifps", this->fps);
+    } else {
+        frameFolder.Format("frames_%i%02i%02i-%02i%02i%02i_%02ifps", (now->tm_year + 1900), (now->tm_mon + 1),
+            now->tm_mday, now->tm_hour, now->tm_min, now->tm_sec, this->fps);
+    }
     this->png_data.path = static_cast<vislib::StringA>(
         this->frameFolderParam.Param<param::FilePathParam>()->Value().generic_u8string().c_str());
     if (this->png_data.path.IsEmpty()) {
@@ -620,8 +665,16 @@ bool CinematicView::render_to_file_setup() {
     param::ParamSlot* animParam = static_cast<param::ParamSlot*>(this->_timeCtrl.GetSlot(0)); // animPlaySlot
     animParam->Param<param::BoolParam>()->SetValue(false);
 
+    if (!this->render_to_file_next_frame()) {
+        this->render_to_file_cleanup();
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+            "[CINEMATIC VIEW] No frames left to render for worker %u of %u.", workerIndex, workerCount);
+        return false;
+    }
+
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-        "[CINEMATIC VIEW] Started rendering of complete animation...");
+        "[CINEMATIC VIEW] Started rendering of frames %u to %u (worker %u of %u)...", this->png_data.cnt,
+        this->png_data.last_frame, workerIndex, workerCount);
 
     return true;
 }
@@ -634,32 +687,13 @@ bool CinematicView::render_to_file_write() {
         if (ccc == nullptr)
             return false;
 
-        vislib::StringA tmpFilename, tmpStr;
-        tmpStr.Format(".%i", this->png_data.exp_frame_cnt);
-        tmpStr.Prepend("%0");
-        tmpStr.Append("i.png");
-        tmpFilename.Format(tmpStr.PeekBuffer(), this->png_data.cnt);
-        if (this->sbSide != CinematicView::SKYBOX_NONE &&
-            this->addSBSideToNameParam.Param<core::param::BoolParam>()->Value()) {
-            if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_FRONT) {
-                tmpFilename.Prepend("_front.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_BACK) {
-                tmpFilename.Prepend("_back.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_RIGHT) {
-                tmpFilename.Prepend("_right.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_LEFT) {
-                tmpFilename.Prepend("_left.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_UP) {
-                tmpFilename.Prepend("_up.");
-            } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_DOWN) {
-                tmpFilename.Prepend("_down.");
-            }
-        }
-        tmpFilename.Prepend(this->png_data.filename);
+        // The image is written to a temporary file first, so only complete frames are skipped when resuming
+        const vislib::StringA filePath =
+            vislib::sys::Path::Concatenate(this->png_data.path, this->render_to_file_name(this->png_data.cnt));
+        const vislib::StringA partPath = filePath + ".part";
 
         // Open final image file
-        if (!this->png_data.file.Open(vislib::sys::Path::Concatenate(this->png_data.path, tmpFilename),
-                vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_EXCLUSIVE,
+        if (!this->png_data.file.Open(partPath, vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_EXCLUSIVE,
                 vislib::sys::File::CREATE_OVERWRITE)) {
             throw vislib::Exception(
                 "[CINEMATIC VIEW] [render_to_file_write] Cannot open output file", __FILE__, __LINE__);
@@ -741,6 +775,13 @@ bool CinematicView::render_to_file_write() {
         try {
             this->png_data.file.Close();
         } catch (...) {}
+        if (vislib::sys::File::Exists(filePath.PeekBuffer())) {
+            vislib::sys::File::Delete(filePath.PeekBuffer());
+        }
+        if (!vislib::sys::File::Rename(partPath.PeekBuffer(), filePath.PeekBuffer())) {
+            throw vislib::Exception(
+                "[CINEMATIC VIEW] [render_to_file_write] Cannot rename output file", __FILE__, __LINE__);
+        }
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "[CINEMATIC VIEW] [render_to_file_write] Wrote png file %d for animation time %f ...\n", this->png_data.cnt,
             this->png_data.animTime);
@@ -749,12 +790,6 @@ bool CinematicView::render_to_file_write() {
 
         // Next frame/time step
         this->png_data.cnt++;
-        this->png_data.animTime = (float)this->png_data.cnt / (float)this->fps;
-        float fpsFrac = (1.0f / static_cast<float>(this->fps));
-        // Fit animTime to exact full seconds (removing rounding error)
-        if (std::abs(this->png_data.animTime - std::round(this->png_data.animTime)) < (fpsFrac / 2.0)) {
-            this->png_data.animTime = std::round(this->png_data.animTime);
-        }
 
         /// XXX Handling this case is actually only necessary when rendering is done via FBOCompositor
         /// XXX Rendering crashes - WHY?
@@ -764,8 +799,7 @@ bool CinematicView::render_to_file_write() {
         //} else
 
         // Check condition for finishing rendering
-        auto lastFrame = static_cast<unsigned int>(this->lastRenderFrameParam.Param<param::IntParam>()->Value());
-        if ((this->png_data.animTime > ccc->GetTotalAnimTime()) || (this->png_data.cnt > lastFrame)) {
+        if (!this->render_to_file_next_frame()) {
             this->render_to_file_cleanup();
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[CINEMATIC VIEW] Finished rendering.");
             return false;
@@ -776,6 +810,62 @@ bool CinematicView::render_to_file_write() {
 }
 
 
+vislib::StringA CinematicView::render_to_file_name(unsigned int frame) const {
+
+    vislib::StringA tmpFilename, tmpStr;
+    tmpStr.Format(".%i", this->png_data.exp_frame_cnt);
+    tmpStr.Prepend("%0");
+    tmpStr.Append("i.png");
+    tmpFilename.Format(tmpStr.PeekBuffer(), frame);
+    if (this->sbSide != CinematicView::SKYBOX_NONE &&
+        this->addSBSideToNameParam.Param<core::param::BoolParam>()->Value()) {
+        if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_FRONT) {
+            tmpFilename.Prepend("_front.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_BACK) {
+            tmpFilename.Prepend("_back.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_RIGHT) {
+            tmpFilename.Prepend("_right.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_LEFT) {
+            tmpFilename.Prepend("_left.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_UP) {
+            tmpFilename.Prepend("_up.");
+        } else if (this->sbSide == CinematicView::SkyboxSides::SKYBOX_DOWN) {
+            tmpFilename.Prepend("_down.");
+        }
+    }
+    tmpFilename.Prepend(this->png_data.filename);
+    return tmpFilename;
+}
+
+
+bool CinematicView::render_to_file_next_frame() {
+
+    auto ccc = this->keyframeKeeperSlot.CallAs<cinematic::CallKeyframeKeeper>();
+    if (ccc == nullptr) {
+        return false;
+    }
+
+    // Frames written completely by an earlier run are skipped
+    if (this->resumeParam.Param<param::BoolParam>()->Value()) {
+        while ((this->png_data.cnt <= this->png_data.last_frame) &&
+               vislib::sys::File::Exists(
+                   vislib::sys::Path::Concatenate(this->png_data.path, this->render_to_file_name(this->png_data.cnt))
+                       .PeekBuffer())) {
+            this->png_data.cnt++;
+        }
+    }
+
+    this->png_data.animTime = (float)this->png_data.cnt / (float)this->fps;
+    float fpsFrac = (1.0f / static_cast<float>(this->fps));
+    // Fit animTime to exact full seconds (removing rounding error)
+    if (std::abs(this->png_data.animTime - std::round(this->png_data.animTime)) < (fpsFrac / 2.0)) {
+        this->png_data.animTime = std::round(this->png_data.animTime);
+    }
+
+    return (this->png_data.animTime <= ccc->GetTotalAnimTime()) && (this->png_data.cnt <= this->png_data.last_frame);
+}
+
+
 bool CinematicView::render_to_file_cleanup() {
 
     this->rendering = false;
@@ -37,6 +37,7 @@ public:
     std::vector<std::string> requested_lifetime_resources() override {
         auto lifetime_resources = Base::requested_lifetime_resources();
         lifetime_resources.push_back("MegaMolGraph");
+        lifetime_resources.push_back("optional<MPI_Context>");
         return lifetime_resources;
     }
 
@@ -105,6 +106,7 @@ private:
         vislib::StringA path;
         vislib::StringA filename;
         unsigned int cnt;
+        unsigned int last_frame;
         png_structp structptr = nullptr;
         png_infop infoptr = nullptr;
         float animTime;
@@ -138,6 +140,22 @@ private:
 
     bool render_to_file_cleanup();
 
+    /**
+     * Answer the file name of a frame, without the output folder.
+     *
+     * @param frame The number of the frame
+     *
+     * @return The file name
+     */
+    vislib::StringA render_to_file_name(unsigned int frame) const;
+
+    /**
+     * Advances to the next frame of the own frame range which has not been written yet.
+     *
+     * @return 'true' if there is such a frame, 'false' if all frames have been written
+     */
+    bool render_to_file_next_frame();
+
     /**
      * Error handling function for png export
      *
@@ -202,6 +220,9 @@ private:
     core::param::ParamSlot fpsParam;
     core::param::ParamSlot frameFolderParam;
     core::param::ParamSlot addSBSideToNameParam;
+    core::param::ParamSlot workerCountParam;
+    core::param::ParamSlot workerIndexParam;
+    core::param::ParamSlot resumeParam;
 };
 
 } // namespace cinematic_gl
@@ -7,16 +7,84 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "datatools/FrameResultCache.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/factories/CallAutoDescription.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/ParamSlot.h"
+#include "mmcore/param/ParamSnapshot.h"
+#include "mmcore/param/StringParam.h"
+#include "mmcore/utility/log/Log.h"
 
 namespace megamol {
 namespace datatools {
 
+/** Whether the requests of a call can carry a region of interest */
+template<class C, class = void>
+struct has_region_of_interest : std::false_type {};
+
+template<class C>
+struct has_region_of_interest<C, std::void_t<decltype(std::declval<C&>().ClearRegionOfInterest())>>
+        : std::true_type {};
+
+/** Whether the requests of a call can ask for a window of consecutive frames */
+template<class C, class = void>
+struct has_frame_window : std::false_type {};
+
+template<class C>
+struct has_frame_window<C, std::void_t<decltype(std::declval<C&>().SetFrameWindow(1u))>> : std::true_type {};
+
+/**
+ * Reduces a request forwarded to the original data to the complete particles of a single frame, i.e. drops its region
+ * of interest and frame window. Modules computing on the particles of the requested frame only must do so, as their
+ * result may depend on particles outside of the region and they would pass the further frames of a window on
+ * unprocessed.
+ *
+ * @param request The forwarded request
+ */
+template<class C>
+void request_whole_frame(C& request) {
+    if constexpr (has_region_of_interest<C>::value) {
+        request.ClearRegionOfInterest();
+    }
+    if constexpr (has_frame_window<C>::value) {
+        request.SetFrameWindow(1);
+    }
+}
+
 /**
  * Abstract class data manipulators for calls with getData/getExtent interface
+ *
+ * Modules reading their parameters only through 'parameters' in 'manipulateData' and 'manipulateExtent' can opt in to
+ * asynchronous manipulation by overriding 'supportsAsync', which exposes the 'asyncManipulation' parameter. If it is
+ * enabled, the original data is requested by the calling thread and detached from the upstream modules, and only its
+ * manipulation runs on a worker thread, with the parameter values of the request. A data request is then answered
+ * immediately with the last completed result, which carries the frame ID it was computed for, and a request for another
+ * frame supersedes the one being computed. Only the very first request waits for its result. This requires 'detachData'
+ * to be able to make the data independent of the memory of this and the upstream modules; otherwise, and for modules
+ * with further inputs, the module falls back to synchronous manipulation.
+ *
+ * If 'frameCache' is enabled, detached results are kept in a least recently used cache keyed by the hash and frame
+ * of the original data, the values of all parameters and the region of interest forwarded to the original data, so
+ * revisited frames are served without manipulating them again. Modules with further inputs cannot be cached, because
+ * their data is not part of the key.
  */
 template<class C>
 class AbstractManipulator : public megamol::core::Module {
@@ -43,6 +111,7 @@ protected:
      * Manipulates the particle data
      *
      * @remarks the default implementation does not changed the data
+     * @remarks implementations read their parameters from 'parameters', as this may run on a worker thread
      *
      * @param outData The call receiving the manipulated data
      * @param inData The call holding the original data
@@ -63,7 +132,96 @@ protected:
      */
     virtual bool manipulateExtent(C& outData, C& inData);
 
+    /**
+     * Adjusts the data request before it is forwarded to the original data
+     *
+     * @remarks the default implementation drops the region of interest, as the manipulation of a particle may depend
+     *          on particles outside of it. Only manipulators of single particles should forward it. It also requests
+     *          a single frame, as 'manipulateData' only manipulates the requested frame and the further frames of a
+     *          window would be passed on unmanipulated. Callers get a shorter window then, which they must handle.
+     *
+     * @param inData The call requesting the original data, holding the request of the caller
+     */
+    virtual void prepareRequest(C& inData);
+
+    /**
+     * Copies all data referenced by 'data' into 'storage' and redirects 'data' to the copies, such that the result
+     * stays valid while the next one is computed asynchronously
+     *
+     * @remarks the default implementation does not support this, which disables the asynchronous mode
+     *
+     * @param data The manipulated data
+     * @param storage Receives the memory referenced by 'data' afterwards
+     *
+     * @return True if 'data' no longer references memory owned by this or any other module
+     */
+    virtual bool detachData(C& data, std::vector<std::vector<uint8_t>>& storage);
+
+    /**
+     * Redirects all data pointers of a detached result, which is used to read spilled results back from disk
+     *
+     * @remarks the default implementation does nothing
+     *
+     * @param data The detached result
+     * @param relocate Maps a previous data address to the new one
+     */
+    virtual void relocateData(C& data, std::function<const void*(const void*)> const& relocate);
+
+    /**
+     * Answer whether 'manipulateData' may run on a worker thread. This requires it to read its parameters only from
+     * 'parameters' and to touch no other state shared with the calling thread, e.g. the dirty flags of the slots.
+     *
+     * @remarks the default implementation answers false, which hides the 'asyncManipulation' parameter
+     *
+     * @return True if the module supports the asynchronous manipulation
+     */
+    virtual bool supportsAsync(void) const;
+
+    /**
+     * Answer the parameter values captured with the request being manipulated. Only valid in 'manipulateData' and
+     * 'manipulateExtent'.
+     *
+     * @return The parameter values
+     */
+    inline core::param::ParamSnapshot const& parameters(void) const {
+        return *this->requestParams;
+    }
+
+    /**
+     * Answer whether the running asynchronous manipulation has been superseded by a request for another frame.
+     * Long running implementations of 'manipulateData' may poll this and return false early.
+     *
+     * @return True if the result of the running manipulation is no longer needed
+     */
+    inline bool isCancelled(void) const {
+        return this->cancelled.load();
+    }
+
+    /**
+     * Reports the progress of the running asynchronous manipulation
+     *
+     * @param progress The progress in [0, 1]
+     */
+    inline void setProgress(float progress) {
+        this->progress.store(std::clamp(progress, 0.0f, 1.0f));
+    }
+
 private:
+    /** A request waiting for the worker */
+    struct AsyncJob {
+        /** The request of the caller */
+        C request;
+
+        /** The original data, detached from the upstream modules */
+        DetachedResult<C> input;
+
+        /** The key of the result in the frame cache */
+        typename FrameResultCache<C>::Key key;
+
+        /** The parameter values of the request */
+        std::shared_ptr<const core::param::ParamSnapshot> params;
+    };
+
     /**
      * Called when the data is requested by this module
      *
@@ -82,11 +240,174 @@ private:
      */
     bool getExtentCallback(megamol::core::Call& c);
 
+    /**
+     * Answers a data request with the last completed asynchronous result and schedules the request on the worker.
+     * Waits for the result if there is none yet.
+     *
+     * @param outData The incoming call
+     *
+     * @return True if a result was available
+     */
+    bool getDataAsync(C& outData);
+
+    /**
+     * Requests the original data, detaches it and hands it to the worker, unless the last scheduled request had the
+     * same original data and parameters
+     *
+     * @param request The request of the caller
+     *
+     * @return False if the original data is not available or cannot be detached
+     */
+    bool scheduleAsync(C const& request);
+
+    /**
+     * Looks the result up in the frame cache or manipulates the data and detaches the result
+     *
+     * @param outData The call receiving the manipulated data
+     * @param inData The call holding the original data
+     * @param key The key of the result in the frame cache
+     * @param useCache Whether to use the frame cache
+     * @param previous The previous result, which is reused if 'outData' turns out to be identical
+     * @param result Receives the detached result, or nullptr if 'outData' references memory of the modules
+     *
+     * @return True on success
+     */
+    bool manipulateDetached(C& outData, C& inData, typename FrameResultCache<C>::Key const& key, bool useCache,
+        std::shared_ptr<DetachedResult<C>> const& previous, std::shared_ptr<DetachedResult<C>>& result);
+
+    /** Applies the parameters of the frame cache */
+    void updateFrameCache(void);
+
+    /**
+     * Answer whether the module has further inputs besides the original data, which are neither part of the key of
+     * the frame cache nor detached for the worker
+     *
+     * @return True if there are further caller slots
+     */
+    bool hasFurtherInputs(void) const;
+
+    /**
+     * Captures the values of all parameters of the module besides the ones of this class, which do not affect the
+     * result
+     *
+     * @return The parameter values
+     */
+    std::shared_ptr<const core::param::ParamSnapshot> captureParameters(void);
+
+    /**
+     * Answer the key of the result of a request in the frame cache. The request of the caller is only part of the key
+     * as far as 'prepareRequest' forwards it to the original data, as the result does not depend on the rest of it.
+     *
+     * @param inData The call holding the original data and the forwarded request
+     * @param params The parameter values of the request
+     *
+     * @return The key
+     */
+    static typename FrameResultCache<C>::Key resultKey(C const& inData, core::param::ParamSnapshot const& params);
+
+    /**
+     * Answer whether the asynchronous manipulation is supported and enabled
+     *
+     * @return True if requests are manipulated on the worker thread
+     */
+    inline bool asyncEnabled(void) const {
+        return this->supportsAsync() && this->asyncSlot.template Param<core::param::BoolParam>()->Value();
+    }
+
+    /** The body of the worker thread manipulating the detached data asynchronously */
+    void runWorker(void);
+
+    /** Stops the worker thread and drops all asynchronous results */
+    void stopWorker(void);
+
+    /**
+     * Shows the state of the asynchronous manipulation in the GUI
+     *
+     * @param status The state of the served result
+     * @param progress The progress of the running manipulation
+     */
+    void showAsyncState(const char* status, float progress);
+
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
     /** The slot accessing the original data */
     megamol::core::CallerSlot inDataSlot;
+
+    /** Toggles the asynchronous manipulation */
+    megamol::core::param::ParamSlot asyncSlot;
+
+    /** Shows whether the served result is up to date */
+    megamol::core::param::ParamSlot asyncStatusSlot;
+
+    /** Shows the progress of the running asynchronous manipulation */
+    megamol::core::param::ParamSlot asyncProgressSlot;
+
+    /** Toggles the frame cache */
+    megamol::core::param::ParamSlot frameCacheSlot;
+
+    /** The memory budget of the frame cache in MB */
+    megamol::core::param::ParamSlot frameCacheBudgetSlot;
+
+    /** The directory results evicted from the frame cache are spilled to */
+    megamol::core::param::ParamSlot frameCacheSpillDirSlot;
+
+    /** The disk budget of the spilled results in MB */
+    megamol::core::param::ParamSlot frameCacheSpillBudgetSlot;
+
+    /** Serialises the manipulation between the caller and the worker */
+    std::mutex computeLock;
+
+    /** The parameter values of the request being manipulated, only accessed with 'computeLock' held */
+    std::shared_ptr<const core::param::ParamSnapshot> requestParams;
+
+    /** Guards the members of the asynchronous manipulation below */
+    std::mutex asyncLock;
+
+    /** Wakes the worker */
+    std::condition_variable asyncSignal;
+
+    /** Signals that the worker completed a request */
+    std::condition_variable asyncDoneSignal;
+
+    /** The worker thread */
+    std::thread worker;
+
+    /** Asks the worker to terminate */
+    bool workerExit;
+
+    /** Flag whether the worker is manipulating data */
+    bool workerBusy;
+
+    /** The frame the worker is manipulating */
+    unsigned int workerFrame;
+
+    /** The request waiting for the worker, if any */
+    std::unique_ptr<AsyncJob> asyncJob;
+
+    /** The key of the last scheduled request, which is not scheduled again */
+    typename FrameResultCache<C>::Key asyncKey;
+
+    /** The last completed result */
+    std::shared_ptr<DetachedResult<C>> asyncResult;
+
+    /** The last extents, served while the worker is manipulating */
+    std::unique_ptr<C> asyncExtent;
+
+    /** Flag whether 'detachData' failed, which forces synchronous manipulation without caching */
+    std::atomic<bool> detachUnsupported;
+
+    /** The cached results, only accessed with 'computeLock' held */
+    FrameResultCache<C> frameCache;
+
+    /** Flag whether the frame cache is in use */
+    std::atomic<bool> frameCacheEnabled;
+
+    /** Flag whether the running manipulation has been superseded */
+    std::atomic<bool> cancelled;
+
+    /** The progress of the running manipulation */
+    std::atomic<float> progress;
 };
 
 
@@ -94,7 +415,24 @@ template<class C>
 AbstractManipulator<C>::AbstractManipulator(const char* outSlotName, const char* inSlotName)
         : megamol::core::Module()
         , outDataSlot(outSlotName, "providing access to the manipulated data")
-        , inDataSlot(inSlotName, "accessing the original data") {
+        , inDataSlot(inSlotName, "accessing the original data")
+        , asyncSlot("asyncManipulation",
+              "Manipulates the data in the background and serves the last completed result meanwhile")
+        , asyncStatusSlot("asyncStatus", "Whether the served result is up to date")
+        , asyncProgressSlot("asyncProgress", "The progress of the running asynchronous manipulation")
+        , frameCacheSlot("frameCache", "Keeps manipulated frames to serve them again without recomputation")
+        , frameCacheBudgetSlot("frameCacheBudget", "The memory budget of the frame cache in MB")
+        , frameCacheSpillDirSlot(
+              "frameCacheSpillDir", "Directory receiving frames evicted from memory, leave empty to drop them")
+        , frameCacheSpillBudgetSlot("frameCacheSpillBudget", "The disk budget of the spilled frames in MB")
+        , workerExit(false)
+        , workerBusy(false)
+        , workerFrame(0)
+        , asyncKey(0, 0, 0, 0)
+        , detachUnsupported(false)
+        , frameCacheEnabled(false)
+        , cancelled(false)
+        , progress(0.0f) {
 
     this->outDataSlot.SetCallback(C::ClassName(), "GetData", &AbstractManipulator::getDataCallback);
     this->outDataSlot.SetCallback(C::ClassName(), "GetExtent", &AbstractManipulator::getExtentCallback);
@@ -102,6 +440,28 @@ AbstractManipulator<C>::AbstractManipulator(const char* outSlotName, const char*
 
     this->inDataSlot.template SetCompatibleCall<core::factories::CallAutoDescription<C>>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    // the asynchronous slots are made available in 'create', once 'supportsAsync' can be answered by the subclass
+    this->asyncSlot << new core::param::BoolParam(false);
+
+    this->asyncStatusSlot << new core::param::StringParam("synchronous");
+    this->asyncStatusSlot.Parameter()->SetGUIReadOnly(true);
+
+    this->asyncProgressSlot << new core::param::FloatParam(0.0f, 0.0f, 1.0f);
+    this->asyncProgressSlot.Parameter()->SetGUIReadOnly(true);
+
+    this->frameCacheSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->frameCacheSlot);
+
+    this->frameCacheBudgetSlot << new core::param::IntParam(1024, 1);
+    this->MakeSlotAvailable(&this->frameCacheBudgetSlot);
+
+    this->frameCacheSpillDirSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_Directory_ToBeCreated);
+    this->MakeSlotAvailable(&this->frameCacheSpillDirSlot);
+
+    this->frameCacheSpillBudgetSlot << new core::param::IntParam(4096, 0);
+    this->MakeSlotAvailable(&this->frameCacheSpillBudgetSlot);
 }
 
 
@@ -113,12 +473,22 @@ AbstractManipulator<C>::~AbstractManipulator() {
 
 template<class C>
 bool AbstractManipulator<C>::create() {
+    if (this->supportsAsync()) {
+        this->MakeSlotAvailable(&this->asyncSlot);
+        this->MakeSlotAvailable(&this->asyncStatusSlot);
+        this->MakeSlotAvailable(&this->asyncProgressSlot);
+    }
     return true;
 }
 
 
 template<class C>
-void AbstractManipulator<C>::release() {}
+void AbstractManipulator<C>::release() {
+    this->stopWorker();
+    std::lock_guard<std::mutex> computeGuard(this->computeLock);
+    this->frameCache.Clear();
+    this->frameCacheEnabled = false;
+}
 
 
 template<class C>
@@ -137,20 +507,82 @@ bool AbstractManipulator<C>::manipulateExtent(C& outData, C& inData) {
 }
 
 
+template<class C>
+void AbstractManipulator<C>::prepareRequest(C& inData) {
+    request_whole_frame(inData);
+}
+
+
+template<class C>
+bool AbstractManipulator<C>::detachData(C& data, std::vector<std::vector<uint8_t>>& storage) {
+    return false;
+}
+
+
+template<class C>
+void AbstractManipulator<C>::relocateData(C& data, std::function<const void*(const void*)> const& relocate) {}
+
+
+template<class C>
+bool AbstractManipulator<C>::supportsAsync() const {
+    return false;
+}
+
+
 template<class C>
 bool AbstractManipulator<C>::getDataCallback(megamol::core::Call& c) {
     auto outMpdc = dynamic_cast<C*>(&c);
     if (outMpdc == NULL)
         return false;
 
+    this->updateFrameCache();
+
+    if (this->asyncEnabled()) {
+        if (!this->detachUnsupported && !this->hasFurtherInputs()) {
+            const bool served = this->getDataAsync(*outMpdc);
+            if (served || !this->detachUnsupported) {
+                return served;
+            }
+        }
+        this->showAsyncState("unsupported", 0.0f);
+    } else {
+        this->showAsyncState("synchronous", 0.0f);
+    }
+
+    std::lock_guard<std::mutex> computeGuard(this->computeLock);
+    const bool useCache = this->frameCacheEnabled;
+    if (useCache) {
+        // the caller is done with the previous result, which may be held by the cache
+        outMpdc->Unlock();
+    }
+
     auto inMpdc = this->inDataSlot.template CallAs<C>();
     if (inMpdc == NULL)
         return false;
 
     *inMpdc = *outMpdc; // to get the correct request time
+    this->prepareRequest(*inMpdc);
     if (!(*inMpdc)(0))
         return false;
 
+    this->requestParams = this->captureParameters();
+    if (useCache) {
+        const auto key = resultKey(*inMpdc, *this->requestParams);
+        std::shared_ptr<DetachedResult<C>> result;
+        if (!this->manipulateDetached(*outMpdc, *inMpdc, key, true, nullptr, result)) {
+            inMpdc->Unlock();
+            return false;
+        }
+        if (result != nullptr) {
+            // hand out the cached memory, which stays valid until the caller unlocks it
+            outMpdc->Unlock();
+            *outMpdc = result->data;
+            outMpdc->SetUnlocker(new DetachedResultUnlocker<C>(result), false);
+        }
+        inMpdc->Unlock();
+        return true;
+    }
+
     if (!this->manipulateData(*outMpdc, *inMpdc)) {
         inMpdc->Unlock();
         return false;
@@ -168,6 +600,19 @@ bool AbstractManipulator<C>::getExtentCallback(megamol::core::Call& c) {
     if (outMpdc == NULL)
         return false;
 
+    std::unique_lock<std::mutex> computeGuard(this->computeLock, std::try_to_lock);
+    if (!computeGuard.owns_lock()) {
+        // the worker is manipulating, so answer with the last extents if there are any
+        {
+            std::lock_guard<std::mutex> lock(this->asyncLock);
+            if (this->asyncExtent != nullptr) {
+                *outMpdc = *this->asyncExtent;
+                return true;
+            }
+        }
+        computeGuard.lock();
+    }
+
     auto inMpdc = this->inDataSlot.template CallAs<C>();
     if (inMpdc == NULL)
         return false;
@@ -176,6 +621,7 @@ bool AbstractManipulator<C>::getExtentCallback(megamol::core::Call& c) {
     if (!(*inMpdc)(1))
         return false;
 
+    this->requestParams = this->captureParameters();
     if (!this->manipulateExtent(*outMpdc, *inMpdc)) {
         inMpdc->Unlock();
         return false;
@@ -183,9 +629,300 @@ bool AbstractManipulator<C>::getExtentCallback(megamol::core::Call& c) {
 
     inMpdc->Unlock();
 
+    if (this->asyncEnabled()) {
+        std::lock_guard<std::mutex> lock(this->asyncLock);
+        this->asyncExtent = std::make_unique<C>();
+        *this->asyncExtent = *outMpdc;
+        this->asyncExtent->SetUnlocker(nullptr, false);
+    }
+
+    return true;
+}
+
+
+template<class C>
+bool AbstractManipulator<C>::getDataAsync(C& outData) {
+    // the caller is done with the previous result
+    outData.Unlock();
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(this->asyncLock);
+        if (!this->worker.joinable()) {
+            this->workerExit = false;
+            this->worker = std::thread(&AbstractManipulator::runWorker, this);
+        }
+        // requests for the frame being computed are merged, requests for any other frame supersede it
+        schedule = !this->workerBusy || (outData.FrameID() != this->workerFrame);
+    }
+    if (schedule && !this->scheduleAsync(outData)) {
+        this->showAsyncState("failed", 0.0f);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(this->asyncLock);
+    if (this->asyncResult == nullptr) {
+        // there is nothing to serve yet, so the first request waits for its result
+        this->asyncDoneSignal.wait(lock, [this]() {
+            return this->workerExit || (!this->workerBusy && (this->asyncJob == nullptr));
+        });
+    }
+
+    const char* status = "failed";
+    bool served = false;
+    if (this->asyncResult != nullptr) {
+        const bool current = !this->workerBusy && (this->asyncResult->data.FrameID() == outData.FrameID());
+        status = current ? "ready" : "stale";
+        outData = this->asyncResult->data;
+        outData.SetUnlocker(new DetachedResultUnlocker<C>(this->asyncResult), false);
+        served = true;
+    }
+    const float progress = this->workerBusy ? this->progress.load() : 1.0f;
+    lock.unlock();
+
+    this->showAsyncState(status, progress);
+    return served;
+}
+
+
+template<class C>
+bool AbstractManipulator<C>::scheduleAsync(C const& request) {
+    auto inData = this->inDataSlot.template CallAs<C>();
+    if (inData == nullptr)
+        return false;
+
+    *inData = request; // to get the correct request time
+    this->prepareRequest(*inData);
+    if (!(*inData)(0))
+        return false;
+
+    auto params = this->captureParameters();
+    const auto key = resultKey(*inData, *params);
+    {
+        std::lock_guard<std::mutex> lock(this->asyncLock);
+        if ((inData->DataHash() != 0) && (key == this->asyncKey)) {
+            // the result is completed or being computed already
+            inData->Unlock();
+            return true;
+        }
+    }
+
+    auto job = std::make_unique<AsyncJob>();
+    job->request = request;
+    job->request.SetUnlocker(nullptr, false);
+    job->input.data = *inData;
+    job->input.data.SetUnlocker(nullptr, false);
+    const bool detached = this->detachData(job->input.data, job->input.storage);
+    inData->Unlock();
+    if (!detached) {
+        if (!this->detachUnsupported.exchange(true)) {
+            core::utility::log::Log::DefaultLog.WriteWarn(
+                "%s cannot detach its data, falling back to synchronous manipulation without caching",
+                this->FullName().PeekBuffer());
+        }
+        return false;
+    }
+    job->key = key;
+    job->params = std::move(params);
+
+    std::lock_guard<std::mutex> lock(this->asyncLock);
+    if (this->workerBusy) {
+        this->cancelled = true;
+    }
+    this->asyncJob = std::move(job);
+    this->asyncKey = key;
+    this->asyncSignal.notify_one();
+    return true;
+}
+
+
+template<class C>
+void AbstractManipulator<C>::runWorker(void) {
+    std::unique_lock<std::mutex> lock(this->asyncLock);
+    while (true) {
+        this->asyncSignal.wait(lock, [this]() { return this->workerExit || (this->asyncJob != nullptr); });
+        if (this->workerExit) {
+            break;
+        }
+        std::unique_ptr<AsyncJob> job = std::move(this->asyncJob);
+        this->workerBusy = true;
+        this->workerFrame = job->request.FrameID();
+        this->cancelled = false;
+        this->progress = 0.0f;
+        lock.unlock();
+
+        // 'asyncResult' is only replaced by this thread, so it can be read without the lock
+        std::shared_ptr<DetachedResult<C>> result;
+        bool manipulated = false;
+        {
+            std::lock_guard<std::mutex> computeGuard(this->computeLock);
+            this->requestParams = job->params;
+            // a superseded manipulation that still completes is served until the next one is done
+            C outData;
+            outData = job->request;
+            manipulated = this->manipulateDetached(
+                outData, job->input.data, job->key, this->frameCacheEnabled, this->asyncResult, result);
+            outData.Unlock();
+        }
+        // the result is detached, so the original data is no longer needed
+        job.reset();
+
+        lock.lock();
+        this->workerBusy = false;
+        this->cancelled = false;
+        if (manipulated && (result != nullptr)) {
+            this->asyncResult = std::move(result);
+        } else if (this->asyncJob == nullptr) {
+            // allow the failed request to be scheduled again
+            this->asyncKey = typename FrameResultCache<C>::Key(0, 0, 0, 0);
+        }
+        this->asyncDoneSignal.notify_all();
+    }
+}
+
+
+template<class C>
+bool AbstractManipulator<C>::manipulateDetached(C& outData, C& inData, typename FrameResultCache<C>::Key const& key,
+    bool useCache, std::shared_ptr<DetachedResult<C>> const& previous, std::shared_ptr<DetachedResult<C>>& result) {
+    const bool cacheable = useCache && (std::get<0>(key) != 0);
+    if (cacheable) {
+        result = this->frameCache.Find(key, [this](C& data, std::function<const void*(const void*)> const& relocate) {
+            this->relocateData(data, relocate);
+        });
+        if (result != nullptr) {
+            outData = result->data;
+            return true;
+        }
+    }
+
+    if (!this->manipulateData(outData, inData)) {
+        return false;
+    }
+
+    if ((previous != nullptr) && (outData.DataHash() != 0) && (outData.DataHash() == previous->data.DataHash()) &&
+        (outData.FrameID() == previous->data.FrameID())) {
+        result = previous;
+    } else {
+        result = std::make_shared<DetachedResult<C>>();
+        result->data = outData;
+        result->data.SetUnlocker(nullptr, false);
+        if (!this->detachData(result->data, result->storage)) {
+            result.reset();
+            if (!this->detachUnsupported.exchange(true)) {
+                core::utility::log::Log::DefaultLog.WriteWarn(
+                    "%s cannot detach its results, falling back to synchronous manipulation without caching",
+                    this->FullName().PeekBuffer());
+            }
+            return true;
+        }
+    }
+    if (cacheable) {
+        this->frameCache.Insert(key, result);
+    }
+
     return true;
 }
 
 
+template<class C>
+void AbstractManipulator<C>::updateFrameCache(void) {
+    bool enable = this->frameCacheSlot.template Param<core::param::BoolParam>()->Value() && !this->detachUnsupported;
+    if (enable && !this->frameCacheEnabled && this->hasFurtherInputs()) {
+        // the data of further inputs is not part of the key
+        core::utility::log::Log::DefaultLog.WriteWarn(
+            "%s cannot cache frames because it has further inputs", this->FullName().PeekBuffer());
+        this->frameCacheSlot.template Param<core::param::BoolParam>()->SetValue(false, false);
+        enable = false;
+    }
+    if ((enable == this->frameCacheEnabled) && !this->frameCacheBudgetSlot.IsDirty() &&
+        !this->frameCacheSpillDirSlot.IsDirty() && !this->frameCacheSpillBudgetSlot.IsDirty()) {
+        return;
+    }
+    this->frameCacheBudgetSlot.ResetDirty();
+    this->frameCacheSpillDirSlot.ResetDirty();
+    this->frameCacheSpillBudgetSlot.ResetDirty();
+
+    std::lock_guard<std::mutex> computeGuard(this->computeLock);
+    if (enable) {
+        std::string prefix(this->FullName().PeekBuffer());
+        std::replace(prefix.begin(), prefix.end(), ':', '_');
+        const size_t mb = 1024 * 1024;
+        this->frameCache.SetBudget(
+            mb * static_cast<size_t>(this->frameCacheBudgetSlot.template Param<core::param::IntParam>()->Value()),
+            mb * static_cast<size_t>(this->frameCacheSpillBudgetSlot.template Param<core::param::IntParam>()->Value()),
+            this->frameCacheSpillDirSlot.template Param<core::param::FilePathParam>()->Value(), prefix);
+    } else {
+        this->frameCache.Clear();
+    }
+    this->frameCacheEnabled = enable;
+}
+
+
+template<class C>
+bool AbstractManipulator<C>::hasFurtherInputs(void) const {
+    for (auto it = this->ChildList_Begin(); it != this->ChildList_End(); ++it) {
+        auto slot = dynamic_cast<const core::CallerSlot*>(it->get());
+        if ((slot != nullptr) && (slot != &this->inDataSlot)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+template<class C>
+std::shared_ptr<const core::param::ParamSnapshot> AbstractManipulator<C>::captureParameters(void) {
+    return core::param::ParamSnapshot::Capture(*this,
+        {&this->asyncSlot, &this->asyncStatusSlot, &this->asyncProgressSlot, &this->frameCacheSlot,
+            &this->frameCacheBudgetSlot, &this->frameCacheSpillDirSlot, &this->frameCacheSpillBudgetSlot});
+}
+
+
+template<class C>
+typename FrameResultCache<C>::Key AbstractManipulator<C>::resultKey(
+    C const& inData, core::param::ParamSnapshot const& params) {
+    size_t hash = 0;
+    auto combine = [&hash](size_t v) { hash ^= v + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    if constexpr (has_region_of_interest<C>::value) {
+        if (inData.HasRegionOfInterest()) {
+            auto const& roi = inData.GetRegionOfInterest();
+            for (float v : {roi.Left(), roi.Bottom(), roi.Back(), roi.Right(), roi.Top(), roi.Front()}) {
+                combine(std::hash<float>()(v));
+            }
+        }
+    }
+    return typename FrameResultCache<C>::Key(inData.DataHash(), inData.FrameID(), params.Hash(), hash);
+}
+
+
+template<class C>
+void AbstractManipulator<C>::stopWorker(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->asyncLock);
+        this->workerExit = true;
+        this->cancelled = true;
+    }
+    this->asyncSignal.notify_all();
+    this->asyncDoneSignal.notify_all();
+    if (this->worker.joinable()) {
+        this->worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(this->asyncLock);
+    this->asyncJob.reset();
+    this->asyncKey = typename FrameResultCache<C>::Key(0, 0, 0, 0);
+    this->asyncResult.reset();
+    this->asyncExtent.reset();
+    this->cancelled = false;
+}
+
+
+template<class C>
+void AbstractManipulator<C>::showAsyncState(const char* status, float progress) {
+    this->asyncStatusSlot.template Param<core::param::StringParam>()->SetValue(status, false);
+    this->asyncProgressSlot.template Param<core::param::FloatParam>()->SetValue(progress, false);
+}
+
+
 } /* end namespace datatools */
 } /* end namespace megamol */
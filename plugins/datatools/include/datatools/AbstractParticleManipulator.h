@@ -14,5 +14,19 @@ namespace datatools {
 
 using AbstractParticleManipulator = AbstractManipulator<geocalls::MultiParticleDataCall>;
 
+/**
+ * Copies the particle data of all lists, which allows particle manipulators to work asynchronously and to cache frames
+ */
+template<>
+bool AbstractManipulator<geocalls::MultiParticleDataCall>::detachData(
+    geocalls::MultiParticleDataCall& data, std::vector<std::vector<uint8_t>>& storage);
+
+/**
+ * Redirects the particle data of all lists
+ */
+template<>
+void AbstractManipulator<geocalls::MultiParticleDataCall>::relocateData(
+    geocalls::MultiParticleDataCall& data, std::function<const void*(const void*)> const& relocate);
+
 } /* end namespace datatools */
 } /* end namespace megamol */
@@ -0,0 +1,370 @@
+/*
+ * FrameResultCache.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "mmstd/data/AbstractGetDataCall.h"
+
+namespace megamol {
+namespace datatools {
+
+/**
+ * A manipulation result that owns all memory it references
+ */
+template<class C>
+struct DetachedResult {
+    /** The result, referencing 'storage' */
+    C data;
+
+    /** The memory referenced by 'data' */
+    std::vector<std::vector<uint8_t>> storage;
+
+    /**
+     * Answer the number of bytes owned by the result
+     *
+     * @return The size of 'storage' in bytes
+     */
+    size_t Size(void) const {
+        size_t size = 0;
+        for (auto const& s : this->storage) {
+            size += s.size();
+        }
+        return size;
+    }
+};
+
+
+/**
+ * Unlocker keeping a detached result alive until the caller is done with it
+ */
+template<class C>
+class DetachedResultUnlocker : public core::AbstractGetDataCall::Unlocker {
+public:
+    /**
+     * Ctor
+     *
+     * @param result The result handed out
+     */
+    explicit DetachedResultUnlocker(std::shared_ptr<const DetachedResult<C>> result) : result(std::move(result)) {}
+
+    /** Releases the result */
+    void Unlock() override {
+        this->result.reset();
+    }
+
+private:
+    /** The result handed out */
+    std::shared_ptr<const DetachedResult<C>> result;
+};
+
+
+/**
+ * Least recently used cache of detached results within a memory budget. Results evicted from memory can be spilled
+ * into a directory, from which they are read back when requested again.
+ */
+template<class C>
+class FrameResultCache {
+public:
+    /**
+     * The input data hash, the frame ID, the hash of the parameters and the hash of the region of interest forwarded
+     * to the input data
+     */
+    using Key = std::tuple<size_t, unsigned int, uint64_t, size_t>;
+
+    /** Shared pointer to a result */
+    using ResultPtr = std::shared_ptr<DetachedResult<C>>;
+
+    /** Ctor */
+    FrameResultCache(void) : memoryBudget(0), spillBudget(0), memoryUsed(0), spillUsed(0), spillCount(0) {}
+
+    /** Dtor */
+    ~FrameResultCache(void) {
+        this->Clear();
+    }
+
+    /**
+     * Drops all results and deletes the spilled files
+     */
+    void Clear(void) {
+        for (auto& e : this->entries) {
+            this->removeSpillFile(e);
+        }
+        this->entries.clear();
+        this->index.clear();
+        this->memoryUsed = 0;
+        this->spillUsed = 0;
+    }
+
+    /**
+     * Answer whether the cache is empty
+     *
+     * @return True if no result is cached
+     */
+    inline bool IsEmpty(void) const {
+        return this->entries.empty();
+    }
+
+    /**
+     * Sets the budgets and the spill location. Results exceeding the new budgets are evicted.
+     *
+     * @param memory The number of bytes the results in memory may use
+     * @param spill The number of bytes the spilled results may use, zero disables spilling
+     * @param directory The directory receiving the spilled results, empty to disable spilling
+     * @param prefix Prefix of the spilled file names, which must be unique per cache sharing 'directory'
+     */
+    void SetBudget(size_t memory, size_t spill, std::filesystem::path const& directory, std::string const& prefix) {
+        if ((directory != this->spillDirectory) || (prefix != this->spillPrefix)) {
+            for (auto it = this->entries.begin(); it != this->entries.end();) {
+                auto next = std::next(it);
+                if (it->result == nullptr) {
+                    this->drop(it);
+                }
+                it = next;
+            }
+            this->spillDirectory = directory;
+            this->spillPrefix = prefix;
+        }
+        this->memoryBudget = memory;
+        this->spillBudget = directory.empty() ? 0 : spill;
+        this->trim();
+    }
+
+    /**
+     * Looks up a result and marks it as most recently used. Spilled results are read back and passed to 'relocate'
+     * together with a function mapping their previous data addresses to the reloaded memory.
+     *
+     * @param key The key of the result
+     * @param relocate Callable redirecting the data pointers of a 'C&' with a 'const void*(const void*)' function
+     *
+     * @return The result or nullptr if it is not cached
+     */
+    template<class F>
+    ResultPtr Find(Key const& key, F&& relocate) {
+        auto it = this->index.find(key);
+        if (it == this->index.end()) {
+            return nullptr;
+        }
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        Entry& e = this->entries.front();
+        if (e.result != nullptr) {
+            return e.result;
+        }
+        if (!this->reload(e, relocate)) {
+            this->drop(this->entries.begin());
+            return nullptr;
+        }
+        // the reloaded result may push others out of memory
+        ResultPtr result = e.result;
+        this->trim();
+        return result;
+    }
+
+    /**
+     * Adds a result as most recently used and evicts the least recently used ones exceeding the budgets
+     *
+     * @param key The key of the result
+     * @param result The result, which must not be modified anymore
+     */
+    void Insert(Key const& key, ResultPtr result) {
+        auto it = this->index.find(key);
+        if (it != this->index.end()) {
+            this->drop(it->second);
+        }
+        Entry e;
+        e.key = key;
+        e.size = result->Size();
+        e.result = std::move(result);
+        this->memoryUsed += e.size;
+        this->entries.push_front(std::move(e));
+        this->index[key] = this->entries.begin();
+        this->trim();
+    }
+
+private:
+    /** A cached result */
+    struct Entry {
+        /** The key of the result */
+        Key key;
+
+        /** The result, nullptr if it is spilled */
+        ResultPtr result;
+
+        /** The size of the storage of the result */
+        size_t size = 0;
+
+        /** The spilled result, whose pointers still hold the addresses of the spilled storage */
+        std::unique_ptr<C> spilledData;
+
+        /** The addresses and sizes of the spilled storage */
+        std::vector<std::pair<uintptr_t, size_t>> spilledBuffers;
+
+        /** The file holding the spilled storage */
+        std::filesystem::path spillFile;
+    };
+
+    /** Entry list iterator */
+    using EntryIter = typename std::list<Entry>::iterator;
+
+    /**
+     * Removes an entry including its spilled file
+     */
+    void drop(EntryIter it) {
+        if (it->result != nullptr) {
+            this->memoryUsed -= it->size;
+        } else {
+            this->spillUsed -= it->size;
+        }
+        this->removeSpillFile(*it);
+        this->index.erase(it->key);
+        this->entries.erase(it);
+    }
+
+    /**
+     * Evicts the least recently used results until the budgets are met. Results are spilled first if possible.
+     */
+    void trim(void) {
+        for (auto it = this->entries.end(); (this->memoryUsed > this->memoryBudget) && (it != this->entries.begin());) {
+            --it;
+            if (it->result == nullptr) {
+                continue;
+            }
+            auto next = std::next(it);
+            this->memoryUsed -= it->size;
+            if ((it->size <= this->spillBudget) && this->spill(*it)) {
+                this->spillUsed += it->size;
+            } else {
+                it->result.reset();
+                this->removeSpillFile(*it);
+                this->index.erase(it->key);
+                this->entries.erase(it);
+            }
+            it = next;
+        }
+        for (auto it = this->entries.end(); (this->spillUsed > this->spillBudget) && (it != this->entries.begin());) {
+            --it;
+            if (it->result != nullptr) {
+                continue;
+            }
+            auto next = std::next(it);
+            this->drop(it);
+            it = next;
+        }
+    }
+
+    /**
+     * Writes the storage of a result into a file and releases the result
+     *
+     * @return True on success
+     */
+    bool spill(Entry& e) {
+        e.spillFile = this->spillDirectory / (this->spillPrefix + "_" + std::to_string(this->spillCount++) + ".bin");
+        std::ofstream file(e.spillFile, std::ios::binary | std::ios::trunc);
+        e.spilledBuffers.clear();
+        for (auto const& s : e.result->storage) {
+            file.write(reinterpret_cast<const char*>(s.data()), static_cast<std::streamsize>(s.size()));
+            e.spilledBuffers.emplace_back(reinterpret_cast<uintptr_t>(s.data()), s.size());
+        }
+        if (!file) {
+            file.close();
+            this->removeSpillFile(e);
+            return false;
+        }
+        e.spilledData = std::make_unique<C>();
+        *e.spilledData = e.result->data;
+        e.result.reset();
+        return true;
+    }
+
+    /**
+     * Reads a spilled result back into memory
+     *
+     * @return True on success
+     */
+    template<class F>
+    bool reload(Entry& e, F&& relocate) {
+        std::ifstream file(e.spillFile, std::ios::binary);
+        auto result = std::make_shared<DetachedResult<C>>();
+        for (auto const& b : e.spilledBuffers) {
+            result->storage.emplace_back(b.second);
+            file.read(reinterpret_cast<char*>(result->storage.back().data()), static_cast<std::streamsize>(b.second));
+        }
+        if (!file) {
+            return false;
+        }
+        result->data = *e.spilledData;
+        relocate(result->data, [&e, &result](const void* ptr) -> const void* {
+            const auto addr = reinterpret_cast<uintptr_t>(ptr);
+            for (size_t i = 0; i < e.spilledBuffers.size(); ++i) {
+                if ((addr >= e.spilledBuffers[i].first) &&
+                    (addr < e.spilledBuffers[i].first + e.spilledBuffers[i].second)) {
+                    return result->storage[i].data() + (addr - e.spilledBuffers[i].first);
+                }
+            }
+            return ptr;
+        });
+        this->removeSpillFile(e);
+        this->spillUsed -= e.size;
+        this->memoryUsed += e.size;
+        e.result = std::move(result);
+        return true;
+    }
+
+    /**
+     * Deletes the spilled file of an entry, if any
+     */
+    void removeSpillFile(Entry& e) {
+        if (!e.spillFile.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(e.spillFile, ec);
+            e.spillFile.clear();
+        }
+        e.spilledData.reset();
+        e.spilledBuffers.clear();
+    }
+
+    /** The results, most recently used first */
+    std::list<Entry> entries;
+
+    /** The entries by key */
+    std::map<Key, EntryIter> index;
+
+    /** The number of bytes the results in memory may use */
+    size_t memoryBudget;
+
+    /** The number of bytes the spilled results may use */
+    size_t spillBudget;
+
+    /** The number of bytes used by the results in memory */
+    size_t memoryUsed;
+
+    /** The number of bytes used by the spilled results */
+    size_t spillUsed;
+
+    /** The directory receiving the spilled results */
+    std::filesystem::path spillDirectory;
+
+    /** The prefix of the spilled file names */
+    std::string spillPrefix;
+
+    /** The number of spilled files written so far, used for unique names */
+    unsigned int spillCount;
+};
+
+} /* end namespace datatools */
+} /* end namespace megamol */
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "datatools/PointcloudHelpers.h"
+#include "datatools/clustering/DBSCAN.h"
+
+namespace megamol::datatools::clustering {
+
+namespace grid_dbscan_detail {
+
+/**
+ * Concurrent union-find over indices. Roots are always linked below smaller roots, so the representative of a set is
+ * its smallest element.
+ */
+class union_find {
+public:
+    explicit union_find(index_t size) : _parent(size) {
+        for (index_t i = 0; i < size; ++i) {
+            _parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    index_t find(index_t x) {
+        while (true) {
+            auto p = _parent[x].load(std::memory_order_relaxed);
+            if (p == x)
+                return x;
+            auto const gp = _parent[p].load(std::memory_order_relaxed);
+            if (p != gp) {
+                // path halving, losing the race is harmless
+                _parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            }
+            x = gp;
+        }
+    }
+
+    void unite(index_t a, index_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (a < b)
+                std::swap(a, b);
+            auto expected = a;
+            if (_parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+                return;
+        }
+    }
+
+private:
+    std::vector<std::atomic<index_t>> _parent;
+};
+
+} // namespace grid_dbscan_detail
+
+/**
+ * Parallel DBSCAN on a uniform grid.
+ *
+ * The point cloud is binned into cells with a diagonal of at most sqrt(eps), so all points of a cell are neighbors of
+ * each other. Core points are marked per cell, core points of neighboring cells are merged with a concurrent
+ * union-find and border points join the smallest adjacent cluster. Cluster ids are assigned in the order of the
+ * smallest core point index of each cluster, which reproduces the labels of DBSCAN(). Like the
+ * nanoflann::L2_Simple_Adaptor of kd_tree_t, distances are squared euclidean and ignore the weights of the point cloud.
+ *
+ * @param data The point cloud
+ * @param eps Squared neighborhood radius, as for DBSCAN()
+ * @param minPts Minimal number of points (including the point itself) in the neighborhood of a core point
+ *
+ * @return Cluster id per point, cluster_type::NOISE for noise
+ */
+template<typename T, int DIM>
+inline cluster_result_t DBSCAN_grid(genericPointcloud<T, DIM> const& data, T eps, index_t minPts) {
+    using cell_key_t = uint64_t;
+    // keeps the number of cells below 2^64
+    constexpr int64_t max_cells_per_dim = (int64_t(1) << (64 / DIM)) - 1;
+    constexpr auto no_cell = std::numeric_limits<uint32_t>::max();
+
+    auto const num_points = data.kdtree_get_point_count();
+    cluster_result_t clusters(num_points, static_cast<cluster_type_ut>(cluster_type::NOISE));
+    if (num_points == 0 || eps <= static_cast<T>(0))
+        return clusters;
+
+    // grid geometry
+    std::array<double, DIM> mins;
+    std::array<double, DIM> maxs;
+    for (int d = 0; d < DIM; ++d) {
+        mins[d] = std::numeric_limits<double>::max();
+        maxs[d] = std::numeric_limits<double>::lowest();
+    }
+    for (index_t idx = 0; idx < num_points; ++idx) {
+        auto const pos = data.get_position(idx);
+        for (int d = 0; d < DIM; ++d) {
+            auto const val = static_cast<double>(pos[d]);
+            mins[d] = std::min(mins[d], val);
+            maxs[d] = std::max(maxs[d], val);
+        }
+    }
+
+    auto const radius = std::sqrt(static_cast<double>(eps));
+    auto const base_side = radius / std::sqrt(static_cast<double>(DIM));
+    std::array<double, DIM> side;
+    std::array<int64_t, DIM> extents;
+    std::array<int64_t, DIM> reach;
+    std::array<cell_key_t, DIM> strides;
+    cell_key_t total_cells = 1;
+    double diagonal_sq = 0.0;
+    for (int d = DIM - 1; d >= 0; --d) {
+        // coarsen the grid if the cell keys would overflow
+        auto const range = maxs[d] - mins[d];
+        side[d] = std::max(base_side, range / static_cast<double>(max_cells_per_dim - 1));
+        extents[d] = std::min(static_cast<int64_t>(range / side[d]) + 1, max_cells_per_dim);
+        reach[d] = std::min(static_cast<int64_t>(radius / side[d]) + 1, extents[d] - 1);
+        strides[d] = total_cells;
+        total_cells *= static_cast<cell_key_t>(extents[d]);
+        diagonal_sq += side[d] * side[d];
+    }
+    bool const cells_are_cliques = diagonal_sq <= static_cast<double>(eps);
+
+    // offsets of all cells that can contain neighbors of a point in the center cell, closest first
+    std::vector<std::pair<double, std::array<int64_t, DIM>>> sorted_offsets;
+    {
+        std::array<int64_t, DIM> off;
+        for (int d = 0; d < DIM; ++d) {
+            off[d] = -reach[d];
+        }
+        while (true) {
+            double min_dist_sq = 0.0;
+            for (int d = 0; d < DIM; ++d) {
+                auto const gap = static_cast<double>(std::max<int64_t>(std::abs(off[d]) - 1, 0)) * side[d];
+                min_dist_sq += gap * gap;
+            }
+            if (min_dist_sq < static_cast<double>(eps)) {
+                sorted_offsets.emplace_back(min_dist_sq, off);
+            }
+            int d = 0;
+            for (; d < DIM; ++d) {
+                if (++off[d] <= reach[d])
+                    break;
+                off[d] = -reach[d];
+            }
+            if (d == DIM)
+                break;
+        }
+        std::stable_sort(sorted_offsets.begin(), sorted_offsets.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+    }
+    std::vector<std::array<int64_t, DIM>> offsets(sorted_offsets.size());
+    std::transform(sorted_offsets.cbegin(), sorted_offsets.cend(), offsets.begin(),
+        [](auto const& el) { return el.second; });
+
+    auto const cell_coords = [&](index_t idx) {
+        std::array<int64_t, DIM> coords;
+        auto const pos = data.get_position(idx);
+        for (int d = 0; d < DIM; ++d) {
+            auto const c = static_cast<int64_t>((static_cast<double>(pos[d]) - mins[d]) / side[d]);
+            coords[d] = std::clamp<int64_t>(c, 0, extents[d] - 1);
+        }
+        return coords;
+    };
+    auto const make_key = [&strides](std::array<int64_t, DIM> const& coords) {
+        cell_key_t key = 0;
+        for (int d = 0; d < DIM; ++d) {
+            key += static_cast<cell_key_t>(coords[d]) * strides[d];
+        }
+        return key;
+    };
+
+    // bin points into cells, points of a cell are contiguous in 'order'
+    std::vector<std::pair<cell_key_t, index_t>> keyed(num_points);
+#pragma omp parallel for
+    for (int64_t idx = 0; idx < static_cast<int64_t>(num_points); ++idx) {
+        keyed[idx] = std::make_pair(make_key(cell_coords(idx)), static_cast<index_t>(idx));
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<index_t> order(num_points);
+    std::vector<index_t> cell_begin;
+    for (index_t i = 0; i < num_points; ++i) {
+        order[i] = keyed[i].second;
+        if (i == 0 || keyed[i].first != keyed[i - 1].first) {
+            cell_begin.push_back(i);
+        }
+    }
+    auto const num_cells = cell_begin.size();
+    cell_begin.push_back(num_points);
+
+    // cell lookup, a dense table if the grid is not much larger than the data, a hash map otherwise
+    bool const dense_lut = total_cells <= 4 * static_cast<cell_key_t>(num_points) && num_cells < no_cell;
+    std::vector<uint32_t> dense_cells;
+    std::unordered_map<cell_key_t, index_t> sparse_cells;
+    if (dense_lut) {
+        dense_cells.resize(total_cells, no_cell);
+        for (index_t cell = 0; cell < num_cells; ++cell) {
+            dense_cells[keyed[cell_begin[cell]].first] = static_cast<uint32_t>(cell);
+        }
+    } else {
+        sparse_cells.reserve(num_cells);
+        for (index_t cell = 0; cell < num_cells; ++cell) {
+            sparse_cells.emplace(keyed[cell_begin[cell]].first, cell);
+        }
+    }
+    keyed.clear();
+    keyed.shrink_to_fit();
+
+    // cells in front of the center cell have a larger index, as cells are sorted by key
+    std::vector<int64_t> key_deltas(offsets.size());
+    for (std::size_t o = 0; o < offsets.size(); ++o) {
+        key_deltas[o] = 0;
+        for (int d = 0; d < DIM; ++d) {
+            key_deltas[o] += offsets[o][d] * static_cast<int64_t>(strides[d]);
+        }
+    }
+
+    // answers the cell at offset 'o' from 'center' or 'num_cells' if it is empty
+    auto const lookup_cell = [&](std::array<int64_t, DIM> const& center, bool interior, std::size_t o) -> index_t {
+        if (!interior) {
+            for (int d = 0; d < DIM; ++d) {
+                auto const c = center[d] + offsets[o][d];
+                if (c < 0 || c >= extents[d])
+                    return num_cells;
+            }
+        }
+        auto const key = static_cast<cell_key_t>(static_cast<int64_t>(make_key(center)) + key_deltas[o]);
+        if (dense_lut) {
+            auto const n = dense_cells[key];
+            return n != no_cell ? n : num_cells;
+        }
+        auto const it = sparse_cells.find(key);
+        return it != sparse_cells.end() ? it->second : num_cells;
+    };
+    auto const is_interior = [&](std::array<int64_t, DIM> const& center) {
+        for (int d = 0; d < DIM; ++d) {
+            if (center[d] < reach[d] || center[d] >= extents[d] - reach[d])
+                return false;
+        }
+        return true;
+    };
+    auto const neighbor_cells = [&](index_t cell, std::vector<index_t>& neighbors, bool forward_only) {
+        neighbors.clear();
+        auto const center = cell_coords(order[cell_begin[cell]]);
+        auto const interior = is_interior(center);
+        for (std::size_t o = 0; o < offsets.size(); ++o) {
+            if (forward_only && key_deltas[o] <= 0)
+                continue;
+            auto const n = lookup_cell(center, interior, o);
+            if (n != num_cells) {
+                neighbors.push_back(n);
+            }
+        }
+    };
+    // evaluated as nanoflann::L2_Simple_Adaptor does, so the radius test matches the one of the k-d tree exactly
+    auto const is_neighbor = [&data, eps](index_t a, index_t b) {
+        auto const pa = data.get_position(a);
+        auto const pb = data.get_position(b);
+        T dist = 0;
+        for (int d = 0; d < DIM; ++d) {
+            T const diff = pa[d] - pb[d];
+            dist += diff * diff;
+        }
+        return dist < eps;
+    };
+
+    // mark core points, all per-point state below is indexed by position in 'order' for locality
+    std::vector<char> core(num_points, 0);
+#pragma omp parallel
+    {
+        std::vector<index_t> neighbors;
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t cell = 0; cell < static_cast<int64_t>(num_cells); ++cell) {
+            auto const begin = cell_begin[cell];
+            auto const end = cell_begin[cell + 1];
+            if (cells_are_cliques && end - begin >= minPts) {
+                std::fill(core.begin() + begin, core.begin() + end, 1);
+                continue;
+            }
+            // most points are identified as core early, so neighbor cells are looked up on demand
+            auto const center = cell_coords(order[begin]);
+            auto const interior = is_interior(center);
+            std::size_t resolved = 0;
+            neighbors.clear();
+            for (auto i = begin; i < end; ++i) {
+                auto const p = order[i];
+                index_t count = 0;
+                for (std::size_t k = 0; count < minPts; ++k) {
+                    while (k >= neighbors.size() && resolved < offsets.size()) {
+                        auto const n = lookup_cell(center, interior, resolved++);
+                        if (n != num_cells) {
+                            neighbors.push_back(n);
+                        }
+                    }
+                    if (k >= neighbors.size())
+                        break;
+                    for (auto j = cell_begin[neighbors[k]]; j < cell_begin[neighbors[k] + 1] && count < minPts; ++j) {
+                        if (is_neighbor(p, order[j])) {
+                            ++count;
+                        }
+                    }
+                }
+                core[i] = count >= minPts ? 1 : 0;
+            }
+        }
+    }
+
+    // first core point per cell
+    std::vector<index_t> cell_core(num_cells, num_points);
+#pragma omp parallel for
+    for (int64_t cell = 0; cell < static_cast<int64_t>(num_cells); ++cell) {
+        for (auto i = cell_begin[cell]; i < cell_begin[cell + 1]; ++i) {
+            if (core[i] != 0) {
+                cell_core[cell] = i;
+                break;
+            }
+        }
+    }
+
+    // merge core points of neighboring cells
+    grid_dbscan_detail::union_find components(num_points);
+#pragma omp parallel
+    {
+        std::vector<index_t> neighbors;
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t cell = 0; cell < static_cast<int64_t>(num_cells); ++cell) {
+            auto const end = cell_begin[cell + 1];
+            auto const first_core = cell_core[cell];
+            if (first_core == num_points)
+                continue;
+            neighbor_cells(cell, neighbors, true);
+
+            if (cells_are_cliques) {
+                for (auto i = first_core + 1; i < end; ++i) {
+                    if (core[i] != 0) {
+                        components.unite(first_core, i);
+                    }
+                }
+                // one edge per pair of cells suffices
+                for (auto const n : neighbors) {
+                    if (cell_core[n] == num_points || components.find(first_core) == components.find(cell_core[n]))
+                        continue;
+                    bool linked = false;
+                    for (auto i = first_core; i < end && !linked; ++i) {
+                        if (core[i] == 0)
+                            continue;
+                        for (auto j = cell_core[n]; j < cell_begin[n + 1]; ++j) {
+                            if (core[j] != 0 && is_neighbor(order[i], order[j])) {
+                                components.unite(i, j);
+                                linked = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            } else {
+                for (auto i = first_core; i < end; ++i) {
+                    if (core[i] == 0)
+                        continue;
+                    for (auto j = i + 1; j < end; ++j) {
+                        if (core[j] != 0 && is_neighbor(order[i], order[j])) {
+                            components.unite(i, j);
+                        }
+                    }
+                    for (auto const n : neighbors) {
+                        for (auto j = cell_core[n]; j < cell_begin[n + 1]; ++j) {
+                            if (core[j] != 0 && is_neighbor(order[i], order[j])) {
+                                components.unite(i, j);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // number the clusters in the order of their smallest core point
+    std::vector<index_t> position(num_points);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(num_points); ++i) {
+        position[order[i]] = i;
+    }
+    std::vector<index_t> labels(num_points, static_cast<cluster_type_ut>(cluster_type::NOISE));
+    index_t cluster_idx = static_cast<cluster_type_ut>(cluster_type::NOISE);
+    for (index_t idx = 0; idx < num_points; ++idx) {
+        auto const i = position[idx];
+        if (core[i] == 0)
+            continue;
+        auto const root = components.find(i);
+        if (labels[root] == static_cast<cluster_type_ut>(cluster_type::NOISE)) {
+            labels[root] = ++cluster_idx;
+        }
+        labels[i] = labels[root];
+    }
+
+    // border points join the adjacent cluster with the smallest id
+#pragma omp parallel
+    {
+        std::vector<index_t> neighbors;
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t cell = 0; cell < static_cast<int64_t>(num_cells); ++cell) {
+            auto const begin = cell_begin[cell];
+            auto const end = cell_begin[cell + 1];
+            neighbors.clear();
+            for (auto i = begin; i < end; ++i) {
+                if (core[i] != 0)
+                    continue;
+                if (neighbors.empty()) {
+                    neighbor_cells(cell, neighbors, false);
+                }
+                auto label = std::numeric_limits<index_t>::max();
+                for (auto const n : neighbors) {
+                    if (cell_core[n] == num_points)
+                        continue;
+                    for (auto j = cell_core[n]; j < cell_begin[n + 1]; ++j) {
+                        if (core[j] != 0 && labels[j] < label && is_neighbor(order[i], order[j])) {
+                            label = labels[j];
+                        }
+                    }
+                }
+                if (label != std::numeric_limits<index_t>::max()) {
+                    labels[i] = label;
+                }
+            }
+        }
+    }
+
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(num_points); ++i) {
+        clusters[order[i]] = labels[i];
+    }
+
+    return clusters;
+}
+
+} // namespace megamol::datatools::clustering
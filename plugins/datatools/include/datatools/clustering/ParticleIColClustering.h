@@ -5,6 +5,7 @@
 #include "datatools/AbstractParticleManipulator.h"
 
 #include "datatools/clustering/DBSCAN.h"
+#include "datatools/clustering/GridDBSCAN.h"
 
 namespace megamol::datatools::clustering {
 class ParticleIColClustering : public AbstractParticleManipulator {
@@ -29,22 +30,30 @@ protected:
     bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
 
 private:
+    enum class algorithm : int { GRID = 0, KD_TREE = 1, VERIFY = 2 };
+
     bool isDirty() {
-        return _eps_slot.IsDirty() || _minpts_slot.IsDirty() || _icol_weight.IsDirty();
+        return _eps_slot.IsDirty() || _minpts_slot.IsDirty() || _icol_weight.IsDirty() || _algorithm_slot.IsDirty();
     }
 
     void resetDirty() {
         _eps_slot.ResetDirty();
         _minpts_slot.ResetDirty();
         _icol_weight.ResetDirty();
+        _algorithm_slot.ResetDirty();
     }
 
+    /** Answers the k-d tree of a particle list, which is built on demand */
+    std::shared_ptr<kd_tree_t<float, 4>> getKDTree(std::size_t pl_idx);
+
     core::param::ParamSlot _eps_slot;
 
     core::param::ParamSlot _minpts_slot;
 
     core::param::ParamSlot _icol_weight;
 
+    core::param::ParamSlot _algorithm_slot;
+
     std::vector<std::shared_ptr<genericPointcloud<float, 4>>> _points;
 
     std::vector<std::shared_ptr<kd_tree_t<float, 4>>> _kd_trees;
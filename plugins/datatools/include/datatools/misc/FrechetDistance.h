@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <vector>
 
 // http://www.kr.tuwien.ac.at/staff/eiter/et-archive/cdtr9464.pdf
@@ -87,6 +89,18 @@ inline T frechet_distance(std::size_t sample_count, std::function<T(std::size_t,
     return ca[sample_count * sample_count - 1];
 }
 
+/**
+ * Lower bound of the discrete Frechet distance of two sequences, as every coupling contains both pairs of end points.
+ *
+ * @param rows The number of samples of the first sequence
+ * @param cols The number of samples of the second sequence
+ * @param dist Distance between sample 'i' of the first and sample 'j' of the second sequence
+ */
+template<typename T, typename D>
+inline T frechet_lower_bound(std::size_t rows, std::size_t cols, D const& dist) {
+    return std::max<T>(dist(0, 0), dist(rows - 1, cols - 1));
+}
+
 template<typename T>
 inline T frechet_distance_2(std::size_t sample_count, std::function<T(std::size_t, std::size_t)> const& dist) {
     auto const total_size = sample_count * sample_count;
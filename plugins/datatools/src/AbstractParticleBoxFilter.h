@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <type_traits>
 
@@ -49,6 +50,13 @@ protected:
      */
     bool manipulateData(T& outData, T& inData) override;
 
+    /**
+     * Requests only the particles within the box from the data source
+     *
+     * @param inData The call requesting the original data
+     */
+    void prepareRequest(T& inData) override;
+
 private:
     static vislib::math::Cuboid<float> getBoxFromString(vislib::TString const& str) {
         if (!str.Contains(',')) {
@@ -110,9 +118,36 @@ AbstractParticleBoxFilter<T>::~AbstractParticleBoxFilter() {
 }
 
 
+template<class T>
+void AbstractParticleBoxFilter<T>::prepareRequest(T& inData) {
+    auto const hasRoi = inData.HasRegionOfInterest();
+    auto const roi = inData.GetRegionOfInterest();
+    AbstractManipulator<T>::prepareRequest(inData);
+
+    // the filter only removes particles, so it needs no particles outside of its box
+    auto box = getBoxFromString(boxSlot_.Param<core::param::StringParam>()->Value().c_str());
+    box.EnforcePositiveSize();
+    if (hasRoi) {
+        // only the intersection with the region requested downstream is needed
+        box.Set(std::max(box.Left(), roi.Left()), std::max(box.Bottom(), roi.Bottom()),
+            std::max(box.Back(), roi.Back()), std::min(box.Right(), roi.Right()), std::min(box.Top(), roi.Top()),
+            std::min(box.Front(), roi.Front()));
+    }
+    inData.SetRegionOfInterest(box);
+}
+
+
 template<class T>
 bool AbstractParticleBoxFilter<T>::manipulateData(T& outData, T& inData) {
+    // the region of interest belongs to the request of the caller and is kept
+    auto const hasRoi = outData.HasRegionOfInterest();
+    auto const roi = outData.GetRegionOfInterest();
     outData = inData;
+    if (hasRoi) {
+        outData.SetRegionOfInterest(roi);
+    } else {
+        outData.ClearRegionOfInterest();
+    }
 
     inData.SetUnlocker(nullptr, false); // keep original data locked
                                         // original data will be unlocked through outData
@@ -0,0 +1,109 @@
+/*
+ * AbstractParticleManipulator.cpp
+ *
+ * Copyright (C) 2019 MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+#include "datatools/AbstractParticleManipulator.h"
+
+#include <algorithm>
+
+using namespace megamol;
+
+
+/*
+ * datatools::AbstractManipulator<geocalls::MultiParticleDataCall>::detachData
+ */
+template<>
+bool datatools::AbstractManipulator<geocalls::MultiParticleDataCall>::detachData(
+    geocalls::MultiParticleDataCall& data, std::vector<std::vector<uint8_t>>& storage) {
+    using geocalls::SimpleSphericalParticles;
+
+    struct Range {
+        const uint8_t* begin;
+        const uint8_t* end;
+        const uint8_t* copy;
+    };
+
+    // the memory of all attributes, with overlapping ranges like interleaved attributes sharing one copy
+    std::vector<Range> merged;
+    for (unsigned int i = 0; i < data.GetParticleListCount(); ++i) {
+        auto& parts = data.AccessParticles(i);
+        if (parts.IsVAO()) {
+            return false;
+        }
+        const uint64_t cnt = parts.GetCount();
+        auto add = [cnt, &merged](const void* ptr, unsigned int stride, unsigned int size) {
+            auto begin = static_cast<const uint8_t*>(ptr);
+            if ((begin != nullptr) && (cnt > 0) && (size > 0)) {
+                merged.push_back(Range{begin, begin + (cnt - 1) * (stride == 0 ? size : stride) + size, nullptr});
+            }
+        };
+        add(parts.GetVertexData(), parts.GetVertexDataStride(),
+            SimpleSphericalParticles::VertexDataSize[parts.GetVertexDataType()]);
+        add(parts.GetColourData(), parts.GetColourDataStride(),
+            SimpleSphericalParticles::ColorDataSize[parts.GetColourDataType()]);
+        add(parts.GetDirData(), parts.GetDirDataStride(),
+            SimpleSphericalParticles::DirDataSize[parts.GetDirDataType()]);
+        add(parts.GetIDData(), parts.GetIDDataStride(), SimpleSphericalParticles::IDDataSize[parts.GetIDDataType()]);
+    }
+
+    std::sort(merged.begin(), merged.end(), [](Range const& l, Range const& r) { return l.begin < r.begin; });
+    size_t last = 0;
+    for (size_t m = 1; m < merged.size(); ++m) {
+        if (merged[m].begin < merged[last].end) {
+            merged[last].end = std::max(merged[last].end, merged[m].end);
+        } else {
+            merged[++last] = merged[m];
+        }
+    }
+    merged.resize(merged.empty() ? 0 : last + 1);
+
+    storage.clear();
+    storage.reserve(merged.size());
+    for (auto& m : merged) {
+        storage.emplace_back(m.begin, m.end);
+        m.copy = storage.back().data();
+    }
+
+    this->relocateData(data, [&merged](const void* ptr) -> const void* {
+        auto p = static_cast<const uint8_t*>(ptr);
+        for (auto const& m : merged) {
+            if ((p >= m.begin) && (p < m.end)) {
+                return m.copy + (p - m.begin);
+            }
+        }
+        return ptr;
+    });
+
+    return true;
+}
+
+
+/*
+ * datatools::AbstractManipulator<geocalls::MultiParticleDataCall>::relocateData
+ */
+template<>
+void datatools::AbstractManipulator<geocalls::MultiParticleDataCall>::relocateData(
+    geocalls::MultiParticleDataCall& data, std::function<const void*(const void*)> const& relocate) {
+    using geocalls::SimpleSphericalParticles;
+
+    for (unsigned int i = 0; i < data.GetParticleListCount(); ++i) {
+        // a fresh list object, because copies of a list share its particle store
+        SimpleSphericalParticles src = data.AccessParticles(i);
+        auto& dst = data.AccessParticles(i);
+        dst = SimpleSphericalParticles();
+        dst.SetCount(src.GetCount());
+        auto const col = src.GetGlobalColour();
+        dst.SetGlobalColour(col[0], col[1], col[2], col[3]);
+        dst.SetGlobalRadius(src.GetGlobalRadius());
+        dst.SetGlobalType(src.GetGlobalType());
+        dst.SetColourMapIndexValues(src.GetMinColourIndexValue(), src.GetMaxColourIndexValue());
+        dst.SetBBox(src.GetBBox());
+        dst.SetClusterInfos(src.GetClusterInfos());
+        dst.SetVertexData(src.GetVertexDataType(), relocate(src.GetVertexData()), src.GetVertexDataStride());
+        dst.SetColourData(src.GetColourDataType(), relocate(src.GetColourData()), src.GetColourDataStride());
+        dst.SetDirData(src.GetDirDataType(), relocate(src.GetDirData()), src.GetDirDataStride());
+        dst.SetIDData(src.GetIDDataType(), relocate(src.GetIDData()), src.GetIDDataStride());
+    }
+}
@@ -17,6 +17,11 @@
 #include "vislib/String.h"
 #include "vislib/sys/File.h"
 
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <vector>
+
 using namespace megamol;
 
 
@@ -35,6 +40,9 @@ datatools::DataFileSequence::DataFileSequence(void)
         , fileNumberStepSlot("fileNumberStep", "Slot for the file number increase step")
         , fileNameSlotNameSlot("fileNameSlotName", "The name of the data source file name parameter slot")
         , useClipBoxAsBBox("useClipBoxAsBBox", "If true will use the all-data clip box as bounding box")
+        , prefetchCountSlot("prefetchCount",
+              "The number of files following the current one in stepping direction which are read ahead in the "
+              "background, 0 to disable")
         , outDataSlot("outData", "The slot for publishing data to the writer")
         , inDataSlot("inData", "The slot for requesting data from the source")
         , clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
@@ -45,7 +53,10 @@ datatools::DataFileSequence::DataFileSequence(void)
         , fileNumStep(1)
         , needDataUpdate(true)
         , frameCnt(1)
-        , lastIdxRequested(0) {
+        , lastIdxRequested(0)
+        , prefetchFrame(UINT_MAX)
+        , prefetchedCapacity(0)
+        , prefetchStop(false) {
 
     this->fileNameTemplateSlot << new core::param::StringParam(this->fileNameTemplate.PeekBuffer());
     this->fileNameTemplateSlot.SetUpdateCallback(&DataFileSequence::onFileNameTemplateChanged);
@@ -67,6 +78,9 @@ datatools::DataFileSequence::DataFileSequence(void)
     this->useClipBoxAsBBox << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->useClipBoxAsBBox);
 
+    this->prefetchCountSlot << new core::param::IntParam(2, 0);
+    this->MakeSlotAvailable(&this->prefetchCountSlot);
+
     //core::CallDescriptionManager::DescriptionIterator iter(core::CallDescriptionManager::Instance()->GetIterator());
     //const core::CallDescription *cd = NULL;
     //while ((cd = this->moveToNextCompatibleCall(iter)) != NULL) {
@@ -107,7 +121,9 @@ bool datatools::DataFileSequence::create(void) {
 /*
  * moldyn::DataFileSequence::release
  */
-void datatools::DataFileSequence::release(void) {}
+void datatools::DataFileSequence::release(void) {
+    this->stopPrefetching();
+}
 
 
 /*
@@ -172,6 +188,8 @@ bool datatools::DataFileSequence::getDataCallback(core::Call& caller) {
 
         pgdc->SetFrameID(frameID, true);
         pgdc->SetDataHash(this->datahash);
+
+        this->prefetch(frameID);
     }
 
     return true;
@@ -512,6 +530,7 @@ void datatools::DataFileSequence::assertData(void) {
         return;
     vislib::TString filename;
     this->needDataUpdate = false;
+    this->stopPrefetching();
 
     this->frameCnt = 0;
     this->clipbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
@@ -580,3 +599,106 @@ void datatools::DataFileSequence::assertData(void) {
 
     this->datahash++;
 }
+
+
+/*
+ * datatools::DataFileSequence::framePath
+ */
+std::filesystem::path datatools::DataFileSequence::framePath(unsigned int frameID) const {
+    vislib::TString filename;
+    filename.Format(this->fileNameTemplate, this->fileNumMin + this->fileNumStep * frameID);
+    return std::filesystem::path(filename.PeekBuffer());
+}
+
+
+/*
+ * datatools::DataFileSequence::prefetch
+ */
+void datatools::DataFileSequence::prefetch(unsigned int frameID) {
+    if (frameID == this->prefetchFrame) {
+        return;
+    }
+    const unsigned int count = static_cast<unsigned int>(
+        vislib::math::Max(0, this->prefetchCountSlot.Param<core::param::IntParam>()->Value()));
+    const bool forward = (this->prefetchFrame == UINT_MAX) || (frameID > this->prefetchFrame);
+    this->prefetchFrame = frameID;
+
+    std::unique_lock<std::mutex> lock(this->prefetchLock);
+    // the current file has just been read by the source, the files of the previous steps are kept for going back
+    this->prefetchedCapacity = 2 * static_cast<size_t>(count) + 1;
+    const auto current = this->framePath(frameID);
+    this->prefetched.remove(current);
+    this->prefetched.push_front(current);
+    while (this->prefetched.size() > this->prefetchedCapacity) {
+        this->prefetched.pop_back();
+    }
+
+    // files queued for a previous step are dropped, as stepping has moved on
+    this->prefetchQueue.clear();
+    for (unsigned int i = 1; i <= count; ++i) {
+        if (forward ? (frameID + i >= this->frameCnt) : (i > frameID)) {
+            break;
+        }
+        auto path = this->framePath(forward ? frameID + i : frameID - i);
+        if (std::find(this->prefetched.begin(), this->prefetched.end(), path) == this->prefetched.end()) {
+            this->prefetchQueue.push_back(std::move(path));
+        }
+    }
+    if (this->prefetchQueue.empty()) {
+        return;
+    }
+    if (!this->prefetchThread.joinable()) {
+        this->prefetchStop = false;
+        this->prefetchThread = std::thread(&DataFileSequence::prefetchFiles, this);
+    }
+    lock.unlock();
+    this->prefetchSignal.notify_one();
+}
+
+
+/*
+ * datatools::DataFileSequence::stopPrefetching
+ */
+void datatools::DataFileSequence::stopPrefetching(void) {
+    if (this->prefetchThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->prefetchLock);
+            this->prefetchStop = true;
+        }
+        this->prefetchSignal.notify_one();
+        this->prefetchThread.join();
+    }
+    this->prefetchQueue.clear();
+    this->prefetched.clear();
+    this->prefetchFrame = UINT_MAX;
+}
+
+
+/*
+ * datatools::DataFileSequence::prefetchFiles
+ */
+void datatools::DataFileSequence::prefetchFiles(void) {
+    // reading the files once places them in the file system cache, from which the source then parses them
+    std::vector<char> buffer(1 << 20);
+    std::unique_lock<std::mutex> lock(this->prefetchLock);
+    while (true) {
+        this->prefetchSignal.wait(lock, [this]() { return this->prefetchStop || !this->prefetchQueue.empty(); });
+        if (this->prefetchStop) {
+            return;
+        }
+        std::filesystem::path path = std::move(this->prefetchQueue.front());
+        this->prefetchQueue.pop_front();
+        lock.unlock();
+
+        std::ifstream file(path, std::ios::binary);
+        while (!this->prefetchStop && file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {}
+
+        lock.lock();
+        if (std::find(this->prefetched.begin(), this->prefetched.end(), path) == this->prefetched.end()) {
+            this->prefetched.push_front(std::move(path));
+            while (this->prefetched.size() > this->prefetchedCapacity) {
+                this->prefetched.pop_back();
+            }
+        }
+    }
+}
@@ -6,6 +6,14 @@
  */
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <thread>
+
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
@@ -154,6 +162,34 @@ private:
      */
     void assertData(void);
 
+    /**
+     * Answer the path of the file of a frame
+     *
+     * @param frameID The frame
+     *
+     * @return The path of the file
+     */
+    std::filesystem::path framePath(unsigned int frameID) const;
+
+    /**
+     * Queues the files following a frame in the stepping direction for
+     * being read ahead into the file system cache. Files read recently are
+     * skipped.
+     *
+     * @param frameID The frame that has just been loaded
+     */
+    void prefetch(unsigned int frameID);
+
+    /**
+     * Stops the prefetching thread and forgets all prefetched files
+     */
+    void stopPrefetching(void);
+
+    /**
+     * Body of the prefetching thread
+     */
+    void prefetchFiles(void);
+
     /** The file name template */
     core::param::ParamSlot fileNameTemplateSlot;
 
@@ -172,6 +208,9 @@ private:
     /** Flag controlling the bounding box */
     core::param::ParamSlot useClipBoxAsBBox;
 
+    /** The number of files read ahead in the background */
+    core::param::ParamSlot prefetchCountSlot;
+
     /** The slot for publishing data to the writer */
     core::CalleeSlot outDataSlot;
 
@@ -204,6 +243,30 @@ private:
 
     /** The last frame index requested */
     unsigned int lastIdxRequested;
+
+    /** The frame the files have last been prefetched for, UINT_MAX if none */
+    unsigned int prefetchFrame;
+
+    /** The thread reading files ahead */
+    std::thread prefetchThread;
+
+    /** Guards the prefetching queue and the list of prefetched files */
+    std::mutex prefetchLock;
+
+    /** Wakes the prefetching thread */
+    std::condition_variable prefetchSignal;
+
+    /** The files to be read ahead */
+    std::deque<std::filesystem::path> prefetchQueue;
+
+    /** The files read recently, most recent first */
+    std::list<std::filesystem::path> prefetched;
+
+    /** The number of files kept in 'prefetched' */
+    size_t prefetchedCapacity;
+
+    /** Asks the prefetching thread to terminate */
+    std::atomic<bool> prefetchStop;
 };
 
 } /* end namespace datatools */
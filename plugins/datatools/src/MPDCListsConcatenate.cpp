@@ -8,6 +8,7 @@
 #include "MPDCListsConcatenate.h"
 
 #include "geometry_calls/MultiParticleDataCall.h"
+#include "mmcore/ParallelCalls.h"
 
 
 megamol::datatools::MPDCListsConcatenate::MPDCListsConcatenate()
@@ -16,6 +17,8 @@ megamol::datatools::MPDCListsConcatenate::MPDCListsConcatenate()
         , dataIn2Slot("in2", "Second data source") {
     dataOutSlot.SetCallback("MultiParticleDataCall", "GetData", &MPDCListsConcatenate::getData);
     dataOutSlot.SetCallback("MultiParticleDataCall", "GetExtent", &MPDCListsConcatenate::getExtent);
+    dataOutSlot.SetCallbackConcurrencySafe("MultiParticleDataCall", "GetData");
+    dataOutSlot.SetCallbackConcurrencySafe("MultiParticleDataCall", "GetExtent");
     MakeSlotAvailable(&dataOutSlot);
 
     dataIn1Slot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
@@ -68,9 +71,7 @@ bool megamol::datatools::MPDCListsConcatenate::getExtent(megamol::core::Call& c)
     }
 
     // both calls are connected, so be smart!
-    if (!((*i1c)(1)))
-        return false;
-    if (!((*i2c)(1)))
+    if (!core::ParallelCalls().Add(i1c, 1).Add(i2c, 1)())
         return false;
 
     auto const i1fc = i1c->FrameCount();
@@ -84,11 +85,8 @@ bool megamol::datatools::MPDCListsConcatenate::getExtent(megamol::core::Call& c)
         reqFid = minFc - 1;
 
     i1c->SetFrameID(reqFid, oc->IsFrameForced());
-    if (!((*i1c)(1)))
-        return false;
-
     i2c->SetFrameID(reqFid, oc->IsFrameForced());
-    if (!((*i2c)(1)))
+    if (!core::ParallelCalls().Add(i1c, 1).Add(i2c, 1)())
         return false;
 
     vislib::math::Cuboid<float> osbb(i1c->AccessBoundingBoxes().ObjectSpaceBBox());
@@ -134,9 +132,7 @@ bool megamol::datatools::MPDCListsConcatenate::getData(megamol::core::Call& c) {
 
     // both calls are connected, so be smart!
 
-    if (!((*i1c)(0)))
-        return false;
-    if (!((*i2c)(0)))
+    if (!core::ParallelCalls().Add(i1c, 0).Add(i2c, 0)())
         return false;
 
     auto const i1plc = i1c->GetParticleListCount();
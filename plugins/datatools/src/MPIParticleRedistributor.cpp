@@ -0,0 +1,743 @@
+/*
+ * MPIParticleRedistributor.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "MPIParticleRedistributor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "cluster/mpi/MpiCall.h"
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/utility/log/Log.h"
+#include "vislib/sys/SystemInformation.h"
+
+using namespace megamol;
+
+namespace {
+
+std::array<float, 3> lowerCorner(vislib::math::Cuboid<float> const& box) {
+    return {box.Left(), box.Bottom(), box.Back()};
+}
+
+std::array<float, 3> upperCorner(vislib::math::Cuboid<float> const& box) {
+    return {box.Right(), box.Top(), box.Front()};
+}
+
+vislib::math::Cuboid<float> makeBox(std::array<float, 3> const& lo, std::array<float, 3> const& hi) {
+    return vislib::math::Cuboid<float>(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+}
+
+bool containsExpanded(vislib::math::Cuboid<float> const& box, std::array<float, 3> const& pos, float width) {
+    auto const lo = lowerCorner(box);
+    auto const hi = upperCorner(box);
+    for (int d = 0; d < 3; ++d) {
+        if (pos[d] < lo[d] - width || pos[d] > hi[d] + width)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * datatools::MPIParticleRedistributor::MPIParticleRedistributor
+ */
+datatools::MPIParticleRedistributor::MPIParticleRedistributor(void)
+        : AbstractParticleManipulator("outData", "indata")
+        , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
+        , decompositionSlot("decomposition", "The spatial decomposition of the global bounding box")
+        , ghostWidthSlot("ghostWidth", "Width of the ghost layer exchanged with neighbouring regions")
+        , rebalanceThresholdSlot(
+              "rebalanceThreshold", "Load imbalance (max/mean particles per rank) triggering a new decomposition")
+        , datahash(0)
+        , lastTime(std::numeric_limits<unsigned int>::max())
+        , myHash(0)
+        , globalBBoxValid(false)
+        , gridDims({1, 1, 1})
+        , decompositionValid(false) {
+
+    this->callRequestMpi.SetCompatibleCall<core::cluster::mpi::MpiCallDescription>();
+    this->MakeSlotAvailable(&this->callRequestMpi);
+
+    auto ep = new core::param::EnumParam(KD_TREE);
+    ep->SetTypePair(KD_TREE, "k-d tree");
+    ep->SetTypePair(UNIFORM_GRID, "uniform grid");
+    this->decompositionSlot << ep;
+    this->MakeSlotAvailable(&this->decompositionSlot);
+
+    this->ghostWidthSlot << new core::param::FloatParam(0.0f, 0.0f);
+    this->MakeSlotAvailable(&this->ghostWidthSlot);
+
+    this->rebalanceThresholdSlot << new core::param::FloatParam(1.2f, 1.0f);
+    this->MakeSlotAvailable(&this->rebalanceThresholdSlot);
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::~MPIParticleRedistributor
+ */
+datatools::MPIParticleRedistributor::~MPIParticleRedistributor(void) {
+    this->Release();
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::manipulateData
+ */
+bool datatools::MPIParticleRedistributor::manipulateData(
+    geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
+    using geocalls::MultiParticleDataCall;
+
+    outData = inData; // also transfers the unlocker to 'outData'
+
+    inData.SetUnlocker(nullptr, false); // keep original data locked
+                                        // original data will be unlocked through outData
+#ifdef MEGAMOL_USE_MPI
+    if (!initMPI())
+        return true;
+
+    bool dirty = false;
+    if (this->decompositionSlot.IsDirty()) {
+        this->decompositionSlot.ResetDirty();
+        this->decompositionValid = false;
+        dirty = true;
+    }
+    if (this->ghostWidthSlot.IsDirty()) {
+        this->ghostWidthSlot.ResetDirty();
+        dirty = true;
+    }
+    if (this->rebalanceThresholdSlot.IsDirty()) {
+        this->rebalanceThresholdSlot.ResetDirty();
+        dirty = true;
+    }
+
+    // every rank decides locally, but all of them must enter the collectives below together
+    int update[2] = {dirty || this->lastTime != outData.FrameID() || this->datahash != inData.DataHash(),
+        !this->decompositionValid};
+    MPI_Allreduce(MPI_IN_PLACE, update, 2, MPI_INT, MPI_LOR, this->comm);
+    this->decompositionValid = (update[1] == 0);
+
+    if (update[0] != 0) {
+        unsigned int plc = inData.GetParticleListCount();
+        std::vector<std::vector<std::array<float, 3>>> positions(plc);
+        for (unsigned int i = 0; i < plc; ++i) {
+            auto const& p = inData.AccessParticles(i);
+            auto const& store = p.GetParticleStore();
+            positions[i].resize(p.GetCount());
+#pragma omp parallel for
+            for (int64_t idx = 0; idx < static_cast<int64_t>(p.GetCount()); ++idx) {
+                positions[i][idx] = {
+                    store.GetXAcc()->Get_f(idx), store.GetYAcc()->Get_f(idx), store.GetZAcc()->Get_f(idx)};
+            }
+        }
+
+        this->computeGlobalBBox(inData);
+        bool const grid = this->decompositionSlot.Param<core::param::EnumParam>()->Value() == UNIFORM_GRID;
+        if (this->decompositionValid && this->globalBBox != this->decompositionBBox) {
+            // the uniform grid is cheap to rebuild locally, the k-d tree keeps its splits and lets the load imbalance
+            // decide about rebuilding, unless its regions no longer cover the box
+            this->decompositionValid = !grid && this->fitKDTree();
+        }
+        if (grid) {
+            if (!this->decompositionValid) {
+                this->buildGrid();
+            }
+        } else if (this->needsRebalance(positions)) {
+            this->buildKDTree(positions);
+        }
+        this->decompositionBBox = this->globalBBox;
+        this->decompositionValid = true;
+
+        if (!this->redistribute(inData, positions, this->ghostWidthSlot.Param<core::param::FloatParam>()->Value())) {
+            return false;
+        }
+
+        this->datahash = inData.DataHash();
+        this->lastTime = outData.FrameID();
+        ++this->myHash;
+    }
+
+    auto const& region = this->regions[this->mpiRank];
+    outData.SetParticleListCount(static_cast<unsigned int>(this->outLists.size()));
+    for (unsigned int i = 0; i < this->outLists.size(); ++i) {
+        outData.AccessParticles(i) = this->outLists[i];
+        outData.AccessParticles(i).SetBBox(region);
+    }
+    outData.SetDataHash(this->myHash);
+    if (this->globalBBoxValid) {
+        outData.AccessBoundingBoxes().SetObjectSpaceBBox(this->globalBBox);
+        outData.AccessBoundingBoxes().SetObjectSpaceClipBox(this->globalClipBox);
+    }
+#endif /* MEGAMOL_USE_MPI */
+
+    return true;
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::manipulateExtent
+ */
+bool datatools::MPIParticleRedistributor::manipulateExtent(
+    geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
+    outData = inData;
+    inData.SetUnlocker(nullptr, false);
+    // the global extents are only known after the first collective data request
+    if (this->globalBBoxValid) {
+        outData.AccessBoundingBoxes().SetObjectSpaceBBox(this->globalBBox);
+        outData.AccessBoundingBoxes().SetObjectSpaceClipBox(this->globalClipBox);
+    }
+    return true;
+}
+
+
+#ifdef MEGAMOL_USE_MPI
+
+/*
+ * datatools::MPIParticleRedistributor::computeGlobalBBox
+ */
+void datatools::MPIParticleRedistributor::computeGlobalBBox(geocalls::MultiParticleDataCall& inData) {
+    auto const& bboxes = inData.AccessBoundingBoxes();
+    auto const bb = bboxes.ObjectSpaceBBox();
+    auto const cb = bboxes.IsObjectSpaceClipBoxValid() ? bboxes.ObjectSpaceClipBox() : bb;
+
+    // min over lower corners and negated upper corners in a single reduction
+    std::array<float, 12> local = {bb.Left(), bb.Bottom(), bb.Back(), -bb.Right(), -bb.Top(), -bb.Front(), cb.Left(),
+        cb.Bottom(), cb.Back(), -cb.Right(), -cb.Top(), -cb.Front()};
+    std::array<float, 12> global;
+    MPI_Allreduce(local.data(), global.data(), 12, MPI_FLOAT, MPI_MIN, this->comm);
+
+    this->globalBBox.Set(global[0], global[1], global[2], -global[3], -global[4], -global[5]);
+    this->globalClipBox.Set(global[6], global[7], global[8], -global[9], -global[10], -global[11]);
+    this->globalBBoxValid = true;
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::buildGrid
+ */
+void datatools::MPIParticleRedistributor::buildGrid() {
+    auto const lo = lowerCorner(this->globalBBox);
+    auto const hi = upperCorner(this->globalBBox);
+    std::array<float, 3> const ext = {hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]};
+
+    // choose the factorization of the rank count with the smallest cell surface
+    float best = std::numeric_limits<float>::max();
+    for (int nx = 1; nx <= this->mpiSize; ++nx) {
+        if (this->mpiSize % nx != 0)
+            continue;
+        int const rest = this->mpiSize / nx;
+        for (int ny = 1; ny <= rest; ++ny) {
+            if (rest % ny != 0)
+                continue;
+            int const nz = rest / ny;
+            float const cx = ext[0] / nx, cy = ext[1] / ny, cz = ext[2] / nz;
+            float const surface = cx * cy + cy * cz + cx * cz;
+            if (surface < best) {
+                best = surface;
+                this->gridDims = {nx, ny, nz};
+            }
+        }
+    }
+
+    this->kdNodes.clear();
+    this->regions.resize(this->mpiSize);
+    for (int r = 0; r < this->mpiSize; ++r) {
+        std::array<int, 3> const idx = {
+            r % this->gridDims[0], (r / this->gridDims[0]) % this->gridDims[1], r / (this->gridDims[0] * this->gridDims[1])};
+        std::array<float, 3> rlo, rhi;
+        for (int d = 0; d < 3; ++d) {
+            rlo[d] = lo[d] + ext[d] * idx[d] / this->gridDims[d];
+            rhi[d] = lo[d] + ext[d] * (idx[d] + 1) / this->gridDims[d];
+        }
+        this->regions[r] = makeBox(rlo, rhi);
+    }
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::buildKDTree
+ */
+void datatools::MPIParticleRedistributor::buildKDTree(
+    std::vector<std::vector<std::array<float, 3>>> const& positions) {
+    constexpr int numBins = 256;
+
+    this->kdNodes.clear();
+    this->kdNodes.push_back(KDNode{this->globalBBox, 0, this->mpiSize, -1, 0.0f, -1, -1});
+
+    std::vector<std::vector<int>> nodeOf(positions.size());
+    for (size_t l = 0; l < positions.size(); ++l) {
+        nodeOf[l].assign(positions[l].size(), 0);
+    }
+
+    // split all nodes of one level at once, the particle histograms of all ranks are summed up per level
+    std::vector<int> open;
+    if (this->mpiSize > 1)
+        open.push_back(0);
+    while (!open.empty()) {
+        std::vector<int> slotOf(this->kdNodes.size(), -1);
+        for (size_t s = 0; s < open.size(); ++s) {
+            auto& node = this->kdNodes[open[s]];
+            auto const lo = lowerCorner(node.box);
+            auto const hi = upperCorner(node.box);
+            node.axis = 0;
+            for (int d = 1; d < 3; ++d) {
+                if (hi[d] - lo[d] > hi[node.axis] - lo[node.axis])
+                    node.axis = d;
+            }
+            slotOf[open[s]] = static_cast<int>(s);
+        }
+
+        std::vector<uint64_t> hist(open.size() * numBins, 0), globalHist(open.size() * numBins);
+        for (size_t l = 0; l < positions.size(); ++l) {
+            for (size_t idx = 0; idx < positions[l].size(); ++idx) {
+                int const s = slotOf[nodeOf[l][idx]];
+                if (s < 0)
+                    continue;
+                auto const& node = this->kdNodes[open[s]];
+                float const lo = lowerCorner(node.box)[node.axis];
+                float const hi = upperCorner(node.box)[node.axis];
+                float const rel = hi > lo ? (positions[l][idx][node.axis] - lo) / (hi - lo) : 0.0f;
+                int const bin = std::clamp(static_cast<int>(rel * numBins), 0, numBins - 1);
+                ++hist[s * numBins + bin];
+            }
+        }
+        MPI_Allreduce(
+            hist.data(), globalHist.data(), static_cast<int>(hist.size()), MPI_UINT64_T, MPI_SUM, this->comm);
+
+        std::vector<int> next;
+        for (size_t s = 0; s < open.size(); ++s) {
+            int const n = open[s];
+            int const numRanks = this->kdNodes[n].rank_end - this->kdNodes[n].rank_begin;
+            int const numLeft = numRanks / 2;
+            int const axis = this->kdNodes[n].axis;
+            float const lo = lowerCorner(this->kdNodes[n].box)[axis];
+            float const hi = upperCorner(this->kdNodes[n].box)[axis];
+
+            uint64_t total = 0;
+            for (int b = 0; b < numBins; ++b) {
+                total += globalHist[s * numBins + b];
+            }
+
+            // place the split such that the particle counts match the rank counts of both halves
+            float split = lo + (hi - lo) * numLeft / numRanks;
+            if (total > 0) {
+                double const target = static_cast<double>(total) * numLeft / numRanks;
+                uint64_t cum = 0;
+                for (int b = 0; b < numBins; ++b) {
+                    auto const cnt = globalHist[s * numBins + b];
+                    if (cum + cnt >= target && cnt > 0) {
+                        double const frac = (target - cum) / cnt;
+                        split = lo + (hi - lo) * static_cast<float>((b + frac) / numBins);
+                        break;
+                    }
+                    cum += cnt;
+                }
+            }
+
+            auto leftHi = upperCorner(this->kdNodes[n].box);
+            auto rightLo = lowerCorner(this->kdNodes[n].box);
+            leftHi[axis] = split;
+            rightLo[axis] = split;
+            KDNode left{makeBox(lowerCorner(this->kdNodes[n].box), leftHi), this->kdNodes[n].rank_begin,
+                this->kdNodes[n].rank_begin + numLeft, -1, 0.0f, -1, -1};
+            KDNode right{makeBox(rightLo, upperCorner(this->kdNodes[n].box)), this->kdNodes[n].rank_begin + numLeft,
+                this->kdNodes[n].rank_end, -1, 0.0f, -1, -1};
+
+            this->kdNodes[n].split = split;
+            this->kdNodes[n].left = static_cast<int>(this->kdNodes.size());
+            this->kdNodes.push_back(left);
+            this->kdNodes[n].right = static_cast<int>(this->kdNodes.size());
+            this->kdNodes.push_back(right);
+            if (left.rank_end - left.rank_begin > 1)
+                next.push_back(this->kdNodes[n].left);
+            if (right.rank_end - right.rank_begin > 1)
+                next.push_back(this->kdNodes[n].right);
+        }
+
+        for (size_t l = 0; l < positions.size(); ++l) {
+            for (size_t idx = 0; idx < positions[l].size(); ++idx) {
+                auto const& node = this->kdNodes[nodeOf[l][idx]];
+                if (node.left < 0)
+                    continue;
+                nodeOf[l][idx] = positions[l][idx][node.axis] < node.split ? node.left : node.right;
+            }
+        }
+        open = std::move(next);
+    }
+
+    this->regions.resize(this->mpiSize);
+    for (auto const& node : this->kdNodes) {
+        if (node.left < 0) {
+            this->regions[node.rank_begin] = node.box;
+        }
+    }
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::fitKDTree
+ */
+bool datatools::MPIParticleRedistributor::fitKDTree() {
+    if (this->kdNodes.empty())
+        return false;
+
+    auto const oldLo = lowerCorner(this->decompositionBBox);
+    auto const oldHi = upperCorner(this->decompositionBBox);
+    auto const lo = lowerCorner(this->globalBBox);
+    auto const hi = upperCorner(this->globalBBox);
+
+    // the splits are kept, so every particle still falls into a region as long as they all lie within the new box
+    for (auto const& node : this->kdNodes) {
+        if (node.left >= 0 && (node.split <= lo[node.axis] || node.split >= hi[node.axis]))
+            return false;
+    }
+
+    // move the faces on the border of the old box to the border of the new one
+    for (auto& node : this->kdNodes) {
+        auto nodeLo = lowerCorner(node.box);
+        auto nodeHi = upperCorner(node.box);
+        for (int d = 0; d < 3; ++d) {
+            if (nodeLo[d] == oldLo[d])
+                nodeLo[d] = lo[d];
+            if (nodeHi[d] == oldHi[d])
+                nodeHi[d] = hi[d];
+        }
+        node.box = makeBox(nodeLo, nodeHi);
+        if (node.left < 0) {
+            this->regions[node.rank_begin] = node.box;
+        }
+    }
+    return true;
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::needsRebalance
+ */
+bool datatools::MPIParticleRedistributor::needsRebalance(
+    std::vector<std::vector<std::array<float, 3>>> const& positions) {
+    if (!this->decompositionValid || this->kdNodes.empty())
+        return true;
+
+    std::vector<uint64_t> counts(this->mpiSize, 0), globalCounts(this->mpiSize);
+    for (auto const& list : positions) {
+        for (auto const& pos : list) {
+            ++counts[this->findOwner(pos)];
+        }
+    }
+    MPI_Allreduce(counts.data(), globalCounts.data(), this->mpiSize, MPI_UINT64_T, MPI_SUM, this->comm);
+
+    uint64_t total = 0, maxCount = 0;
+    for (auto const c : globalCounts) {
+        total += c;
+        maxCount = std::max(maxCount, c);
+    }
+    if (total == 0)
+        return false;
+    double const imbalance = static_cast<double>(maxCount) * this->mpiSize / total;
+    return imbalance > this->rebalanceThresholdSlot.Param<core::param::FloatParam>()->Value();
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::findOwner
+ */
+int datatools::MPIParticleRedistributor::findOwner(std::array<float, 3> const& pos) const {
+    if (!this->kdNodes.empty()) {
+        int n = 0;
+        while (this->kdNodes[n].left >= 0) {
+            n = pos[this->kdNodes[n].axis] < this->kdNodes[n].split ? this->kdNodes[n].left : this->kdNodes[n].right;
+        }
+        return this->kdNodes[n].rank_begin;
+    }
+
+    auto const lo = lowerCorner(this->globalBBox);
+    auto const hi = upperCorner(this->globalBBox);
+    std::array<int, 3> idx;
+    for (int d = 0; d < 3; ++d) {
+        float const rel = hi[d] > lo[d] ? (pos[d] - lo[d]) / (hi[d] - lo[d]) : 0.0f;
+        idx[d] = std::clamp(static_cast<int>(rel * this->gridDims[d]), 0, this->gridDims[d] - 1);
+    }
+    return idx[0] + this->gridDims[0] * (idx[1] + this->gridDims[1] * idx[2]);
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::findGhostTargets
+ */
+void datatools::MPIParticleRedistributor::findGhostTargets(
+    std::array<float, 3> const& pos, float width, int owner, std::vector<int>& targets) const {
+    targets.clear();
+    if (!this->kdNodes.empty()) {
+        std::vector<int> stack = {0};
+        while (!stack.empty()) {
+            auto const& node = this->kdNodes[stack.back()];
+            stack.pop_back();
+            if (node.left < 0) {
+                if (node.rank_begin != owner && containsExpanded(node.box, pos, width))
+                    targets.push_back(node.rank_begin);
+                continue;
+            }
+            if (pos[node.axis] - width < node.split)
+                stack.push_back(node.left);
+            if (pos[node.axis] + width >= node.split)
+                stack.push_back(node.right);
+        }
+        return;
+    }
+
+    auto const lo = lowerCorner(this->globalBBox);
+    auto const hi = upperCorner(this->globalBBox);
+    std::array<int, 3> first, last;
+    for (int d = 0; d < 3; ++d) {
+        float const cell = (hi[d] - lo[d]) / this->gridDims[d];
+        if (cell <= 0.0f) {
+            first[d] = last[d] = 0;
+            continue;
+        }
+        first[d] = std::clamp(static_cast<int>((pos[d] - width - lo[d]) / cell), 0, this->gridDims[d] - 1);
+        last[d] = std::clamp(static_cast<int>((pos[d] + width - lo[d]) / cell), 0, this->gridDims[d] - 1);
+    }
+    for (int z = first[2]; z <= last[2]; ++z) {
+        for (int y = first[1]; y <= last[1]; ++y) {
+            for (int x = first[0]; x <= last[0]; ++x) {
+                int const r = x + this->gridDims[0] * (y + this->gridDims[1] * z);
+                if (r != owner && containsExpanded(this->regions[r], pos, width))
+                    targets.push_back(r);
+            }
+        }
+    }
+}
+
+
+/*
+ * datatools::MPIParticleRedistributor::redistribute
+ */
+bool datatools::MPIParticleRedistributor::redistribute(geocalls::MultiParticleDataCall& inData,
+    std::vector<std::vector<std::array<float, 3>>> const& positions, float ghost_width) {
+    using geocalls::MultiParticleDataCall;
+    using Particles = MultiParticleDataCall::Particles;
+
+    unsigned int plc = inData.GetParticleListCount();
+    unsigned int globalPlc = 0;
+    MPI_Allreduce(&plc, &globalPlc, 1, MPI_UNSIGNED, MPI_MAX, this->comm);
+    if (plc != globalPlc) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "MPIParticleRedistributor: rank %d provides %u of %u particle lists", this->mpiRank, plc, globalPlc);
+    }
+
+    // ranks without particles may report arbitrary data types, agree on the types of the ranks providing data
+    std::vector<int> localTypes(4 * globalPlc, 0), types(4 * globalPlc);
+    std::vector<float> localRange(2 * globalPlc, std::numeric_limits<float>::max()), colRange(2 * globalPlc);
+    for (unsigned int i = 0; i < plc; ++i) {
+        auto const& p = inData.AccessParticles(i);
+        if (p.GetCount() == 0)
+            continue;
+        localTypes[4 * i + 0] = p.GetVertexDataType();
+        localTypes[4 * i + 1] = p.GetColourDataType();
+        localTypes[4 * i + 2] = p.GetDirDataType();
+        localTypes[4 * i + 3] = p.GetIDDataType();
+        localRange[2 * i + 0] = p.GetMinColourIndexValue();
+        localRange[2 * i + 1] = -p.GetMaxColourIndexValue();
+    }
+    MPI_Allreduce(localTypes.data(), types.data(), static_cast<int>(types.size()), MPI_INT, MPI_MAX, this->comm);
+    MPI_Allreduce(
+        localRange.data(), colRange.data(), static_cast<int>(colRange.size()), MPI_FLOAT, MPI_MIN, this->comm);
+
+    bool const withGhosts = ghost_width > 0.0f;
+    this->lists.resize(globalPlc);
+    this->outLists.clear();
+    this->outLists.resize(withGhosts ? 2 * globalPlc : globalPlc);
+
+    std::vector<int> targets;
+    for (unsigned int i = 0; i < globalPlc; ++i) {
+        auto const vdt = static_cast<Particles::VertexDataType>(types[4 * i + 0]);
+        auto const cdt = static_cast<Particles::ColourDataType>(types[4 * i + 1]);
+        auto const ddt = static_cast<Particles::DirDataType>(types[4 * i + 2]);
+        auto const idt = static_cast<Particles::IDDataType>(types[4 * i + 3]);
+        size_t const vsize = Particles::VertexDataSize[vdt];
+        size_t const csize = Particles::ColorDataSize[cdt];
+        size_t const dsize = Particles::DirDataSize[ddt];
+        size_t const isize = Particles::IDDataSize[idt];
+        size_t const elSize = vsize + csize + dsize + isize;
+
+        uint64_t cnt = 0;
+        uint8_t const *vd = nullptr, *cd = nullptr, *dd = nullptr, *id = nullptr;
+        size_t vds = vsize, cds = csize, dds = dsize, ids = isize;
+        if (i < plc) {
+            auto const& p = inData.AccessParticles(i);
+            bool const match = p.GetVertexDataType() == vdt && p.GetColourDataType() == cdt &&
+                               p.GetDirDataType() == ddt && p.GetIDDataType() == idt;
+            if (p.GetCount() > 0 && !match) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "MPIParticleRedistributor: data types of list %u on rank %d do not match the other ranks, "
+                    "dropping its particles",
+                    i, this->mpiRank);
+            } else {
+                cnt = p.GetCount();
+                vd = reinterpret_cast<uint8_t const*>(p.GetVertexData());
+                cd = reinterpret_cast<uint8_t const*>(p.GetColourData());
+                dd = reinterpret_cast<uint8_t const*>(p.GetDirData());
+                id = reinterpret_cast<uint8_t const*>(p.GetIDData());
+                vds = p.GetVertexDataStride() == 0 ? vsize : p.GetVertexDataStride();
+                cds = p.GetColourDataStride() == 0 ? csize : p.GetColourDataStride();
+                dds = p.GetDirDataStride() == 0 ? dsize : p.GetDirDataStride();
+                ids = p.GetIDDataStride() == 0 ? isize : p.GetIDDataStride();
+            }
+        }
+        if (elSize == 0) {
+            cnt = 0;
+        }
+
+        // assign owners and ghost targets
+        std::vector<int> owner(cnt);
+        std::vector<int> sendCounts(this->mpiSize, 0), ghostSendCounts(this->mpiSize, 0);
+        std::vector<std::vector<int>> ghostTargets(withGhosts ? cnt : 0);
+        for (uint64_t idx = 0; idx < cnt; ++idx) {
+            owner[idx] = this->findOwner(positions[i][idx]);
+            ++sendCounts[owner[idx]];
+            if (withGhosts) {
+                this->findGhostTargets(positions[i][idx], ghost_width, owner[idx], targets);
+                ghostTargets[idx] = targets;
+                for (auto const t : targets) {
+                    ++ghostSendCounts[t];
+                }
+            }
+        }
+
+        std::vector<int> sendOffsets(this->mpiSize, 0), ghostSendOffsets(this->mpiSize, 0);
+        for (int r = 1; r < this->mpiSize; ++r) {
+            sendOffsets[r] = sendOffsets[r - 1] + sendCounts[r - 1];
+            ghostSendOffsets[r] = ghostSendOffsets[r - 1] + ghostSendCounts[r - 1];
+        }
+
+        auto pack = [&](uint64_t idx, uint8_t* dst) {
+            if (vsize > 0)
+                std::memcpy(dst, vd + idx * vds, vsize);
+            if (csize > 0)
+                std::memcpy(dst + vsize, cd + idx * cds, csize);
+            if (dsize > 0)
+                std::memcpy(dst + vsize + csize, dd + idx * dds, dsize);
+            if (isize > 0)
+                std::memcpy(dst + vsize + csize + dsize, id + idx * ids, isize);
+        };
+
+        std::vector<uint8_t> sendBuf(cnt * elSize);
+        std::vector<uint8_t> ghostSendBuf(
+            (ghostSendOffsets[this->mpiSize - 1] + ghostSendCounts[this->mpiSize - 1]) * elSize);
+        {
+            auto pos = sendOffsets;
+            auto ghostPos = ghostSendOffsets;
+            for (uint64_t idx = 0; idx < cnt; ++idx) {
+                pack(idx, sendBuf.data() + static_cast<size_t>(pos[owner[idx]]++) * elSize);
+                if (withGhosts) {
+                    for (auto const t : ghostTargets[idx]) {
+                        pack(idx, ghostSendBuf.data() + static_cast<size_t>(ghostPos[t]++) * elSize);
+                    }
+                }
+            }
+        }
+
+        MPI_Datatype elType = MPI_BYTE;
+        if (elSize > 0) {
+            MPI_Type_contiguous(static_cast<int>(elSize), MPI_BYTE, &elType);
+            MPI_Type_commit(&elType);
+        }
+
+        auto exchange = [&](std::vector<uint8_t> const& send, std::vector<int> const& counts,
+                            std::vector<int> const& offsets, std::vector<uint8_t>& recv) -> uint64_t {
+            std::vector<int> recvCounts(this->mpiSize), recvOffsets(this->mpiSize, 0);
+            MPI_Alltoall(counts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, this->comm);
+            uint64_t total = recvCounts[0];
+            for (int r = 1; r < this->mpiSize; ++r) {
+                recvOffsets[r] = recvOffsets[r - 1] + recvCounts[r - 1];
+                total += recvCounts[r];
+            }
+            recv.resize(total * elSize);
+            MPI_Alltoallv(send.data(), counts.data(), offsets.data(), elType, recv.data(), recvCounts.data(),
+                recvOffsets.data(), elType, this->comm);
+            return total;
+        };
+
+        auto& list = this->lists[i];
+        list.owned_count = exchange(sendBuf, sendCounts, sendOffsets, list.owned);
+        list.ghost_count = 0;
+        list.ghosts.clear();
+        if (withGhosts) {
+            list.ghost_count = exchange(ghostSendBuf, ghostSendCounts, ghostSendOffsets, list.ghosts);
+        }
+        if (elSize > 0) {
+            MPI_Type_free(&elType);
+        }
+
+        // describe the received data
+        auto setup = [&](Particles& out, uint64_t count, std::vector<uint8_t> const& data) {
+            if (i < plc) {
+                auto const& in = inData.AccessParticles(i);
+                out.SetGlobalRadius(in.GetGlobalRadius());
+                auto const gc = in.GetGlobalColour();
+                out.SetGlobalColour(gc[0], gc[1], gc[2], gc[3]);
+                out.SetGlobalType(in.GetGlobalType());
+            }
+            out.SetCount(count);
+            if (count == 0)
+                return;
+            out.SetVertexData(vdt, data.data(), static_cast<unsigned int>(elSize));
+            out.SetColourData(cdt, data.data() + vsize, static_cast<unsigned int>(elSize));
+            out.SetDirData(ddt, data.data() + vsize + csize, static_cast<unsigned int>(elSize));
+            out.SetIDData(idt, data.data() + vsize + csize + dsize, static_cast<unsigned int>(elSize));
+            out.SetColourMapIndexValues(colRange[2 * i + 0], -colRange[2 * i + 1]);
+        };
+        setup(this->outLists[i], list.owned_count, list.owned);
+        if (withGhosts) {
+            setup(this->outLists[globalPlc + i], list.ghost_count, list.ghosts);
+        }
+    }
+
+    return true;
+}
+
+#endif /* MEGAMOL_USE_MPI */
+
+
+/*
+ * datatools::MPIParticleRedistributor::initMPI
+ */
+bool datatools::MPIParticleRedistributor::initMPI() {
+    bool retval = false;
+#ifdef MEGAMOL_USE_MPI
+    if (this->comm == MPI_COMM_NULL) {
+        auto c = this->callRequestMpi.CallAs<core::cluster::mpi::MpiCall>();
+        if (c != nullptr) {
+            /* New method: let MpiProvider do all the stuff. */
+            if ((*c)(core::cluster::mpi::MpiCall::IDX_PROVIDE_MPI)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("Got MPI communicator.");
+                this->comm = c->GetComm();
+            } else {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    _T("Could not ")
+                    _T("retrieve MPI communicator for the MPI-based view ")
+                    _T("from the registered provider module."));
+            }
+        }
+
+        if (this->comm != MPI_COMM_NULL) {
+            ::MPI_Comm_rank(this->comm, &this->mpiRank);
+            ::MPI_Comm_size(this->comm, &this->mpiSize);
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("This MPIParticleRedistributor on %hs is %d ")
+                                                                   _T("of %d."),
+                vislib::sys::SystemInformation::ComputerNameA().PeekBuffer(), this->mpiRank, this->mpiSize);
+        } /* end if (this->comm != MPI_COMM_NULL) */
+    }     /* end if (this->comm == MPI_COMM_NULL) */
+
+    /* Determine success of the whole operation. */
+    retval = (this->comm != MPI_COMM_NULL);
+#endif /* MEGAMOL_USE_MPI */
+    return retval;
+}
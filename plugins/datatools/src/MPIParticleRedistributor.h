@@ -0,0 +1,169 @@
+/*
+ * MPIParticleRedistributor.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "datatools/AbstractParticleManipulator.h"
+#include "mmcore/param/ParamSlot.h"
+#include "vislib/math/Cuboid.h"
+
+#ifdef MEGAMOL_USE_MPI
+#include "mpi.h"
+#endif /* MEGAMOL_USE_MPI */
+
+namespace megamol {
+namespace datatools {
+
+/**
+ * Module redistributing object-space distributed MultiparticleDataCalls over MPI.
+ * The global bounding box is decomposed into one compact region per rank (k-d tree or uniform grid) and all particles
+ * are exchanged such that every rank owns the particles of its region. Particles within the ghost width of a foreign
+ * region are additionally sent to that rank and provided as separate particle lists following the owned lists.
+ * The uniform grid follows the global bounding box of every time step. The k-d tree keeps its splits between time
+ * steps and only moves its outer faces to the global bounding box; it is rebuilt when the load imbalance exceeds a
+ * threshold or a split falls outside of the global bounding box.
+ */
+class MPIParticleRedistributor : public AbstractParticleManipulator {
+public:
+    /** Return module class name */
+    static const char* ClassName(void) {
+        return "MPIParticleRedistributor";
+    }
+
+    /** Return module class description */
+    static const char* Description(void) {
+        return "redistributes MultiparticleDataCalls over MPI into spatial regions per rank with ghost layers";
+    }
+
+    /** Module is only available with MPI */
+    static bool IsAvailable(void) {
+#ifdef MEGAMOL_USE_MPI
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /** Ctor */
+    MPIParticleRedistributor(void);
+
+    /** Dtor */
+    virtual ~MPIParticleRedistributor(void);
+
+protected:
+    /**
+     * Manipulates the particle data
+     *
+     * @param outData The call receiving the manipulated data
+     * @param inData The call holding the original data
+     *
+     * @return True on success
+     */
+    bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
+
+    /**
+     * Manipulates the particle data extend information
+     *
+     * @param outData The call receiving the manipulated information
+     * @param inData The call holding the original data
+     *
+     * @return True on success
+     */
+    bool manipulateExtent(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) override;
+
+    bool initMPI();
+
+private:
+    enum DecompositionType { KD_TREE = 0, UNIFORM_GRID = 1 };
+
+    /** Node of the k-d decomposition, leaves carry the rank owning the region */
+    struct KDNode {
+        vislib::math::Cuboid<float> box;
+        int rank_begin;
+        int rank_end;
+        int axis;
+        float split;
+        int left;
+        int right;
+    };
+
+    /** Redistributed data of one particle list */
+    struct ListData {
+        std::vector<uint8_t> owned;
+        std::vector<uint8_t> ghosts;
+        uint64_t owned_count;
+        uint64_t ghost_count;
+    };
+
+#ifdef MEGAMOL_USE_MPI
+    void computeGlobalBBox(geocalls::MultiParticleDataCall& inData);
+
+    void buildGrid();
+
+    void buildKDTree(std::vector<std::vector<std::array<float, 3>>> const& positions);
+
+    /**
+     * Moves the outer faces of the k-d regions to the current global bounding box, keeping the splits
+     *
+     * @return False if a split lies outside of the global bounding box, which requires a new decomposition
+     */
+    bool fitKDTree();
+
+    bool needsRebalance(std::vector<std::vector<std::array<float, 3>>> const& positions);
+
+    int findOwner(std::array<float, 3> const& pos) const;
+
+    void findGhostTargets(std::array<float, 3> const& pos, float width, int owner, std::vector<int>& targets) const;
+
+    bool redistribute(geocalls::MultiParticleDataCall& inData,
+        std::vector<std::vector<std::array<float, 3>>> const& positions, float ghost_width);
+
+    /** The communicator that the view uses. */
+    MPI_Comm comm = MPI_COMM_NULL;
+#endif /* MEGAMOL_USE_MPI */
+
+    /** slot for MPIprovider */
+    core::CallerSlot callRequestMpi;
+
+    /** Selects the spatial decomposition scheme */
+    core::param::ParamSlot decompositionSlot;
+
+    /** Width of the ghost layer around every region */
+    core::param::ParamSlot ghostWidthSlot;
+
+    /** Load imbalance (max/mean) above which the k-d decomposition is recomputed */
+    core::param::ParamSlot rebalanceThresholdSlot;
+
+    int mpiRank = 0;
+    int mpiSize = 0;
+
+    size_t datahash;
+    unsigned int lastTime;
+    size_t myHash;
+
+    vislib::math::Cuboid<float> globalBBox;
+    vislib::math::Cuboid<float> globalClipBox;
+    bool globalBBoxValid;
+
+    /** Current regions, index is the rank */
+    std::vector<vislib::math::Cuboid<float>> regions;
+    std::vector<KDNode> kdNodes;
+    std::array<int, 3> gridDims;
+    bool decompositionValid;
+
+    /** The global bounding box the current regions partition */
+    vislib::math::Cuboid<float> decompositionBBox;
+
+    std::vector<ListData> lists;
+    std::vector<geocalls::SimpleSphericalParticles> outLists;
+};
+
+} /* end namespace datatools */
+} /* end namespace megamol */
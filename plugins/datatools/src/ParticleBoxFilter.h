@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AbstractParticleBoxFilter.h"
+#include "datatools/AbstractParticleManipulator.h"
 
 namespace megamol {
 namespace datatools {
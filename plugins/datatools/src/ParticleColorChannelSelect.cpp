@@ -40,6 +40,14 @@ datatools::ParticleColorChannelSelect::~ParticleColorChannelSelect(void) {
 }
 
 
+/*
+ * datatools::ParticleColorChannelSelect::supportsAsync
+ */
+bool datatools::ParticleColorChannelSelect::supportsAsync(void) const {
+    return true;
+}
+
+
 /*
  * datatools::ParticleColorChannelSelect::manipulateData
  */
@@ -48,7 +56,7 @@ bool datatools::ParticleColorChannelSelect::manipulateData(
     outData = inData;                   // also transfers the unlocker to 'outData'
     inData.SetUnlocker(nullptr, false); // keep original data locked
                                         // original data will be unlocked through outData
-    int chan = channelSlot.Param<core::param::EnumParam>()->Value();
+    int chan = this->parameters().Get<int>("channel");
     if (chan < 0)
         chan = 0;
     if (chan > 3)
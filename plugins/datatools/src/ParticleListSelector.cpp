@@ -29,13 +29,21 @@ datatools::ParticleListSelector::~ParticleListSelector(void) {
 }
 
 
+/*
+ * datatools::ParticleListSelector::supportsAsync
+ */
+bool datatools::ParticleListSelector::supportsAsync(void) const {
+    return true;
+}
+
+
 /*
  * datatools::ParticleListSelector::manipulateData
  */
 bool datatools::ParticleListSelector::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
     using geocalls::MultiParticleDataCall;
-    int idx = this->listIndexSlot.Param<core::param::IntParam>()->Value();
+    int idx = this->parameters().Get<int>("listIndex");
 
     outData = inData; // also transfers the unlocker to 'outData'
 
@@ -29,13 +29,21 @@ datatools::ParticleThinner::~ParticleThinner(void) {
 }
 
 
+/*
+ * datatools::ParticleThinner::supportsAsync
+ */
+bool datatools::ParticleThinner::supportsAsync(void) const {
+    return true;
+}
+
+
 /*
  * datatools::ParticleThinner::manipulateData
  */
 bool datatools::ParticleThinner::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
     using geocalls::MultiParticleDataCall;
-    int tf = this->thinningFactorSlot.Param<core::param::IntParam>()->Value();
+    int tf = this->parameters().Get<int>("thinningFactor");
 
     outData = inData; // also transfers the unlocker to 'outData'
 
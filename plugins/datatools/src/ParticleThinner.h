@@ -59,6 +59,13 @@ protected:
      */
     virtual bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData);
 
+    /**
+     * Answer whether 'manipulateData' may run on a worker thread
+     *
+     * @return True, as the parameters are only read from 'parameters'
+     */
+    bool supportsAsync(void) const override;
+
 private:
     /** The thinning factor. Only each n-th particle will be kept. */
     core::param::ParamSlot thinningFactorSlot;
@@ -129,8 +129,9 @@ bool datatools::ParticleVelocities::assertData(
         //cachedVertexData.resize(0);
         this->cachedTime = -1;
         this->cachedNumLists = 0;
-        // load previous Frame
+        // load previous Frame, sources supporting frame windows deliver the current one along with it
         in->SetFrameID(time - 1, true);
+        in->SetFrameWindow(2);
         //if (!(*in)(1)) {
         //    megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleVelocities: could not get previous frame extents (%u)", time - 1);
         //    return false;
@@ -180,25 +181,42 @@ bool datatools::ParticleVelocities::assertData(
             this->cachedVertexData[i] = new char[thesize];
             memcpy(this->cachedVertexData[i], in->AccessParticles(i).GetVertexData(), thesize);
         }
-        // TODO: what am I actually doing here
-        //in->SetUnlocker(nullptr, false);
-        in->Unlock();
         this->cachedTime = time - 1;
         this->cachedNumLists = in->GetParticleListCount();
 
-        in->SetFrameID(time, true);
-        do {
+        if ((in->GetWindowFrameCount() > 1) && (in->GetWindowFrameID(1) == time)) {
+            // the current frame stays locked together with the previous one by the unlocker of 'in'
+            in->SetParticleListCount(in->GetWindowParticleListCount(1));
+            for (unsigned int i = 0; i < in->GetParticleListCount(); i++) {
+                in->AccessParticles(i) = in->AccessWindowParticles(1, i);
+            }
+            in->SetFrameWindow(1);
+            in->SetFrameID(time, true);
             if (!(*in)(1)) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "ParticleVelocities: could not get current frame extents (%u)", time - 1);
                 return false;
             }
-            if (!(*in)(0)) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(
-                    "ParticleVelocities: could not get current frame (%u)", time - 1);
-                return false;
-            }
-        } while (in->FrameID() != time); // did we get correct frame?
+        } else {
+            in->SetFrameWindow(1);
+            // TODO: what am I actually doing here
+            //in->SetUnlocker(nullptr, false);
+            in->Unlock();
+
+            in->SetFrameID(time, true);
+            do {
+                if (!(*in)(1)) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError(
+                        "ParticleVelocities: could not get current frame extents (%u)", time - 1);
+                    return false;
+                }
+                if (!(*in)(0)) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError(
+                        "ParticleVelocities: could not get current frame (%u)", time - 1);
+                    return false;
+                }
+            } while (in->FrameID() != time); // did we get correct frame?
+        }
         if (cachedNumLists != in->GetParticleListCount()) {
             megamol::core::utility::log::Log::DefaultLog.WriteError("ParticleVelocities: inconsistent number of lists"
                                                                     "between frames %u (%u) and %u (%u)",
@@ -6,6 +6,7 @@
  */
 
 #include "SphereDataUnifier.h"
+#include "datatools/AbstractManipulator.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "vislib/RawStorage.h"
 
@@ -72,6 +73,7 @@ bool datatools::SphereDataUnifier::getDataCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    request_whole_frame(*outCall);
 
     if ((*outCall)(0)) {
         unsigned int listCnt = outCall->GetParticleListCount();
@@ -315,6 +317,7 @@ bool datatools::SphereDataUnifier::getExtentCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    request_whole_frame(*outCall);
 
     if ((*outCall)(1)) {
         outCall->SetUnlocker(NULL, false);
@@ -1,5 +1,8 @@
 #include "datatools/clustering/ParticleIColClustering.h"
 
+#include <chrono>
+
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 
@@ -8,7 +11,10 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
         : AbstractParticleManipulator("outData", "inData")
         , _eps_slot("eps", "")
         , _minpts_slot("minpts", "")
-        , _icol_weight("icol weight", "") {
+        , _icol_weight("icol weight", "")
+        , _algorithm_slot("algorithm",
+              "Parallel grid DBSCAN, the serial k-d tree reference implementation or the grid checked against the "
+              "reference") {
     _eps_slot << new core::param::FloatParam(0.1f, 0.0f, 1.0f);
     MakeSlotAvailable(&_eps_slot);
 
@@ -17,6 +23,13 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
 
     _icol_weight << new core::param::FloatParam(0.5f, 0.0f, 1.0f);
     MakeSlotAvailable(&_icol_weight);
+
+    auto ep = new core::param::EnumParam(static_cast<int>(algorithm::GRID));
+    ep->SetTypePair(static_cast<int>(algorithm::GRID), "grid (parallel)");
+    ep->SetTypePair(static_cast<int>(algorithm::KD_TREE), "k-d tree (serial)");
+    ep->SetTypePair(static_cast<int>(algorithm::VERIFY), "grid (verified)");
+    _algorithm_slot << ep;
+    MakeSlotAvailable(&_algorithm_slot);
 }
 
 
@@ -37,6 +50,7 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
         auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
         auto const minpts = static_cast<index_t>(_minpts_slot.Param<core::param::IntParam>()->Value());
         auto const icol_weight = _icol_weight.Param<core::param::FloatParam>()->Value();
+        auto const algo = static_cast<algorithm>(_algorithm_slot.Param<core::param::EnumParam>()->Value());
 
         std::array<float, 4> weights = {(1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
 
@@ -76,15 +90,41 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
                     p_bbox.GetBack(), p_bbox.GetFront(), parts.GetMinColourIndexValue(),
                     parts.GetMaxColourIndexValue()};
 
+                // the k-d tree references the point cloud and is rebuilt on demand
+                _kd_trees[pl_idx].reset();
                 _points[pl_idx] = std::make_shared<genericPointcloud<float, 4>>(cur_points, bbox, weights);
                 _points[pl_idx]->normalize_data();
-
-                _kd_trees[pl_idx] = std::make_shared<kd_tree_t<float, 4>>(
-                    4, *_points[pl_idx], nanoflann::KDTreeSingleIndexAdaptorParams());
-                _kd_trees[pl_idx]->buildIndex();
             }
 
-            auto const cluster_res = DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
+            auto const start = std::chrono::high_resolution_clock::now();
+            cluster_result_t cluster_res;
+            if (algo == algorithm::KD_TREE) {
+                cluster_res = DBSCAN(getKDTree(pl_idx), eps * eps, minpts);
+            } else {
+                cluster_res = DBSCAN_grid(*_points[pl_idx], eps * eps, minpts);
+            }
+            std::chrono::duration<float, std::milli> const duration = std::chrono::high_resolution_clock::now() - start;
+            core::utility::log::Log::DefaultLog.WriteInfo(
+                "[ParticleIColClustering]: Clustering list idx %d took %f ms", pl_idx, duration.count());
+
+            if (algo == algorithm::VERIFY) {
+                auto const reference = DBSCAN(getKDTree(pl_idx), eps * eps, minpts);
+                std::size_t mismatches = 0;
+                for (std::size_t pidx = 0; pidx < reference.size(); ++pidx) {
+                    if (reference[pidx] != cluster_res[pidx]) {
+                        ++mismatches;
+                    }
+                }
+                if (mismatches > 0) {
+                    core::utility::log::Log::DefaultLog.WriteError(
+                        "[ParticleIColClustering]: Grid DBSCAN differs from the k-d tree DBSCAN for %zu of %zu "
+                        "particles in list idx %d",
+                        mismatches, reference.size(), pl_idx);
+                } else {
+                    core::utility::log::Log::DefaultLog.WriteInfo(
+                        "[ParticleIColClustering]: Grid DBSCAN matches the k-d tree DBSCAN in list idx %d", pl_idx);
+                }
+            }
 
             _ret_cols[pl_idx].resize(p_count);
             std::transform(cluster_res.cbegin(), cluster_res.cend(), _ret_cols[pl_idx].begin(),
@@ -113,3 +153,14 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
 
     return true;
 }
+
+
+std::shared_ptr<megamol::datatools::clustering::kd_tree_t<float, 4>>
+megamol::datatools::clustering::ParticleIColClustering::getKDTree(std::size_t pl_idx) {
+    if (_kd_trees[pl_idx] == nullptr) {
+        _kd_trees[pl_idx] =
+            std::make_shared<kd_tree_t<float, 4>>(4, *_points[pl_idx], nanoflann::KDTreeSingleIndexAdaptorParams());
+        _kd_trees[pl_idx]->buildIndex();
+    }
+    return _kd_trees[pl_idx];
+}
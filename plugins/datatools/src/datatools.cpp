@@ -29,6 +29,7 @@
 #include "MPDCGrid.h"
 #include "MPDCListsConcatenate.h"
 #include "MPIParticleCollector.h"
+#include "MPIParticleRedistributor.h"
 #include "MPIVolumeAggregator.h"
 #include "ModColIRange.h"
 #include "MultiParticleRelister.h"
@@ -159,6 +160,7 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleNeighborhood>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleThermodyn>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::MPIParticleCollector>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::MPIParticleRedistributor>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::MPIVolumeAggregator>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticlesToDensity>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::MPDCListsConcatenate>();
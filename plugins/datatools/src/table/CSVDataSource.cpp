@@ -128,6 +128,8 @@ CSVDataSource::CSVDataSource(void)
 
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetData", &CSVDataSource::getDataCallback);
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetHash", &CSVDataSource::getHashCallback);
+    this->getDataSlot.SetCallbackConcurrencySafe(TableDataCall::ClassName(), "GetData");
+    this->getDataSlot.SetCallbackConcurrencySafe(TableDataCall::ClassName(), "GetHash");
     this->MakeSlotAvailable(&this->getDataSlot);
 }
 
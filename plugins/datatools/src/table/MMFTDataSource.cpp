@@ -66,6 +66,8 @@ MMFTDataSource::MMFTDataSource()
 
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetData", &MMFTDataSource::getDataCallback);
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetHash", &MMFTDataSource::getHashCallback);
+    getDataSlot_.SetCallbackConcurrencySafe(TableDataCall::ClassName(), "GetData");
+    getDataSlot_.SetCallbackConcurrencySafe(TableDataCall::ClassName(), "GetHash");
     MakeSlotAvailable(&getDataSlot_);
 }
 
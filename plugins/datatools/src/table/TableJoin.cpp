@@ -9,6 +9,8 @@
 
 #include <limits>
 
+#include "mmcore/ParallelCalls.h"
+
 using namespace megamol::datatools;
 using namespace megamol::datatools::table;
 using namespace megamol;
@@ -36,6 +38,8 @@ TableJoin::TableJoin(void)
 
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(), TableDataCall::FunctionName(0), &TableJoin::processData);
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(), TableDataCall::FunctionName(1), &TableJoin::getExtent);
+    this->dataOutSlot.SetCallbackConcurrencySafe(TableDataCall::ClassName(), TableDataCall::FunctionName(0));
+    this->dataOutSlot.SetCallbackConcurrencySafe(TableDataCall::ClassName(), TableDataCall::FunctionName(1));
     this->MakeSlotAvailable(&this->dataOutSlot);
 }
 
@@ -64,9 +68,7 @@ bool TableJoin::processData(core::Call& c) {
             return false;
 
         // call getHash before check of frame count
-        if (!(*firstInCall)(1))
-            return false;
-        if (!(*secondInCall)(1))
+        if (!core::ParallelCalls().Add(firstInCall, 1).Add(secondInCall, 1)())
             return false;
 
         // check time compatibility
@@ -81,10 +83,8 @@ bool TableJoin::processData(core::Call& c) {
         firstInCall->SetFrameID(outCall->GetFrameID());
         secondInCall->SetFrameID(outCall->GetFrameID());
 
-        // issue calls
-        if (!(*firstInCall)())
-            return false;
-        if (!(*secondInCall)())
+        // issue calls, the tables are fetched concurrently if their branches allow it
+        if (!core::ParallelCalls().Add(firstInCall, 0).Add(secondInCall, 0)())
             return false;
 
         if (this->firstDataHash != firstInCall->DataHash() || this->secondDataHash != secondInCall->DataHash() ||
@@ -6,6 +6,7 @@
  */
 
 #include "AddClusterColours.h"
+#include "datatools/AbstractManipulator.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmstd_gl/renderer/CallGetTransferFunctionGL.h"
@@ -116,6 +117,7 @@ bool AddClusterColours::getDataCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    datatools::request_whole_frame(*outCall);
 
     if ((*outCall)(0)) {
         uhWriter.SetPosition(0);
@@ -264,6 +266,7 @@ bool AddClusterColours::getExtentCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    datatools::request_whole_frame(*outCall);
 
     if ((*outCall)(1)) {
         outCall->SetUnlocker(NULL, false);
@@ -1,4 +1,5 @@
 #include "ParticleDensityOpacityModule.h"
+#include "datatools/AbstractManipulator.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/EnumParam.h"
@@ -120,6 +121,7 @@ bool ParticleDensityOpacityModule::getDataCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    datatools::request_whole_frame(*outCall);
 
     if ((*outCall)(0)) {
         bool update_data(false);
@@ -225,6 +227,7 @@ bool ParticleDensityOpacityModule::getExtentCallback(core::Call& caller) {
         return false;
 
     *outCall = *inCall;
+    datatools::request_whole_frame(*outCall);
 
     if ((*outCall)(1)) {
         outCall->SetUnlocker(nullptr, false);
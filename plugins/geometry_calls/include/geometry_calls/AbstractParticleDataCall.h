@@ -9,6 +9,9 @@
 
 #include "mmstd/data/AbstractGetData3DCall.h"
 #include "vislib/Array.h"
+#include "vislib/math/Cuboid.h"
+
+#include <vector>
 
 
 namespace megamol::geocalls {
@@ -110,6 +113,145 @@ public:
         this->timeStamp = timeStamp;
     }
 
+    /**
+     * Answer whether only the particles within a region of interest are
+     * requested.
+     *
+     * @return True if a region of interest is set
+     */
+    inline bool HasRegionOfInterest(void) const {
+        return this->hasRoi;
+    }
+
+    /**
+     * Gets the requested region of interest
+     *
+     * @return The region of interest in object space
+     */
+    inline const vislib::math::Cuboid<float>& GetRegionOfInterest(void) const {
+        return this->roi;
+    }
+
+    /**
+     * Requests only the particles within a region of interest. Data sources
+     * may ignore the request or deliver a superset of these particles, so
+     * the data must still be clipped by the caller if needed.
+     *
+     * @param roi The region of interest in object space
+     */
+    void SetRegionOfInterest(const vislib::math::Cuboid<float>& roi) {
+        this->roi = roi;
+        this->hasRoi = true;
+    }
+
+    /**
+     * Requests all particles again.
+     */
+    void ClearRegionOfInterest(void) {
+        this->hasRoi = false;
+    }
+
+    /**
+     * Answer the number of consecutive frames requested together, starting
+     * at the requested frame.
+     *
+     * @return The size of the requested frame window
+     */
+    inline unsigned int GetFrameWindow(void) const {
+        return this->frameWindow;
+    }
+
+    /**
+     * Requests 'count' consecutive frames starting at the requested frame in
+     * one go. Data sources may ignore the request or deliver fewer frames,
+     * e.g. at the end of the data, so the caller must check
+     * 'GetWindowFrameCount' after the data has been fetched. Setting the
+     * window discards the additional frames of the previous answer.
+     *
+     * @param count The number of frames, 1 for the requested frame only
+     */
+    void SetFrameWindow(unsigned int count) {
+        this->frameWindow = (count < 1) ? 1 : count;
+        this->windowFrames.clear();
+    }
+
+    /**
+     * Answer the number of frames delivered, which is at least 1 for the
+     * requested frame itself.
+     *
+     * @return The number of frames delivered
+     */
+    inline unsigned int GetWindowFrameCount(void) const {
+        return static_cast<unsigned int>(this->windowFrames.size()) + 1;
+    }
+
+    /**
+     * Answer the ID of a delivered frame
+     *
+     * @param frame The zero-based index of the frame within the window
+     *
+     * @return The frame ID
+     */
+    inline unsigned int GetWindowFrameID(unsigned int frame) const {
+        return (frame == 0) ? this->FrameID() : this->windowFrames[frame - 1].frameID;
+    }
+
+    /**
+     * Answer the number of particle lists of a delivered frame
+     *
+     * @param frame The zero-based index of the frame within the window
+     *
+     * @return The number of particle lists
+     */
+    inline unsigned int GetWindowParticleListCount(unsigned int frame) const {
+        return (frame == 0) ? this->GetParticleListCount()
+                            : static_cast<unsigned int>(this->windowFrames[frame - 1].lists.Count());
+    }
+
+    /**
+     * Accesses the particles of list item 'idx' of a delivered frame. The
+     * frame 0 is the requested frame, whose lists are also returned by
+     * 'AccessParticles'.
+     *
+     * @param frame The zero-based index of the frame within the window
+     * @param idx The zero-based index of the particle list to return
+     *
+     * @return The requested particle list
+     */
+    const T& AccessWindowParticles(unsigned int frame, unsigned int idx) const {
+        return (frame == 0) ? this->lists[idx] : this->windowFrames[frame - 1].lists[idx];
+    }
+
+    /**
+     * Sets the number of frames delivered. Called by data sources answering
+     * a frame window request; the additional frames are set with
+     * 'SetWindowFrame'.
+     *
+     * @param cnt The number of frames including the requested frame
+     */
+    void SetWindowFrameCount(unsigned int cnt) {
+        this->windowFrames.resize((cnt < 1) ? 0 : (cnt - 1));
+    }
+
+    /**
+     * Sets an additional frame of the window to the particle lists of
+     * 'src'. The data is not copied, so it must stay valid until the call
+     * is unlocked.
+     *
+     * @param frame The zero-based index of the frame within the window, at
+     *              least 1
+     * @param frameID The ID of the frame
+     * @param src The call holding the particle lists of the frame
+     */
+    void SetWindowFrame(unsigned int frame, unsigned int frameID, const AbstractParticleDataCall<T>& src) {
+        WindowFrame& f = this->windowFrames[frame - 1];
+        f.frameID = frameID;
+        f.lists.SetCount(src.lists.Count());
+        for (SIZE_T i = 0; i < src.lists.Count(); i++) {
+            f.lists[i] = src.lists[i];
+        }
+    }
+
     /**
      * Assignment operator.
      * Makes a deep copy of all members. While for data these are only
@@ -129,17 +271,38 @@ protected:
     virtual ~AbstractParticleDataCall(void);
 
 private:
+    /** An additional frame of a frame window */
+    struct WindowFrame {
+        /** The ID of the frame */
+        unsigned int frameID = 0;
+
+        /** Array of lists of particles */
+        vislib::Array<T> lists;
+    };
+
 #ifdef _WIN32
 #pragma warning(disable : 4251)
 #endif /* _WIN32 */
     /** Array of lists of particles */
     vislib::Array<T> lists;
+
+    /** The additional frames of the window following the requested frame */
+    std::vector<WindowFrame> windowFrames;
 #ifdef _WIN32
 #pragma warning(default : 4251)
 #endif /* _WIN32 */
 
     /** The data defined time stamp */
     float timeStamp;
+
+    /** The requested region of interest */
+    vislib::math::Cuboid<float> roi;
+
+    /** Flag whether a region of interest is requested */
+    bool hasRoi;
+
+    /** The number of consecutive frames requested */
+    unsigned int frameWindow;
 };
 
 
@@ -149,7 +312,11 @@ private:
 template<class T>
 AbstractParticleDataCall<T>::AbstractParticleDataCall(void) : AbstractGetData3DCall()
                                                             , lists()
-                                                            , timeStamp(0.0f) {
+                                                            , windowFrames()
+                                                            , timeStamp(0.0f)
+                                                            , roi()
+                                                            , hasRoi(false)
+                                                            , frameWindow(1) {
     // Intentionally empty
 }
 
@@ -161,6 +328,7 @@ template<class T>
 AbstractParticleDataCall<T>::~AbstractParticleDataCall(void) {
     this->Unlock();
     this->lists.Clear();
+    this->windowFrames.clear();
 }
 
 
@@ -175,6 +343,10 @@ AbstractParticleDataCall<T>& AbstractParticleDataCall<T>::operator=(const Abstra
         this->lists[i] = rhs.lists[i];
     }
     this->timeStamp = rhs.timeStamp;
+    this->roi = rhs.roi;
+    this->hasRoi = rhs.hasRoi;
+    this->windowFrames = rhs.windowFrames;
+    this->frameWindow = rhs.frameWindow;
     return *this;
 }
 
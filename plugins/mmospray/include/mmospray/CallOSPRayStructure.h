@@ -43,6 +43,11 @@ static uint32_t voxelDataTypeOSP[] = {2500, 3000, 3500, 6000, 7000};
 
 struct sphereStructure {
     std::shared_ptr<ParticleDataAccessCollection> spheres;
+
+    // The sphere data is shared with OSPRay without copying. These tokens keep the producing frames locked
+    // as long as OSPRay may access them, positions and attributes can stem from different frames.
+    std::shared_ptr<void> geometryLock;
+    std::shared_ptr<void> attributeLock;
 };
 
 struct structuredVolumeStructure {
@@ -101,6 +106,8 @@ struct OSPRayStructureContainer {
     std::shared_ptr<OSPRayTransformationContainer> transformationContainer = nullptr;
     bool transformationChanged = false;
     bool dataChanged;
+    // only colours or the global radius changed, the geometry can be kept
+    bool attributesChanged = false;
     bool materialChanged;
     bool parameterChanged;
     bool isValid = false;
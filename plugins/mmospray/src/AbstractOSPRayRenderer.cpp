@@ -621,6 +621,79 @@ void AbstractOSPRayRenderer::changeTransformation() {
 }
 
 
+void AbstractOSPRayRenderer::setSphereColor(
+    ::ospray::cpp::GeometricModel& model, ParticleDataAccessCollection::Spheres const& spheres) {
+    bool color_found = false;
+    for (auto& attrib : spheres.attributes) {
+
+        // check colorpointer and convert to rgba
+        if (attrib.semantic == ParticleDataAccessCollection::COLOR) {
+            color_found = true;
+            ::ospray::cpp::SharedData colorData;
+            if (attrib.component_type == ParticleDataAccessCollection::ValueType::FLOAT) {
+                auto count = attrib.byte_size / attrib.stride;
+                auto osp_type = OSP_VEC3F;
+                if (attrib.component_cnt == 4)
+                    osp_type = OSP_VEC4F;
+                colorData = ::ospray::cpp::SharedData(&attrib.data[attrib.offset], osp_type, count, attrib.stride);
+            } else {
+                core::utility::log::Log::DefaultLog.WriteError("[OSPRayRenderer][SPHERES] Color type not supported.");
+            }
+            colorData.commit();
+            model.setParam("color", colorData);
+        }
+    }
+
+    if (!color_found) {
+        auto col = rkcommon::math::vec4f(
+            spheres.global_color[0], spheres.global_color[1], spheres.global_color[2], spheres.global_color[3]);
+        model.setParam("color", col);
+    }
+}
+
+bool AbstractOSPRayRenderer::changeAttributes() {
+    bool changed = false;
+
+    for (auto& entry : this->_structureMap) {
+        auto const& element = entry.second;
+        if (!element.attributesChanged || element.dataChanged || element.type != structureTypeEnum::GEOMETRY ||
+            element.geometryType != geometryTypeEnum::SPHERES)
+            continue;
+        auto& container = std::get<sphereStructure>(element.structure);
+        auto reps = _sphereRepresentations.find(entry.first);
+        if (container.spheres == nullptr || reps == _sphereRepresentations.end())
+            continue;
+
+        // the geometry keeps sharing the positions, only colours and the global radius are re-committed
+        for (auto& spheres : container.spheres->accessSphereCollections()) {
+            auto rep = reps->second.find(spheres.first);
+            if (rep == reps->second.end())
+                continue;
+            auto& geo = std::get<::ospray::cpp::Geometry>(_baseStructures[entry.first].structures[rep->second.index]);
+            auto& model = _geometricModels[entry.first][rep->second.index];
+
+            bool radius_found = false;
+            for (auto& attrib : spheres.second.attributes) {
+                radius_found = radius_found || attrib.semantic == ParticleDataAccessCollection::RADIUS;
+            }
+            if (!radius_found && rep->second.globalRadius != spheres.second.global_radius) {
+                geo.setParam("radius", static_cast<float>(spheres.second.global_radius));
+                geo.commit();
+                rep->second.globalRadius = spheres.second.global_radius;
+            }
+
+            setSphereColor(model, spheres.second);
+            model.commit();
+        }
+        _sharedDataLocks[entry.first] = {container.geometryLock, container.attributeLock};
+        _groups[entry.first].commit();
+        changed = true;
+    }
+
+    return changed;
+}
+
+
 bool AbstractOSPRayRenderer::generateRepresentations() {
 
     bool returnValue = true;
@@ -664,6 +737,9 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
             _clippingModels[entry.first].clear();
             _clippingModels.erase(entry.first);
 
+            _sphereRepresentations.erase(entry.first);
+            _sharedDataLocks.erase(entry.first);
+
             //if (_groups[entry.first]) {
             //    ospRelease(_groups[entry.first].handle());
             //}
@@ -780,20 +856,22 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
                 }
 
                 _numCreateGeo = container.spheres->accessSphereCollections().size();
+                _sharedDataLocks[entry.first] = {container.geometryLock, container.attributeLock};
 
                 for (auto& spheres : container.spheres->accessSphereCollections()) {
+                    _sphereRepresentations[entry.first][spheres.first] = {
+                        _baseStructures[entry.first].size(), spheres.second.global_radius};
                     _baseStructures[entry.first].emplace_back(
                         ::ospray::cpp::Geometry("sphere"), structureTypeEnum::GEOMETRY);
 
                     bool radius_found = false;
-                    bool color_found = false;
 
                     for (auto& attrib : spheres.second.attributes) {
 
                         if (attrib.semantic == ParticleDataAccessCollection::POSITION) {
                             auto count = attrib.byte_size / attrib.stride;
 
-                            auto vertexData = ::ospray::cpp::CopiedData(attrib.data, OSP_VEC3F, count, attrib.stride);
+                            auto vertexData = ::ospray::cpp::SharedData(attrib.data, OSP_VEC3F, count, attrib.stride);
                             vertexData.commit();
                             std::get<::ospray::cpp::Geometry>(_baseStructures[entry.first].structures.back())
                                 .setParam("sphere.position", vertexData);
@@ -820,33 +898,7 @@ bool AbstractOSPRayRenderer::generateRepresentations() {
                     _geometricModels[entry.first].emplace_back(::ospray::cpp::GeometricModel(
                         std::get<::ospray::cpp::Geometry>(_baseStructures[entry.first].structures.back())));
 
-                    for (auto& attrib : spheres.second.attributes) {
-
-                        // check colorpointer and convert to rgba
-                        if (attrib.semantic == ParticleDataAccessCollection::COLOR) {
-                            color_found = true;
-                            ::ospray::cpp::SharedData colorData;
-                            if (attrib.component_type == ParticleDataAccessCollection::ValueType::FLOAT) {
-                                auto count = attrib.byte_size / attrib.stride;
-                                auto osp_type = OSP_VEC3F;
-                                if (attrib.component_cnt == 4)
-                                    osp_type = OSP_VEC4F;
-                                colorData = ::ospray::cpp::SharedData(
-                                    &attrib.data[attrib.offset], osp_type, count, attrib.stride);
-                            } else {
-                                core::utility::log::Log::DefaultLog.WriteError(
-                                    "[OSPRayRenderer][SPHERES] Color type not supported.");
-                            }
-                            colorData.commit();
-                            _geometricModels[entry.first].back().setParam("color", colorData);
-                        }
-                    }
-
-                    if (!color_found) {
-                        auto col = rkcommon::math::vec4f(spheres.second.global_color[0], spheres.second.global_color[1],
-                            spheres.second.global_color[2], spheres.second.global_color[3]);
-                        _geometricModels[entry.first].back().setParam("color", col);
-                    }
+                    setSphereColor(_geometricModels[entry.first].back(), spheres.second);
 
 
                 } // end for num geometies
@@ -149,6 +149,13 @@ protected:
 
     void createInstances();
 
+    /**
+     * Re-commits colours and global radii of sphere structures whose positions did not change.
+     *
+     * @return True if any structure was updated
+     */
+    bool changeAttributes();
+
     void changeMaterial();
 
     void changeTransformation();
@@ -203,6 +210,16 @@ protected:
     std::map<CallOSPRayStructure*, ::ospray::cpp::Instance> _instances;
     std::map<CallOSPRayStructure*, ::ospray::cpp::Material> _materials;
 
+    // location of every sphere collection within the structure vectors
+    struct sphereRepresentation {
+        size_t index;
+        double globalRadius;
+    };
+    std::map<CallOSPRayStructure*, std::map<std::string, sphereRepresentation>> _sphereRepresentations;
+
+    // keeps the frames shared with OSPRay locked
+    std::map<CallOSPRayStructure*, std::vector<std::shared_ptr<void>>> _sharedDataLocks;
+
 
     // Structure map
     OSPRayStrcutrureMap _structureMap;
@@ -211,6 +228,8 @@ protected:
 
     void fillLightArray(std::array<float, 3> eyeDir);
 
+    void setSphereColor(::ospray::cpp::GeometricModel& model, ParticleDataAccessCollection::Spheres const& spheres);
+
     long long int _ispcLimit = 1ULL << 30;
     long long int _numCreateGeo;
 
@@ -109,6 +109,7 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
         return false;
     // check if data has changed
     _data_has_changed = false;
+    _attributes_have_changed = false;
     _material_has_changed = false;
     _transformation_has_changed = false;
     _clipping_geo_changed = false;
@@ -117,6 +118,9 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
         if (structure.dataChanged) {
             _data_has_changed = true;
         }
+        if (structure.attributesChanged) {
+            _attributes_have_changed = true;
+        }
         if (structure.materialChanged) {
             _material_has_changed = true;
         }
@@ -194,14 +198,16 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
     _camera->commit();
 
     // if nothing changes, the image is rendered multiple times
-    if (_data_has_changed || _material_has_changed || _light_has_changed || _cam_has_changed || _renderer_has_changed ||
-        _transformation_has_changed || _clipping_geo_changed ||
+    if (_data_has_changed || _attributes_have_changed || _material_has_changed || _light_has_changed ||
+        _cam_has_changed || _renderer_has_changed || _transformation_has_changed || _clipping_geo_changed ||
         !(this->_accumulateSlot.Param<core::param::BoolParam>()->Value()) ||
         _frameID != static_cast<size_t>(cr.Time()) || this->InterfaceIsDirty()) {
 
 
         auto cam_pose = _cam.get<Camera::Pose>();
         std::array<float, 3> eyeDir = {cam_pose.direction.x, cam_pose.direction.y, cam_pose.direction.z};
+        // colour or radius updates keep the geometry and thus avoid rebuilding the acceleration structure
+        const bool attributes_updated = _attributes_have_changed && this->changeAttributes();
         if (_data_has_changed || _frameID != static_cast<size_t>(cr.Time()) || _renderer_has_changed) {
             // || this->InterfaceIsDirty()) {
             if (!this->generateRepresentations())
@@ -222,6 +228,12 @@ bool OSPRayRenderer::Render(megamol::core::view::CallRender3D& cr) {
             const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
                 "[OSPRayRenderer] Commiting World took: %d microseconds", duration);
+        } else if (attributes_updated) {
+            this->createInstances();
+            std::vector<::ospray::cpp::Instance> instanceArray;
+            std::transform(_instances.begin(), _instances.end(), std::back_inserter(instanceArray), second(_instances));
+            _world->setParam("instance", ::ospray::cpp::CopiedData(instanceArray));
+            _world->commit();
         }
         if (_material_has_changed && !_data_has_changed) {
             this->changeMaterial();
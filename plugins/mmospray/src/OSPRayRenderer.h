@@ -99,6 +99,7 @@ private:
 
     // rendering conditions
     bool _data_has_changed;
+    bool _attributes_have_changed;
     bool _material_has_changed;
     bool _light_has_changed;
     bool _cam_has_changed;
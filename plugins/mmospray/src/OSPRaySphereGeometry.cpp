@@ -8,13 +8,46 @@
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/Call.h"
 #include "mmcore/utility/log/Log.h"
+#include <cstring>
 
 using namespace megamol::ospray;
 
 
+namespace {
+
+/** Moves the unlocker of 'call' into a token that unlocks the frame when the last reference is released */
+std::shared_ptr<void> takeFrameLock(megamol::geocalls::MultiParticleDataCall& call) {
+    auto unlocker = call.GetUnlocker();
+    call.SetUnlocker(nullptr, false);
+    return std::shared_ptr<void>(nullptr, [unlocker](void*) {
+        if (unlocker != nullptr) {
+            unlocker->Unlock();
+            delete unlocker;
+        }
+    });
+}
+
+/** FNV-1a over 32 bit words of the first 'size' bytes of every record */
+uint64_t hashRecords(uint8_t const* data, size_t count, size_t stride, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t const* rec = data + i * stride;
+        for (size_t b = 0; b + sizeof(uint32_t) <= size; b += sizeof(uint32_t)) {
+            uint32_t word;
+            std::memcpy(&word, rec + b, sizeof(uint32_t));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
+
 OSPRaySphereGeometry::OSPRaySphereGeometry(void)
         : AbstractOSPRayStructure()
-        , getDataSlot("getdata", "Connects to the data source") {
+        , getDataSlot("getdata", "Connects to the data source")
+        , geometryLocked(false) {
 
     this->getDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->getDataSlot);
@@ -46,30 +79,42 @@ bool OSPRaySphereGeometry::readData(megamol::core::Call& call) {
     if (!(*cd)(0))
         return false;
 
+    this->structureContainer.attributesChanged = false;
     auto interface_dirty = this->InterfaceIsDirty();
     if (this->datahash != cd->DataHash() || this->time != os->getTime() || interface_dirty) {
         this->datahash = cd->DataHash();
         this->time = os->getTime();
-        this->structureContainer.dataChanged = true;
     } else {
+        // OSPRay still shares the memory of the frame locked previously
+        cd->Unlock();
         return true;
     }
 
-    if (cd->GetParticleListCount() == 0)
+    if (cd->GetParticleListCount() == 0) {
+        cd->Unlock();
         return false;
+    }
+
+    // the particle memory is shared with OSPRay, so the frame stays locked as long as OSPRay uses it
+    const bool frameLocked = cd->GetUnlocker() != nullptr;
+    auto frameLock = takeFrameLock(*cd);
 
     sphereStructure ss;
     ss.spheres = std::make_shared<ParticleDataAccessCollection>();
 
     const auto plist_count = cd->GetParticleListCount();
+    std::vector<PositionState> positions(plist_count);
+    bool geometryChanged = interface_dirty || this->positionState.size() != plist_count;
     for (int i = 0; i < plist_count; ++i) {
         geocalls::MultiParticleDataCall::Particles& parts = cd->AccessParticles(i);
 
         std::vector<ParticleDataAccessCollection::VertexAttribute> attrib;
 
         unsigned int partCount = parts.GetCount();
-        if (partCount == 0)
+        if (partCount == 0) {
+            geometryChanged = geometryChanged || this->positionState[i].count != 0;
             continue;
+        }
 
         int vertex_stride = 3;
         size_t vertex_byte_stride = parts.GetVertexDataStride();
@@ -77,6 +122,20 @@ bool OSPRaySphereGeometry::readData(megamol::core::Call& call) {
                                  ? geocalls::MultiParticleDataCall::Particles::VertexDataSize[parts.GetVertexDataType()]
                                  : vertex_byte_stride;
 
+        // the geometry can only be kept if the positions did not change and the shared memory is still valid
+        auto& pos = positions[i];
+        pos.data = parts.GetVertexData();
+        pos.count = partCount;
+        pos.type = parts.GetVertexDataType();
+        pos.stride = vertex_byte_stride;
+        pos.hash = hashRecords(static_cast<const uint8_t*>(pos.data), partCount, vertex_byte_stride,
+            geocalls::MultiParticleDataCall::Particles::VertexDataSize[parts.GetVertexDataType()]);
+        if (!geometryChanged) {
+            auto const& old = this->positionState[i];
+            geometryChanged = old.count != pos.count || old.type != pos.type || old.stride != pos.stride ||
+                              old.hash != pos.hash || (old.data != pos.data && !this->geometryLocked);
+        }
+
         size_t color_byte_stride = parts.GetColourDataStride();
         color_byte_stride = color_byte_stride == 0
                                 ? geocalls::MultiParticleDataCall::Particles::ColorDataSize[parts.GetColourDataType()]
@@ -129,6 +188,18 @@ bool OSPRaySphereGeometry::readData(megamol::core::Call& call) {
             g_col[0] / 255.0f, g_col[1] / 255.0f, g_col[2] / 255.0f, g_col[3] / 255.0f};
         ss.spheres->addSphereCollection(identifier, attrib, parts.GetGlobalRadius(), global_color);
     }
+    ss.attributeLock = frameLock;
+    if (geometryChanged) {
+        this->positionState = std::move(positions);
+        this->geometryLock = frameLock;
+        this->geometryLocked = frameLocked;
+        this->structureContainer.dataChanged = true;
+    } else {
+        // positions are still read from the frame the geometry was built from
+        this->structureContainer.attributesChanged = true;
+    }
+    ss.geometryLock = this->geometryLock;
+
     // Write stuff into the structureContainer
     this->structureContainer.type = structureTypeEnum::GEOMETRY;
     this->structureContainer.geometryType = geometryTypeEnum::SPHERES;
@@ -147,7 +218,11 @@ bool OSPRaySphereGeometry::create() {
     return true;
 }
 
-void OSPRaySphereGeometry::release() {}
+void OSPRaySphereGeometry::release() {
+    this->structureContainer.structure = sphereStructure();
+    this->geometryLock.reset();
+    this->positionState.clear();
+}
 
 /*
 ospray::OSPRaySphereGeometry::InterfaceIsDirty()
@@ -7,6 +7,8 @@
 
 #include "mmcore/CallerSlot.h"
 #include "mmospray/AbstractOSPRayStructure.h"
+#include <memory>
+#include <vector>
 
 namespace megamol {
 namespace ospray {
@@ -59,6 +61,25 @@ protected:
 
     /** The call for data */
     core::CallerSlot getDataSlot;
+
+private:
+    /** Layout and content hash of the positions of one particle list */
+    struct PositionState {
+        const void* data = nullptr;
+        size_t count = 0;
+        int type = 0;
+        size_t stride = 0;
+        uint64_t hash = 0;
+    };
+
+    /** Positions the current geometry was built from */
+    std::vector<PositionState> positionState;
+
+    /** Lock of the frame holding the positions shared with OSPRay */
+    std::shared_ptr<void> geometryLock;
+
+    /** Whether 'geometryLock' actually locks data, i.e. the positions stay valid even if the source moves on */
+    bool geometryLocked;
 };
 
 } // namespace ospray
@@ -4,10 +4,18 @@
  */
 
 #include "Pkd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <stdint.h>
 #include <thread>
 
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+
 #define POS(idx, dim) pos(idx, dim)
 
 using namespace megamol;
@@ -15,12 +23,18 @@ using namespace megamol;
 
 ospray::PkdBuilder::PkdBuilder()
         : megamol::datatools::AbstractParticleManipulator("outData", "inData")
+        , cacheSizeSlot("cacheSize", "Size of the in-memory frame cache in MegaBytes (0 disables caching)")
+        , cacheDirectorySlot("cacheDirectory", "Directory for persisting built trees (empty disables persistence)")
         , inDataHash(std::numeric_limits<size_t>::max())
         , outDataHash(0)
-/*, numParticles(0)
-, numInnerNodes(0)*/
-{
-    //model = std::make_shared<ParticleModel>();
+        , frameID(0)
+        , cacheBytes(0) {
+    this->cacheSizeSlot << new core::param::IntParam(1024, 0);
+    this->MakeSlotAvailable(&this->cacheSizeSlot);
+
+    this->cacheDirectorySlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_Directory_ToBeCreated);
+    this->MakeSlotAvailable(&this->cacheDirectorySlot);
 }
 
 ospray::PkdBuilder::~PkdBuilder() {
@@ -30,44 +44,222 @@ ospray::PkdBuilder::~PkdBuilder() {
 bool ospray::PkdBuilder::manipulateData(
     geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData) {
 
-    if ((inData.DataHash() != inDataHash) || (inData.FrameID() != frameID)) {
+    if (this->cacheSizeSlot.IsDirty()) {
+        this->cacheSizeSlot.ResetDirty();
+        this->insertEntry(CacheKey(this->inDataHash, this->frameID), nullptr);
+    }
+
+    if ((inData.DataHash() != inDataHash) || (inData.FrameID() != frameID) || !this->current) {
         inDataHash = inData.DataHash();
         //outDataHash++;
         frameID = inData.FrameID();
 
-        outData = inData;
+        const CacheKey key(inDataHash, frameID);
+        auto it = this->cacheIndex.find(key);
+        if (it != this->cacheIndex.end()) {
+            // revisited frame: move to the front of the cache
+            this->cache.splice(this->cache.begin(), this->cache, it->second);
+            this->current = it->second->second;
+        } else {
+            const auto dir = this->cacheDirectorySlot.Param<core::param::FilePathParam>()->Value();
+            std::filesystem::path path;
+            this->current = nullptr;
+            uint64_t print = 0;
+            if (!dir.empty()) {
+                print = fingerprint(inData);
+                char name[32];
+                snprintf(name, sizeof(name), "pkd_%016llx.pkd", static_cast<unsigned long long>(print));
+                path = dir / name;
+                std::error_code ec;
+                std::filesystem::create_directories(dir, ec);
+                this->current = this->loadEntry(path, print);
+            }
+            if (!this->current) {
+                this->current = this->buildEntry(inData);
+                if (!path.empty() && !this->storeEntry(path, *this->current, print)) {
+                    core::utility::log::Log::DefaultLog.WriteWarn(
+                        "PkdBuilder: Unable to write \"%s\"", path.generic_u8string().c_str());
+                }
+            }
+            this->insertEntry(key, this->current);
+        }
 
-        models.resize(inData.GetParticleListCount());
+        outData = inData;
 
         for (unsigned int i = 0; i < inData.GetParticleListCount(); ++i) {
-            auto& parts = inData.AccessParticles(i);
             auto& out = outData.AccessParticles(i);
+            auto& model = this->current->models[i];
+
+            out.SetCount(model.position.size());
+            if (model.position.empty()) {
+                out.SetVertexData(megamol::geocalls::SimpleSphericalParticles::VERTDATA_NONE, nullptr);
+                out.SetColourData(megamol::geocalls::SimpleSphericalParticles::COLDATA_NONE, nullptr);
+            } else {
+                out.SetVertexData(
+                    megamol::geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ, &model.position[0].x, 16);
+                out.SetColourData(
+                    megamol::geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA, &model.position[0].w, 16);
+            }
+            out.SetGlobalRadius(this->current->radii[i]);
+        }
+
+        outData.SetUnlocker(nullptr, false);
+    }
+
+    return true;
+}
+
+
+std::shared_ptr<ospray::PkdBuilder::CacheEntry> ospray::PkdBuilder::buildEntry(
+    geocalls::MultiParticleDataCall& inData) const {
+    auto entry = std::make_shared<CacheEntry>();
+    entry->models.resize(inData.GetParticleListCount());
+    entry->radii.resize(inData.GetParticleListCount());
 
-            // empty the model
-            // this->model->position.clear();
-            models[i].position.clear();
+    for (unsigned int i = 0; i < inData.GetParticleListCount(); ++i) {
+        auto& parts = inData.AccessParticles(i);
 
-            // put data the data into the model
-            // and build the pkd tree
-            // this->model->fill(parts);
-            models[i].fill(parts);
-            // this->build();
+        // put data the data into the model
+        // and build the pkd tree
+        entry->models[i].fill(parts);
+        entry->radii[i] = parts.GetGlobalRadius();
+        if (!entry->models[i].position.empty()) {
             Pkd pkd;
-            pkd.model = &models[i];
+            pkd.model = &entry->models[i];
             pkd.build();
+        }
+        entry->bytes += entry->models[i].position.size() * sizeof(rkcommon::math::vec4f);
+    }
+    return entry;
+}
 
-            out.SetCount(parts.GetCount());
-            out.SetVertexData(
-                megamol::geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ, &models[i].position[0].x, 16);
-            out.SetColourData(
-                megamol::geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA, &models[i].position[0].w, 16);
-            out.SetGlobalRadius(parts.GetGlobalRadius());
+
+uint64_t ospray::PkdBuilder::fingerprint(geocalls::MultiParticleDataCall& inData) {
+    // FNV-1a
+    auto add = [](uint64_t& hash, void const* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t const*>(data)[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    constexpr uint64_t basis = 14695981039346656037ULL;
+    constexpr int64_t blockSize = 1 << 16;
+
+    uint64_t hash = basis;
+    const unsigned int frame = inData.FrameID();
+    const unsigned int listCount = inData.GetParticleListCount();
+    add(hash, &frame, sizeof(frame));
+    add(hash, &listCount, sizeof(listCount));
+    for (unsigned int i = 0; i < listCount; ++i) {
+        auto& parts = inData.AccessParticles(i);
+        const int64_t count = static_cast<int64_t>(parts.GetCount());
+        const float radius = parts.GetGlobalRadius();
+        add(hash, &count, sizeof(count));
+        add(hash, &radius, sizeof(radius));
+
+        // all values the trees are built from, i.e. the positions and colours as read by 'ParticleModel::fill'
+        auto const& store = parts.GetParticleStore();
+        std::vector<uint64_t> blocks((count + blockSize - 1) / blockSize, basis);
+#pragma omp parallel for
+        for (int64_t b = 0; b < static_cast<int64_t>(blocks.size()); ++b) {
+            const int64_t end = std::min(count, (b + 1) * blockSize);
+            for (int64_t p = b * blockSize; p < end; ++p) {
+                const float position[3] = {
+                    store.GetXAcc()->Get_f(p), store.GetYAcc()->Get_f(p), store.GetZAcc()->Get_f(p)};
+                const uint8_t colour[4] = {store.GetCRAcc()->Get_u8(p), store.GetCGAcc()->Get_u8(p),
+                    store.GetCBAcc()->Get_u8(p), store.GetCAAcc()->Get_u8(p)};
+                add(blocks[b], position, sizeof(position));
+                add(blocks[b], colour, sizeof(colour));
+            }
         }
+        add(hash, blocks.data(), blocks.size() * sizeof(uint64_t));
+    }
+    return hash;
+}
 
-        outData.SetUnlocker(nullptr, false);
+
+std::shared_ptr<ospray::PkdBuilder::CacheEntry> ospray::PkdBuilder::loadEntry(
+    std::filesystem::path const& path, uint64_t fingerprint) const {
+    std::error_code ec;
+    const uint64_t fileSize = std::filesystem::file_size(path, ec);
+    std::ifstream in(path, std::ios::binary);
+    if (ec || !in)
+        return nullptr;
+
+    char magic[6];
+    uint16_t version = 0;
+    uint64_t storedFingerprint = 0;
+    uint32_t listCount = 0;
+    in.read(magic, 6);
+    in.read(reinterpret_cast<char*>(&version), 2);
+    in.read(reinterpret_cast<char*>(&storedFingerprint), 8);
+    in.read(reinterpret_cast<char*>(&listCount), 4);
+    if (!in || std::memcmp(magic, "MMPKD", 6) != 0 || version != 101 || storedFingerprint != fingerprint)
+        return nullptr;
+
+    // the counts must fit the file, so corrupt files do not trigger huge allocations
+    uint64_t remaining = fileSize - std::min<uint64_t>(fileSize, 20);
+    if (listCount > remaining / 12)
+        return nullptr;
+
+    auto entry = std::make_shared<CacheEntry>();
+    entry->models.resize(listCount);
+    entry->radii.resize(listCount);
+    for (uint32_t i = 0; i < listCount; ++i) {
+        uint64_t count = 0;
+        in.read(reinterpret_cast<char*>(&entry->radii[i]), 4);
+        in.read(reinterpret_cast<char*>(&count), 8);
+        if (!in || remaining < 12)
+            return nullptr;
+        remaining -= 12;
+        if (count > remaining / sizeof(rkcommon::math::vec4f))
+            return nullptr;
+        remaining -= count * sizeof(rkcommon::math::vec4f);
+        entry->models[i].position.resize(count);
+        in.read(reinterpret_cast<char*>(entry->models[i].position.data()), count * sizeof(rkcommon::math::vec4f));
+        entry->bytes += count * sizeof(rkcommon::math::vec4f);
     }
+    return in ? entry : nullptr;
+}
 
-    return true;
+
+bool ospray::PkdBuilder::storeEntry(
+    std::filesystem::path const& path, CacheEntry const& entry, uint64_t fingerprint) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    const uint16_t version = 101;
+    const uint32_t listCount = static_cast<uint32_t>(entry.models.size());
+    out.write("MMPKD", 6);
+    out.write(reinterpret_cast<char const*>(&version), 2);
+    out.write(reinterpret_cast<char const*>(&fingerprint), 8);
+    out.write(reinterpret_cast<char const*>(&listCount), 4);
+    for (uint32_t i = 0; i < listCount; ++i) {
+        const uint64_t count = entry.models[i].position.size();
+        out.write(reinterpret_cast<char const*>(&entry.radii[i]), 4);
+        out.write(reinterpret_cast<char const*>(&count), 8);
+        out.write(
+            reinterpret_cast<char const*>(entry.models[i].position.data()), count * sizeof(rkcommon::math::vec4f));
+    }
+    return static_cast<bool>(out);
+}
+
+
+void ospray::PkdBuilder::insertEntry(CacheKey const& key, std::shared_ptr<CacheEntry> entry) {
+    if (entry) {
+        this->cache.emplace_front(key, entry);
+        this->cacheIndex[key] = this->cache.begin();
+        this->cacheBytes += entry->bytes;
+    }
+
+    // the current frame is referenced by 'current' in any case, so it is never freed while in use
+    const size_t limit = static_cast<size_t>(this->cacheSizeSlot.Param<core::param::IntParam>()->Value()) << 20;
+    while (!this->cache.empty() && this->cacheBytes > limit) {
+        this->cacheBytes -= this->cache.back().second->bytes;
+        this->cacheIndex.erase(this->cache.back().first);
+        this->cache.pop_back();
+    }
 }
 
 
@@ -130,6 +322,10 @@ void ospray::Pkd::build() {
     }
     // PRINT(numLevels);
 
+    // spawn about twice as many subtree builds as there are cores for load balancing
+    const size_t numCores = std::max(std::thread::hardware_concurrency(), 1u);
+    parallelDepth = static_cast<size_t>(std::ceil(std::log2(static_cast<double>(numCores)))) + 1;
+
     const rkcommon::math::box3f& bounds = model->getBounds();
     /*std::cout << "#osp:pkd: bounds of model " << bounds << std::endl;
     std::cout << "#osp:pkd: number of input particles " << numParticles << std::endl;*/
@@ -241,7 +437,8 @@ void ospray::Pkd::buildRec(const size_t nodeID, const rkcommon::math::box3f& bou
 
     lBounds.upper[dim] = rBounds.lower[dim] = pos(nodeID, dim);
 
-    if ((numLevels - depth) > 20) {
+    // subtrees of less than 2^14 particles are not worth a thread
+    if (depth < parallelDepth && (numLevels - depth) > 14) {
         std::thread lThread(&pkdBuildThread, new PKDBuildJob(this, leftChildOf(nodeID), lBounds, depth + 1));
         buildRec(rightChildOf(nodeID), rBounds, depth + 1);
         lThread.join();
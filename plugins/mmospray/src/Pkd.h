@@ -8,9 +8,14 @@
 #include "datatools/AbstractParticleManipulator.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CallerSlot.h"
+#include "mmcore/param/ParamSlot.h"
 #include "rkcommon/math/box.h"
 #include "rkcommon/math/vec.h"
+#include <filesystem>
+#include <list>
 #include <map>
+#include <memory>
+#include <utility>
 
 
 #include "pkd/ParticleModel.h"
@@ -49,13 +54,48 @@ protected:
     virtual bool manipulateData(geocalls::MultiParticleDataCall& outData, geocalls::MultiParticleDataCall& inData);
 
 private:
+    /** The sorted particle lists of one frame */
+    struct CacheEntry {
+        std::vector<ParticleModel> models;
+        std::vector<float> radii;
+        size_t bytes = 0;
+    };
+
+    /** Key of the frame cache: data hash and frame ID of the incoming data */
+    using CacheKey = std::pair<size_t, unsigned int>;
+
+    /** Builds the trees of all particle lists of 'inData' */
+    std::shared_ptr<CacheEntry> buildEntry(geocalls::MultiParticleDataCall& inData) const;
+
+    /** Answers a hash over the frame ID, list layout and the positions and colours of all particles of 'inData' */
+    static uint64_t fingerprint(geocalls::MultiParticleDataCall& inData);
+
+    /** Loads a persisted frame, answers nullptr unless it was stored with 'fingerprint' and is intact */
+    std::shared_ptr<CacheEntry> loadEntry(std::filesystem::path const& path, uint64_t fingerprint) const;
+
+    bool storeEntry(std::filesystem::path const& path, CacheEntry const& entry, uint64_t fingerprint) const;
+
+    /** Inserts 'entry' into the frame cache and evicts the least recently used frames exceeding the cache size */
+    void insertEntry(CacheKey const& key, std::shared_ptr<CacheEntry> entry);
+
+    /** Size of the in-memory frame cache in MegaBytes */
+    core::param::ParamSlot cacheSizeSlot;
+
+    /** Optional directory in which built trees are persisted */
+    core::param::ParamSlot cacheDirectorySlot;
+
     size_t inDataHash;
     size_t outDataHash;
     unsigned int frameID;
     unsigned int vertexLength;
 
-    //std::shared_ptr<ParticleModel> model;
-    std::vector<ParticleModel> models;
+    /** The frame currently handed out to the outgoing call */
+    std::shared_ptr<CacheEntry> current;
+
+    /** Recently built frames, most recently used first */
+    std::list<std::pair<CacheKey, std::shared_ptr<CacheEntry>>> cache;
+    std::map<CacheKey, decltype(cache)::iterator> cacheIndex;
+    size_t cacheBytes;
 };
 
 struct Pkd {
@@ -65,6 +105,9 @@ struct Pkd {
     size_t numInnerNodes;
     size_t numLevels;
 
+    //! subtrees above this depth are built by separate threads
+    size_t parallelDepth;
+
     __forceinline size_t isInnerNode(const size_t nodeID) const {
         return nodeID < numInnerNodes;
     }
@@ -80,7 +80,12 @@ void megamol::ospray::ParticleModel::fill(geocalls::SimpleSphericalParticles par
     auto const& bAcc = parStore.GetCBAcc();
     auto const& aAcc = parStore.GetCAAcc();
 
-    for (size_t loop = 0; loop < parts.GetCount(); ++loop) {
+    const size_t offset = this->position.size();
+    const int64_t count = static_cast<int64_t>(parts.GetCount());
+    this->position.resize(offset + count);
+
+#pragma omp parallel for
+    for (int64_t loop = 0; loop < count; ++loop) {
 
         rkcommon::math::vec3f pos;
 
@@ -97,6 +102,6 @@ void megamol::ospray::ParticleModel::fill(geocalls::SimpleSphericalParticles par
 
         float const color = encodeColorToFloat(col);
 
-        this->position.emplace_back(pos, color);
+        this->position[offset + loop] = rkcommon::math::vec4f(pos, color);
     }
 }
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 #include "mmcore/Module.h"
 #include "vislib/sys/CriticalSection.h"
@@ -141,6 +144,17 @@ protected:
      */
     virtual void loadFrame(Frame* frame, unsigned int idx) = 0;
 
+    /**
+     * Answer how many frames the loader thread may load at the same time.
+     * If this is larger than one, 'loadFrame' is called concurrently for
+     * different frames and must be thread-safe.
+     *
+     * @return The maximum number of concurrent calls to 'loadFrame'.
+     */
+    virtual unsigned int maxConcurrentFrameLoads() const {
+        return 1;
+    }
+
     /**
      * Requests the frame from the frame cache, which is the best for the
      * requested frame index. Must not be called before the frame cache
@@ -159,6 +173,24 @@ protected:
     Frame* requestLockedFrame(unsigned int idx);
     Frame* requestLockedFrame(unsigned int idx, bool forceIdx);
 
+    /**
+     * Requests 'count' consecutive frames starting at 'idx' together, e.g.
+     * for filters working on a temporal window. Waits until the frames of
+     * the window are loaded and marks them with state 'STATE_INUSE'. You
+     * must call 'Unlock' on each returned frame. The window is shortened at
+     * the end of the dataset and to leave at least one cache buffer to the
+     * loader thread, which prefetches the frames following the window. If
+     * the loader thread makes no progress on the window, e.g. because other
+     * callers hold the buffers, the frames loaded so far are returned.
+     *
+     * @param idx The index of the first frame of the window.
+     * @param count The number of frames requested.
+     *
+     * @return The consecutive frames at the start of the window in order,
+     *         or an empty vector if not even the first one is loaded.
+     */
+    std::vector<Frame*> requestLockedFrames(unsigned int idx, unsigned int count);
+
     /**
      * Resets the whole module to the same state as directly after the
      * 'ctor' returned. You must call 'setFrameCount' and 'initFrameCache'
@@ -193,6 +225,22 @@ private:
      */
     void unlock(Frame* frame);
 
+    /**
+     * Answer the number of loading rounds the loader thread has finished.
+     *
+     * @return The number of finished loading rounds.
+     */
+    unsigned int loadedRounds();
+
+    /**
+     * Waits until the loader thread has finished another loading round
+     * after 'round', or at most 100 ms.
+     *
+     * @param round The result of 'loadedRounds' before the cache was
+     *              searched for the frames to wait for.
+     */
+    void waitForLoadedRound(unsigned int round);
+
 #ifdef _WIN32
 #pragma warning(disable : 4251)
 #endif /* _WIN32 */
@@ -220,6 +268,15 @@ private:
 
     /** TODO: The Mueller shalt document his stuff */
     std::atomic_bool isRunning;
+
+    /** The number of loading rounds the loader thread has finished */
+    unsigned int loadRound;
+
+    /** The lock guarding 'loadRound' */
+    std::mutex loadRoundLock;
+
+    /** Signalled whenever the loader thread has finished a loading round */
+    std::condition_variable loadRoundSignal;
 #ifdef _WIN32
 #pragma warning(default : 4251)
 #endif /* _WIN32 */
@@ -9,7 +9,9 @@
 #include "mmcore/utility/log/Log.h"
 #include "vislib/assert.h"
 #include "vislib/sys/Thread.h"
+#include <algorithm>
 #include <chrono>
+#include <vector>
 
 using namespace megamol::core;
 
@@ -26,7 +28,8 @@ view::AnimDataModule::AnimDataModule(void)
         , frameCache(NULL)
         , cacheSize(0)
         , stateLock()
-        , lastRequested(0) {
+        , lastRequested(0)
+        , loadRound(0) {
     this->isRunning.store(false);
 }
 
@@ -161,6 +164,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
  * view::AnimDataModule::requestLockedFrame
  */
 view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned int idx, bool forceIdx) {
+    unsigned int round = this->loadedRounds();
     Frame* f = this->requestLockedFrame(idx);
     if ((f->FrameNumber() == idx) || (!forceIdx))
         return f;
@@ -170,6 +174,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
     if (idx >= this->frameCnt) {
         idx = this->frameCnt - 1;
         f->Unlock();
+        round = this->loadedRounds();
         f = this->requestLockedFrame(idx);
     }
 
@@ -179,7 +184,8 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
 
         // HAZARD: This will wait for all eternity if the requested frame is never loaded
 
-        vislib::sys::Thread::Sleep(100); // time for the loader thread to load
+        this->waitForLoadedRound(round); // time for the loader thread to load
+        round = this->loadedRounds();
         f = this->requestLockedFrame(idx);
     }
 
@@ -187,6 +193,71 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
 }
 
 
+/*
+ * view::AnimDataModule::requestLockedFrames
+ */
+std::vector<view::AnimDataModule::Frame*> view::AnimDataModule::requestLockedFrames(
+    unsigned int idx, unsigned int count) {
+    std::vector<Frame*> frames;
+    if ((this->frameCache == NULL) || (this->frameCnt == 0)) {
+        return frames;
+    }
+    if (idx >= this->frameCnt) {
+        idx = this->frameCnt - 1;
+    }
+    count = (std::min)(count, this->frameCnt - idx);
+    if (this->cacheSize < this->frameCnt) {
+        // the loader thread needs a free buffer for the missing frames
+        count = (std::min)(count, (std::max)(1U, this->cacheSize - 1));
+    }
+    if (count == 0) {
+        return frames;
+    }
+
+    // frames are only pinned once the window is complete, so waiting does not take buffers from the loader thread.
+    // If the window does not fit next to the frames other callers hold, the complete part at its start is returned.
+    const unsigned int patience = 10;
+    std::vector<Frame*> window(count, NULL);
+    unsigned int complete = 0;
+    unsigned int stalled = 0;
+    while (true) {
+        unsigned int round = this->loadedRounds();
+        const bool loading = this->isRunning.load() || this->loader.IsRunning();
+
+        this->stateLock.Lock();
+        // the loader thread fetches the missing frames of the window first and then prefetches the following ones
+        this->lastRequested = idx;
+        std::fill(window.begin(), window.end(), static_cast<Frame*>(NULL));
+        for (unsigned int i = 0; i < this->cacheSize; i++) {
+            Frame* f = this->frameCache[i];
+            if (((f->state == Frame::STATE_AVAILABLE) || (f->state == Frame::STATE_INUSE)) && (f->frame >= idx) &&
+                (f->frame < idx + count)) {
+                window[f->frame - idx] = f;
+            }
+        }
+        unsigned int available = 0;
+        while ((available < count) && (window[available] != NULL)) {
+            available++;
+        }
+        stalled = (available > complete) ? 0 : stalled + 1;
+        complete = available;
+        if ((complete == count) || (stalled >= patience) || !loading) {
+            for (unsigned int i = 0; i < complete; i++) {
+                window[i]->state = Frame::STATE_INUSE;
+                frames.push_back(window[i]);
+            }
+            this->stateLock.Unlock();
+            break;
+        }
+        this->stateLock.Unlock();
+
+        this->waitForLoadedRound(round);
+    }
+
+    return frames;
+}
+
+
 /*
  * view::AnimDataModule::resetFrameCache
  */
@@ -226,13 +297,15 @@ void view::AnimDataModule::setFrameCount(unsigned int cnt) {
 DWORD view::AnimDataModule::loaderFunction(void* userData) {
     AnimDataModule* This = static_cast<AnimDataModule*>(userData);
     ASSERT(This != NULL);
-    unsigned int index, i, j, req;
-#ifdef _LOADING_REPORTING
-    unsigned int l;
-#endif /* _LOADING_REPORTING */
+    unsigned int index, i, j, k, req;
     Frame* frame;
     vislib::StringA fullName(This->FullName());
 
+    // frames to be loaded in one round, their distances to the requested frame and their target cache buffers
+    std::vector<unsigned int> indices;
+    std::vector<unsigned int> distances;
+    std::vector<Frame*> targets;
+
     std::chrono::high_resolution_clock::duration accumDuration = std::chrono::seconds(0);
     unsigned int accumCount = 0;
     std::chrono::system_clock::time_point lastReportTime = std::chrono::system_clock::now();
@@ -245,16 +318,21 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
             break;
 
         // idea:
-        //  1. search for the most important frame to be loaded.
-        //  2. search for the best cached frame to be overwritten.
-        //  3. load the frame
+        //  1. search for the most important frames to be loaded.
+        //  2. search for the best cached frames to be overwritten.
+        //  3. load the frames
+
+        // at most half of the cache is refilled at once to keep frames close to the requested one
+        const unsigned int maxLoads = (std::max)(1U, (std::min)(This->maxConcurrentFrameLoads(), This->cacheSize / 2));
 
         // 1.
         // Note: we do not need to lock here, because we won't change the frame
         // state now, and the different states that can be set outside this
         // thread are aquivalent for us.
+        indices.clear();
+        distances.clear();
         index = req = This->lastRequested;
-        for (j = 0; j < This->cacheSize; j++) {
+        for (j = 0; j < This->cacheSize && indices.size() < maxLoads; j++) {
             for (i = 0; i < This->cacheSize; i++) {
                 if (!This->isRunning.load())
                     break;
@@ -267,14 +345,15 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
             if (!This->isRunning.load())
                 break;
             if (i >= This->cacheSize) {
-                break;
+                indices.push_back(index);
+                distances.push_back(j);
             }
             index = (index + 1) % This->frameCnt;
         }
         if (!This->isRunning.load())
             break;
-        if (j >= This->cacheSize) {
-            if (j >= This->frameCnt) {
+        if (indices.empty()) {
+            if (This->cacheSize >= This->frameCnt) {
                 ASSERT(This->frameCnt == This->cacheSize);
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo(
                     "All frames of the dataset loaded into cache. Terminating loading Thread.");
@@ -286,64 +365,87 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
         // 2.
         // Note: We now need to lock, because we must synchronise against
         // frames changing from 'STATE_AVAILABLE' to 'STATE_INUSE'.
+        targets.clear();
         This->stateLock.Lock();
-        // core idea: search for the frame with the largest distance to the requested frame
-        frame = NULL; // the frame to be overwritten
-        j = 0;        // the distance to the found frame to be overwritten
-        for (i = 0; i < This->cacheSize; i++) {
-            if (This->frameCache[i]->state == Frame::STATE_INVALID) {
-                frame = This->frameCache[i];
-                // j = UINT_MAX; // not required, since we instantly leave the loop
-#ifdef _LOADING_REPORTING
-                l = i;
-#endif /* _LOADING_REPORTING */
-                break;
-            } else if (This->frameCache[i]->state == Frame::STATE_AVAILABLE) {
-                // distance to the frame[i];
-                long ld = static_cast<long>(This->frameCache[i]->frame) - static_cast<long>(req);
-                if (ld < 0) {
-                    if (ld < (static_cast<long>(This->frameCnt)) / 10) {
-                        ld += static_cast<long>(This->frameCnt);
-                        if (ld < 0)
-                            ld = 0; // should never happen
-                    } else {
-                        ld = -10 * ld;
+        for (k = 0; k < indices.size(); k++) {
+            // core idea: search for the frame with the largest distance to the requested frame
+            frame = NULL; // the frame to be overwritten
+            j = 0;        // the distance to the found frame to be overwritten
+            for (i = 0; i < This->cacheSize; i++) {
+                if (This->frameCache[i]->state == Frame::STATE_INVALID) {
+                    frame = This->frameCache[i];
+                    // j = UINT_MAX; // not required, since we instantly leave the loop
+                    break;
+                } else if (This->frameCache[i]->state == Frame::STATE_AVAILABLE) {
+                    // distance to the frame[i];
+                    long ld = static_cast<long>(This->frameCache[i]->frame) - static_cast<long>(req);
+                    if (ld < 0) {
+                        if (ld < (static_cast<long>(This->frameCnt)) / 10) {
+                            ld += static_cast<long>(This->frameCnt);
+                            if (ld < 0)
+                                ld = 0; // should never happen
+                        } else {
+                            ld = -10 * ld;
+                        }
                     }
-                }
 
-                if (j < static_cast<unsigned int>(ld)) {
-                    frame = This->frameCache[i];
-                    j = static_cast<unsigned int>(ld);
-#ifdef _LOADING_REPORTING
-                    l = i;
-#endif /* _LOADING_REPORTING */
+                    // additional frames must not evict frames needed before the ones being loaded
+                    if ((k > 0) && (static_cast<unsigned int>(ld) <= distances.back())) {
+                        continue;
+                    }
+
+                    if (j < static_cast<unsigned int>(ld)) {
+                        frame = This->frameCache[i];
+                        j = static_cast<unsigned int>(ld);
+                    }
                 }
+                if (!This->isRunning.load())
+                    break;
             }
-            if (!This->isRunning.load())
-                break;
-        }
 
-        // 3.
-        if (frame != NULL) {
+            // 3.
+            // if frame is NULL no suitable cache buffer found for loading. This is
+            // mostly the case if the cache is too small or if the data source
+            // locks too much frames.
+            if (frame == NULL)
+                break;
             frame->state = Frame::STATE_LOADING;
+            targets.push_back(frame);
         }
-        // if frame is NULL no suitable cache buffer found for loading. This is
-        // mostly the case if the cache is too small or if the data source
-        // locks too much frames.
         This->stateLock.Unlock();
 
-        if ((frame != NULL) && This->isRunning.load()) {
+        if (!targets.empty() && This->isRunning.load()) {
 #ifdef _LOADING_REPORTING
-            printf("Loading frame %i into cache %i\n", index, l);
+            for (k = 0; k < targets.size(); k++) {
+                printf("Loading frame %i\n", indices[k]);
+            }
 #endif /* _LOADING_REPORTING */
 
             std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-            This->loadFrame(frame, index);
+            // we no not need to lock when setting the state, because this
+            // transition from 'STATE_LOADING' to 'STATE_AVAILABLE' is safe
+            // for the using thread.
+            if (targets.size() == 1) {
+                This->loadFrame(targets[0], indices[0]);
+                targets[0]->state = Frame::STATE_AVAILABLE;
+            } else {
+#pragma omp parallel for num_threads(static_cast<int>(targets.size()))
+                for (int t = 0; t < static_cast<int>(targets.size()); t++) {
+                    This->loadFrame(targets[t], indices[t]);
+                    targets[t]->state = Frame::STATE_AVAILABLE;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(This->loadRoundLock);
+                This->loadRound++;
+            }
+            This->loadRoundSignal.notify_all();
 
             std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
             accumDuration += duration;
-            accumCount++;
+            accumCount += static_cast<unsigned int>(targets.size());
 
             std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
             if ((reportTime - lastReportTime) > lastReportDistance) {
@@ -356,11 +458,6 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
                         static_cast<unsigned int>(accumCount));
                 }
             }
-
-            // we no not need to lock here, because this transition from
-            // 'STATE_LOADING' to 'STATE_AVAILABLE' is safe for the using
-            // thread.
-            frame->state = Frame::STATE_AVAILABLE;
         }
     }
 
@@ -387,3 +484,24 @@ void view::AnimDataModule::unlock(view::AnimDataModule::Frame* frame) {
     frame->state = Frame::STATE_AVAILABLE;
     this->stateLock.Unlock();
 }
+
+
+/*
+ * view::AnimDataModule::loadedRounds
+ */
+unsigned int view::AnimDataModule::loadedRounds(void) {
+    std::lock_guard<std::mutex> lock(this->loadRoundLock);
+    return this->loadRound;
+}
+
+
+/*
+ * view::AnimDataModule::waitForLoadedRound
+ */
+void view::AnimDataModule::waitForLoadedRound(unsigned int round) {
+    std::unique_lock<std::mutex> lock(this->loadRoundLock);
+    // the timeout covers frames becoming available by other means, e.g. being unlocked
+    this->loadRoundSignal.wait_for(lock, std::chrono::milliseconds(100), [this, round]() {
+        return (this->loadRound != round) || !this->isRunning.load();
+    });
+}
@@ -0,0 +1,339 @@
+/*
+ * MMPLDCompression.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "MMPLDCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace megamol::moldyn::io::mmpld {
+
+namespace {
+
+/** Layout of one list of a chunked frame */
+struct ListLayout {
+    /** The list header in the source frame */
+    uint8_t const* header = nullptr;
+    size_t header_size = 0;
+    /** Offset of the list header in the decoded frame */
+    uint64_t header_dst = 0;
+
+    uint64_t count = 0;
+    unsigned int stride = 0;
+    unsigned int enc_stride = 0;
+    uint8_t flags = 0;
+    float qbox[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    uint32_t particles_per_chunk = 0;
+
+    /** The first compressed chunk and the offsets of all chunks relative to it */
+    uint8_t const* chunks = nullptr;
+    std::vector<uint64_t> chunk_offsets;
+    /** Offset of the first record in the decoded frame */
+    uint64_t records_dst = 0;
+};
+
+/** Answer the size of an encoded record, quantization shrinks the three float coordinates to 16 bit */
+unsigned int encodedStride(ListHeader const& header, bool quantized) {
+    return quantized ? header.Stride() - 6 : header.Stride();
+}
+
+void append(std::vector<uint8_t>& out, void const* data, size_t size) {
+    auto const* bytes = static_cast<uint8_t const*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+/**
+ * Parses the list headers and chunk tables of a chunked frame.
+ *
+ * @param src The frame data
+ * @param size The size of the frame data
+ * @param lists Receives the layout of every list, may be nullptr
+ *
+ * @return The size of the decoded frame or 0 if the frame is corrupt
+ */
+uint64_t parseFrame(uint8_t const* src, size_t size, std::vector<ListLayout>* lists) {
+    if (size < 8) {
+        return 0;
+    }
+    uint32_t listCnt = 0;
+    std::memcpy(&listCnt, src + 4, 4);
+    size_t pos = 8;
+    uint64_t dstSize = 8;
+
+    for (uint32_t i = 0; i < listCnt; ++i) {
+        ListLayout list;
+        ListHeader header;
+        list.header_size = ReadListHeader(src + pos, size - pos, ChunkedVersion, header);
+        if (list.header_size == 0) {
+            return 0;
+        }
+        list.header = src + pos;
+        list.header_dst = dstSize;
+        pos += list.header_size;
+        dstSize += list.header_size;
+
+        if (header.vert_type != 0) {
+            if (VertexSize(header.vert_type) == 0 || (header.col_type != 0 && ColourSize(header.col_type) == 0)) {
+                return 0;
+            }
+            if (size - pos < 4) {
+                return 0;
+            }
+            list.flags = src[pos];
+            pos += 4;
+            bool const quantized = (list.flags & CHUNK_QUANTIZED) != 0;
+            if (quantized) {
+                if (!IsQuantizable(header.vert_type) || size - pos < sizeof(list.qbox)) {
+                    return 0;
+                }
+                std::memcpy(list.qbox, src + pos, sizeof(list.qbox));
+                pos += sizeof(list.qbox);
+            }
+            uint32_t chunkCnt = 0;
+            if (size - pos < 8) {
+                return 0;
+            }
+            std::memcpy(&list.particles_per_chunk, src + pos, 4);
+            std::memcpy(&chunkCnt, src + pos + 4, 4);
+            pos += 8;
+            if (list.particles_per_chunk == 0 ? (header.count != 0)
+                                              : (static_cast<uint64_t>(chunkCnt) !=
+                                                    (header.count + list.particles_per_chunk - 1) /
+                                                        list.particles_per_chunk)) {
+                return 0;
+            }
+            if ((size - pos) / 8 < chunkCnt) {
+                return 0;
+            }
+            list.chunk_offsets.resize(chunkCnt + 1, 0);
+            for (uint32_t c = 0; c < chunkCnt; ++c) {
+                uint64_t chunkSize = 0;
+                std::memcpy(&chunkSize, src + pos + c * 8, 8);
+                list.chunk_offsets[c + 1] = list.chunk_offsets[c] + chunkSize;
+            }
+            pos += static_cast<size_t>(chunkCnt) * 8;
+            if (list.chunk_offsets.back() > size - pos) {
+                return 0;
+            }
+            list.chunks = src + pos;
+            pos += static_cast<size_t>(list.chunk_offsets.back());
+
+            list.count = header.count;
+            list.stride = header.Stride();
+            list.enc_stride = encodedStride(header, quantized);
+            list.records_dst = dstSize;
+            dstSize += list.count * list.stride;
+        }
+
+        if (lists != nullptr) {
+            lists->push_back(std::move(list));
+        }
+    }
+
+    return dstSize;
+}
+
+/**
+ * Compresses one chunk of a list.
+ */
+void encodeChunk(ListHeader const& header, uint8_t const* records, uint64_t first, size_t n, bool quantized,
+    float const* qbox, std::vector<uint8_t>& out) {
+    unsigned int const stride = header.Stride();
+    unsigned int const encStride = encodedStride(header, quantized);
+    std::vector<uint8_t> shuffled(n * encStride);
+
+    float scale[3] = {0.0f, 0.0f, 0.0f};
+    if (quantized) {
+        for (int k = 0; k < 3; ++k) {
+            float const extent = qbox[k + 3] - qbox[k];
+            scale[k] = (extent > 0.0f) ? 65535.0f / extent : 0.0f;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        uint8_t const* rec = records + (first + i) * stride;
+        if (quantized) {
+            float pos[3];
+            std::memcpy(pos, rec, sizeof(pos));
+            for (int k = 0; k < 3; ++k) {
+                float const q = std::round((pos[k] - qbox[k]) * scale[k]);
+                auto const v = static_cast<uint16_t>(std::min(std::max(q, 0.0f), 65535.0f));
+                shuffled[(2 * k) * n + i] = static_cast<uint8_t>(v & 0xff);
+                shuffled[(2 * k + 1) * n + i] = static_cast<uint8_t>(v >> 8);
+            }
+            for (unsigned int b = 6; b < encStride; ++b) {
+                shuffled[b * n + i] = rec[b + 6];
+            }
+        } else {
+            for (unsigned int b = 0; b < encStride; ++b) {
+                shuffled[b * n + i] = rec[b];
+            }
+        }
+    }
+
+    uLongf outSize = compressBound(static_cast<uLong>(shuffled.size()));
+    out.resize(outSize);
+    compress2(out.data(), &outSize, shuffled.data(), static_cast<uLong>(shuffled.size()), Z_BEST_SPEED);
+    out.resize(outSize);
+}
+
+/**
+ * Decompresses one chunk of a list directly to its records in the decoded frame.
+ */
+bool decodeChunk(ListLayout const& list, uint32_t chunk, uint8_t* dst) {
+    thread_local std::vector<uint8_t> scratch;
+
+    uint64_t const first = static_cast<uint64_t>(chunk) * list.particles_per_chunk;
+    size_t const n = static_cast<size_t>(std::min<uint64_t>(list.particles_per_chunk, list.count - first));
+    size_t const encSize = n * list.enc_stride;
+    scratch.resize(encSize);
+
+    uLongf outSize = static_cast<uLongf>(encSize);
+    int const res = uncompress(scratch.data(), &outSize, list.chunks + list.chunk_offsets[chunk],
+        static_cast<uLong>(list.chunk_offsets[chunk + 1] - list.chunk_offsets[chunk]));
+    if (res != Z_OK || outSize != encSize) {
+        return false;
+    }
+
+    // byte 'b' of record 'i' is found at 'b * planeStep + i * recStep'
+    bool const shuffled = (list.flags & CHUNK_SHUFFLED) != 0;
+    size_t const planeStep = shuffled ? n : 1;
+    size_t const recStep = shuffled ? 1 : list.enc_stride;
+    uint8_t const* enc = scratch.data();
+    uint8_t* rec = dst + list.records_dst + first * list.stride;
+
+    if ((list.flags & CHUNK_QUANTIZED) == 0) {
+        for (size_t i = 0; i < n; ++i, rec += list.stride) {
+            for (unsigned int b = 0; b < list.enc_stride; ++b) {
+                rec[b] = enc[b * planeStep + i * recStep];
+            }
+        }
+        return true;
+    }
+
+    float scale[3];
+    for (int k = 0; k < 3; ++k) {
+        scale[k] = (list.qbox[k + 3] - list.qbox[k]) / 65535.0f;
+    }
+    for (size_t i = 0; i < n; ++i, rec += list.stride) {
+        float pos[3];
+        for (int k = 0; k < 3; ++k) {
+            auto const q = static_cast<uint16_t>(enc[(2 * k) * planeStep + i * recStep] |
+                                                 (enc[(2 * k + 1) * planeStep + i * recStep] << 8));
+            pos[k] = list.qbox[k] + static_cast<float>(q) * scale[k];
+        }
+        std::memcpy(rec, pos, sizeof(pos));
+        for (unsigned int b = 6; b < list.enc_stride; ++b) {
+            rec[b + 6] = enc[b * planeStep + i * recStep];
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * EncodeListData
+ */
+void EncodeListData(ListHeader const& header, uint8_t const* records, uint32_t particlesPerChunk, bool quantize,
+    std::vector<uint8_t>& out) {
+    if (header.vert_type == 0) {
+        return;
+    }
+    if (particlesPerChunk == 0) {
+        particlesPerChunk = DefaultChunkSize;
+    }
+    bool const quantized = quantize && IsQuantizable(header.vert_type) && header.count > 0;
+    unsigned int const stride = header.Stride();
+
+    // the quantization box is taken from the data, the bounding box of the list might be loose
+    float qbox[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    if (quantized) {
+        std::memcpy(qbox, records, 12);
+        std::memcpy(qbox + 3, records, 12);
+        for (uint64_t i = 1; i < header.count; ++i) {
+            float pos[3];
+            std::memcpy(pos, records + i * stride, sizeof(pos));
+            for (int k = 0; k < 3; ++k) {
+                qbox[k] = std::min(qbox[k], pos[k]);
+                qbox[k + 3] = std::max(qbox[k + 3], pos[k]);
+            }
+        }
+    }
+
+    auto const chunkCnt = static_cast<uint32_t>((header.count + particlesPerChunk - 1) / particlesPerChunk);
+    std::vector<std::vector<uint8_t>> chunks(chunkCnt);
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t c = 0; c < static_cast<int64_t>(chunkCnt); ++c) {
+        uint64_t const first = static_cast<uint64_t>(c) * particlesPerChunk;
+        auto const n = static_cast<size_t>(std::min<uint64_t>(particlesPerChunk, header.count - first));
+        encodeChunk(header, records, first, n, quantized, qbox, chunks[c]);
+    }
+
+    uint8_t flags[4] = {CHUNK_SHUFFLED, 0, 0, 0};
+    if (quantized) {
+        flags[0] |= CHUNK_QUANTIZED;
+    }
+    append(out, flags, sizeof(flags));
+    if (quantized) {
+        append(out, qbox, sizeof(qbox));
+    }
+    append(out, &particlesPerChunk, 4);
+    append(out, &chunkCnt, 4);
+    for (auto const& chunk : chunks) {
+        uint64_t const chunkSize = chunk.size();
+        append(out, &chunkSize, 8);
+    }
+    for (auto const& chunk : chunks) {
+        append(out, chunk.data(), chunk.size());
+    }
+}
+
+
+/*
+ * DecodedFrameSize
+ */
+uint64_t DecodedFrameSize(uint8_t const* src, size_t size) {
+    return parseFrame(src, size, nullptr);
+}
+
+
+/*
+ * DecodeFrame
+ */
+bool DecodeFrame(uint8_t const* src, size_t size, vislib::RawStorage& dst) {
+    std::vector<ListLayout> lists;
+    uint64_t const dstSize = parseFrame(src, size, &lists);
+    if (dstSize == 0) {
+        return false;
+    }
+    dst.EnforceSize(static_cast<SIZE_T>(dstSize));
+    auto* out = dst.As<uint8_t>();
+
+    // time stamp, list count and list headers are stored uncompressed
+    std::memcpy(out, src, 8);
+    std::vector<std::pair<ListLayout const*, uint32_t>> jobs;
+    for (auto const& list : lists) {
+        std::memcpy(out + list.header_dst, list.header, list.header_size);
+        for (uint32_t c = 0; c + 1 < list.chunk_offsets.size(); ++c) {
+            jobs.emplace_back(&list, c);
+        }
+    }
+
+    bool success = true;
+#pragma omp parallel for schedule(dynamic) reduction(&& : success)
+    for (int64_t j = 0; j < static_cast<int64_t>(jobs.size()); ++j) {
+        success = decodeChunk(*jobs[j].first, jobs[j].second, out) && success;
+    }
+    return success;
+}
+
+} // namespace megamol::moldyn::io::mmpld
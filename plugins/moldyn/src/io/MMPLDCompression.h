@@ -0,0 +1,90 @@
+/*
+ * MMPLDCompression.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MMPLDFormat.h"
+#include "vislib/RawStorage.h"
+
+
+/**
+ * Frame layout of chunked MMPLD files (version 1.4):
+ *
+ *   float    time stamp
+ *   uint32   number of particle lists
+ * Per list:
+ *   list header as in version 1.3
+ *   if the vertex type is not 0:
+ *     uint8    encoding flags (ChunkFlags)
+ *     uint8[3] reserved
+ *     float[6] quantization box (only if CHUNK_QUANTIZED is set)
+ *     uint32   particles per chunk
+ *     uint32   number of chunks
+ *     uint64   compressed size of each chunk
+ *     the compressed chunks
+ *
+ * Every chunk holds the records of up to 'particles per chunk' particles. The bytes of the records are shuffled by
+ * their position within the record before they are compressed with zlib, so every chunk can be decoded on its own.
+ * Quantized lists store the positions of float vertex types as 16-bit integers relative to the quantization box.
+ */
+namespace megamol::moldyn::io::mmpld {
+
+/** The first MMPLD version storing the particle records in compressed chunks */
+constexpr unsigned int ChunkedVersion = 104;
+
+/** Default number of particles per chunk */
+constexpr uint32_t DefaultChunkSize = 1 << 16;
+
+/** Encoding flags of a chunked particle list */
+enum ChunkFlags : uint8_t { CHUNK_SHUFFLED = 1, CHUNK_QUANTIZED = 2 };
+
+/**
+ * Answer whether the positions of a list of vertex type 'vt' can be quantized.
+ */
+inline bool IsQuantizable(uint8_t vt) {
+    return vt == 1 || vt == 2;
+}
+
+/**
+ * Encodes the particle records of one list into chunks and appends the list data block to 'out'. The chunks are
+ * compressed in parallel.
+ *
+ * @param header The header of the list
+ * @param records 'header.count' packed records of 'header.Stride()' bytes
+ * @param particlesPerChunk The number of particles per chunk
+ * @param quantize Quantize the positions, ignored if the vertex type cannot be quantized
+ * @param out Receives the list data block
+ */
+void EncodeListData(ListHeader const& header, uint8_t const* records, uint32_t particlesPerChunk, bool quantize,
+    std::vector<uint8_t>& out);
+
+/**
+ * Answer the size of a chunked frame after decoding.
+ *
+ * @param src The frame data
+ * @param size The size of the frame data in bytes
+ *
+ * @return The decoded size in bytes or 0 if the frame is corrupt
+ */
+uint64_t DecodedFrameSize(uint8_t const* src, size_t size);
+
+/**
+ * Decodes a chunked frame into the uncompressed frame layout of version 1.3. The chunks of all lists are decoded in
+ * parallel, directly into 'dst'.
+ *
+ * @param src The frame data
+ * @param size The size of the frame data in bytes
+ * @param dst Receives the decoded frame
+ *
+ * @return True on success, false if the frame is corrupt
+ */
+bool DecodeFrame(uint8_t const* src, size_t size, vislib::RawStorage& dst);
+
+} // namespace megamol::moldyn::io::mmpld
@@ -6,6 +6,8 @@
  */
 
 #include "MMPLDDataSource.h"
+#include "MMPLDCompression.h"
+#include "MMPLDFormat.h"
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/BoolParam.h"
@@ -16,6 +18,12 @@
 #include "vislib/sys/FastFile.h"
 #include "vislib/sys/SystemInformation.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <vector>
+
 namespace megamol::moldyn::io {
 
 
@@ -26,13 +34,42 @@ namespace megamol::moldyn::io {
 #define CACHE_SIZE_MAX 100000
 // factor multiplied to the frame size for estimating the overhead to the pure data.
 #define CACHE_FRAME_FACTOR 1.15f
+// number of average frames the particles of regions of interest may take in the region cache
+#define REGION_CACHE_FRAMES 3
 
 /*****************************************************************************/
 
+namespace {
+
+/**
+ * Answers the size of the cell directory of a frame, which is 0 if the frame has none. The file position is changed.
+ */
+UINT64 cellDirectorySize(
+    vislib::sys::File* file, vislib::sys::File::FileSize start, UINT64 size, unsigned int version) {
+    if (version == 101 || version >= mmpld::ChunkedVersion || size <= mmpld::CellDirectoryFooterSize) {
+        return 0;
+    }
+    uint8_t footer[mmpld::CellDirectoryFooterSize];
+    file->Seek(start + size - sizeof(footer));
+    if (file->Read(footer, sizeof(footer)) != sizeof(footer) ||
+        std::memcmp(footer + 8, mmpld::CellDirectoryMagic, 8) != 0) {
+        return 0;
+    }
+    UINT64 dirSize = 0;
+    std::memcpy(&dirSize, footer, 8);
+    return (dirSize <= size - sizeof(footer)) ? dirSize : 0;
+}
+
+} // namespace
+
+
 /*
  * MMPLDDataSource::Frame::Frame
  */
-MMPLDDataSource::Frame::Frame(AnimDataModule& owner) : AnimDataModule::Frame(owner), dat() {
+MMPLDDataSource::Frame::Frame(AnimDataModule& owner)
+        : AnimDataModule::Frame(owner)
+        , dat()
+        , fileVersion(0) {
     // intentionally empty
 }
 
@@ -51,11 +88,178 @@ MMPLDDataSource::Frame::~Frame() {
 bool MMPLDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version) {
     this->frame = idx;
     this->fileVersion = version;
+    if (version >= mmpld::ChunkedVersion) {
+        // the chunks are decoded to the uncompressed layout, which 'SetData' reads like version 103
+        std::vector<uint8_t> packed(static_cast<size_t>(size));
+        if (file->Read(packed.data(), size) != size) {
+            return false;
+        }
+        return mmpld::DecodeFrame(packed.data(), packed.size(), this->dat);
+    }
     this->dat.EnforceSize(static_cast<SIZE_T>(size));
     return (file->Read(this->dat, size) == size);
 }
 
 
+/*
+ * MMPLDDataSource::Frame::LoadFrameRegion
+ */
+bool MMPLDDataSource::Frame::LoadFrameRegion(vislib::sys::File* file, unsigned int idx, UINT64 size,
+    unsigned int version, vislib::math::Cuboid<float> const& roi, bool& outUsedDirectory) {
+    using megamol::core::utility::log::Log;
+    using vislib::sys::File;
+    File::FileSize const start = file->Tell();
+
+    // the cell directory is at the end of the frame
+    std::vector<uint8_t> directory(static_cast<size_t>(cellDirectorySize(file, start, size, version)));
+    if (!directory.empty()) {
+        file->Seek(start + size - mmpld::CellDirectoryFooterSize - directory.size());
+        if (file->Read(directory.data(), directory.size()) != directory.size()) {
+            directory.clear();
+        }
+    }
+
+    // a list of the compact frame: its header with the reduced particle count and the ranges of particles to read
+    struct List {
+        std::vector<uint8_t> header;
+        UINT64 recordsOffset = 0;
+        unsigned int stride = 0;
+        std::vector<std::pair<UINT64, UINT64>> ranges;
+    };
+    std::vector<List> lists;
+    size_t const prefixSize = (version >= 102) ? 8 : 4;
+    uint8_t prefix[8];
+    bool valid = !directory.empty() && (size >= prefixSize);
+    if (valid) {
+        file->Seek(start);
+        valid = (file->Read(prefix, prefixSize) == prefixSize);
+    }
+
+    size_t dp = 0;
+    auto readDir = [&](void* dst, size_t cnt) {
+        if (dp + cnt > directory.size()) {
+            return false;
+        }
+        std::memcpy(dst, directory.data() + dp, cnt);
+        dp += cnt;
+        return true;
+    };
+    UINT32 listCnt = 0;
+    valid = valid && readDir(&listCnt, 4);
+    if (valid) {
+        UINT32 frameListCnt = 0;
+        std::memcpy(&frameListCnt, prefix + prefixSize - 4, 4);
+        valid = (frameListCnt == listCnt);
+    }
+    for (UINT32 li = 0; valid && li < listCnt; ++li) {
+        UINT64 headerOffset = 0;
+        UINT32 level = 0;
+        float box[6];
+        valid = readDir(&headerOffset, 8) && readDir(&level, 4) && readDir(box, sizeof(box)) &&
+                (level <= mmpld::MaxCellLevel) && (headerOffset < size);
+        if (!valid) {
+            break;
+        }
+        size_t const cellCnt = size_t(1) << (3 * level);
+        std::vector<UINT64> starts(cellCnt + 1);
+        valid = readDir(starts.data(), starts.size() * sizeof(UINT64));
+
+        // the header is at most 46 bytes long: types, radius, intensity range, count and bounding box
+        uint8_t headerBuf[46];
+        auto const headerRead = static_cast<File::FileSize>(std::min<UINT64>(sizeof(headerBuf), size - headerOffset));
+        file->Seek(start + headerOffset);
+        valid = valid && (file->Read(headerBuf, headerRead) == headerRead);
+        mmpld::ListHeader header;
+        size_t const headerSize =
+            valid ? mmpld::ReadListHeader(headerBuf, static_cast<size_t>(headerRead), version, header) : 0;
+        valid = (headerSize != 0) && (starts.back() == header.count);
+        if (!valid) {
+            break;
+        }
+
+        List list;
+        list.header.assign(headerBuf, headerBuf + headerSize);
+        list.recordsOffset = headerOffset + headerSize;
+        list.stride = header.Stride();
+
+        // collect the particles of all cells intersecting the region, consecutive cells are merged
+        float cellSize[3];
+        for (int k = 0; k < 3; ++k) {
+            cellSize[k] = (box[k + 3] - box[k]) / static_cast<float>(1 << level);
+        }
+        float const roiMin[3] = {roi.Left(), roi.Bottom(), roi.Back()};
+        float const roiMax[3] = {roi.Right(), roi.Top(), roi.Front()};
+        UINT64 count = 0;
+        for (size_t c = 0; c < cellCnt; ++c) {
+            if (starts[c + 1] <= starts[c]) {
+                continue;
+            }
+            UINT32 const cell[3] = {mmpld::CompactBits(static_cast<UINT32>(c)),
+                mmpld::CompactBits(static_cast<UINT32>(c >> 1)), mmpld::CompactBits(static_cast<UINT32>(c >> 2))};
+            bool inside = true;
+            for (int k = 0; k < 3; ++k) {
+                float const cellMin = box[k] + static_cast<float>(cell[k]) * cellSize[k];
+                float const cellMax = (cell[k] + 1 == (1u << level)) ? box[k + 3] : cellMin + cellSize[k];
+                inside = inside && (cellMin <= roiMax[k]) && (cellMax >= roiMin[k]);
+            }
+            if (!inside) {
+                continue;
+            }
+            if (!list.ranges.empty() && list.ranges.back().first + list.ranges.back().second == starts[c]) {
+                list.ranges.back().second += starts[c + 1] - starts[c];
+            } else {
+                list.ranges.emplace_back(starts[c], starts[c + 1] - starts[c]);
+            }
+            count += starts[c + 1] - starts[c];
+        }
+        valid = (list.recordsOffset + header.count * list.stride <= size);
+
+        // patch the particle count, which is followed by the bounding box from version 1.3 on
+        size_t const countPos = headerSize - 8 - ((version >= 103) ? 24 : 0);
+        std::memcpy(list.header.data() + countPos, &count, 8);
+        lists.push_back(std::move(list));
+    }
+
+    outUsedDirectory = valid;
+    if (!valid) {
+        // no usable cell directory, load the whole frame
+        if (!directory.empty()) {
+            Log::DefaultLog.WriteWarn("MMPLDDataSource: cell directory of frame %u cannot be used", idx);
+        }
+        file->Seek(start);
+        return this->LoadFrame(file, idx, size, version);
+    }
+
+    this->frame = idx;
+    this->fileVersion = version;
+
+    UINT64 compactSize = prefixSize;
+    for (auto const& list : lists) {
+        compactSize += list.header.size();
+        for (auto const& range : list.ranges) {
+            compactSize += range.second * list.stride;
+        }
+    }
+    this->dat.EnforceSize(static_cast<SIZE_T>(compactSize));
+    auto* out = this->dat.As<uint8_t>();
+    std::memcpy(out, prefix, prefixSize);
+    out += prefixSize;
+    for (auto const& list : lists) {
+        std::memcpy(out, list.header.data(), list.header.size());
+        out += list.header.size();
+        for (auto const& range : list.ranges) {
+            UINT64 const rangeSize = range.second * list.stride;
+            file->Seek(start + list.recordsOffset + range.first * list.stride);
+            if (file->Read(out, rangeSize) != rangeSize) {
+                return false;
+            }
+            out += rangeSize;
+        }
+    }
+    return true;
+}
+
+
 /*
  * MMPLDDataSource::Frame::SetData
  */
@@ -233,7 +437,12 @@ MMPLDDataSource::MMPLDDataSource(void)
         , frameIdx(NULL)
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
-        , data_hash(0) {
+        , data_hash(0)
+        , fileLock()
+        , hasCellDirectory(false)
+        , regionCacheBytes(0)
+        , regionCacheBudget(0)
+        , regionFallbackLogged(false) {
 
     this->filename.SetParameter(
         new core::param::FilePathParam("", core::param::FilePathParam::Flag_File_RestrictExtension, {"mmpld"}));
@@ -259,6 +468,10 @@ MMPLDDataSource::MMPLDDataSource(void)
         geocalls::MultiParticleDataCall::FunctionName(0), &MMPLDDataSource::getDataCallback);
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(1), &MMPLDDataSource::getExtentCallback);
+    this->getData.SetCallbackConcurrencySafe(
+        geocalls::MultiParticleDataCall::ClassName(), geocalls::MultiParticleDataCall::FunctionName(0));
+    this->getData.SetCallbackConcurrencySafe(
+        geocalls::MultiParticleDataCall::ClassName(), geocalls::MultiParticleDataCall::FunctionName(1));
     this->MakeSlotAvailable(&this->getData);
 
     this->setFrameCount(1);
@@ -307,8 +520,10 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
     //printf("Requesting frame %u of %u frames\n", idx, this->FrameCount());
     //Log::DefaultLog.WriteInfo( "Requesting frame %u of %u frames\n", idx, this->FrameCount());
     ASSERT(idx < this->FrameCount());
+    std::lock_guard<std::mutex> lock(this->fileLock);
     this->file->Seek(this->frameIdx[idx]);
-    if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
+    UINT64 const size = this->frameIdx[idx + 1] - this->frameIdx[idx];
+    if (!f->LoadFrame(this->file, idx, size, this->fileVersion)) {
         // failed
         Log::DefaultLog.WriteError("Unable to read frame %d from MMPLD file\n", idx);
     }
@@ -320,6 +535,7 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
  */
 void MMPLDDataSource::release(void) {
     this->resetFrameCache();
+    this->clearRegionCache();
     if (this->file != NULL) {
         vislib::sys::File* f = this->file;
         this->file = NULL;
@@ -340,6 +556,9 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     this->bbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     this->clipbox = this->bbox;
     this->data_hash++;
+    this->clearRegionCache();
+    this->hasCellDirectory = false;
+    this->regionFallbackLogged = false;
 
     if (this->file == NULL) {
         this->file = new vislib::sys::FastFile();
@@ -380,7 +599,7 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     }
     unsigned short ver;
     _ASSERT_READFILE(&ver, 2);
-    if (ver < 100 || ver > 103) {
+    if (ver < 100 || ver > mmpld::ChunkedVersion) {
         _ERROR_OUT("MMPLD file header version wrong");
     }
     this->fileVersion = ver;
@@ -405,7 +624,25 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
         size += static_cast<double>(this->frameIdx[i + 1] - this->frameIdx[i]);
     }
     size /= static_cast<double>(frmCnt);
+    if (ver >= mmpld::ChunkedVersion) {
+        // the cache holds decoded frames, estimate their size by the compression ratio of the first frame
+        std::vector<uint8_t> first(static_cast<size_t>(this->frameIdx[1] - this->frameIdx[0]));
+        this->file->Seek(this->frameIdx[0]);
+        _ASSERT_READFILE(first.data(), first.size());
+        UINT64 const decoded = mmpld::DecodedFrameSize(first.data(), first.size());
+        if (decoded == 0) {
+            _ERROR_OUT("MMPLD file contains corrupt frame data");
+        }
+        if (!first.empty()) {
+            size *= static_cast<double>(decoded) / static_cast<double>(first.size());
+        }
+    }
     size *= CACHE_FRAME_FACTOR;
+    this->regionCacheBudget = static_cast<UINT64>(size * REGION_CACHE_FRAMES);
+
+    // regions of interest are only read from the file if it is sorted into cells, which applies to all its frames
+    this->hasCellDirectory = (cellDirectorySize(this->file, static_cast<vislib::sys::File::FileSize>(this->frameIdx[0]),
+                                  this->frameIdx[1] - this->frameIdx[0], ver) != 0);
 
     UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
     if (this->limitMemorySlot.Param<core::param::BoolParam>()->Value()) {
@@ -442,26 +679,163 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
  * MMPLDDataSource::getDataCallback
  */
 bool MMPLDDataSource::getDataCallback(core::Call& caller) {
+    using megamol::core::utility::log::Log;
     geocalls::MultiParticleDataCall* c2 = dynamic_cast<geocalls::MultiParticleDataCall*>(&caller);
     if (c2 == NULL)
         return false;
 
-    Frame* f = NULL;
-    if (c2 != NULL) {
-        f = dynamic_cast<Frame*>(this->requestLockedFrame(c2->FrameID(), c2->IsFrameForced()));
+    if (c2->HasRegionOfInterest()) {
+        if (this->hasCellDirectory) {
+            return this->getRegionData(*c2);
+        }
+        // reading the whole frame for the region again and again is slower than serving the cached frame
+        if (!this->regionFallbackLogged.exchange(true)) {
+            Log::DefaultLog.WriteInfo("MMPLDDataSource: the file has no cell directory, requests of a region of "
+                                      "interest are answered with the complete frames");
+        }
+    }
+
+    std::vector<Frame*> frames;
+    if (c2->GetFrameWindow() > 1) {
+        // all frames of the window are pinned together, while the loader thread prefetches the following ones
+        for (auto* af : this->requestLockedFrames(c2->FrameID(), c2->GetFrameWindow())) {
+            frames.push_back(dynamic_cast<Frame*>(af));
+        }
+    }
+    if (frames.empty()) {
+        Frame* f = dynamic_cast<Frame*>(this->requestLockedFrame(c2->FrameID(), c2->IsFrameForced()));
         if (f == NULL)
             return false;
-        c2->SetUnlocker(new Unlocker(*f));
-        c2->SetFrameID(f->FrameNumber());
-        c2->SetDataHash(this->data_hash);
-        auto overrideBBox = this->overrideBBoxSlot.Param<core::param::BoolParam>()->Value();
-        f->SetData(*c2, this->bbox, overrideBBox);
+        frames.push_back(f);
+    }
+    c2->SetUnlocker(new Unlocker(frames));
+    c2->SetFrameID(frames[0]->FrameNumber());
+    c2->SetDataHash(this->data_hash);
+    auto overrideBBox = this->overrideBBoxSlot.Param<core::param::BoolParam>()->Value();
+    frames[0]->SetData(*c2, this->bbox, overrideBBox);
+
+    c2->SetWindowFrameCount(static_cast<unsigned int>(frames.size()));
+    for (unsigned int i = 1; i < frames.size(); i++) {
+        geocalls::MultiParticleDataCall windowCall;
+        windowCall.SetFrameID(frames[i]->FrameNumber());
+        frames[i]->SetData(windowCall, this->bbox, overrideBBox);
+        c2->SetWindowFrame(i, frames[i]->FrameNumber(), windowCall);
+    }
+
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::getRegionData
+ */
+bool MMPLDDataSource::getRegionData(geocalls::MultiParticleDataCall& call) {
+    using megamol::core::utility::log::Log;
+    if (this->file == NULL || this->FrameCount() == 0) {
+        return false;
+    }
+
+    // the regions are read into frames of their own, as the frames of the frame cache are shared by all requests
+    unsigned int const first = (std::min)(call.FrameID(), this->FrameCount() - 1);
+    unsigned int const count = (std::min)((std::max)(call.GetFrameWindow(), 1u), this->FrameCount() - first);
+    vislib::math::Cuboid<float> const roi = call.GetRegionOfInterest();
+    std::array<float, 6> const roiKey = {roi.Left(), roi.Bottom(), roi.Back(), roi.Right(), roi.Top(), roi.Front()};
+    std::vector<std::shared_ptr<Frame>> regions;
+    bool usedDirectory = true;
+    for (unsigned int idx = first; idx < first + count; ++idx) {
+        auto region = this->findRegion(idx, roiKey);
+        if (region == nullptr) {
+            region = std::make_shared<Frame>(*this);
+            bool frameUsedDirectory = false;
+            {
+                std::lock_guard<std::mutex> lock(this->fileLock);
+                this->file->Seek(this->frameIdx[idx]);
+                if (!region->LoadFrameRegion(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx],
+                        this->fileVersion, roi, frameUsedDirectory)) {
+                    Log::DefaultLog.WriteError("Unable to read frame %d from MMPLD file\n", idx);
+                    return false;
+                }
+            }
+            usedDirectory = usedDirectory && frameUsedDirectory;
+            this->storeRegion(idx, roiKey, region);
+        }
+        regions.push_back(std::move(region));
+    }
+    if (!usedDirectory && !this->regionFallbackLogged.exchange(true)) {
+        Log::DefaultLog.WriteInfo("MMPLDDataSource: frames without a usable cell directory are read completely "
+                                  "for requests of a region of interest");
+    }
+
+    // consumers caching per data hash must not mistake the particles of one region for those of another
+    size_t hash = this->data_hash;
+    for (float v : roiKey) {
+        hash ^= std::hash<float>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+
+    std::vector<Frame*> frames;
+    for (auto const& region : regions) {
+        frames.push_back(region.get());
+    }
+    call.SetUnlocker(new Unlocker({}, std::move(regions)));
+    call.SetFrameID(first);
+    call.SetDataHash(hash);
+    auto overrideBBox = this->overrideBBoxSlot.Param<core::param::BoolParam>()->Value();
+    frames[0]->SetData(call, this->bbox, overrideBBox);
+
+    call.SetWindowFrameCount(count);
+    for (unsigned int i = 1; i < count; i++) {
+        geocalls::MultiParticleDataCall windowCall;
+        windowCall.SetFrameID(first + i);
+        frames[i]->SetData(windowCall, this->bbox, overrideBBox);
+        call.SetWindowFrame(i, first + i, windowCall);
     }
 
     return true;
 }
 
 
+/*
+ * MMPLDDataSource::findRegion
+ */
+std::shared_ptr<MMPLDDataSource::Frame> MMPLDDataSource::findRegion(
+    unsigned int idx, std::array<float, 6> const& roi) {
+    std::lock_guard<std::mutex> lock(this->regionCacheLock);
+    for (auto it = this->regionCache.begin(); it != this->regionCache.end(); ++it) {
+        if (it->frame == idx && it->roi == roi) {
+            // most recently used first
+            this->regionCache.splice(this->regionCache.begin(), this->regionCache, it);
+            return this->regionCache.front().data;
+        }
+    }
+    return nullptr;
+}
+
+
+/*
+ * MMPLDDataSource::storeRegion
+ */
+void MMPLDDataSource::storeRegion(unsigned int idx, std::array<float, 6> const& roi, std::shared_ptr<Frame> region) {
+    std::lock_guard<std::mutex> lock(this->regionCacheLock);
+    this->regionCacheBytes += region->GetSize();
+    this->regionCache.push_front({idx, roi, std::move(region)});
+    // the entries are only dropped from the cache, requests still holding them keep them alive
+    while (this->regionCache.size() > 1 && this->regionCacheBytes > this->regionCacheBudget) {
+        this->regionCacheBytes -= this->regionCache.back().data->GetSize();
+        this->regionCache.pop_back();
+    }
+}
+
+
+/*
+ * MMPLDDataSource::clearRegionCache
+ */
+void MMPLDDataSource::clearRegionCache(void) {
+    std::lock_guard<std::mutex> lock(this->regionCacheLock);
+    this->regionCache.clear();
+    this->regionCacheBytes = 0;
+}
+
+
 /*
  * MMPLDDataSource::getExtentCallback
  */
@@ -16,6 +16,13 @@
 #include "vislib/sys/File.h"
 #include "vislib/types.h"
 
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 
 namespace megamol::moldyn::io {
 
@@ -110,6 +117,15 @@ protected:
             this->dat.EnforceSize(0);
         }
 
+        /**
+         * Answer the size of the loaded data
+         *
+         * @return The size of the loaded data in bytes
+         */
+        inline SIZE_T GetSize(void) const {
+            return this->dat.GetSize();
+        }
+
         /**
          * Loads a frame from 'file' into this object
          *
@@ -117,12 +133,32 @@ protected:
          *             to be at the correct location
          * @param idx The zero-based index of the frame
          * @param size The size of the frame data in bytes
-         * @param version File version (100 = standard, 101 with clusterInfos)
+         * @param version File version (100 = standard, 101 with clusterInfos,
+         *                104 with compressed chunks)
          *
          * @return True on success
          */
         bool LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version);
 
+        /**
+         * Loads the particles of a frame within a region of interest. If the
+         * frame has a cell directory, only the cells intersecting the region
+         * are read, otherwise the whole frame is loaded.
+         *
+         * @param file The file stream to load from. The stream is assumed
+         *             to be at the correct location
+         * @param idx The zero-based index of the frame
+         * @param size The size of the frame data in bytes
+         * @param version File version
+         * @param roi The region of interest
+         * @param outUsedDirectory Receives whether only the cells within the
+         *                         region have been read
+         *
+         * @return True on success
+         */
+        bool LoadFrameRegion(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version,
+            vislib::math::Cuboid<float> const& roi, bool& outUsedDirectory);
+
         /**
          * Sets the data into the call
          *
@@ -147,29 +183,39 @@ protected:
         /**
          * Ctor.
          *
-         * @param frame The frame to unlock
+         * @param frames The frames to unlock
+         * @param regions The frames loaded for a region of interest, which
+         *                are not part of the frame cache and released on
+         *                unlocking
          */
-        Unlocker(Frame& frame) : geocalls::MultiParticleDataCall::Unlocker(), frame(&frame) {
+        Unlocker(std::vector<Frame*> frames, std::vector<std::shared_ptr<Frame>> regions = {})
+                : geocalls::MultiParticleDataCall::Unlocker()
+                , frames(std::move(frames))
+                , regions(std::move(regions)) {
             // intentionally empty
         }
 
         /** Dtor. */
         virtual ~Unlocker(void) {
             this->Unlock();
-            ASSERT(this->frame == NULL);
+            ASSERT(this->frames.empty());
         }
 
         /** Unlocks the data */
         virtual void Unlock(void) {
-            if (this->frame != NULL) {
-                this->frame->Unlock();
-                this->frame = NULL; // DO NOT DELETE!
+            for (Frame* frame : this->frames) {
+                frame->Unlock(); // DO NOT DELETE!
             }
+            this->frames.clear();
+            this->regions.clear();
         }
 
     private:
-        /** The frame to unlock */
-        Frame* frame;
+        /** The frames to unlock, which are the frames of the requested window */
+        std::vector<Frame*> frames;
+
+        /** The frames of the requested window loaded for a region of interest */
+        std::vector<std::shared_ptr<Frame>> regions;
     };
 
     /**
@@ -190,6 +236,41 @@ protected:
      */
     bool getDataCallback(core::Call& caller);
 
+    /**
+     * Reads the particles within the region of interest of a request into
+     * the region cache, bypassing the frame cache.
+     *
+     * @param call The requesting call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool getRegionData(geocalls::MultiParticleDataCall& call);
+
+    /**
+     * Looks up the particles of a frame within a region of interest in the
+     * region cache.
+     *
+     * @param idx The zero-based index of the frame
+     * @param roi The region of interest as minimum and maximum corner
+     *
+     * @return The cached region or nullptr
+     */
+    std::shared_ptr<Frame> findRegion(unsigned int idx, std::array<float, 6> const& roi);
+
+    /**
+     * Stores the particles of a frame within a region of interest in the
+     * region cache, evicting the least recently used regions beyond its
+     * budget.
+     *
+     * @param idx The zero-based index of the frame
+     * @param roi The region of interest as minimum and maximum corner
+     * @param region The loaded region
+     */
+    void storeRegion(unsigned int idx, std::array<float, 6> const& roi, std::shared_ptr<Frame> region);
+
+    /** Drops all regions from the region cache */
+    void clearRegionCache(void);
+
     /**
      * Gets the data from the source.
      *
@@ -231,6 +312,34 @@ protected:
 
     /** Data file load id counter */
     size_t data_hash;
+
+    /** Serialises the access to 'file' */
+    std::mutex fileLock;
+
+    /** Flag whether the frames of the file are sorted into cells with a cell directory */
+    bool hasCellDirectory;
+
+    /** An entry of the region cache */
+    struct RegionEntry {
+        unsigned int frame;
+        std::array<float, 6> roi;
+        std::shared_ptr<Frame> data;
+    };
+
+    /** The regions of interest loaded recently, most recently used first */
+    std::list<RegionEntry> regionCache;
+
+    /** The size of all regions in the region cache in bytes */
+    UINT64 regionCacheBytes;
+
+    /** The memory budget of the region cache in bytes */
+    UINT64 regionCacheBudget;
+
+    /** Serialises the access to the region cache */
+    std::mutex regionCacheLock;
+
+    /** Flag whether loading complete frames for a region of interest has been reported for the current file */
+    std::atomic<bool> regionFallbackLogged;
 };
 
 
@@ -0,0 +1,309 @@
+/*
+ * MMPLDFormat.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+
+#include "geometry_calls/MultiParticleDataCall.h"
+
+
+/**
+ * Spatially sorted frames (versions 1.0, 1.2 and 1.3) may be followed by a cell directory, which readers of the plain
+ * format ignore. The particles of each list are then sorted along a Morton curve over the bounding box of the list,
+ * and the directory stores where every cell of a regular grid over this box starts:
+ *
+ *   uint32   number of particle lists
+ * Per list:
+ *   uint64   offset of the list header relative to the frame start
+ *   uint32   cell level, the grid has 2^level cells per axis
+ *   float[6] bounding box of the grid
+ *   uint64   index of the first particle of every cell in Morton order, followed by the particle count
+ * Footer:
+ *   uint64   size of the directory in bytes, without the footer
+ *   char[8]  magic id "MMPLDCD"
+ */
+namespace megamol::moldyn::io::mmpld {
+
+/** Magic id at the end of a frame with cell directory */
+constexpr char CellDirectoryMagic[8] = "MMPLDCD";
+
+/** Size of the footer of the cell directory */
+constexpr unsigned int CellDirectoryFooterSize = 16;
+
+/** Number of bits per axis of the Morton codes used for sorting */
+constexpr unsigned int MortonBits = 10;
+
+/** Maximum cell level of a cell directory */
+constexpr unsigned int MaxCellLevel = 6;
+
+/**
+ * Spreads the lower 10 bits of 'v' to every third bit.
+ */
+inline uint32_t SpreadBits(uint32_t v) {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+/**
+ * Reverts 'SpreadBits'.
+ */
+inline uint32_t CompactBits(uint32_t v) {
+    v &= 0x09249249;
+    v = (v | (v >> 2)) & 0x030c30c3;
+    v = (v | (v >> 4)) & 0x0300f00f;
+    v = (v | (v >> 8)) & 0x030000ff;
+    v = (v | (v >> 16)) & 0x3ff;
+    return v;
+}
+
+/**
+ * Answer the Morton code of a position within a box, using 'MortonBits' bits per axis.
+ *
+ * @param pos The position
+ * @param box The box as minimum and maximum corner
+ *
+ * @return The Morton code
+ */
+inline uint32_t MortonCode(std::array<float, 3> const& pos, float const* box) {
+    uint32_t code = 0;
+    for (int k = 0; k < 3; ++k) {
+        float const extent = box[k + 3] - box[k];
+        float const rel = (extent > 0.0f) ? (pos[k] - box[k]) / extent : 0.0f;
+        float const cells = static_cast<float>(1 << MortonBits);
+        auto const cell = static_cast<uint32_t>(std::min(std::max(rel, 0.0f) * cells, cells - 1.0f));
+        code |= SpreadBits(cell) << k;
+    }
+    return code;
+}
+
+/**
+ * Answer the size in bytes of one vertex of the MMPLD vertex type 'vt'.
+ */
+inline unsigned int VertexSize(uint8_t vt) {
+    switch (vt) {
+    case 1:
+        return 12;
+    case 2:
+        return 16;
+    case 3:
+        return 6;
+    case 4:
+        return 24;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Answer the size in bytes of one colour of the MMPLD colour type 'ct'.
+ */
+inline unsigned int ColourSize(uint8_t ct) {
+    switch (ct) {
+    case 1:
+        return 3;
+    case 2:
+    case 3:
+        return 4;
+    case 4:
+        return 12;
+    case 5:
+        return 16;
+    case 6:
+    case 7:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Answer the call vertex type of the MMPLD vertex type 'vt'.
+ */
+inline geocalls::SimpleSphericalParticles::VertexDataType VertexDataType(uint8_t vt) {
+    switch (vt) {
+    case 1:
+        return geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ;
+    case 2:
+        return geocalls::SimpleSphericalParticles::VERTDATA_FLOAT_XYZR;
+    case 3:
+        return geocalls::SimpleSphericalParticles::VERTDATA_SHORT_XYZ;
+    case 4:
+        return geocalls::SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ;
+    default:
+        return geocalls::SimpleSphericalParticles::VERTDATA_NONE;
+    }
+}
+
+/**
+ * Answer the call colour type of the MMPLD colour type 'ct'.
+ */
+inline geocalls::SimpleSphericalParticles::ColourDataType ColourDataType(uint8_t ct) {
+    switch (ct) {
+    case 1:
+        return geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGB;
+    case 2:
+        return geocalls::SimpleSphericalParticles::COLDATA_UINT8_RGBA;
+    case 3:
+        return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_I;
+    case 4:
+        return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_RGB;
+    case 5:
+        return geocalls::SimpleSphericalParticles::COLDATA_FLOAT_RGBA;
+    case 6:
+        return geocalls::SimpleSphericalParticles::COLDATA_USHORT_RGBA;
+    case 7:
+        return geocalls::SimpleSphericalParticles::COLDATA_DOUBLE_I;
+    default:
+        return geocalls::SimpleSphericalParticles::COLDATA_NONE;
+    }
+}
+
+/**
+ * Reads the position of one interleaved MMPLD particle record.
+ *
+ * @param vt The MMPLD vertex type
+ * @param rec Pointer to the beginning of the record
+ *
+ * @return The position of the particle
+ */
+inline std::array<float, 3> ReadPosition(uint8_t vt, uint8_t const* rec) {
+    std::array<float, 3> pos = {0.0f, 0.0f, 0.0f};
+    switch (vt) {
+    case 1:
+    case 2: {
+        float v[3];
+        std::memcpy(v, rec, sizeof(v));
+        pos = {v[0], v[1], v[2]};
+    } break;
+    case 3: {
+        uint16_t v[3];
+        std::memcpy(v, rec, sizeof(v));
+        pos = {static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2])};
+    } break;
+    case 4: {
+        double v[3];
+        std::memcpy(v, rec, sizeof(v));
+        pos = {static_cast<float>(v[0]), static_cast<float>(v[1]), static_cast<float>(v[2])};
+    } break;
+    default:
+        break;
+    }
+    return pos;
+}
+
+/** The header of one particle list within an MMPLD frame */
+struct ListHeader {
+    uint8_t vert_type = 0;
+    uint8_t col_type = 0;
+    float global_radius = 0.05f;
+    uint8_t global_colour[4] = {192, 192, 192, 255};
+    float col_range[2] = {0.0f, 1.0f};
+    uint64_t count = 0;
+    float bbox[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    bool has_bbox = false;
+
+    /** Answer the size of one interleaved particle record */
+    unsigned int Stride() const {
+        return VertexSize(vert_type) + ColourSize(col_type);
+    }
+
+    /** Sets the meta data of this header into 'pts', the data pointers are left untouched */
+    void SetMetaData(geocalls::SimpleSphericalParticles& pts) const {
+        pts.SetGlobalRadius(global_radius);
+        pts.SetGlobalColour(global_colour[0], global_colour[1], global_colour[2]);
+        pts.SetColourMapIndexValues(col_range[0], col_range[1]);
+        if (has_bbox) {
+            vislib::math::Cuboid<float> box;
+            box.Set(bbox[0], bbox[1], bbox[2], bbox[3], bbox[4], bbox[5]);
+            pts.SetBBox(box);
+        }
+    }
+};
+
+/**
+ * Reads a list header as written by MMPLDWriter. The stream is left at the beginning of the particle records.
+ *
+ * @param in The stream to read from
+ * @param version The MMPLD file version
+ * @param header Receives the header
+ *
+ * @return True on success
+ */
+inline bool ReadListHeader(std::istream& in, unsigned int version, ListHeader& header) {
+    header = ListHeader();
+    in.read(reinterpret_cast<char*>(&header.vert_type), 1);
+    in.read(reinterpret_cast<char*>(&header.col_type), 1);
+    if (header.vert_type == 0) {
+        header.col_type = 0;
+    }
+    if (header.vert_type == 1 || header.vert_type == 3 || header.vert_type == 4) {
+        in.read(reinterpret_cast<char*>(&header.global_radius), 4);
+    }
+    if (header.col_type == 0) {
+        in.read(reinterpret_cast<char*>(header.global_colour), 4);
+    } else if (header.col_type == 3 || header.col_type == 7) {
+        in.read(reinterpret_cast<char*>(header.col_range), 8);
+    }
+    in.read(reinterpret_cast<char*>(&header.count), 8);
+    if (version >= 103) {
+        in.read(reinterpret_cast<char*>(header.bbox), 24);
+        header.has_bbox = true;
+    }
+    return static_cast<bool>(in);
+}
+
+/**
+ * Reads a list header as written by MMPLDWriter from memory.
+ *
+ * @param data The memory to read from
+ * @param size The number of bytes available at 'data'
+ * @param version The MMPLD file version
+ * @param header Receives the header
+ *
+ * @return The size of the header in bytes or 0 if 'size' is too small
+ */
+inline size_t ReadListHeader(uint8_t const* data, size_t size, unsigned int version, ListHeader& header) {
+    header = ListHeader();
+    size_t pos = 0;
+    auto read = [&](void* dst, size_t cnt) {
+        if (pos + cnt > size) {
+            return false;
+        }
+        std::memcpy(dst, data + pos, cnt);
+        pos += cnt;
+        return true;
+    };
+    bool ok = read(&header.vert_type, 1) && read(&header.col_type, 1);
+    if (header.vert_type == 0) {
+        header.col_type = 0;
+    }
+    if (header.vert_type == 1 || header.vert_type == 3 || header.vert_type == 4) {
+        ok = ok && read(&header.global_radius, 4);
+    }
+    if (header.col_type == 0) {
+        ok = ok && read(header.global_colour, 4);
+    } else if (header.col_type == 3 || header.col_type == 7) {
+        ok = ok && read(header.col_range, 8);
+    }
+    ok = ok && read(&header.count, 8);
+    if (version >= 103) {
+        ok = ok && read(header.bbox, 24);
+        header.has_bbox = true;
+    }
+    return ok ? pos : 0;
+}
+
+} // namespace megamol::moldyn::io::mmpld
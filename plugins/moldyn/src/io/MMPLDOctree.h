@@ -0,0 +1,105 @@
+/*
+ * MMPLDOctree.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <vector>
+
+
+/**
+ * File layout of the particle octree written by MMPLDOctreeWriter:
+ *
+ * Header:
+ *   char[6]  magic id "MMPLO"
+ *   uint16   version
+ *   uint32   number of particle lists
+ *   float[6] bounding box
+ *   float[6] clip box
+ *   uint64   offset of the node directory
+ * Node data:
+ *   interleaved MMPLD particle records of all nodes, one contiguous block per node
+ * Node directory (per list):
+ *   ListEntry, followed by ListEntry::node_count NodeEntry objects, the root node being the first one
+ *
+ * Every inner node stores a spatially uniform subset of the particles of its subtree, the remaining particles are
+ * pushed down to its children. Any ancestor-closed set of nodes therefore holds each particle at most once.
+ */
+namespace megamol::moldyn::io::mmplo {
+
+constexpr char MagicID[6] = "MMPLO";
+
+constexpr uint16_t Version = 100;
+
+/** Directory entry of one particle list */
+struct ListEntry {
+    uint8_t vert_type;
+    uint8_t col_type;
+    uint8_t global_colour[4];
+    uint16_t reserved;
+    float global_radius;
+    float col_range[2];
+    uint32_t node_count;
+};
+
+/** Directory entry of one octree node */
+struct NodeEntry {
+    uint64_t offset;
+    uint64_t count;
+    float box[6];
+    uint32_t level;
+    uint32_t reserved;
+    int32_t children[8];
+};
+
+/** The file header */
+struct Header {
+    uint16_t version = 0;
+    uint32_t list_count = 0;
+    float bbox[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    float clipbox[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    uint64_t directory_offset = 0;
+};
+
+/**
+ * Reads header and node directory of an octree file.
+ *
+ * @param in The stream to read from
+ * @param header Receives the file header
+ * @param lists Receives the list entries
+ * @param nodes Receives the node entries per list
+ *
+ * @return True on success
+ */
+inline bool ReadDirectory(
+    std::istream& in, Header& header, std::vector<ListEntry>& lists, std::vector<std::vector<NodeEntry>>& nodes) {
+    char magic[6];
+    in.read(magic, 6);
+    if (!in || std::memcmp(magic, MagicID, 6) != 0)
+        return false;
+    in.read(reinterpret_cast<char*>(&header.version), 2);
+    in.read(reinterpret_cast<char*>(&header.list_count), 4);
+    in.read(reinterpret_cast<char*>(header.bbox), 24);
+    in.read(reinterpret_cast<char*>(header.clipbox), 24);
+    in.read(reinterpret_cast<char*>(&header.directory_offset), 8);
+    if (!in || header.version != Version || header.directory_offset == 0)
+        return false;
+
+    in.seekg(header.directory_offset);
+    lists.resize(header.list_count);
+    nodes.resize(header.list_count);
+    for (uint32_t l = 0; l < header.list_count; ++l) {
+        in.read(reinterpret_cast<char*>(&lists[l]), sizeof(ListEntry));
+        nodes[l].resize(lists[l].node_count);
+        in.read(reinterpret_cast<char*>(nodes[l].data()), sizeof(NodeEntry) * lists[l].node_count);
+    }
+    return static_cast<bool>(in);
+}
+
+} // namespace megamol::moldyn::io::mmplo
@@ -0,0 +1,412 @@
+/*
+ * MMPLDOctreeDataSource.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "MMPLDOctreeDataSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <queue>
+
+#include "MMPLDFormat.h"
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/Vector3fParam.h"
+#include "mmcore/utility/log/Log.h"
+
+namespace megamol::moldyn::io {
+
+
+/*
+ * MMPLDOctreeDataSource::MMPLDOctreeDataSource
+ */
+MMPLDOctreeDataSource::MMPLDOctreeDataSource(void)
+        : core::Module()
+        , getDataSlot("getdata", "Slot to request data from this data source.")
+        , filenameSlot("filename", "The path to the octree file to load.")
+        , budgetSlot("particleBudget", "Maximum number of particles to load")
+        , useFocusSlot("useFocus", "Refines the octree around the focus point first")
+        , focusSlot("focus", "The point of interest in object space")
+        , composedCount(0)
+        , dataHash(0)
+        , loaderStop(false)
+        , newData(false) {
+
+    this->filenameSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_File_RestrictExtension, {"mmplo"});
+    this->MakeSlotAvailable(&this->filenameSlot);
+
+    this->budgetSlot << new core::param::IntParam(10000000, 1);
+    this->MakeSlotAvailable(&this->budgetSlot);
+
+    this->useFocusSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->useFocusSlot);
+
+    this->focusSlot << new core::param::Vector3fParam(vislib::math::Vector<float, 3>(0.0f, 0.0f, 0.0f));
+    this->MakeSlotAvailable(&this->focusSlot);
+
+    this->getDataSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
+        geocalls::MultiParticleDataCall::FunctionName(0), &MMPLDOctreeDataSource::getDataCallback);
+    this->getDataSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
+        geocalls::MultiParticleDataCall::FunctionName(1), &MMPLDOctreeDataSource::getExtentCallback);
+    this->MakeSlotAvailable(&this->getDataSlot);
+}
+
+
+/*
+ * MMPLDOctreeDataSource::~MMPLDOctreeDataSource
+ */
+MMPLDOctreeDataSource::~MMPLDOctreeDataSource(void) {
+    this->Release();
+}
+
+
+/*
+ * MMPLDOctreeDataSource::create
+ */
+bool MMPLDOctreeDataSource::create(void) {
+    return true;
+}
+
+
+/*
+ * MMPLDOctreeDataSource::release
+ */
+void MMPLDOctreeDataSource::release(void) {
+    this->stopLoader();
+    this->lists.clear();
+    this->nodes.clear();
+    this->selection.clear();
+    this->published.clear();
+}
+
+
+/*
+ * MMPLDOctreeDataSource::getDataCallback
+ */
+bool MMPLDOctreeDataSource::getDataCallback(core::Call& caller) {
+    auto* mpdc = dynamic_cast<geocalls::MultiParticleDataCall*>(&caller);
+    if (mpdc == nullptr)
+        return false;
+
+    this->assertFile();
+    this->assertSelection();
+    this->compose();
+
+    vislib::math::Cuboid<float> bbox;
+    bbox.Set(this->header.bbox[0], this->header.bbox[1], this->header.bbox[2], this->header.bbox[3],
+        this->header.bbox[4], this->header.bbox[5]);
+
+    mpdc->SetFrameCount(1);
+    mpdc->SetFrameID(0);
+    mpdc->SetDataHash(this->dataHash);
+    mpdc->SetParticleListCount(static_cast<unsigned int>(this->lists.size()));
+    for (size_t l = 0; l < this->lists.size(); ++l) {
+        auto const& le = this->lists[l];
+        auto& pts = mpdc->AccessParticles(static_cast<unsigned int>(l));
+        pts.SetGlobalRadius(le.global_radius);
+        pts.SetGlobalColour(le.global_colour[0], le.global_colour[1], le.global_colour[2], le.global_colour[3]);
+        pts.SetColourMapIndexValues(le.col_range[0], le.col_range[1]);
+        if (!this->nodes[l].empty()) {
+            auto const& root = this->nodes[l].front();
+            vislib::math::Cuboid<float> box;
+            box.Set(root.box[0], root.box[1], root.box[2], root.box[3], root.box[4], root.box[5]);
+            pts.SetBBox(box);
+        } else {
+            pts.SetBBox(bbox);
+        }
+
+        const unsigned int vertSize = mmpld::VertexSize(le.vert_type);
+        const unsigned int stride = vertSize + mmpld::ColourSize(le.col_type);
+        const uint64_t count = (stride > 0) ? this->published[l].size() / stride : 0;
+        pts.SetCount(count);
+        if (count > 0) {
+            uint8_t const* data = this->published[l].data();
+            pts.SetVertexData(mmpld::VertexDataType(le.vert_type), data, stride);
+            pts.SetColourData(mmpld::ColourDataType(le.col_type), data + vertSize, stride);
+        } else {
+            pts.SetVertexData(geocalls::SimpleSphericalParticles::VERTDATA_NONE, nullptr);
+            pts.SetColourData(geocalls::SimpleSphericalParticles::COLDATA_NONE, nullptr);
+        }
+    }
+    mpdc->SetUnlocker(nullptr);
+
+    return true;
+}
+
+
+/*
+ * MMPLDOctreeDataSource::getExtentCallback
+ */
+bool MMPLDOctreeDataSource::getExtentCallback(core::Call& caller) {
+    auto* mpdc = dynamic_cast<geocalls::MultiParticleDataCall*>(&caller);
+    if (mpdc == nullptr)
+        return false;
+
+    this->assertFile();
+    this->assertSelection();
+    this->compose();
+
+    mpdc->SetFrameCount(1);
+    mpdc->SetDataHash(this->dataHash);
+    mpdc->AccessBoundingBoxes().Clear();
+    mpdc->AccessBoundingBoxes().SetObjectSpaceBBox(this->header.bbox[0], this->header.bbox[1], this->header.bbox[2],
+        this->header.bbox[3], this->header.bbox[4], this->header.bbox[5]);
+    mpdc->AccessBoundingBoxes().SetObjectSpaceClipBox(this->header.clipbox[0], this->header.clipbox[1],
+        this->header.clipbox[2], this->header.clipbox[3], this->header.clipbox[4], this->header.clipbox[5]);
+    mpdc->SetUnlocker(nullptr);
+
+    return true;
+}
+
+
+/*
+ * MMPLDOctreeDataSource::assertFile
+ */
+void MMPLDOctreeDataSource::assertFile(void) {
+    using megamol::core::utility::log::Log;
+    if (!this->filenameSlot.IsDirty())
+        return;
+    this->filenameSlot.ResetDirty();
+
+    this->stopLoader();
+    this->header = mmplo::Header();
+    this->lists.clear();
+    this->nodes.clear();
+    this->selection.clear();
+    this->published.clear();
+    this->composedCount = 0;
+    this->loaded.clear();
+    this->loadQueue.clear();
+    ++this->dataHash;
+
+    const auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
+    if (filename.empty())
+        return;
+    std::ifstream in(filename, std::ios::binary);
+    if (!in || !mmplo::ReadDirectory(in, this->header, this->lists, this->nodes)) {
+        Log::DefaultLog.WriteError("Unable to read octree file \"%s\"", filename.generic_u8string().c_str());
+        this->header = mmplo::Header();
+        this->lists.clear();
+        this->nodes.clear();
+        return;
+    }
+    this->published.resize(this->lists.size());
+
+    // enforce a new selection for the new file
+    this->budgetSlot.ForceSetDirty();
+    this->startLoader();
+}
+
+
+/*
+ * MMPLDOctreeDataSource::assertSelection
+ */
+void MMPLDOctreeDataSource::assertSelection(void) {
+    if (!this->budgetSlot.IsDirty() && !this->useFocusSlot.IsDirty() && !this->focusSlot.IsDirty())
+        return;
+    this->budgetSlot.ResetDirty();
+    this->useFocusSlot.ResetDirty();
+    this->focusSlot.ResetDirty();
+
+    const uint64_t budget = static_cast<uint64_t>(this->budgetSlot.Param<core::param::IntParam>()->Value());
+    const bool useFocus = this->useFocusSlot.Param<core::param::BoolParam>()->Value();
+    const auto& focus = this->focusSlot.Param<core::param::Vector3fParam>()->Value();
+
+    // nodes close to the focus relative to their size come first, ties are broken coarse-to-fine
+    struct Candidate {
+        float priority;
+        uint32_t level;
+        NodeKey key;
+        bool operator<(Candidate const& rhs) const {
+            return (priority != rhs.priority) ? (priority > rhs.priority) : (level > rhs.level);
+        }
+    };
+    auto makeCandidate = [&](uint32_t l, uint32_t n) {
+        auto const& node = this->nodes[l][n];
+        float priority = static_cast<float>(node.level);
+        if (useFocus) {
+            float dist2 = 0.0f;
+            float diag2 = 0.0f;
+            for (int d = 0; d < 3; ++d) {
+                const float ext = node.box[d + 3] - node.box[d];
+                const float diff = std::max({node.box[d] - focus[d], 0.0f, focus[d] - node.box[d + 3]});
+                dist2 += diff * diff;
+                diag2 += ext * ext;
+            }
+            priority = (diag2 > 0.0f) ? std::sqrt(dist2 / diag2) : 0.0f;
+        }
+        return Candidate{priority, node.level, makeKey(l, n)};
+    };
+
+    std::priority_queue<Candidate> candidates;
+    for (uint32_t l = 0; l < this->nodes.size(); ++l) {
+        if (!this->nodes[l].empty()) {
+            candidates.push(makeCandidate(l, 0));
+        }
+    }
+    std::vector<NodeKey> newSelection;
+    std::vector<uint64_t> listSizes(this->lists.size(), 0);
+    uint64_t total = 0;
+    while (!candidates.empty()) {
+        const Candidate c = candidates.top();
+        candidates.pop();
+        const uint32_t l = static_cast<uint32_t>(c.key >> 32);
+        auto const& node = this->nodes[l][static_cast<uint32_t>(c.key)];
+        if (total + node.count > budget)
+            continue;
+        total += node.count;
+        listSizes[l] += node.count;
+        newSelection.push_back(c.key);
+        for (int32_t child : node.children) {
+            if (child >= 0) {
+                candidates.push(makeCandidate(l, static_cast<uint32_t>(child)));
+            }
+        }
+    }
+
+    if (newSelection == this->selection)
+        return;
+    this->composedCount = 0;
+    for (size_t l = 0; l < this->lists.size(); ++l) {
+        const unsigned int stride =
+            mmpld::VertexSize(this->lists[l].vert_type) + mmpld::ColourSize(this->lists[l].col_type);
+        this->published[l].clear();
+        this->published[l].reserve(listSizes[l] * stride);
+    }
+    ++this->dataHash;
+
+    std::lock_guard<std::mutex> lock(this->loaderLock);
+    this->selection = std::move(newSelection);
+    std::unordered_map<NodeKey, std::vector<uint8_t>> keep;
+    this->loadQueue.clear();
+    for (NodeKey key : this->selection) {
+        auto it = this->loaded.find(key);
+        if (it != this->loaded.end()) {
+            keep.emplace(key, std::move(it->second));
+        } else {
+            this->loadQueue.push_back(key);
+        }
+    }
+    this->loaded = std::move(keep);
+    this->newData = true;
+    this->loaderCond.notify_one();
+}
+
+
+/*
+ * MMPLDOctreeDataSource::compose
+ */
+void MMPLDOctreeDataSource::compose(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->loaderLock);
+        if (!this->newData)
+            return;
+        this->newData = false;
+    }
+
+    // nodes are loaded in selection order, so the published lists grow by appending
+    bool changed = false;
+    while (this->composedCount < this->selection.size()) {
+        const NodeKey key = this->selection[this->composedCount];
+        std::vector<uint8_t> const* data = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(this->loaderLock);
+            auto it = this->loaded.find(key);
+            if (it != this->loaded.end()) {
+                data = &it->second;
+            }
+        }
+        if (data == nullptr)
+            break;
+        // the loader never modifies or erases an element once it is inserted
+        auto& dst = this->published[static_cast<uint32_t>(key >> 32)];
+        dst.insert(dst.end(), data->begin(), data->end());
+        ++this->composedCount;
+        changed = true;
+    }
+    if (changed) {
+        ++this->dataHash;
+    }
+}
+
+
+/*
+ * MMPLDOctreeDataSource::startLoader
+ */
+void MMPLDOctreeDataSource::startLoader(void) {
+    this->loaderStop = false;
+    this->loader = std::thread(
+        &MMPLDOctreeDataSource::loaderLoop, this, this->filenameSlot.Param<core::param::FilePathParam>()->Value());
+}
+
+
+/*
+ * MMPLDOctreeDataSource::stopLoader
+ */
+void MMPLDOctreeDataSource::stopLoader(void) {
+    if (!this->loader.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(this->loaderLock);
+        this->loaderStop = true;
+    }
+    this->loaderCond.notify_one();
+    this->loader.join();
+}
+
+
+/*
+ * MMPLDOctreeDataSource::loaderLoop
+ */
+void MMPLDOctreeDataSource::loaderLoop(std::filesystem::path filename) {
+    using megamol::core::utility::log::Log;
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        Log::DefaultLog.WriteError("Unable to open octree file \"%s\"", filename.generic_u8string().c_str());
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->loaderLock);
+    while (true) {
+        this->loaderCond.wait(lock, [this]() { return this->loaderStop || !this->loadQueue.empty(); });
+        if (this->loaderStop)
+            break;
+        const NodeKey key = this->loadQueue.front();
+        this->loadQueue.pop_front();
+        if (this->loaded.count(key) > 0)
+            continue;
+
+        // the directory is immutable while the loader runs
+        const uint32_t l = static_cast<uint32_t>(key >> 32);
+        auto const& le = this->lists[l];
+        auto const& node = this->nodes[l][static_cast<uint32_t>(key)];
+        const uint64_t size = node.count * (mmpld::VertexSize(le.vert_type) + mmpld::ColourSize(le.col_type));
+
+        lock.unlock();
+        std::vector<uint8_t> data(size);
+        in.seekg(node.offset);
+        in.read(reinterpret_cast<char*>(data.data()), size);
+        const bool ok = static_cast<bool>(in);
+        lock.lock();
+
+        if (!ok) {
+            Log::DefaultLog.WriteError("Unable to read octree node from \"%s\"", filename.generic_u8string().c_str());
+            break;
+        }
+        // drop nodes deselected in the meantime
+        if (std::find(this->loadQueue.begin(), this->loadQueue.end(), key) == this->loadQueue.end() &&
+            std::find(this->selection.begin(), this->selection.end(), key) == this->selection.end())
+            continue;
+        this->loaded.emplace(key, std::move(data));
+        this->newData = true;
+    }
+}
+
+} // namespace megamol::moldyn::io
@@ -0,0 +1,164 @@
+/*
+ * MMPLDOctreeDataSource.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "MMPLDOctree.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/param/ParamSlot.h"
+
+
+namespace megamol::moldyn::io {
+
+
+/**
+ * Data source streaming particles from an octree file written by MMPLDOctreeWriter.
+ *
+ * A subset of nodes is selected coarse-to-fine until the particle budget is exhausted, optionally refining nodes near
+ * a focus point first. The selected nodes are read by a background thread and published to the call as soon as they
+ * arrive, so a coarse overview is available immediately and gets refined over the following frames.
+ */
+class MMPLDOctreeDataSource : public core::Module {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "MMPLDOctreeDataSource";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "Streams a level-of-detail subset of a particle octree file within a particle budget";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor. */
+    MMPLDOctreeDataSource(void);
+
+    /** Dtor. */
+    virtual ~MMPLDOctreeDataSource(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool create(void) override;
+
+    /**
+     * Implementation of 'Release'.
+     */
+    void release(void) override;
+
+private:
+    /** Identifies a node by list index (upper 32 bit) and node index (lower 32 bit) */
+    using NodeKey = uint64_t;
+
+    static NodeKey makeKey(uint32_t list, uint32_t node) {
+        return (static_cast<uint64_t>(list) << 32) | node;
+    }
+
+    bool getDataCallback(core::Call& caller);
+
+    bool getExtentCallback(core::Call& caller);
+
+    /** Opens the file if the file name changed and restarts the loader */
+    void assertFile(void);
+
+    /** Recomputes the node selection if budget or focus changed */
+    void assertSelection(void);
+
+    /** Copies newly loaded nodes into the published particle lists */
+    void compose(void);
+
+    void startLoader(void);
+
+    void stopLoader(void);
+
+    void loaderLoop(std::filesystem::path filename);
+
+    /** The slot for requesting data */
+    core::CalleeSlot getDataSlot;
+
+    /** The octree file */
+    core::param::ParamSlot filenameSlot;
+
+    /** Maximum number of particles to load */
+    core::param::ParamSlot budgetSlot;
+
+    /** Whether to refine around the focus point first */
+    core::param::ParamSlot useFocusSlot;
+
+    /** The focus point in object space */
+    core::param::ParamSlot focusSlot;
+
+    /** The file header */
+    mmplo::Header header;
+
+    /** The list directory */
+    std::vector<mmplo::ListEntry> lists;
+
+    /** The node directory per list */
+    std::vector<std::vector<mmplo::NodeEntry>> nodes;
+
+    /** The selected nodes in load order, only modified while holding 'loaderLock' */
+    std::vector<NodeKey> selection;
+
+    /** Number of selected nodes already appended to 'published' */
+    size_t composedCount;
+
+    /** The particle records handed out to the call, one buffer per list */
+    std::vector<std::vector<uint8_t>> published;
+
+    /** The data hash */
+    size_t dataHash;
+
+    /** The background loader, all members below are guarded by 'loaderLock' */
+    std::thread loader;
+    std::mutex loaderLock;
+    std::condition_variable loaderCond;
+    std::atomic<bool> loaderStop;
+
+    /** Nodes still to be read, in order */
+    std::deque<NodeKey> loadQueue;
+
+    /** Node data already read */
+    std::unordered_map<NodeKey, std::vector<uint8_t>> loaded;
+
+    /** Set by the loader whenever new data arrives */
+    bool newData;
+};
+
+
+} // namespace megamol::moldyn::io
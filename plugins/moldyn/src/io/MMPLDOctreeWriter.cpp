@@ -0,0 +1,492 @@
+/*
+ * MMPLDOctreeWriter.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "MMPLDOctreeWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MMPLDCompression.h"
+#include "MMPLDFormat.h"
+#include "MMPLDOctree.h"
+#include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/utility/log/Log.h"
+
+namespace megamol::moldyn::io {
+
+namespace {
+
+/** Number of particle records read from disk at once */
+constexpr uint64_t ChunkRecords = 1 << 20;
+
+/** Sequential source of interleaved particle records */
+class RecordSource {
+public:
+    RecordSource(std::istream& in, uint64_t count, unsigned int stride)
+            : in(in)
+            , remaining(count)
+            , count(count)
+            , stride(stride) {}
+
+    uint64_t Count() const {
+        return this->count;
+    }
+
+    /** Reads up to 'max_records' records into 'dst', answers the number of records read */
+    uint64_t Read(std::vector<uint8_t>& dst, uint64_t max_records) {
+        const uint64_t n = std::min(max_records, this->remaining);
+        dst.resize(n * this->stride);
+        if (n > 0) {
+            this->in.read(reinterpret_cast<char*>(dst.data()), dst.size());
+            if (!this->in) {
+                throw std::runtime_error("unexpected end of particle data");
+            }
+        }
+        this->remaining -= n;
+        return n;
+    }
+
+private:
+    std::istream& in;
+    uint64_t remaining;
+    uint64_t count;
+    unsigned int stride;
+};
+
+/** Recursive octree construction for one particle list */
+class OctreeBuilder {
+public:
+    OctreeBuilder(std::ofstream& out, std::filesystem::path const& tmp_dir, uint8_t vert_type, unsigned int stride,
+        unsigned int resolution, unsigned int max_depth, uint64_t memory_records)
+            : out(out)
+            , tmpDir(tmp_dir)
+            , vertType(vert_type)
+            , stride(stride)
+            , resolution(resolution)
+            , leafCapacity(static_cast<uint64_t>(resolution) * resolution * resolution)
+            , maxDepth(max_depth)
+            , memoryRecords(std::max<uint64_t>(memory_records, 1))
+            , spillCounter(0) {}
+
+    std::vector<mmplo::NodeEntry>& Nodes() {
+        return this->nodes;
+    }
+
+    /** Builds the subtree of all particles of 'src' within 'box', answers the index of its root node */
+    int32_t Build(RecordSource& src, std::array<float, 6> const& box, uint32_t level) {
+        const uint64_t count = src.Count();
+        if (count <= this->memoryRecords) {
+            std::vector<uint8_t> recs;
+            src.Read(recs, count);
+            return this->buildInMemory(recs, box, level);
+        }
+
+        const int32_t idx = this->newNode(box, level);
+        if (level >= this->maxDepth) {
+            // degenerate input (e.g. many coincident particles): store everything in this leaf
+            this->nodes[idx].offset = static_cast<uint64_t>(this->out.tellp());
+            std::vector<uint8_t> chunk;
+            while (const uint64_t n = src.Read(chunk, ChunkRecords)) {
+                this->out.write(reinterpret_cast<char const*>(chunk.data()), chunk.size());
+                this->nodes[idx].count += n;
+            }
+            return idx;
+        }
+
+        std::vector<uint8_t> occupied(this->leafCapacity, 0);
+        std::vector<uint8_t> samples;
+        std::array<std::filesystem::path, 8> spillNames;
+        std::array<std::unique_ptr<std::ofstream>, 8> spills;
+        std::array<uint64_t, 8> spillCounts;
+        spillCounts.fill(0);
+
+        std::vector<uint8_t> chunk;
+        while (const uint64_t n = src.Read(chunk, ChunkRecords)) {
+            for (uint64_t i = 0; i < n; ++i) {
+                uint8_t const* rec = chunk.data() + i * this->stride;
+                const auto pos = mmpld::ReadPosition(this->vertType, rec);
+                const uint64_t cell = this->cellOf(pos, box);
+                if (!occupied[cell]) {
+                    occupied[cell] = 1;
+                    samples.insert(samples.end(), rec, rec + this->stride);
+                    continue;
+                }
+                const int c = childOf(pos, box);
+                if (!spills[c]) {
+                    spillNames[c] = this->tmpDir / ("node" + std::to_string(this->spillCounter++) + ".tmp");
+                    spills[c] = std::make_unique<std::ofstream>(spillNames[c], std::ios::binary | std::ios::trunc);
+                    if (!*spills[c]) {
+                        throw std::runtime_error("cannot create temporary file " + spillNames[c].string());
+                    }
+                }
+                spills[c]->write(reinterpret_cast<char const*>(rec), this->stride);
+                ++spillCounts[c];
+            }
+        }
+        this->writeNode(idx, samples);
+        samples = std::vector<uint8_t>();
+
+        for (int c = 0; c < 8; ++c) {
+            if (!spills[c])
+                continue;
+            spills[c]->close();
+            if (!*spills[c]) {
+                throw std::runtime_error("cannot write temporary file " + spillNames[c].string());
+            }
+            spills[c].reset();
+            {
+                std::ifstream in(spillNames[c], std::ios::binary);
+                RecordSource childSrc(in, spillCounts[c], this->stride);
+                const int32_t child = this->Build(childSrc, childBox(box, c), level + 1);
+                this->nodes[idx].children[c] = child;
+            }
+            std::filesystem::remove(spillNames[c]);
+        }
+        return idx;
+    }
+
+private:
+    int32_t buildInMemory(std::vector<uint8_t>& recs, std::array<float, 6> const& box, uint32_t level) {
+        const int32_t idx = this->newNode(box, level);
+        const uint64_t count = recs.size() / this->stride;
+        if (count <= this->leafCapacity || level >= this->maxDepth) {
+            this->writeNode(idx, recs);
+            return idx;
+        }
+
+        std::vector<uint8_t> occupied(this->leafCapacity, 0);
+        std::vector<uint8_t> samples;
+        std::array<std::vector<uint8_t>, 8> children;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint8_t const* rec = recs.data() + i * this->stride;
+            const auto pos = mmpld::ReadPosition(this->vertType, rec);
+            const uint64_t cell = this->cellOf(pos, box);
+            if (!occupied[cell]) {
+                occupied[cell] = 1;
+                samples.insert(samples.end(), rec, rec + this->stride);
+            } else {
+                auto& child = children[childOf(pos, box)];
+                child.insert(child.end(), rec, rec + this->stride);
+            }
+        }
+        recs = std::vector<uint8_t>();
+        this->writeNode(idx, samples);
+
+        for (int c = 0; c < 8; ++c) {
+            if (children[c].empty())
+                continue;
+            const int32_t child = this->buildInMemory(children[c], childBox(box, c), level + 1);
+            this->nodes[idx].children[c] = child;
+        }
+        return idx;
+    }
+
+    int32_t newNode(std::array<float, 6> const& box, uint32_t level) {
+        mmplo::NodeEntry node;
+        node.offset = 0;
+        node.count = 0;
+        std::copy(box.begin(), box.end(), node.box);
+        node.level = level;
+        node.reserved = 0;
+        std::fill(std::begin(node.children), std::end(node.children), -1);
+        this->nodes.push_back(node);
+        return static_cast<int32_t>(this->nodes.size() - 1);
+    }
+
+    void writeNode(int32_t idx, std::vector<uint8_t> const& recs) {
+        this->nodes[idx].offset = static_cast<uint64_t>(this->out.tellp());
+        this->nodes[idx].count = recs.size() / this->stride;
+        this->out.write(reinterpret_cast<char const*>(recs.data()), recs.size());
+    }
+
+    uint64_t cellOf(std::array<float, 3> const& pos, std::array<float, 6> const& box) const {
+        uint64_t cell = 0;
+        for (int d = 2; d >= 0; --d) {
+            const float ext = box[d + 3] - box[d];
+            const float rel = (ext > 0.0f) ? (pos[d] - box[d]) / ext : 0.0f;
+            const auto c = static_cast<int64_t>(rel * static_cast<float>(this->resolution));
+            cell = cell * this->resolution + static_cast<uint64_t>(std::clamp<int64_t>(c, 0, this->resolution - 1));
+        }
+        return cell;
+    }
+
+    static int childOf(std::array<float, 3> const& pos, std::array<float, 6> const& box) {
+        int c = 0;
+        for (int d = 0; d < 3; ++d) {
+            if (pos[d] >= 0.5f * (box[d] + box[d + 3])) {
+                c |= 1 << d;
+            }
+        }
+        return c;
+    }
+
+    static std::array<float, 6> childBox(std::array<float, 6> const& box, int c) {
+        std::array<float, 6> res = box;
+        for (int d = 0; d < 3; ++d) {
+            const float mid = 0.5f * (box[d] + box[d + 3]);
+            if (c & (1 << d)) {
+                res[d] = mid;
+            } else {
+                res[d + 3] = mid;
+            }
+        }
+        return res;
+    }
+
+    std::ofstream& out;
+    std::filesystem::path tmpDir;
+    uint8_t vertType;
+    unsigned int stride;
+    unsigned int resolution;
+    uint64_t leafCapacity;
+    unsigned int maxDepth;
+    uint64_t memoryRecords;
+    uint64_t spillCounter;
+    std::vector<mmplo::NodeEntry> nodes;
+};
+
+} // namespace
+
+
+/*
+ * MMPLDOctreeWriter::MMPLDOctreeWriter
+ */
+MMPLDOctreeWriter::MMPLDOctreeWriter(void)
+        : AbstractDataWriter()
+        , inputFilenameSlot("inputFilename", "The path to the MMPLD file to be converted")
+        , filenameSlot("filename", "The path to the octree file to be written")
+        , frameSlot("frame", "The frame of the MMPLD file to be converted")
+        , nodeResolutionSlot("nodeResolution", "Resolution of the sampling grid per node and axis")
+        , maxDepthSlot("maxDepth", "Maximum depth of the octree")
+        , memoryLimitSlot("memoryLimit", "Size of subtrees (in MegaBytes) that are built in memory") {
+
+    this->inputFilenameSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_File_RestrictExtension, {"mmpld"});
+    this->MakeSlotAvailable(&this->inputFilenameSlot);
+
+    this->filenameSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_File_ToBeCreatedWithRestrExts, {"mmplo"});
+    this->MakeSlotAvailable(&this->filenameSlot);
+
+    this->frameSlot << new core::param::IntParam(0, 0);
+    this->MakeSlotAvailable(&this->frameSlot);
+
+    this->nodeResolutionSlot << new core::param::IntParam(32, 2, 256);
+    this->MakeSlotAvailable(&this->nodeResolutionSlot);
+
+    this->maxDepthSlot << new core::param::IntParam(16, 1, 32);
+    this->MakeSlotAvailable(&this->maxDepthSlot);
+
+    this->memoryLimitSlot << new core::param::IntParam(1024, 1);
+    this->MakeSlotAvailable(&this->memoryLimitSlot);
+}
+
+
+/*
+ * MMPLDOctreeWriter::~MMPLDOctreeWriter
+ */
+MMPLDOctreeWriter::~MMPLDOctreeWriter(void) {
+    this->Release();
+}
+
+
+/*
+ * MMPLDOctreeWriter::create
+ */
+bool MMPLDOctreeWriter::create(void) {
+    return true;
+}
+
+
+/*
+ * MMPLDOctreeWriter::release
+ */
+void MMPLDOctreeWriter::release(void) {}
+
+
+/*
+ * MMPLDOctreeWriter::run
+ */
+bool MMPLDOctreeWriter::run(void) {
+    using megamol::core::utility::log::Log;
+
+    const auto inputName = this->inputFilenameSlot.Param<core::param::FilePathParam>()->Value();
+    const auto outputName = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
+    if (inputName.empty() || outputName.empty()) {
+        Log::DefaultLog.WriteError("No input or output file name specified. Abort.");
+        return false;
+    }
+
+    std::ifstream in(inputName, std::ios::binary);
+    if (!in) {
+        Log::DefaultLog.WriteError("Unable to open \"%s\". Abort.", inputName.generic_u8string().c_str());
+        return false;
+    }
+
+    char magic[6];
+    uint16_t version = 0;
+    uint32_t frameCount = 0;
+    mmplo::Header header;
+    in.read(magic, 6);
+    in.read(reinterpret_cast<char*>(&version), 2);
+    in.read(reinterpret_cast<char*>(&frameCount), 4);
+    in.read(reinterpret_cast<char*>(header.bbox), 24);
+    in.read(reinterpret_cast<char*>(header.clipbox), 24);
+    if (!in || std::memcmp(magic, "MMPLD", 6) != 0 || version < 100 || version > mmpld::ChunkedVersion) {
+        Log::DefaultLog.WriteError(
+            "\"%s\" is not a supported MMPLD file. Abort.", inputName.generic_u8string().c_str());
+        return false;
+    }
+    const uint32_t frame = static_cast<uint32_t>(this->frameSlot.Param<core::param::IntParam>()->Value());
+    if (frame >= frameCount) {
+        Log::DefaultLog.WriteError("Frame %u requested, but file only has %u frames. Abort.", frame, frameCount);
+        return false;
+    }
+    uint64_t frameOffsets[2] = {0, 0};
+    in.seekg(sizeof(uint64_t) * frame, std::ios::cur);
+    in.read(reinterpret_cast<char*>(frameOffsets), 16);
+    in.seekg(frameOffsets[0]);
+
+    // chunked frames cannot be streamed, they are decoded to the uncompressed layout of version 1.3 in memory
+    const bool chunked = version >= mmpld::ChunkedVersion;
+    std::istringstream decoded;
+    if (in && chunked && frameOffsets[1] > frameOffsets[0]) {
+        std::vector<uint8_t> packed(static_cast<size_t>(frameOffsets[1] - frameOffsets[0]));
+        in.read(reinterpret_cast<char*>(packed.data()), packed.size());
+        vislib::RawStorage raw;
+        if (!in || !mmpld::DecodeFrame(packed.data(), packed.size(), raw)) {
+            Log::DefaultLog.WriteError("Unable to decode frame %u. Abort.", frame);
+            return false;
+        }
+        decoded.str(std::string(raw.As<char>(), raw.GetSize()));
+        version = 103;
+    }
+    std::istream& frameData = chunked ? static_cast<std::istream&>(decoded) : in;
+    if (version >= 102) {
+        float timestamp;
+        frameData.read(reinterpret_cast<char*>(&timestamp), 4);
+    }
+    frameData.read(reinterpret_cast<char*>(&header.list_count), 4);
+    if (!frameData) {
+        Log::DefaultLog.WriteError("Unable to read frame %u. Abort.", frame);
+        return false;
+    }
+
+    std::ofstream out(outputName, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        Log::DefaultLog.WriteError("Unable to create \"%s\". Abort.", outputName.generic_u8string().c_str());
+        return false;
+    }
+    header.version = mmplo::Version;
+    out.write(mmplo::MagicID, 6);
+    out.write(reinterpret_cast<char const*>(&header.version), 2);
+    out.write(reinterpret_cast<char const*>(&header.list_count), 4);
+    out.write(reinterpret_cast<char const*>(header.bbox), 24);
+    out.write(reinterpret_cast<char const*>(header.clipbox), 24);
+    const auto directoryOffsetPos = out.tellp();
+    out.write(reinterpret_cast<char const*>(&header.directory_offset), 8);
+
+    std::filesystem::path tmpDir = outputName;
+    tmpDir += ".tmp";
+    std::filesystem::create_directories(tmpDir);
+
+    const unsigned int resolution = this->nodeResolutionSlot.Param<core::param::IntParam>()->Value();
+    const unsigned int maxDepth = this->maxDepthSlot.Param<core::param::IntParam>()->Value();
+    const uint64_t memoryBytes =
+        static_cast<uint64_t>(this->memoryLimitSlot.Param<core::param::IntParam>()->Value()) * 1024 * 1024;
+
+    std::vector<mmplo::ListEntry> lists(header.list_count);
+    std::vector<std::vector<mmplo::NodeEntry>> nodes(header.list_count);
+    try {
+        for (uint32_t l = 0; l < header.list_count; ++l) {
+            mmpld::ListHeader lh;
+            if (!mmpld::ReadListHeader(frameData, version, lh)) {
+                throw std::runtime_error("cannot read list header " + std::to_string(l));
+            }
+            auto& le = lists[l];
+            le.vert_type = lh.vert_type;
+            le.col_type = lh.col_type;
+            std::copy(std::begin(lh.global_colour), std::end(lh.global_colour), le.global_colour);
+            le.reserved = 0;
+            le.global_radius = lh.global_radius;
+            le.col_range[0] = lh.col_range[0];
+            le.col_range[1] = lh.col_range[1];
+            le.node_count = 0;
+
+            const unsigned int stride = lh.Stride();
+            const uint64_t dataStart = static_cast<uint64_t>(frameData.tellg());
+            if (stride > 0 && lh.count > 0) {
+                std::array<float, 6> box;
+                float const* listBox = lh.has_bbox ? lh.bbox : header.bbox;
+                std::copy(listBox, listBox + 6, box.begin());
+                RecordSource src(frameData, lh.count, stride);
+                OctreeBuilder builder(out, tmpDir, lh.vert_type, stride, resolution, maxDepth, memoryBytes / stride);
+                builder.Build(src, box, 0);
+                nodes[l] = std::move(builder.Nodes());
+                le.node_count = static_cast<uint32_t>(nodes[l].size());
+                Log::DefaultLog.WriteInfo("List %u: %llu particles in %u octree nodes", l,
+                    static_cast<unsigned long long>(lh.count), le.node_count);
+            }
+
+            frameData.seekg(dataStart + lh.count * stride);
+            if (version == 101) {
+                // skip the cluster infos
+                uint32_t numClusters = 0;
+                uint64_t clusterDataSize = 0;
+                frameData.read(reinterpret_cast<char*>(&numClusters), 4);
+                frameData.read(reinterpret_cast<char*>(&clusterDataSize), 8);
+                frameData.seekg(clusterDataSize, std::ios::cur);
+            }
+        }
+        if (!out) {
+            throw std::runtime_error("cannot write node data");
+        }
+    } catch (std::exception const& ex) {
+        Log::DefaultLog.WriteError("Octree construction failed: %s. Abort.", ex.what());
+        out.close();
+        std::filesystem::remove_all(tmpDir);
+        std::filesystem::remove(outputName);
+        return false;
+    }
+    std::filesystem::remove_all(tmpDir);
+
+    header.directory_offset = static_cast<uint64_t>(out.tellp());
+    for (uint32_t l = 0; l < header.list_count; ++l) {
+        out.write(reinterpret_cast<char const*>(&lists[l]), sizeof(mmplo::ListEntry));
+        out.write(reinterpret_cast<char const*>(nodes[l].data()), sizeof(mmplo::NodeEntry) * nodes[l].size());
+    }
+    out.seekp(directoryOffsetPos);
+    out.write(reinterpret_cast<char const*>(&header.directory_offset), 8);
+    out.close();
+    if (!out) {
+        Log::DefaultLog.WriteError("Unable to write \"%s\".", outputName.generic_u8string().c_str());
+        return false;
+    }
+
+    Log::DefaultLog.WriteInfo("Completed writing \"%s\"", outputName.generic_u8string().c_str());
+    return true;
+}
+
+
+/*
+ * MMPLDOctreeWriter::getCapabilities
+ */
+bool MMPLDOctreeWriter::getCapabilities(core::DataWriterCtrlCall& call) {
+    call.SetAbortable(false);
+    return true;
+}
+
+} // namespace megamol::moldyn::io
@@ -0,0 +1,118 @@
+/*
+ * MMPLDOctreeWriter.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include "mmcore/param/ParamSlot.h"
+#include "mmstd/data/AbstractDataWriter.h"
+
+
+namespace megamol::moldyn::io {
+
+
+/**
+ * Builds a level-of-detail particle octree from one frame of an MMPLD file.
+ *
+ * The input file is streamed in chunks. Nodes holding more particles than fit into the memory limit are split by
+ * spilling their particles into temporary files next to the output file, smaller subtrees are built in memory.
+ * Frames of chunked files (version 1.4) cannot be streamed and are decoded in memory first.
+ */
+class MMPLDOctreeWriter : public core::AbstractDataWriter {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "MMPLDOctreeWriter";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "Builds a level-of-detail particle octree from an MMPLD file";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /**
+     * Disallow usage in quickstarts
+     *
+     * @return false
+     */
+    static bool SupportQuickstart(void) {
+        return false;
+    }
+
+    /** Ctor. */
+    MMPLDOctreeWriter(void);
+
+    /** Dtor. */
+    virtual ~MMPLDOctreeWriter(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool create(void) override;
+
+    /**
+     * Implementation of 'Release'.
+     */
+    void release(void) override;
+
+    /**
+     * The main function
+     *
+     * @return True on success
+     */
+    bool run(void) override;
+
+    /**
+     * Function querying the writers capabilities
+     *
+     * @param call The call to receive the capabilities
+     *
+     * @return True on success
+     */
+    bool getCapabilities(core::DataWriterCtrlCall& call) override;
+
+private:
+    /** The MMPLD file to read */
+    core::param::ParamSlot inputFilenameSlot;
+
+    /** The octree file to write */
+    core::param::ParamSlot filenameSlot;
+
+    /** The frame of the MMPLD file to convert */
+    core::param::ParamSlot frameSlot;
+
+    /** Resolution of the sampling grid per node and axis */
+    core::param::ParamSlot nodeResolutionSlot;
+
+    /** Maximum depth of the octree */
+    core::param::ParamSlot maxDepthSlot;
+
+    /** Size of subtrees (in MegaBytes) that are built in memory */
+    core::param::ParamSlot memoryLimitSlot;
+};
+
+
+} // namespace megamol::moldyn::io
@@ -6,20 +6,70 @@
  */
 
 #include "MMPLDWriter.h"
+#include "MMPLDCompression.h"
+#include "MMPLDFormat.h"
 #include "mmcore/BoundingBoxes.h"
 #include <algorithm>
+#include <vector>
 
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
+#include "vislib/RawStorage.h"
 #include "vislib/String.h"
 #include "vislib/sys/FastFile.h"
 #include "vislib/sys/Thread.h"
 
 namespace megamol::moldyn::io {
 
+namespace {
+
+/**
+ * Sorts packed particle records along a Morton curve over the bounding box of their positions.
+ *
+ * @param records The records, sorted in place
+ * @param vt The MMPLD vertex type
+ * @param stride The size of one record
+ * @param box Receives the bounding box of the positions
+ *
+ * @return The Morton code of every sorted record
+ */
+std::vector<uint32_t> sortRecordsSpatially(std::vector<uint8_t>& records, uint8_t vt, size_t stride, float* box) {
+    auto const cnt = static_cast<int64_t>(records.size() / stride);
+    auto const first = mmpld::ReadPosition(vt, records.data());
+    std::copy(first.begin(), first.end(), box);
+    std::copy(first.begin(), first.end(), box + 3);
+    for (int64_t i = 1; i < cnt; ++i) {
+        auto const pos = mmpld::ReadPosition(vt, records.data() + i * stride);
+        for (int k = 0; k < 3; ++k) {
+            box[k] = std::min(box[k], pos[k]);
+            box[k + 3] = std::max(box[k + 3], pos[k]);
+        }
+    }
+
+    std::vector<std::pair<uint32_t, uint64_t>> order(static_cast<size_t>(cnt));
+#pragma omp parallel for
+    for (int64_t i = 0; i < cnt; ++i) {
+        order[i] = {mmpld::MortonCode(mmpld::ReadPosition(vt, records.data() + i * stride), box),
+            static_cast<uint64_t>(i)};
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<uint8_t> sorted(records.size());
+    std::vector<uint32_t> codes(static_cast<size_t>(cnt));
+#pragma omp parallel for
+    for (int64_t i = 0; i < cnt; ++i) {
+        std::copy_n(records.data() + order[i].second * stride, stride, sorted.data() + i * stride);
+        codes[i] = order[i].first;
+    }
+    records.swap(sorted);
+    return codes;
+}
+
+} // namespace
+
 /*
  * :MMPLDWriter::MMPLDWriter
  */
@@ -27,6 +77,13 @@ MMPLDWriter::MMPLDWriter(void)
         : AbstractDataWriter()
         , filenameSlot("filename", "The path to the MMPLD file to be written")
         , versionSlot("version", "The file format version to be written")
+        , quantizeSlot("quantize", "Quantize the positions of float particle lists to 16 bit (version 1.4 only)")
+        , chunkSizeSlot("chunkSize", "The number of particles per compressed chunk (version 1.4 only)")
+        , spatialSortSlot("spatialSort",
+              "Sort the particles along a Morton curve and store a cell directory for region queries (not in 1.1)")
+        , cellLevelSlot("cellLevel", "The cell directory has 2^cellLevel cells per axis")
+        , convertFileSlot("convertFile",
+              "An existing MMPLD file to be converted to the selected version instead of writing the connected data")
         , dataSlot("data", "The slot requesting the data to be written")
         , startFrameSlot("startFrame", "the first frame to write")
         , endFrameSlot("endFrame", "the last frame to write")
@@ -43,9 +100,26 @@ MMPLDWriter::MMPLDWriter(void)
 #endif
     verPar->SetTypePair(102, "1.2");
     verPar->SetTypePair(103, "1.3");
+    verPar->SetTypePair(mmpld::ChunkedVersion, "1.4 (compressed)");
     this->versionSlot.SetParameter(verPar);
     this->MakeSlotAvailable(&this->versionSlot);
 
+    this->quantizeSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->quantizeSlot);
+
+    this->chunkSizeSlot << new core::param::IntParam(static_cast<int>(mmpld::DefaultChunkSize), 1);
+    this->MakeSlotAvailable(&this->chunkSizeSlot);
+
+    this->spatialSortSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->spatialSortSlot);
+
+    this->cellLevelSlot << new core::param::IntParam(4, 0, static_cast<int>(mmpld::MaxCellLevel));
+    this->MakeSlotAvailable(&this->cellLevelSlot);
+
+    this->convertFileSlot << new core::param::FilePathParam(
+        "", core::param::FilePathParam::Flag_File_RestrictExtension, {"mmpld"});
+    this->MakeSlotAvailable(&this->convertFileSlot);
+
     this->startFrameSlot << new core::param::IntParam(0);
     this->MakeSlotAvailable(&startFrameSlot);
     this->endFrameSlot << new core::param::IntParam(0);
@@ -92,6 +166,11 @@ bool MMPLDWriter::run(void) {
         return false;
     }
 
+    auto const convertPath = this->convertFileSlot.Param<core::param::FilePathParam>()->Value();
+    if (!convertPath.empty()) {
+        return this->convertFile(vislib::StringA(convertPath.generic_u8string().c_str()), filename);
+    }
+
     geocalls::MultiParticleDataCall* mpdc = this->dataSlot.CallAs<geocalls::MultiParticleDataCall>();
     if (mpdc == NULL) {
         Log::DefaultLog.WriteError("No data source connected. Abort.");
@@ -258,6 +337,7 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
     using megamol::core::utility::log::Log;
     uint8_t const alpha = 255;
     int ver = this->versionSlot.Param<core::param::EnumParam>()->Value();
+    UINT64 const frameStart = static_cast<UINT64>(file.Tell());
 
     // HAZARD for megamol up to fc4e784dae531953ad4cd3180f424605474dd18b this reads == 102
     // which means that many MMPLDs out there with version 103 are written wrongly (no timestamp)!
@@ -269,8 +349,20 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
     UINT32 listCnt = data.GetParticleListCount();
     ASSERT_WRITEOUT(&listCnt, 4);
 
+    // chunked frames are only sorted, region queries need uncompressed records
+    bool const sortSpatially = this->spatialSortSlot.Param<core::param::BoolParam>()->Value() && (ver != 101);
+    bool const writeDirectory = sortSpatially && (ver < mmpld::ChunkedVersion);
+    auto const cellLevel = static_cast<unsigned int>(this->cellLevelSlot.Param<core::param::IntParam>()->Value());
+    std::vector<uint8_t> directory;
+    auto addToDirectory = [&directory](void const* data, size_t size) {
+        auto const* bytes = static_cast<uint8_t const*>(data);
+        directory.insert(directory.end(), bytes, bytes + size);
+    };
+    addToDirectory(&listCnt, 4);
+
     for (UINT32 li = 0; li < listCnt; li++) {
         geocalls::MultiParticleDataCall::Particles& points = data.AccessParticles(li);
+        UINT64 const headerOffset = static_cast<UINT64>(file.Tell()) - frameStart;
         UINT8 vt = 0, ct = 0;
         unsigned int vs = 0, vo = 0, cs = 0, co = 0;
         switch (points.GetVertexDataType()) {
@@ -391,8 +483,26 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
             ASSERT_WRITEOUT(points.GetBBox().PeekBounds(), 24);
         }
 
-        if (vt == 0)
+        if (vt == 0) {
+            if (writeDirectory) {
+                UINT32 const level = 0;
+                float const box[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+                UINT64 const starts[2] = {0, 0};
+                addToDirectory(&headerOffset, 8);
+                addToDirectory(&level, 4);
+                addToDirectory(box, sizeof(box));
+                addToDirectory(starts, sizeof(starts));
+            }
             continue;
+        }
+
+        // the records of the list are packed in memory and written at once
+        std::vector<uint8_t> records;
+        records.reserve(static_cast<size_t>(cnt * (vs + std::max(cs + 1, 8u))));
+        auto put = [&records](void const* data, size_t size) {
+            auto const* bytes = static_cast<uint8_t const*>(data);
+            records.insert(records.end(), bytes, bytes + size);
+        };
         const unsigned char* vp = static_cast<const unsigned char*>(points.GetVertexData());
         const unsigned char* cp = static_cast<const unsigned char*>(points.GetColourData());
         if (vt == 4 && ct < 5) {
@@ -401,58 +511,58 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
                 auto col = points.GetGlobalColour();
                 uint16_t colNew[4] = {col[0] * 257, col[1] * 257, col[2] * 257, col[3] * 257};
                 for (UINT64 i = 0; i < cnt; ++i) {
-                    ASSERT_WRITEOUT(vp, vs);
+                    put(vp, vs);
                     vp += vo;
-                    ASSERT_WRITEOUT(colNew, 8);
+                    put(colNew, 8);
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGB: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
-                    ASSERT_WRITEOUT(vp, vs);
+                    put(vp, vs);
                     vp += vo;
                     colNew[0] = cp[0] * 257;
                     colNew[1] = cp[1] * 257;
                     colNew[2] = cp[2] * 257;
                     colNew[3] = 65535;
-                    ASSERT_WRITEOUT(colNew, 8);
+                    put(colNew, 8);
                     cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGBA: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
-                    ASSERT_WRITEOUT(vp, vs);
+                    put(vp, vs);
                     vp += vo;
                     colNew[0] = cp[0] * 257;
                     colNew[1] = cp[1] * 257;
                     colNew[2] = cp[2] * 257;
                     colNew[3] = cp[3] * 257;
-                    ASSERT_WRITEOUT(colNew, 8);
+                    put(colNew, 8);
                     cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_I: {
                 double iNew;
                 for (UINT64 i = 0; i < cnt; ++i) {
-                    ASSERT_WRITEOUT(vp, vs);
+                    put(vp, vs);
                     vp += vo;
                     iNew = *(reinterpret_cast<const float*>(cp));
-                    ASSERT_WRITEOUT(&iNew, 8);
+                    put(&iNew, 8);
                     cp += co;
                 }
             } break;
             case geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGB: {
                 uint16_t colNew[4];
                 for (UINT64 i = 0; i < cnt; ++i) {
-                    ASSERT_WRITEOUT(vp, vs);
+                    put(vp, vs);
                     vp += vo;
                     const auto* col = reinterpret_cast<const float*>(cp);
                     colNew[0] = col[0] * 65535.0f;
                     colNew[1] = col[1] * 65535.0f;
                     colNew[2] = col[2] * 65535.0f;
                     colNew[3] = 65535.0f;
-                    ASSERT_WRITEOUT(colNew, 8);
+                    put(colNew, 8);
                     cp += co;
                 }
             } break;
@@ -463,18 +573,59 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
             }
         } else {
             for (UINT64 i = 0; i < cnt; i++) {
-                ASSERT_WRITEOUT(vp, vs);
+                put(vp, vs);
                 vp += vo;
                 if (ct != 0) {
-                    ASSERT_WRITEOUT(cp, cs);
+                    put(cp, cs);
                     // warning: this only works since only one format is 3 bytes long, the illegal ct = 1
                     if (cs == 3) { // the unaligned ct == 1, UINT8_RGB, will be silently upgraded to ct 2 / cs 4
-                        ASSERT_WRITEOUT(&alpha, 1);
+                        put(&alpha, 1);
                     }
                     cp += co;
                 }
             }
         }
+        if (sortSpatially && cnt > 0) {
+            float box[6];
+            auto const codes = sortRecordsSpatially(records, vt, records.size() / cnt, box);
+            if (writeDirectory) {
+                // count the particles per cell, the cell is given by the highest bits of the Morton code
+                std::vector<UINT64> starts((size_t(1) << (3 * cellLevel)) + 1, 0);
+                for (auto const code : codes) {
+                    ++starts[(code >> (3 * (mmpld::MortonBits - cellLevel))) + 1];
+                }
+                for (size_t c = 1; c < starts.size(); ++c) {
+                    starts[c] += starts[c - 1];
+                }
+                UINT32 const level = cellLevel;
+                addToDirectory(&headerOffset, 8);
+                addToDirectory(&level, 4);
+                addToDirectory(box, sizeof(box));
+                addToDirectory(starts.data(), starts.size() * sizeof(UINT64));
+            }
+        } else if (writeDirectory) {
+            UINT32 const level = 0;
+            float const box[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+            UINT64 const starts[2] = {0, cnt};
+            addToDirectory(&headerOffset, 8);
+            addToDirectory(&level, 4);
+            addToDirectory(box, sizeof(box));
+            addToDirectory(starts, sizeof(starts));
+        }
+
+        if (ver >= mmpld::ChunkedVersion) {
+            mmpld::ListHeader lh;
+            lh.vert_type = vt;
+            lh.col_type = (vt == 4 && ct < 5) ? ((ct == 3) ? 7 : 6) : ct;
+            lh.count = cnt;
+            std::vector<uint8_t> encoded;
+            mmpld::EncodeListData(lh, records.data(),
+                static_cast<uint32_t>(this->chunkSizeSlot.Param<core::param::IntParam>()->Value()),
+                this->quantizeSlot.Param<core::param::BoolParam>()->Value(), encoded);
+            ASSERT_WRITEOUT(encoded.data(), encoded.size());
+        } else if (!records.empty()) {
+            ASSERT_WRITEOUT(records.data(), records.size());
+        }
 #ifdef WITH_CLUSTERINFO
         if (ver == 101) {
             if (points.GetClusterInfos() != NULL) {
@@ -491,7 +642,183 @@ bool MMPLDWriter::writeFrame(vislib::sys::File& file, geocalls::MultiParticleDat
 #endif
     }
 
+    if (writeDirectory) {
+        UINT64 const directorySize = directory.size();
+        ASSERT_WRITEOUT(directory.data(), directory.size());
+        ASSERT_WRITEOUT(&directorySize, 8);
+        ASSERT_WRITEOUT(mmpld::CellDirectoryMagic, 8);
+    }
+
     return true;
 #undef ASSERT_WRITEOUT
 }
+
+
+/*
+ * MMPLDWriter::convertFile
+ */
+bool MMPLDWriter::convertFile(vislib::StringA const& inFilename, vislib::TString const& outFilename) {
+    using megamol::core::utility::log::Log;
+
+    vislib::sys::FastFile in;
+    if (!in.Open(inFilename, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ,
+            vislib::sys::File::OPEN_ONLY)) {
+        Log::DefaultLog.WriteError("Unable to open input file \"%s\". Abort.", inFilename.PeekBuffer());
+        return false;
+    }
+
+#define ASSERT_READIN(A, S)                                                                              \
+    if (in.Read((A), (S)) != (S)) {                                                                      \
+        Log::DefaultLog.WriteError("Unable to read input file \"%s\". Abort.", inFilename.PeekBuffer()); \
+        return false;                                                                                    \
+    }
+
+    char magicID[6];
+    UINT16 inVersion = 0;
+    UINT32 frameCnt = 0;
+    float bbox[6], cbox[6];
+    ASSERT_READIN(magicID, 6);
+    ASSERT_READIN(&inVersion, 2);
+    if (::memcmp(magicID, "MMPLD", 6) != 0 || inVersion < 100 || inVersion > mmpld::ChunkedVersion) {
+        Log::DefaultLog.WriteError("\"%s\" is not a valid MMPLD file. Abort.", inFilename.PeekBuffer());
+        return false;
+    }
+    ASSERT_READIN(&frameCnt, 4);
+    ASSERT_READIN(bbox, 6 * 4);
+    ASSERT_READIN(cbox, 6 * 4);
+    std::vector<UINT64> frameIdx(frameCnt + 1);
+    ASSERT_READIN(frameIdx.data(), 8 * (frameCnt + 1));
+
+    vislib::sys::FastFile file;
+    if (!file.Open(outFilename, vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_EXCLUSIVE,
+            vislib::sys::File::CREATE_OVERWRITE)) {
+        Log::DefaultLog.WriteError(
+            "Unable to create output file \"%s\". Abort.", vislib::StringA(outFilename).PeekBuffer());
+        return false;
+    }
+
+#define ASSERT_WRITEOUT(A, S)                                   \
+    if (file.Write((A), (S)) != (S)) {                          \
+        Log::DefaultLog.WriteError("Write error %d", __LINE__); \
+        file.Close();                                           \
+        return false;                                           \
+    }
+
+    UINT16 version = 0;
+    ASSERT_WRITEOUT(magicID, 6);
+    ASSERT_WRITEOUT(&version, 2);
+    ASSERT_WRITEOUT(&frameCnt, 4);
+    ASSERT_WRITEOUT(bbox, 6 * 4);
+    ASSERT_WRITEOUT(cbox, 6 * 4);
+
+    UINT64 seekTable = static_cast<UINT64>(file.Tell());
+    UINT64 frameOffset = 0;
+    for (UINT32 i = 0; i <= frameCnt; i++) {
+        ASSERT_WRITEOUT(&frameOffset, 8);
+    }
+
+    vislib::RawStorage raw, decoded;
+    for (UINT32 i = 0; i < frameCnt; i++) {
+        frameOffset = static_cast<UINT64>(file.Tell());
+        file.Seek(seekTable + i * 8);
+        ASSERT_WRITEOUT(&frameOffset, 8);
+        file.Seek(frameOffset);
+
+        Log::DefaultLog.WriteInfo("Started converting data frame %u\n", i);
+
+        // read the frame and bring it to the uncompressed layout
+        UINT64 const frameSize = frameIdx[i + 1] - frameIdx[i];
+        raw.EnforceSize(static_cast<SIZE_T>(frameSize));
+        in.Seek(frameIdx[i]);
+        ASSERT_READIN(raw.As<void>(), frameSize);
+        vislib::RawStorage* dat = &raw;
+        if (inVersion >= mmpld::ChunkedVersion) {
+            if (!mmpld::DecodeFrame(raw.As<uint8_t>(), raw.GetSize(), decoded)) {
+                Log::DefaultLog.WriteError("Frame %u of the input file is corrupt. Abort.", i);
+                file.Close();
+                return false;
+            }
+            dat = &decoded;
+        }
+
+        // set the particle lists into a call to write them like connected data
+        geocalls::MultiParticleDataCall data;
+        uint8_t const* ptr = dat->As<uint8_t>();
+        size_t const size = dat->GetSize();
+        size_t pos = 0;
+        bool valid = true;
+        if (inVersion >= 102) {
+            float timestamp = 0.0f;
+            valid = (size >= 4);
+            if (valid) {
+                std::memcpy(&timestamp, ptr, 4);
+                data.SetTimeStamp(timestamp);
+                pos += 4;
+            }
+        }
+        UINT32 listCnt = 0;
+        valid = valid && (size - pos >= 4);
+        if (valid) {
+            std::memcpy(&listCnt, ptr + pos, 4);
+            pos += 4;
+            data.SetParticleListCount(listCnt);
+        }
+        for (UINT32 li = 0; valid && li < listCnt; li++) {
+            mmpld::ListHeader header;
+            size_t const headerSize = mmpld::ReadListHeader(ptr + pos, size - pos, inVersion, header);
+            UINT64 const dataSize = header.count * header.Stride();
+            valid = (headerSize != 0) && (size - pos - headerSize >= dataSize);
+            if (!valid) {
+                break;
+            }
+            pos += headerSize;
+            geocalls::MultiParticleDataCall::Particles& pts = data.AccessParticles(li);
+            header.SetMetaData(pts);
+            pts.SetCount(header.count);
+            pts.SetVertexData(mmpld::VertexDataType(header.vert_type), ptr + pos, header.Stride());
+            pts.SetColourData(mmpld::ColourDataType(header.col_type), ptr + pos + mmpld::VertexSize(header.vert_type),
+                header.Stride());
+            pos += static_cast<size_t>(dataSize);
+            if (inVersion == 101) {
+                // cluster infos are not converted
+                size_t plainSize = 0;
+                valid = (size - pos >= sizeof(unsigned int) + sizeof(size_t));
+                if (valid) {
+                    std::memcpy(&plainSize, ptr + pos + sizeof(unsigned int), sizeof(size_t));
+                    pos += sizeof(unsigned int) + sizeof(size_t);
+                    valid = (size - pos >= plainSize);
+                    pos += plainSize;
+                }
+            }
+        }
+        if (!valid) {
+            Log::DefaultLog.WriteError("Frame %u of the input file is corrupt. Abort.", i);
+            file.Close();
+            return false;
+        }
+
+        if (!this->writeFrame(file, data)) {
+            Log::DefaultLog.WriteError("Cannot write data frame %u. Abort.\n", i);
+            file.Close();
+            return false;
+        }
+    }
+
+    frameOffset = static_cast<UINT64>(file.Tell());
+    file.Seek(seekTable + frameCnt * 8);
+    ASSERT_WRITEOUT(&frameOffset, 8);
+
+    file.Seek(6); // set correct version to show that file is complete
+    version = this->versionSlot.Param<core::param::EnumParam>()->Value();
+    ASSERT_WRITEOUT(&version, 2);
+
+    file.Seek(frameOffset);
+
+    Log::DefaultLog.WriteInfo("Completed converting data\n");
+    file.Close();
+
+#undef ASSERT_WRITEOUT
+#undef ASSERT_READIN
+    return true;
+}
 } // namespace megamol::moldyn::io
@@ -104,12 +104,37 @@ private:
      */
     bool writeFrame(vislib::sys::File& file, geocalls::MultiParticleDataCall& data);
 
+    /**
+     * Converts an existing MMPLD file to the selected file format version
+     *
+     * @param inFilename The file to be converted
+     * @param outFilename The file to be written
+     *
+     * @return True on success
+     */
+    bool convertFile(vislib::StringA const& inFilename, vislib::TString const& outFilename);
+
     /** The file name of the file to be written */
     core::param::ParamSlot filenameSlot;
 
     /** The file format version to be written */
     core::param::ParamSlot versionSlot;
 
+    /** Quantize float positions when writing compressed chunks */
+    core::param::ParamSlot quantizeSlot;
+
+    /** The number of particles per compressed chunk */
+    core::param::ParamSlot chunkSizeSlot;
+
+    /** Sort the particles spatially and write a cell directory */
+    core::param::ParamSlot spatialSortSlot;
+
+    /** The resolution of the cell directory */
+    core::param::ParamSlot cellLevelSlot;
+
+    /** An existing file to be converted instead of writing the connected data */
+    core::param::ParamSlot convertFileSlot;
+
     core::param::ParamSlot startFrameSlot;
     core::param::ParamSlot endFrameSlot;
     core::param::ParamSlot subsetSlot;
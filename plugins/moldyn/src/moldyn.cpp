@@ -14,6 +14,8 @@
 #include "io/MMPGDDataSource.h"
 #include "io/MMPGDWriter.h"
 #include "io/MMPLDDataSource.h"
+#include "io/MMPLDOctreeDataSource.h"
+#include "io/MMPLDOctreeWriter.h"
 #include "io/MMPLDWriter.h"
 #include "io/MMSPDDataSource.h"
 #include "io/SIFFDataSource.h"
@@ -27,6 +29,7 @@
 #include "io/XYZLoader.h"
 
 #include "DataGridder.h"
+#include "rendering/CPUSphereRenderer.h"
 #include "moldyn/ParticleGridDataCall.h"
 
 namespace megamol::moldyn {
@@ -60,7 +63,10 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::MMPGDWriter>();
         this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::MMPLDDataSource>();
         this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::MMPLDWriter>();
+        this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::MMPLDOctreeWriter>();
+        this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::MMPLDOctreeDataSource>();
         this->module_descriptions.RegisterAutoDescription<megamol::moldyn::io::TestSpheresDataSource>();
+        this->module_descriptions.RegisterAutoDescription<megamol::moldyn::rendering::CPUSphereRenderer>();
 
         // register calls
         this->call_descriptions.RegisterAutoDescription<megamol::moldyn::BrickStatsCall>();
@@ -0,0 +1,355 @@
+/*
+ * CPUSphereRenderer.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "CPUSphereRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include "mmcore/param/ButtonParam.h"
+#include "mmcore/param/IntParam.h"
+#include "mmcore/param/StringParam.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::moldyn::rendering;
+using megamol::geocalls::MultiParticleDataCall;
+using megamol::geocalls::SimpleSphericalParticles;
+
+namespace {
+
+/** Packs a colour with components in [0, 1] as RGBA8 */
+inline uint32_t packColour(float r, float g, float b, float a) {
+    auto const channel = [](float c, int shift) {
+        return static_cast<uint32_t>(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f) << shift;
+    };
+    return channel(r, 0) | channel(g, 8) | channel(b, 16) | channel(a, 24);
+}
+
+} // namespace
+
+
+/*
+ * CPUSphereRenderer::CPUSphereRenderer
+ */
+CPUSphereRenderer::CPUSphereRenderer(void)
+        : core::view::Renderer3DModule()
+        , getDataSlot("getData", "Connects to the data source")
+        , getTFSlot("getTransferFunction", "Connects to the transfer function")
+        , tileSizeSlot("tileSize", "The edge length of the image tiles rendered in parallel")
+        , benchmarkSlot("benchmark::run", "Renders random spheres of fixed counts and logs the frame rates")
+        , benchmarkCountsSlot("benchmark::counts", "The comma-separated sphere counts of the benchmark")
+        , benchmarkFramesSlot("benchmark::frames", "The number of frames rendered per sphere count")
+        , raycaster()
+        , dataHash(0)
+        , frameID(std::numeric_limits<unsigned int>::max())
+        , range({0.0f, 1.0f}) {
+
+    this->getDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
+    this->MakeSlotAvailable(&this->getDataSlot);
+
+    this->getTFSlot.SetCompatibleCall<core::view::CallGetTransferFunctionDescription>();
+    this->MakeSlotAvailable(&this->getTFSlot);
+
+    this->tileSizeSlot << new core::param::IntParam(32, 2, 512);
+    this->MakeSlotAvailable(&this->tileSizeSlot);
+
+    this->benchmarkSlot << new core::param::ButtonParam();
+    this->MakeSlotAvailable(&this->benchmarkSlot);
+
+    this->benchmarkCountsSlot << new core::param::StringParam("10000,100000,1000000");
+    this->MakeSlotAvailable(&this->benchmarkCountsSlot);
+
+    this->benchmarkFramesSlot << new core::param::IntParam(20, 1);
+    this->MakeSlotAvailable(&this->benchmarkFramesSlot);
+}
+
+
+/*
+ * CPUSphereRenderer::~CPUSphereRenderer
+ */
+CPUSphereRenderer::~CPUSphereRenderer(void) {
+    this->Release();
+}
+
+
+/*
+ * CPUSphereRenderer::create
+ */
+bool CPUSphereRenderer::create(void) {
+    return true;
+}
+
+
+/*
+ * CPUSphereRenderer::release
+ */
+void CPUSphereRenderer::release(void) {
+    this->raycaster.Build({});
+}
+
+
+/*
+ * CPUSphereRenderer::GetExtents
+ */
+bool CPUSphereRenderer::GetExtents(core::view::CallRender3D& call) {
+    auto* c2 = this->getDataSlot.CallAs<MultiParticleDataCall>();
+    if (c2 != nullptr) {
+        c2->SetFrameID(static_cast<unsigned int>(call.Time()), true);
+        if (!(*c2)(1)) {
+            return false;
+        }
+        call.SetTimeFramesCount(c2->FrameCount());
+        call.AccessBoundingBoxes() = c2->AccessBoundingBoxes();
+    } else {
+        call.SetTimeFramesCount(1);
+        call.AccessBoundingBoxes().Clear();
+    }
+    return true;
+}
+
+
+/*
+ * CPUSphereRenderer::Render
+ */
+bool CPUSphereRenderer::Render(core::view::CallRender3D& call) {
+    auto fbo = call.GetFramebuffer();
+    if (fbo == nullptr || fbo->width == 0 || fbo->height == 0) {
+        return false;
+    }
+
+    if (this->benchmarkSlot.IsDirty()) {
+        this->benchmarkSlot.ResetDirty();
+        this->runBenchmark(call);
+    }
+
+    auto* c2 = this->getDataSlot.CallAs<MultiParticleDataCall>();
+    if (c2 == nullptr) {
+        return false;
+    }
+    auto* tf = this->getTFSlot.CallAs<core::view::CallGetTransferFunction>();
+
+    unsigned int const frame = static_cast<unsigned int>(call.Time());
+    c2->SetFrameID(frame, true);
+    if (!(*c2)(1)) {
+        return false;
+    }
+    c2->SetFrameID(frame, true);
+    if (!(*c2)(0)) {
+        return false;
+    }
+
+    // the range is only updated for new data sets, not for new frames
+    if (c2->DataHash() != this->dataHash || this->dataHash == 0) {
+        this->range = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+        for (unsigned int i = 0; i < c2->GetParticleListCount(); ++i) {
+            auto const& parts = c2->AccessParticles(i);
+            this->range[0] = std::min(parts.GetMinColourIndexValue(), this->range[0]);
+            this->range[1] = std::max(parts.GetMaxColourIndexValue(), this->range[1]);
+        }
+        if (tf != nullptr) {
+            tf->SetRange(this->range);
+        }
+    }
+    bool tfChanged = false;
+    if (tf != nullptr) {
+        if (!(*tf)(0)) {
+            tf = nullptr;
+        } else {
+            tfChanged = tf->IsDirty();
+            tf->ResetDirty();
+        }
+    }
+
+    if (c2->DataHash() != this->dataHash || this->dataHash == 0 || c2->FrameID() != this->frameID || tfChanged) {
+        auto const t1 = std::chrono::high_resolution_clock::now();
+        this->raycaster.Build(convertParticles(*c2, tf, this->range));
+        auto const t2 = std::chrono::high_resolution_clock::now();
+        auto const ms = static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count());
+        core::utility::log::Log::DefaultLog.WriteInfo(
+            "[CPUSphereRenderer] Building the hierarchy of %zu spheres took %lld ms", this->raycaster.SphereCount(),
+            ms);
+        this->dataHash = c2->DataHash();
+        this->frameID = c2->FrameID();
+    }
+    c2->Unlock();
+
+    core::view::Camera const cam = call.GetCamera();
+    glm::mat4 const viewProj = cam.getProjectionMatrix() * cam.getViewMatrix();
+    glm::mat4 const invViewProj = glm::inverse(viewProj);
+    glm::vec4 const bg = call.BackgroundColor();
+
+    this->raycaster.Render(glm::value_ptr(viewProj), glm::value_ptr(invViewProj), fbo->width, fbo->height,
+        static_cast<unsigned int>(this->tileSizeSlot.Param<core::param::IntParam>()->Value()),
+        packColour(bg.r, bg.g, bg.b, bg.a), fbo->colorBuffer, fbo->depthBuffer);
+    fbo->depthBufferActive = true;
+
+    return true;
+}
+
+
+/*
+ * CPUSphereRenderer::convertParticles
+ */
+std::vector<SphereRaycaster::Sphere> CPUSphereRenderer::convertParticles(
+    MultiParticleDataCall& data, core::view::CallGetTransferFunction* tf, std::array<float, 2> const& range) {
+    std::vector<SphereRaycaster::Sphere> spheres;
+    size_t total = 0;
+    for (unsigned int i = 0; i < data.GetParticleListCount(); ++i) {
+        auto const& parts = data.AccessParticles(i);
+        if (parts.GetVertexDataType() != SimpleSphericalParticles::VERTDATA_NONE) {
+            total += parts.GetCount();
+        }
+    }
+    spheres.resize(total);
+
+    // intensities without transfer function are mapped to grey values over the data range
+    std::array<float, 2> const tfRange = (tf != nullptr) ? tf->Range() : range;
+    float const* tfData = (tf != nullptr) ? tf->GetTextureData() : nullptr;
+    unsigned int const tfSize = (tfData != nullptr) ? tf->TextureSize() : 0;
+    unsigned int const tfComponents =
+        (tf != nullptr && tf->TFTextureFormat() == core::view::CallGetTransferFunction::TEXTURE_FORMAT_RGB) ? 3 : 4;
+
+    size_t offset = 0;
+    for (unsigned int i = 0; i < data.GetParticleListCount(); ++i) {
+        auto const& parts = data.AccessParticles(i);
+        if (parts.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_NONE) {
+            continue;
+        }
+        auto const& store = parts.GetParticleStore();
+        auto const& xAcc = store.GetXAcc();
+        auto const& yAcc = store.GetYAcc();
+        auto const& zAcc = store.GetZAcc();
+        auto const& rAcc = store.GetRAcc();
+        auto const& crAcc = store.GetCRAcc();
+        auto const& cgAcc = store.GetCGAcc();
+        auto const& cbAcc = store.GetCBAcc();
+        auto const& caAcc = store.GetCAAcc();
+
+        auto const colType = parts.GetColourDataType();
+        bool const intensity = (colType == SimpleSphericalParticles::COLDATA_FLOAT_I) ||
+                               (colType == SimpleSphericalParticles::COLDATA_DOUBLE_I);
+        float scale = 1.0f;
+        if (colType == SimpleSphericalParticles::COLDATA_UINT8_RGB ||
+            colType == SimpleSphericalParticles::COLDATA_UINT8_RGBA) {
+            scale = 1.0f / 255.0f;
+        } else if (colType == SimpleSphericalParticles::COLDATA_USHORT_RGBA) {
+            scale = 1.0f / 65535.0f;
+        }
+        unsigned char const* globalCol = parts.GetGlobalColour();
+        uint32_t const globalColour = static_cast<uint32_t>(globalCol[0]) |
+                                      (static_cast<uint32_t>(globalCol[1]) << 8) |
+                                      (static_cast<uint32_t>(globalCol[2]) << 16) |
+                                      (static_cast<uint32_t>(globalCol[3]) << 24);
+        float const rangeSize = (tfRange[1] > tfRange[0]) ? (tfRange[1] - tfRange[0]) : 1.0f;
+
+        int64_t const cnt = static_cast<int64_t>(parts.GetCount());
+#pragma omp parallel for
+        for (int64_t p = 0; p < cnt; ++p) {
+            auto& sphere = spheres[offset + p];
+            sphere.x = xAcc->Get_f(p);
+            sphere.y = yAcc->Get_f(p);
+            sphere.z = zAcc->Get_f(p);
+            sphere.r = rAcc->Get_f(p);
+            if (colType == SimpleSphericalParticles::COLDATA_NONE) {
+                sphere.colour = globalColour;
+            } else if (intensity) {
+                float const v = std::min(std::max((crAcc->Get_f(p) - tfRange[0]) / rangeSize, 0.0f), 1.0f);
+                if (tfSize == 0) {
+                    sphere.colour = packColour(v, v, v, 1.0f);
+                    continue;
+                }
+                // linear interpolation between the texels
+                float const pos = v * static_cast<float>(tfSize - 1);
+                auto const lo = static_cast<unsigned int>(pos);
+                auto const hi = std::min(lo + 1, tfSize - 1);
+                float const w = pos - static_cast<float>(lo);
+                float rgba[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+                for (unsigned int k = 0; k < tfComponents; ++k) {
+                    rgba[k] = (1.0f - w) * tfData[lo * tfComponents + k] + w * tfData[hi * tfComponents + k];
+                }
+                sphere.colour = packColour(rgba[0], rgba[1], rgba[2], rgba[3]);
+            } else {
+                sphere.colour = packColour(crAcc->Get_f(p) * scale, cgAcc->Get_f(p) * scale, cbAcc->Get_f(p) * scale,
+                    caAcc->Get_f(p) * scale);
+            }
+        }
+        offset += static_cast<size_t>(cnt);
+    }
+
+    return spheres;
+}
+
+
+/*
+ * CPUSphereRenderer::runBenchmark
+ */
+void CPUSphereRenderer::runBenchmark(core::view::CallRender3D& call) {
+    using megamol::core::utility::log::Log;
+
+    auto fbo = call.GetFramebuffer();
+    core::view::Camera const cam = call.GetCamera();
+    glm::mat4 const viewProj = cam.getProjectionMatrix() * cam.getViewMatrix();
+    glm::mat4 const invViewProj = glm::inverse(viewProj);
+    unsigned int const tileSize = static_cast<unsigned int>(this->tileSizeSlot.Param<core::param::IntParam>()->Value());
+    int const frames = this->benchmarkFramesSlot.Param<core::param::IntParam>()->Value();
+
+    // the spheres fill the current bounding box, so they are visible with the current camera
+    auto box = call.AccessBoundingBoxes().BoundingBox();
+    if (box.IsEmpty()) {
+        box.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    std::istringstream counts(this->benchmarkCountsSlot.Param<core::param::StringParam>()->Value());
+    std::string token;
+    while (std::getline(counts, token, ',')) {
+        size_t count = 0;
+        try {
+            count = static_cast<size_t>(std::stoull(token));
+        } catch (std::exception const&) {
+            Log::DefaultLog.WriteWarn("[CPUSphereRenderer] Ignoring invalid benchmark count \"%s\"", token.c_str());
+            continue;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        // spheres with a fixed seed and a radius giving the same density for all counts
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dx(box.Left(), box.Right());
+        std::uniform_real_distribution<float> dy(box.Bottom(), box.Top());
+        std::uniform_real_distribution<float> dz(box.Back(), box.Front());
+        float const radius = 0.5f * std::cbrt(box.Volume() / static_cast<float>(count));
+        std::vector<SphereRaycaster::Sphere> spheres(count);
+        for (auto& s : spheres) {
+            s = {dx(rng), dy(rng), dz(rng), radius, 0xffb0b0b0u};
+        }
+
+        SphereRaycaster bench;
+        auto const t1 = std::chrono::high_resolution_clock::now();
+        bench.Build(std::move(spheres));
+        auto const t2 = std::chrono::high_resolution_clock::now();
+        std::vector<uint32_t> colour;
+        std::vector<float> depth;
+        for (int f = 0; f < frames; ++f) {
+            bench.Render(glm::value_ptr(viewProj), glm::value_ptr(invViewProj), fbo->width, fbo->height, tileSize,
+                0xff000000u, colour, depth);
+        }
+        auto const t3 = std::chrono::high_resolution_clock::now();
+
+        double const buildMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        double const renderS = std::chrono::duration<double>(t3 - t2).count();
+        Log::DefaultLog.WriteInfo("[CPUSphereRenderer] Benchmark with %zu spheres at %ux%u: build %.1f ms, %.2f fps",
+            count, fbo->width, fbo->height, buildMs, (renderS > 0.0) ? frames / renderS : 0.0);
+    }
+}
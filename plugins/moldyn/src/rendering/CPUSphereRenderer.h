@@ -0,0 +1,144 @@
+/*
+ * CPUSphereRenderer.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "SphereRaycaster.h"
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/param/ParamSlot.h"
+#include "mmstd/renderer/CallGetTransferFunction.h"
+#include "mmstd/renderer/Renderer3DModule.h"
+
+
+namespace megamol::moldyn::rendering {
+
+/**
+ * Renderer ray casting the spheres of a MultiParticleDataCall on the CPU into the CPUFramebuffer of a CallRender3D.
+ * It needs neither a GPU nor OSPRay and can thus be used for headless rendering.
+ */
+class CPUSphereRenderer : public core::view::Renderer3DModule {
+public:
+    /**
+     * Answer the name of this module.
+     *
+     * @return The name of this module.
+     */
+    static const char* ClassName(void) {
+        return "CPUSphereRenderer";
+    }
+
+    /**
+     * Answer a human readable description of this module.
+     *
+     * @return A human readable description of this module.
+     */
+    static const char* Description(void) {
+        return "Renderer ray casting spheres on the CPU";
+    }
+
+    /**
+     * Answers whether this module is available on the current system.
+     *
+     * @return 'true' if the module is available, 'false' otherwise.
+     */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor. */
+    CPUSphereRenderer(void);
+
+    /** Dtor. */
+    virtual ~CPUSphereRenderer(void);
+
+protected:
+    /**
+     * Implementation of 'Create'.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    virtual bool create(void);
+
+    /**
+     * Implementation of 'Release'.
+     */
+    virtual void release(void);
+
+    /**
+     * The get extents callback.
+     *
+     * @param call The calling call.
+     *
+     * @return The return value of the function.
+     */
+    virtual bool GetExtents(core::view::CallRender3D& call);
+
+    /**
+     * The render callback.
+     *
+     * @param call The calling call.
+     *
+     * @return The return value of the function.
+     */
+    virtual bool Render(core::view::CallRender3D& call);
+
+private:
+    /**
+     * Converts the particles of 'data' into spheres.
+     *
+     * @param data The particle data
+     * @param tf The transfer function or nullptr
+     * @param range The colour index range of the data, used if there is no transfer function
+     *
+     * @return The spheres
+     */
+    static std::vector<SphereRaycaster::Sphere> convertParticles(geocalls::MultiParticleDataCall& data,
+        core::view::CallGetTransferFunction* tf, std::array<float, 2> const& range);
+
+    /**
+     * Renders sets of random spheres of fixed sizes with the current camera and framebuffer size and logs the frame
+     * rates.
+     *
+     * @param call The calling call
+     */
+    void runBenchmark(core::view::CallRender3D& call);
+
+    /** The slot fetching the particle data */
+    core::CallerSlot getDataSlot;
+
+    /** The slot fetching the transfer function */
+    core::CallerSlot getTFSlot;
+
+    /** The edge length of the tiles rendered in parallel */
+    core::param::ParamSlot tileSizeSlot;
+
+    /** Button starting the benchmark */
+    core::param::ParamSlot benchmarkSlot;
+
+    /** The comma-separated particle counts of the benchmark */
+    core::param::ParamSlot benchmarkCountsSlot;
+
+    /** The number of frames rendered per particle count in the benchmark */
+    core::param::ParamSlot benchmarkFramesSlot;
+
+    /** The ray caster holding the spheres of the current frame */
+    SphereRaycaster raycaster;
+
+    /** The hash of the data in 'raycaster' */
+    size_t dataHash;
+
+    /** The frame in 'raycaster' */
+    unsigned int frameID;
+
+    /** The colour index range of the current data */
+    std::array<float, 2> range;
+};
+
+} // namespace megamol::moldyn::rendering
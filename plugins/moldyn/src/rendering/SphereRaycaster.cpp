@@ -0,0 +1,300 @@
+/*
+ * SphereRaycaster.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "SphereRaycaster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace megamol::moldyn::rendering;
+
+namespace {
+
+/** Maximum number of spheres per leaf */
+constexpr size_t LeafSize = 4;
+
+/** Subtrees are built in parallel up to this depth */
+constexpr unsigned int ParallelBuildDepth = 6;
+
+/** Number of rays per packet, traced as 2x2 pixels */
+constexpr int PacketSize = 4;
+
+/** Ambient part of the lighting */
+constexpr float Ambient = 0.2f;
+
+/** The rays of one packet in structure-of-arrays layout */
+struct Packet {
+    float ox[PacketSize], oy[PacketSize], oz[PacketSize];
+    float dx[PacketSize], dy[PacketSize], dz[PacketSize];
+    float ix[PacketSize], iy[PacketSize], iz[PacketSize];
+    /** Distance of the closest hit so far, negative for inactive rays */
+    float t[PacketSize];
+    /** Index of the closest sphere hit so far */
+    int64_t hit[PacketSize];
+};
+
+/** Transforms the point 'p' with the column-major matrix 'm' and applies the perspective division */
+inline void transformPoint(float const* m, float const* p, float* out) {
+    float const w = m[3] * p[0] + m[7] * p[1] + m[11] * p[2] + m[15];
+    for (int r = 0; r < 3; ++r) {
+        out[r] = (m[r] * p[0] + m[r + 4] * p[1] + m[r + 8] * p[2] + m[r + 12]) / w;
+    }
+}
+
+/** Answer the reciprocal of a direction component, avoiding infinities of zero components */
+inline float safeInverse(float d) {
+    constexpr float eps = 1e-20f;
+    return 1.0f / ((std::abs(d) < eps) ? std::copysign(eps, d) : d);
+}
+
+inline uint32_t shade(uint32_t colour, float light) {
+    auto const channel = [&](int shift) {
+        float const c = static_cast<float>((colour >> shift) & 0xff) * light;
+        return static_cast<uint32_t>(std::min(c + 0.5f, 255.0f)) << shift;
+    };
+    return channel(0) | channel(8) | channel(16) | (colour & 0xff000000u);
+}
+
+} // namespace
+
+
+/*
+ * SphereRaycaster::SphereRaycaster
+ */
+SphereRaycaster::SphereRaycaster(void) : spheres(), nodes() {}
+
+
+/*
+ * SphereRaycaster::~SphereRaycaster
+ */
+SphereRaycaster::~SphereRaycaster(void) {}
+
+
+/*
+ * SphereRaycaster::Build
+ */
+void SphereRaycaster::Build(std::vector<Sphere>&& spheres) {
+    this->spheres = std::move(spheres);
+    this->nodes.clear();
+    if (this->spheres.empty()) {
+        return;
+    }
+    this->nodes.resize(nodeCount(this->spheres.size()));
+#pragma omp parallel
+    {
+#pragma omp single
+        this->build(0, 0, this->spheres.size(), 0);
+    }
+}
+
+
+/*
+ * SphereRaycaster::Render
+ */
+void SphereRaycaster::Render(float const* viewProj, float const* invViewProj, unsigned int width, unsigned int height,
+    unsigned int tileSize, uint32_t background, std::vector<uint32_t>& colour, std::vector<float>& depth) const {
+    colour.resize(static_cast<size_t>(width) * height);
+    depth.resize(static_cast<size_t>(width) * height);
+    tileSize = std::max(2u, tileSize + (tileSize & 1));
+    int64_t const tilesX = (width + tileSize - 1) / tileSize;
+    int64_t const tilesY = (height + tileSize - 1) / tileSize;
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t tile = 0; tile < tilesX * tilesY; ++tile) {
+        unsigned int const tileX = static_cast<unsigned int>(tile % tilesX) * tileSize;
+        unsigned int const tileY = static_cast<unsigned int>(tile / tilesX) * tileSize;
+        unsigned int const tileEndX = std::min(tileX + tileSize, width);
+        unsigned int const tileEndY = std::min(tileY + tileSize, height);
+        uint32_t stack[64];
+
+        for (unsigned int y = tileY; y < tileEndY; y += 2) {
+            for (unsigned int x = tileX; x < tileEndX; x += 2) {
+                // generate the rays between the near and the far plane
+                Packet p;
+                for (int i = 0; i < PacketSize; ++i) {
+                    unsigned int const px = x + (i & 1);
+                    unsigned int const py = y + (i >> 1);
+                    float const ndc[2] = {(static_cast<float>(px) + 0.5f) / width * 2.0f - 1.0f,
+                        (static_cast<float>(py) + 0.5f) / height * 2.0f - 1.0f};
+                    float const nearNDC[3] = {ndc[0], ndc[1], -1.0f};
+                    float const farNDC[3] = {ndc[0], ndc[1], 1.0f};
+                    float o[3], f[3];
+                    transformPoint(invViewProj, nearNDC, o);
+                    transformPoint(invViewProj, farNDC, f);
+                    float d[3] = {f[0] - o[0], f[1] - o[1], f[2] - o[2]};
+                    float const len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+                    for (auto& c : d) {
+                        c /= len;
+                    }
+                    p.ox[i] = o[0];
+                    p.oy[i] = o[1];
+                    p.oz[i] = o[2];
+                    p.dx[i] = d[0];
+                    p.dy[i] = d[1];
+                    p.dz[i] = d[2];
+                    p.ix[i] = safeInverse(d[0]);
+                    p.iy[i] = safeInverse(d[1]);
+                    p.iz[i] = safeInverse(d[2]);
+                    p.t[i] = (px < tileEndX && py < tileEndY) ? len : -1.0f;
+                    p.hit[i] = -1;
+                }
+
+                // traverse the hierarchy front to back with the whole packet
+                int sp = 0;
+                if (!this->nodes.empty()) {
+                    stack[sp++] = 0;
+                }
+                while (sp > 0) {
+                    Node const& node = this->nodes[stack[--sp]];
+                    bool any = false;
+                    for (int i = 0; i < PacketSize; ++i) {
+                        float const x0 = (node.lo[0] - p.ox[i]) * p.ix[i], x1 = (node.hi[0] - p.ox[i]) * p.ix[i];
+                        float const y0 = (node.lo[1] - p.oy[i]) * p.iy[i], y1 = (node.hi[1] - p.oy[i]) * p.iy[i];
+                        float const z0 = (node.lo[2] - p.oz[i]) * p.iz[i], z1 = (node.hi[2] - p.oz[i]) * p.iz[i];
+                        float const tNear = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::min(z0, z1));
+                        float const tFar = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::max(z0, z1));
+                        any = any || ((tNear <= tFar) && (tFar >= 0.0f) && (tNear < p.t[i]));
+                    }
+                    if (!any) {
+                        continue;
+                    }
+
+                    if (node.count == 0) {
+                        uint32_t const first = static_cast<uint32_t>(&node - this->nodes.data()) + 1;
+                        float const dir = (node.axis == 0) ? p.dx[0] : ((node.axis == 1) ? p.dy[0] : p.dz[0]);
+                        // the nearer child is visited first
+                        if (dir < 0.0f) {
+                            stack[sp++] = first;
+                            stack[sp++] = node.offset;
+                        } else {
+                            stack[sp++] = node.offset;
+                            stack[sp++] = first;
+                        }
+                        continue;
+                    }
+
+                    for (uint32_t s = node.offset; s < node.offset + node.count; ++s) {
+                        Sphere const& sphere = this->spheres[s];
+                        float const r2 = sphere.r * sphere.r;
+#pragma omp simd
+                        for (int i = 0; i < PacketSize; ++i) {
+                            float const ocx = p.ox[i] - sphere.x;
+                            float const ocy = p.oy[i] - sphere.y;
+                            float const ocz = p.oz[i] - sphere.z;
+                            float const b = ocx * p.dx[i] + ocy * p.dy[i] + ocz * p.dz[i];
+                            // distance of the centre to the ray, which is more precise than b^2 - |oc|^2 + r^2
+                            float const lx = ocx - b * p.dx[i];
+                            float const ly = ocy - b * p.dy[i];
+                            float const lz = ocz - b * p.dz[i];
+                            float const disc = r2 - (lx * lx + ly * ly + lz * lz);
+                            float const th = -b - std::sqrt(std::max(disc, 0.0f));
+                            bool const closer = (disc >= 0.0f) && (th > 0.0f) && (th < p.t[i]);
+                            p.t[i] = closer ? th : p.t[i];
+                            p.hit[i] = closer ? static_cast<int64_t>(s) : p.hit[i];
+                        }
+                    }
+                }
+
+                // shade with a head light
+                for (int i = 0; i < PacketSize; ++i) {
+                    unsigned int const px = x + (i & 1);
+                    unsigned int const py = y + (i >> 1);
+                    if (px >= tileEndX || py >= tileEndY) {
+                        continue;
+                    }
+                    size_t const pixel = static_cast<size_t>(py) * width + px;
+                    if (p.hit[i] < 0) {
+                        colour[pixel] = background;
+                        depth[pixel] = 1.0f;
+                        continue;
+                    }
+                    Sphere const& sphere = this->spheres[p.hit[i]];
+                    float const pos[3] = {
+                        p.ox[i] + p.t[i] * p.dx[i], p.oy[i] + p.t[i] * p.dy[i], p.oz[i] + p.t[i] * p.dz[i]};
+                    float const nDotL = -((pos[0] - sphere.x) * p.dx[i] + (pos[1] - sphere.y) * p.dy[i] +
+                                            (pos[2] - sphere.z) * p.dz[i]) /
+                                        sphere.r;
+                    colour[pixel] = shade(sphere.colour, Ambient + (1.0f - Ambient) * std::max(nDotL, 0.0f));
+                    float win[3];
+                    transformPoint(viewProj, pos, win);
+                    depth[pixel] = std::min(std::max(win[2] * 0.5f + 0.5f, 0.0f), 1.0f);
+                }
+            }
+        }
+    }
+}
+
+
+/*
+ * SphereRaycaster::nodeCount
+ */
+size_t SphereRaycaster::nodeCount(size_t count) {
+    if (count <= LeafSize) {
+        return 1;
+    }
+    return 1 + nodeCount(count / 2) + nodeCount(count - count / 2);
+}
+
+
+/*
+ * SphereRaycaster::build
+ */
+void SphereRaycaster::build(size_t idx, size_t begin, size_t end, unsigned int depth) {
+    Node& node = this->nodes[idx];
+    float centreLo[3], centreHi[3];
+    for (int k = 0; k < 3; ++k) {
+        node.lo[k] = centreLo[k] = std::numeric_limits<float>::max();
+        node.hi[k] = centreHi[k] = std::numeric_limits<float>::lowest();
+    }
+    for (size_t s = begin; s < end; ++s) {
+        Sphere const& sphere = this->spheres[s];
+        float const centre[3] = {sphere.x, sphere.y, sphere.z};
+        for (int k = 0; k < 3; ++k) {
+            node.lo[k] = std::min(node.lo[k], centre[k] - sphere.r);
+            node.hi[k] = std::max(node.hi[k], centre[k] + sphere.r);
+            centreLo[k] = std::min(centreLo[k], centre[k]);
+            centreHi[k] = std::max(centreHi[k], centre[k]);
+        }
+    }
+
+    size_t const count = end - begin;
+    if (count <= LeafSize) {
+        node.offset = static_cast<uint32_t>(begin);
+        node.count = static_cast<uint16_t>(count);
+        node.axis = 0;
+        return;
+    }
+
+    // split at the median of the longest axis of the centres
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (centreHi[k] - centreLo[k] > centreHi[axis] - centreLo[axis]) {
+            axis = k;
+        }
+    }
+    size_t const mid = begin + count / 2;
+    auto const key = [axis](Sphere const& s) { return (axis == 0) ? s.x : ((axis == 1) ? s.y : s.z); };
+    std::nth_element(this->spheres.begin() + begin, this->spheres.begin() + mid, this->spheres.begin() + end,
+        [&key](Sphere const& lhs, Sphere const& rhs) { return key(lhs) < key(rhs); });
+
+    size_t const second = idx + 1 + nodeCount(mid - begin);
+    node.offset = static_cast<uint32_t>(second);
+    node.count = 0;
+    node.axis = static_cast<uint16_t>(axis);
+
+    if (depth < ParallelBuildDepth) {
+#pragma omp task
+        this->build(idx + 1, begin, mid, depth + 1);
+#pragma omp task
+        this->build(second, mid, end, depth + 1);
+#pragma omp taskwait
+    } else {
+        this->build(idx + 1, begin, mid, depth + 1);
+        this->build(second, mid, end, depth + 1);
+    }
+}
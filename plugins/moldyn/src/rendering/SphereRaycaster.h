@@ -0,0 +1,99 @@
+/*
+ * SphereRaycaster.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace megamol::moldyn::rendering {
+
+/**
+ * Multithreaded CPU ray caster for spheres.
+ *
+ * The spheres are stored in a bounding volume hierarchy. The image is split into tiles which are rendered in
+ * parallel. Within a tile, 2x2 pixels are traced together as one packet, so every node and every sphere is tested
+ * against all rays of the packet at once.
+ */
+class SphereRaycaster {
+public:
+    /** A sphere with its colour packed as RGBA8 (red in the lowest byte) */
+    struct Sphere {
+        float x, y, z, r;
+        uint32_t colour;
+    };
+
+    /** Ctor. */
+    SphereRaycaster(void);
+
+    /** Dtor. */
+    ~SphereRaycaster(void);
+
+    /**
+     * Builds the bounding volume hierarchy for a new set of spheres.
+     *
+     * @param spheres The spheres, which are reordered and kept by the ray caster
+     */
+    void Build(std::vector<Sphere>&& spheres);
+
+    /**
+     * Answer the number of spheres.
+     *
+     * @return The number of spheres
+     */
+    inline size_t SphereCount(void) const {
+        return this->spheres.size();
+    }
+
+    /**
+     * Renders the spheres. Rows are stored bottom-up like in OpenGL.
+     *
+     * @param viewProj The column-major view-projection matrix
+     * @param invViewProj The inverse of 'viewProj'
+     * @param width The width of the image
+     * @param height The height of the image
+     * @param tileSize The edge length of the tiles rendered in parallel
+     * @param background The packed RGBA8 background colour
+     * @param colour Receives the packed RGBA8 colours
+     * @param depth Receives the window-space depth values in [0, 1]
+     */
+    void Render(float const* viewProj, float const* invViewProj, unsigned int width, unsigned int height,
+        unsigned int tileSize, uint32_t background, std::vector<uint32_t>& colour, std::vector<float>& depth) const;
+
+private:
+    /** A node of the bounding volume hierarchy */
+    struct Node {
+        float lo[3];
+        float hi[3];
+        /** Index of the second child for inner nodes, index of the first sphere for leaves */
+        uint32_t offset;
+        /** Number of spheres, 0 for inner nodes */
+        uint16_t count;
+        /** The axis the node is split along */
+        uint16_t axis;
+    };
+
+    /**
+     * Answer the number of nodes of the subtree over 'count' spheres.
+     */
+    static size_t nodeCount(size_t count);
+
+    /**
+     * Builds the subtree for the spheres [begin, end) into the node 'idx' and its successors.
+     */
+    void build(size_t idx, size_t begin, size_t end, unsigned int depth);
+
+    /** The spheres in the order of the leaves */
+    std::vector<Sphere> spheres;
+
+    /** The nodes in depth-first order, the first child of an inner node directly follows it */
+    std::vector<Node> nodes;
+};
+
+} // namespace megamol::moldyn::rendering
@@ -7,6 +7,9 @@
 
 #include "datatools/table/TableDataCall.h"
 
+#include <algorithm>
+#include <numeric>
+
 
 megamol::probe::ProbeClustering::ProbeClustering()
         : _out_probes_slot("outProbes", "")
@@ -74,6 +77,39 @@ bool megamol::probe::ProbeClustering::create() {
 void megamol::probe::ProbeClustering::release() {}
 
 
+void megamol::probe::ProbeClustering::read_similarities(
+    datatools::table::TableDataCall const& table, std::size_t num_probes) {
+    _sparse_offsets.clear();
+    _sparse_neighbours.clear();
+    if (_col_count != 3 || table.GetColumnsInfos()[0].Name() != "source") {
+        return;
+    }
+
+    // counting sort of the rows by source, then by target within each source
+    _sparse_offsets.resize(num_probes + 1, 0);
+    for (std::size_t row = 0; row < _row_count; ++row) {
+        auto const src = static_cast<std::size_t>(_sim_matrix[row * 3]);
+        if (src < num_probes) {
+            ++_sparse_offsets[src + 1];
+        }
+    }
+    std::partial_sum(_sparse_offsets.begin(), _sparse_offsets.end(), _sparse_offsets.begin());
+    _sparse_neighbours.resize(_sparse_offsets.back());
+    auto next = _sparse_offsets;
+    for (std::size_t row = 0; row < _row_count; ++row) {
+        auto const src = static_cast<std::size_t>(_sim_matrix[row * 3]);
+        if (src < num_probes) {
+            _sparse_neighbours[next[src]++] =
+                std::make_pair(static_cast<std::size_t>(_sim_matrix[row * 3 + 1]), _sim_matrix[row * 3 + 2]);
+        }
+    }
+    for (std::size_t src = 0; src < num_probes; ++src) {
+        std::sort(
+            _sparse_neighbours.begin() + _sparse_offsets[src], _sparse_neighbours.begin() + _sparse_offsets[src + 1]);
+    }
+}
+
+
 bool megamol::probe::ProbeClustering::get_data_cb(core::Call& c) {
     auto out_probes = dynamic_cast<CallProbes*>(&c);
     if (out_probes == nullptr)
@@ -130,6 +166,7 @@ bool megamol::probe::ProbeClustering::get_data_cb(core::Call& c) {
         if (in_probes->hasUpdate() || meta_data.m_frame_ID != _frame_id ||
             in_table->DataHash() != _in_table_data_hash || is_dirty() /*|| is_debug_dirty()*/) {
             auto const num_probes = _probes->getProbeCount();
+            read_similarities(*in_table, num_probes);
 
             auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
             auto const minpts = _minpts_slot.Param<core::param::IntParam>()->Value();
@@ -207,7 +244,7 @@ bool megamol::probe::ProbeClustering::get_data_cb(core::Call& c) {
                     _kd_tree, eps * eps, minpts,
                     [this, threshold, angle_threshold](
                         datatools::clustering::index_t a, datatools::clustering::index_t b) -> bool {
-                        auto const val = _sim_matrix[a + b * _col_count];
+                        auto const val = similarity(a, b);
                         auto const crit_a = val <= threshold;
 
                         auto const a_dir = _cur_dirs[a];
@@ -226,7 +263,7 @@ bool megamol::probe::ProbeClustering::get_data_cb(core::Call& c) {
                         for (auto const& lhs : cluster) {
                             auto val = 0.0f;
                             for (auto const& rhs : cluster) {
-                                val += _sim_matrix[lhs + rhs * _col_count];
+                                val += similarity(lhs, rhs);
                             }
                             val /= static_cast<float>(cluster.size() - 1);
                             scores.push_back(val);
@@ -292,7 +329,7 @@ bool megamol::probe::ProbeClustering::get_data_cb(core::Call& c) {
                     for (auto const& tmp_idx : el.second) {
                         if (tmp_idx == current_idx)
                             continue;
-                        auto const val = _sim_matrix[current_idx + tmp_idx * _col_count];
+                        auto const val = similarity(current_idx, tmp_idx);
                         if (val < min_score) {
                             min_idx = current_idx;
                             min_score = val;
@@ -8,11 +8,16 @@
 #include "mmcore/param/ParamSlot.h"
 
 #include "datatools/clustering/DBSCAN.h"
+#include "datatools/table/TableDataCall.h"
 
 #include "probe/ProbeCalls.h"
 
 #include "glm/glm.hpp"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace megamol::probe {
 class ProbeClustering : public core::Module {
 public:
@@ -80,11 +85,46 @@ private:
         _print_debug_info_slot.ResetDirty();
     }
 
+    /**
+     * Reads the table of similarities, which is either the full matrix or the rows (source, target, distance) of the
+     * nearest neighbours of each probe.
+     *
+     * @param table The table.
+     * @param num_probes The number of probes.
+     */
+    void read_similarities(datatools::table::TableDataCall const& table, std::size_t num_probes);
+
+    /**
+     * Answers the similarity value of two probes. Pairs missing from a table of nearest neighbours are treated as
+     * being at the largest normalized distance.
+     */
+    float similarity(std::size_t lhs, std::size_t rhs) const {
+        if (_sparse_offsets.empty()) {
+            return _sim_matrix[lhs + rhs * _col_count];
+        }
+        if (lhs == rhs) {
+            return 0.0f;
+        }
+        for (auto const [src, dst] : {std::make_pair(lhs, rhs), std::make_pair(rhs, lhs)}) {
+            auto const begin = _sparse_neighbours.begin() + _sparse_offsets[src];
+            auto const end = _sparse_neighbours.begin() + _sparse_offsets[src + 1];
+            auto const it = std::lower_bound(
+                begin, end, dst, [](auto const& el, std::size_t idx) -> bool { return el.first < idx; });
+            if (it != end && it->first == dst) {
+                return it->second;
+            }
+        }
+        return 1.0f;
+    }
+
     bool print_debug_info(core::param::ParamSlot& p) {
         auto const lhs_idx = _lhs_idx_slot.Param<core::param::IntParam>()->Value();
         auto const rhs_idx = _rhs_idx_slot.Param<core::param::IntParam>()->Value();
-        if (lhs_idx < _col_count && rhs_idx < _row_count) {
-            auto const val = _sim_matrix[lhs_idx + rhs_idx * _col_count];
+        auto const has_value = _sparse_offsets.empty() ? (lhs_idx < _col_count && rhs_idx < _row_count)
+                                                       : (lhs_idx + 1 < _sparse_offsets.size() &&
+                                                             rhs_idx + 1 < _sparse_offsets.size());
+        if (has_value) {
+            auto const val = similarity(lhs_idx, rhs_idx);
             core::utility::log::Log::DefaultLog.WriteInfo(
                 "[ProbeClustering]: Similiarty val for %d:%d is %f", lhs_idx, rhs_idx, val);
             auto const angle = glm::degrees(
@@ -159,5 +199,11 @@ private:
     std::size_t _col_count = 0;
 
     std::size_t _row_count = 0;
+
+    /** Start of the neighbours of each probe in '_sparse_neighbours', empty for a full matrix */
+    std::vector<std::size_t> _sparse_offsets;
+
+    /** The (target, distance) pairs of all probes, sorted by target per probe */
+    std::vector<std::pair<std::size_t, float>> _sparse_neighbours;
 };
 } // namespace megamol::probe
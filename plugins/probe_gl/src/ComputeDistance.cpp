@@ -2,24 +2,33 @@
 
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore_gl/utility/ShaderSourceFactory.h"
 
-#include "glm/glm.hpp"
-
 #include "datatools/misc/FrechetDistance.h"
 
+#include "glm/glm.hpp"
+
 #include "eigen.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 //#include "frechet_distance.h"
 
 
 megamol::probe_gl::ComputeDistance::ComputeDistance()
         : _out_table_slot("outTable", "")
         , _in_probes_slot("inProbes", "")
-        , _stretching_factor_slot("stretching factor", "") {
+        , _stretching_factor_slot("stretching factor", "")
+        , _neighbours_slot("neighbours", "Number of most similar probes kept per probe, 0 for no limit")
+        , _max_distance_slot("max distance",
+              "Largest distance of a pair kept per probe, 0 for no limit. Without both limits, the full matrix is "
+              "computed.") {
     _out_table_slot.SetCallback(datatools::table::TableDataCall::ClassName(),
         datatools::table::TableDataCall::FunctionName(0), &ComputeDistance::get_data_cb);
     _out_table_slot.SetCallback(datatools::table::TableDataCall::ClassName(),
@@ -31,6 +40,12 @@ megamol::probe_gl::ComputeDistance::ComputeDistance()
 
     _stretching_factor_slot << new core::param::FloatParam(5.0f, 0.0f);
     MakeSlotAvailable(&_stretching_factor_slot);
+
+    _neighbours_slot << new core::param::IntParam(0, 0);
+    MakeSlotAvailable(&_neighbours_slot);
+
+    _max_distance_slot << new core::param::FloatParam(0.0f, 0.0f);
+    MakeSlotAvailable(&_max_distance_slot);
 }
 
 
@@ -62,17 +77,11 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
 
     auto const& meta_data = in_probes->getMetaData();
 
-    if (in_probes->hasUpdate() || meta_data.m_frame_ID != _frame_id || _stretching_factor_slot.IsDirty()) {
+    if (in_probes->hasUpdate() || meta_data.m_frame_ID != _frame_id || _stretching_factor_slot.IsDirty() ||
+        _neighbours_slot.IsDirty() || _max_distance_slot.IsDirty()) {
         auto const& probe_data = in_probes->getData();
         auto const probe_count = probe_data->getProbeCount();
 
-        _row_count = probe_count;
-        _col_count = probe_count;
-        _col_infos.clear();
-        _col_infos.resize(probe_count);
-        _dis_mat.clear();
-        _dis_mat.resize(probe_count * probe_count, 0.0f);
-
         if (probe_count == 0)
             return false;
         std::size_t sample_count = 0;
@@ -108,10 +117,6 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
 
             sample_count -= base_skip;
 
-            auto min_val = std::numeric_limits<float>::max();
-            auto max_val = std::numeric_limits<float>::lowest();
-
-
             auto vec_dist_func = [](glm::vec4 const& a, glm::vec4 const& b) -> float {
                 auto const angle = std::acos(glm::dot(glm::vec3(a), glm::vec3(b)));
                 auto const angle_dis = angle / M_PI;
@@ -121,7 +126,6 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
 
 
             std::vector<std::vector<glm::vec4>> sample_collection(probe_count);
-            auto X = std::vector<Eigen::MatrixXd>(probe_count, Eigen::MatrixXd(probe_count, sample_count));
 #pragma omp parallel for
             for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
                 std::vector<glm::vec4> a_samples;
@@ -140,82 +144,12 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
                 }
                 sample_collection[a_pidx] = a_samples;
             }
-#pragma omp parallel for
-            for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
-                auto& X_sub = X[a_pidx];
-                for (std::int64_t b_pidx = 0; b_pidx < probe_count; ++b_pidx) {
-
-                    for (std::int64_t as_idx = 0; as_idx < sample_count; ++as_idx) {
-                        auto const val =
-                            vec_dist_func(sample_collection[a_pidx][as_idx], sample_collection[b_pidx][as_idx]);
-                        X_sub(b_pidx, as_idx) = val;
-                    }
-                }
-                /*auto svd = Eigen::JacobiSVD<Eigen::MatrixXd>(X_sub, Eigen::ComputeThinU | Eigen::ComputeThinV);
-                auto sv = svd.singularValues();
-                for (Eigen::Index idx = sv.size() / 2; idx < sv.size(); ++idx) {
-                    sv[idx] = 0.0;
-                }
-                auto U = svd.matrixU();
-                auto V = svd.matrixV();
-                auto D = sv.asDiagonal();
-                X_sub = U * D * V.transpose();*/
-            }
 
             core::utility::log::Log::DefaultLog.WriteInfo("[ComputeDistance] Prepared probes");
-#pragma omp parallel for
-            for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
-
-                for (std::int64_t b_pidx = a_pidx; b_pidx < probe_count; ++b_pidx) {
-
-
-                    std::vector<float> tmp_mat(sample_count * sample_count);
-                    for (std::int64_t as_idx = 0; as_idx < sample_count; ++as_idx) {
-                        for (std::int64_t bs_idx = as_idx; bs_idx < sample_count; ++bs_idx) {
-                            /*auto const val =
-                                vec_dist_func(sample_collection[a_pidx][as_idx], sample_collection[b_pidx][bs_idx]);*/
-                            //auto const val = std::abs(X[a_pidx](b_pidx, as_idx) - X[a_pidx](b_pidx, bs_idx));
-                            auto const val = X[a_pidx](b_pidx, as_idx);
-                            tmp_mat[as_idx + bs_idx * sample_count] = val;
-                            tmp_mat[bs_idx + as_idx * sample_count] = val;
-                        }
-                    }
-
-
-                    auto const score = datatools::misc::frechet_distance<float>(
-                        sample_count, [&tmp_mat, sample_count](std::size_t lhs, std::size_t rhs) -> float {
-                            return tmp_mat[lhs + rhs * sample_count];
-                        });
-
-
-                    _dis_mat[a_pidx + b_pidx * probe_count] = score;
-                    _dis_mat[b_pidx + a_pidx * probe_count] = score;
-#pragma omp critical
-                    {
-                        if (score < min_val)
-                            min_val = score;
-                        if (score > max_val)
-                            max_val = score;
-                    }
-                }
-            }
-            /*if (min_val > 0.0)
-                min_val = 0.0;*/
-            auto org = min_val;
-            auto diff = 1.0 / (max_val - min_val + 1e-8);
-            double stretching = _stretching_factor_slot.Param<core::param::FloatParam>()->Value();
-            /*std::for_each(_dis_mat.begin(), _dis_mat.end(), [org, diff](auto& el) {
-                if (std::isnan(el))
-                    el = 1.0;
-            });*/
-            std::for_each(_dis_mat.begin(), _dis_mat.end(), [org, diff](auto& el) { el = (el - org) * diff; });
-            if (stretching > 1.0f) {
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [stretching](auto& el) { el = el * stretching; });
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [](auto& el) {
-                    if (el > 1.0)
-                        el = 1.0;
+            compute_distances(probe_count, sample_count,
+                [&sample_collection, &vec_dist_func](std::int64_t a, std::int64_t b, std::size_t k) -> float {
+                    return vec_dist_func(sample_collection[a][k], sample_collection[b][k]);
                 });
-            }
             core::utility::log::Log::DefaultLog.WriteInfo("[ComputeDistance] Finished");
         } else if (distrib_probe) {
             core::utility::log::Log::DefaultLog.WriteInfo(
@@ -248,65 +182,15 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
             for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
                 auto const a_probe = probe_data->getProbe<probe::FloatDistributionProbe>(a_pidx);
                 auto const& a_samples_tmp = a_probe.getSamplingResult()->samples;
-                for (std::size_t sample_idx = base_skip; sample_idx < base_sample_count; ++sample_idx) {
+                for (std::size_t sample_idx = base_skip; sample_idx < sample_count; ++sample_idx) {
                     X(a_pidx, sample_idx - base_skip) = a_samples_tmp[sample_idx].mean;
                 }
             }
-            /*auto svd = Eigen::JacobiSVD<Eigen::MatrixXd>(X, Eigen::ComputeThinU | Eigen::ComputeThinV);
-            auto sv = svd.singularValues();
-            for (Eigen::Index idx = sv.size() / 2; idx < sv.size(); ++idx) {
-                sv[idx] = 0.0;
-            }
-            auto U = svd.matrixU();
-            auto V = svd.matrixV();
-            auto D = sv.asDiagonal();
-            X = U * D * V.transpose();*/
-
-            auto min_val = std::numeric_limits<double>::max();
-            auto max_val = std::numeric_limits<double>::lowest();
-#pragma omp parallel for
-            for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
 
-                for (std::int64_t b_pidx = a_pidx; b_pidx < probe_count; ++b_pidx) {
-
-
-                    std::vector<float> tmp_mat(sample_count * sample_count);
-                    for (std::int64_t as_idx = 0; as_idx < sample_count; ++as_idx) {
-                        for (std::int64_t bs_idx = as_idx; bs_idx < sample_count; ++bs_idx) {
-                            auto const val = std::abs(X(a_pidx, as_idx) - X(b_pidx, as_idx));
-                            tmp_mat[as_idx + bs_idx * sample_count] = val;
-                            tmp_mat[bs_idx + as_idx * sample_count] = val;
-                        }
-                    }
-
-                    auto const score = datatools::misc::frechet_distance<float>(
-                        sample_count, [&tmp_mat, sample_count](std::size_t lhs, std::size_t rhs) -> float {
-                            return tmp_mat[lhs + rhs * sample_count];
-                        });
-
-                    // auto const dis = DTW::dtw_distance_only(a_samples, b_samples, 2);
-                    _dis_mat[a_pidx + b_pidx * probe_count] = score;
-                    _dis_mat[b_pidx + a_pidx * probe_count] = score;
-#pragma omp critical
-                    {
-                        if (score < min_val)
-                            min_val = score;
-                        if (score > max_val)
-                            max_val = score;
-                    }
-                }
-            }
-            auto org = min_val;
-            auto diff = 1.0 / (max_val - min_val + 1e-8);
-            double stretching = _stretching_factor_slot.Param<core::param::FloatParam>()->Value();
-            std::for_each(_dis_mat.begin(), _dis_mat.end(), [org, diff](auto& el) { el = (el - org) * diff; });
-            if (stretching > 1.0f) {
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [stretching](auto& el) { el = el * stretching; });
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [](auto& el) {
-                    if (el > 1.0)
-                        el = 1.0;
+            compute_distances(
+                probe_count, base_sample_count, [&X](std::int64_t a, std::int64_t b, std::size_t k) -> float {
+                    return static_cast<float>(std::abs(X(a, k) - X(b, k)));
                 });
-            }
             core::utility::log::Log::DefaultLog.WriteInfo("[ComputeDistance] Finished");
         } else {
             core::utility::log::Log::DefaultLog.WriteInfo("[ComputeDistance] Computing distances for scalar probes");
@@ -332,68 +216,93 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
             for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
                 auto const a_probe = probe_data->getProbe<probe::FloatProbe>(a_pidx);
                 auto const& a_samples_tmp = a_probe.getSamplingResult()->samples;
-                for (std::size_t sample_idx = base_skip; sample_idx < base_sample_count; ++sample_idx) {
+                for (std::size_t sample_idx = base_skip; sample_idx < sample_count; ++sample_idx) {
                     X(a_pidx, sample_idx - base_skip) = a_samples_tmp[sample_idx];
                 }
             }
-            /*auto svd = Eigen::JacobiSVD<Eigen::MatrixXd>(X, Eigen::ComputeThinU | Eigen::ComputeThinV);
-            auto sv = svd.singularValues();
-            for (Eigen::Index idx = sv.size() / 2; idx < sv.size(); ++idx) {
-                sv[idx] = 0.0;
-            }
-            auto U = svd.matrixU();
-            auto V = svd.matrixV();
-            auto D = sv.asDiagonal();
-            X = U * D * V.transpose();*/
 
-            auto min_val = std::numeric_limits<double>::max();
-            auto max_val = std::numeric_limits<double>::lowest();
-#pragma omp parallel for
-            for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
+            compute_distances(
+                probe_count, base_sample_count, [&X](std::int64_t a, std::int64_t b, std::size_t k) -> float {
+                    return static_cast<float>(std::abs(X(a, k) - X(b, k)));
+                });
+            core::utility::log::Log::DefaultLog.WriteInfo("[ComputeDistance] Finished");
+        }
 
-                for (std::int64_t b_pidx = a_pidx; b_pidx < probe_count; ++b_pidx) {
+        _frame_id = meta_data.m_frame_ID;
+        ++_out_data_hash;
+        _stretching_factor_slot.ResetDirty();
+        _neighbours_slot.ResetDirty();
+        _max_distance_slot.ResetDirty();
+    }
 
+    out_table->SetFrameCount(meta_data.m_frame_cnt);
+    out_table->SetFrameID(_frame_id);
+    out_table->SetDataHash(_out_data_hash);
+    out_table->Set(_col_count, _row_count, _col_infos.data(), _dis_mat.data());
 
-                    std::vector<float> tmp_mat(base_sample_count * base_sample_count);
-                    for (std::int64_t as_idx = 0; as_idx < base_sample_count; ++as_idx) {
-                        for (std::int64_t bs_idx = as_idx; bs_idx < base_sample_count; ++bs_idx) {
-                            auto const val = std::abs(X(a_pidx, as_idx) - X(b_pidx, as_idx));
-                            tmp_mat[as_idx + bs_idx * base_sample_count] = val;
-                            tmp_mat[bs_idx + as_idx * base_sample_count] = val;
-                        }
-                    }
+    return true;
+}
 
-                    auto const score = datatools::misc::frechet_distance<float>(
-                        base_sample_count, [&tmp_mat, base_sample_count](std::size_t lhs, std::size_t rhs) -> float {
-                            return tmp_mat[lhs + rhs * base_sample_count];
-                        });
 
-                    // auto const dis = DTW::dtw_distance_only(a_samples, b_samples, 2);
+template<typename F>
+void megamol::probe_gl::ComputeDistance::compute_distances(
+    std::int64_t probe_count, std::size_t sample_count, F const& cost) {
+    auto const neighbours = static_cast<std::size_t>(_neighbours_slot.Param<core::param::IntParam>()->Value());
+    auto const max_distance = _max_distance_slot.Param<core::param::FloatParam>()->Value();
+    auto const bound = (max_distance > 0.0f) ? max_distance : std::numeric_limits<float>::infinity();
+
+    auto min_val = std::numeric_limits<double>::max();
+    auto max_val = std::numeric_limits<double>::lowest();
+
+    // The distance of two samples only depends on the earlier one, so every coupling visits each of the sample
+    // distances and the discrete Frechet distance of two probes is the largest one. It is evaluated blockwise to stop
+    // as soon as it exceeds 'limit', in which case infinity is returned.
+    auto const frechet = [&cost, sample_count](std::int64_t a_pidx, std::int64_t b_pidx, float limit) -> float {
+        float res = 0.0f;
+        for (std::size_t begin = 0; begin < sample_count; begin += 64) {
+            auto const end = std::min<std::size_t>(begin + 64, sample_count);
+#pragma omp simd reduction(max : res)
+            for (std::size_t k = begin; k < end; ++k) {
+                res = std::max(res, cost(a_pidx, b_pidx, k));
+            }
+            if (res > limit) {
+                return std::numeric_limits<float>::infinity();
+            }
+        }
+        return res;
+    };
+
+    if (neighbours == 0 && max_distance <= 0.0f) {
+        _row_count = probe_count;
+        _col_count = probe_count;
+        _col_infos.clear();
+        _col_infos.resize(probe_count);
+        _dis_mat.clear();
+        _dis_mat.resize(probe_count * probe_count, 0.0f);
+
+#pragma omp parallel
+        {
+            auto local_min = std::numeric_limits<double>::max();
+            auto local_max = std::numeric_limits<double>::lowest();
+#pragma omp for schedule(dynamic)
+            for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
+                for (std::int64_t b_pidx = a_pidx; b_pidx < probe_count; ++b_pidx) {
+                    auto const score = frechet(a_pidx, b_pidx, std::numeric_limits<float>::infinity());
+
                     _dis_mat[a_pidx + b_pidx * probe_count] = score;
                     _dis_mat[b_pidx + a_pidx * probe_count] = score;
-#pragma omp critical
-                    {
-                        if (score < min_val)
-                            min_val = score;
-                        if (score > max_val)
-                            max_val = score;
-                    }
+                    local_min = std::min<double>(local_min, score);
+                    local_max = std::max<double>(local_max, score);
                 }
             }
-            auto org = min_val;
-            auto diff = 1.0 / (max_val - min_val + 1e-8);
-            double stretching = _stretching_factor_slot.Param<core::param::FloatParam>()->Value();
-            std::for_each(_dis_mat.begin(), _dis_mat.end(), [org, diff](auto& el) { el = (el - org) * diff; });
-            if (stretching > 1.0f) {
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [stretching](auto& el) { el = el * stretching; });
-                std::for_each(_dis_mat.begin(), _dis_mat.end(), [](auto& el) {
-                    if (el > 1.0)
-                        el = 1.0;
-                });
+#pragma omp critical
+            {
+                min_val = std::min(min_val, local_min);
+                max_val = std::max(max_val, local_max);
             }
-            core::utility::log::Log::DefaultLog.WriteInfo(
-                "[ComputeDistance] Finished with %f and %f", min_val, max_val);
         }
+        normalize(_dis_mat.data(), _dis_mat.data() + _dis_mat.size(), min_val, max_val, 1);
+
         for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
             auto const minmax = std::minmax_element(
                 _dis_mat.begin() + (a_pidx * probe_count), _dis_mat.begin() + (a_pidx * probe_count + probe_count));
@@ -402,18 +311,115 @@ bool megamol::probe_gl::ComputeDistance::get_data_cb(core::Call& c) {
             _col_infos[a_pidx].SetMinimumValue(*minmax.first);
             _col_infos[a_pidx].SetMaximumValue(*minmax.second);
         }
+        return;
+    }
 
-        _frame_id = meta_data.m_frame_ID;
-        ++_out_data_hash;
-        _stretching_factor_slot.ResetDirty();
+    // sparse output: the nearest neighbours of each probe within the bound, as max-heaps of (distance, index) during
+    // the search, where a neighbour count of zero keeps all probes within the bound
+    auto const limited = neighbours > 0;
+    std::vector<std::vector<std::pair<float, std::int64_t>>> nearest(probe_count);
+#pragma omp parallel
+    {
+        std::vector<std::pair<float, std::int64_t>> candidates;
+#pragma omp for schedule(dynamic)
+        for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
+            auto& heap = nearest[a_pidx];
+            if (limited) {
+                heap.reserve(neighbours);
+            }
+            if (sample_count == 0) {
+                continue;
+            }
+            // visit the candidates by the lower bound given by the end points, with the pairwise sample distances the
+            // coupling of the Frechet distance passes
+            candidates.clear();
+            for (std::int64_t b_pidx = 0; b_pidx < probe_count; ++b_pidx) {
+                if (b_pidx != a_pidx) {
+                    auto const lower_bound = datatools::misc::frechet_lower_bound<float>(
+                        sample_count, sample_count, [&cost, a_pidx, b_pidx](std::size_t i, std::size_t j) {
+                            return cost(a_pidx, b_pidx, std::min(i, j));
+                        });
+                    candidates.emplace_back(lower_bound, b_pidx);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+            for (auto const& candidate : candidates) {
+                auto const b_pidx = candidate.second;
+                auto const cur_bound =
+                    (!limited || heap.size() < neighbours) ? bound : std::min(bound, heap.front().first);
+                if (candidate.first > cur_bound) {
+                    break;
+                }
+                auto const score = frechet(a_pidx, b_pidx, cur_bound);
+                if (!(score <= cur_bound)) {
+                    continue;
+                }
+                if (limited && heap.size() == neighbours) {
+                    if (score >= heap.front().first) {
+                        continue;
+                    }
+                    std::pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                heap.emplace_back(score, b_pidx);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            std::sort_heap(heap.begin(), heap.end());
+        }
     }
 
-    out_table->SetFrameCount(meta_data.m_frame_cnt);
-    out_table->SetFrameID(_frame_id);
-    out_table->SetDataHash(_out_data_hash);
-    out_table->Set(_col_count, _row_count, _col_infos.data(), _dis_mat.data());
+    // one row per pair: source probe, target probe and distance
+    _row_count = 0;
+    for (auto const& n : nearest) {
+        _row_count += n.size();
+    }
+    _col_count = 3;
+    _dis_mat.clear();
+    _dis_mat.reserve(_row_count * _col_count);
+    for (std::int64_t a_pidx = 0; a_pidx < probe_count; ++a_pidx) {
+        for (auto const& el : nearest[a_pidx]) {
+            _dis_mat.push_back(static_cast<float>(a_pidx));
+            _dis_mat.push_back(static_cast<float>(el.second));
+            _dis_mat.push_back(el.first);
+            min_val = std::min<double>(min_val, el.first);
+            max_val = std::max<double>(max_val, el.first);
+        }
+    }
+    if (_row_count > 0) {
+        normalize(_dis_mat.data() + 2, _dis_mat.data() + _dis_mat.size(), min_val, max_val, _col_count);
+    }
 
-    return true;
+    _col_infos.clear();
+    _col_infos.resize(_col_count);
+    _col_infos[0].SetName("source");
+    _col_infos[1].SetName("target");
+    _col_infos[2].SetName("distance");
+    for (auto& ci : _col_infos) {
+        ci.SetType(datatools::table::TableDataCall::ColumnType::QUANTITATIVE);
+    }
+    _col_infos[0].SetMinimumValue(0.0f);
+    _col_infos[0].SetMaximumValue(static_cast<float>(probe_count - 1));
+    _col_infos[1].SetMinimumValue(0.0f);
+    _col_infos[1].SetMaximumValue(static_cast<float>(probe_count - 1));
+    _col_infos[2].SetMinimumValue(0.0f);
+    _col_infos[2].SetMaximumValue(1.0f);
+    core::utility::log::Log::DefaultLog.WriteInfo(
+        "[ComputeDistance] Kept %zu pairs of %lld probes", _row_count, static_cast<long long>(probe_count));
+}
+
+
+void megamol::probe_gl::ComputeDistance::normalize(
+    float* begin, float* end, double min_val, double max_val, std::size_t stride) const {
+    auto const org = min_val;
+    auto const diff = 1.0 / (max_val - min_val + 1e-8);
+    double const stretching = _stretching_factor_slot.Param<core::param::FloatParam>()->Value();
+    for (auto it = begin; it < end; it += stride) {
+        auto el = (*it - org) * diff;
+        if (stretching > 1.0f) {
+            el = std::min(el * stretching, 1.0);
+        }
+        *it = static_cast<float>(el);
+    }
 }
 
 
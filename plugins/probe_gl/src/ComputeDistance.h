@@ -57,12 +57,39 @@ private:
 
     bool get_extent_cb(core::Call& c);
 
+    /**
+     * Computes the Frechet distances between all probes into the output table, either as a dense matrix or, if the
+     * number of neighbours or the maximum distance is limited, as the lists of the nearest neighbours of each probe
+     * within these limits.
+     *
+     * @param probe_count The number of probes
+     * @param sample_count The number of samples per probe
+     * @param cost Callable answering the distance of sample 'k' of probes 'a' and 'b' as 'float(a, b, k)'
+     */
+    template<typename F>
+    void compute_distances(std::int64_t probe_count, std::size_t sample_count, F const& cost);
+
+    /**
+     * Normalizes the distances to [0, 1] and applies the stretching factor.
+     *
+     * @param begin Iterator to the first distance
+     * @param end Iterator past the last distance
+     * @param min_val The smallest distance
+     * @param max_val The largest distance
+     * @param stride Distance between two consecutive values
+     */
+    void normalize(float* begin, float* end, double min_val, double max_val, std::size_t stride) const;
+
     core::CalleeSlot _out_table_slot;
 
     core::CallerSlot _in_probes_slot;
 
     core::param::ParamSlot _stretching_factor_slot;
 
+    core::param::ParamSlot _neighbours_slot;
+
+    core::param::ParamSlot _max_distance_slot;
+
     std::size_t _row_count = 0;
 
     std::size_t _col_count = 0;
@@ -13,6 +13,7 @@
 #include "protein_calls/MolecularDataCall.h"
 #include "vislib/math/Quaternion.h"
 #include <algorithm>
+#include <cmath>
 #include <list>
 #include <set>
 #include <vector>
@@ -401,10 +402,13 @@ public:
 
     /**
      * Read the next timestep and check for differences between the atoms.
+     * Only the parts of the reduced surface touching atoms that moved more than 'lowerThreshold' are recomputed. If
+     * any atom moved more than 'upperThreshold', the whole reduced surface is recomputed.
      *
-     * @param protein The protein data source.
      * @param lowerThreshold The lower treshold.
      * @param upperThreshold The upper treshold.
+     *
+     * @return 'true' if the reduced surface was changed, 'false' otherwise.
      */
     bool UpdateData(const float lowerThreshold, const float upperThreshold);
 
@@ -506,6 +510,46 @@ protected:
     void ComputeProbeCutVertex(RSVertex* vertex);
 
 private:
+    /**
+     * Copy the positions and radii of the atoms of this reduced surface from the molecular data call.
+     */
+    void ReadAtoms();
+
+    /**
+     * Sorts all RS-vertices into the voxel map according to their current positions.
+     */
+    void BuildVoxelMap();
+
+    /**
+     * Answer the voxel map coordinate of the position 'pos' along the axis 'axis', clamped to the voxel map.
+     */
+    inline unsigned int VoxelCoord(float pos, float origin, unsigned int axis) const {
+        return std::min(
+            this->voxelMapSize[axis] - 1, (unsigned int)std::max(0, (int)floorf((pos - origin) / this->voxelLength)));
+    }
+
+    /**
+     * Answer the index of the voxel map cell (x, y, z) in the flat voxel maps.
+     */
+    inline size_t VoxelCell(unsigned int x, unsigned int y, unsigned int z) const {
+        return x + this->voxelMapSize[0] * (y + static_cast<size_t>(this->voxelMapSize[1]) * z);
+    }
+
+    /**
+     * Answer the index of the voxel map cell 'idx' in the flat voxel maps.
+     */
+    inline size_t VoxelCell(const vislib::math::Vector<unsigned int, 3>& idx) const {
+        return this->VoxelCell(idx.GetX(), idx.GetY(), idx.GetZ());
+    }
+
+    /**
+     * Answer the index of the voxel map cell containing the position 'pos' in the flat voxel maps.
+     */
+    inline size_t VoxelCellAt(const vislib::math::Vector<float, 3>& pos) const {
+        return this->VoxelCell(this->VoxelCoord(pos.GetX(), this->bBox.Left(), 0),
+            this->VoxelCoord(pos.GetY(), this->bBox.Bottom(), 1), this->VoxelCoord(pos.GetZ(), this->bBox.Back(), 2));
+    }
+
     // The pointer to the protein data interface
     megamol::protein_calls::MolecularDataCall* molecule;
 
@@ -540,13 +584,18 @@ private:
     // the RS-face list
     std::vector<RSFace*> rsFace;
 
-    // vector for the voxel map for RS-vertex positions
-    std::vector<std::vector<std::vector<std::vector<RSVertex*>>>> voxelMap;
-    // vector for the voxel map for probe positions
-    std::vector<std::vector<std::vector<std::vector<RSFace*>>>> voxelMapProbes;
+    // the voxel map for RS-vertex positions in compressed sparse row layout: the RS-vertices of cell 'c' (see
+    // VoxelCell) are voxelMapVertices[voxelMapOffsets[c]] to voxelMapVertices[voxelMapOffsets[c + 1] - 1]
+    std::vector<unsigned int> voxelMapOffsets;
+    std::vector<RSVertex*> voxelMapVertices;
+    // the voxel map for probe positions, x varies fastest (see VoxelCell)
+    std::vector<std::vector<RSFace*>> voxelMapProbes;
+    // the number of voxel map cells along each axis
+    unsigned int voxelMapSize[3];
     // float voxel length
     float voxelLength;
 
+    // the positions and radii of the atoms [firstAtomIdx, firstAtomIdx + numberOfAtoms)
     std::vector<float> atoms;
 
     // number of RS-edges, which are cut by at least one probe
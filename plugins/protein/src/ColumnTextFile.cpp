@@ -0,0 +1,210 @@
+/*
+ * ColumnTextFile.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "ColumnTextFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace megamol;
+using namespace megamol::protein;
+
+namespace {
+
+/** Size of the blocks searched for line breaks in parallel */
+constexpr size_t IndexBlockSize = 1 << 20;
+
+/** Exactly representable powers of ten */
+constexpr double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/** Parses with 'strtod' as fallback for numbers the fast path cannot represent exactly */
+float parseFloatSlow(std::string_view field) {
+    char buf[64];
+    if (field.size() < sizeof(buf)) {
+        std::memcpy(buf, field.data(), field.size());
+        buf[field.size()] = 0;
+        return static_cast<float>(std::strtod(buf, nullptr));
+    }
+    return static_cast<float>(std::strtod(std::string(field).c_str(), nullptr));
+}
+
+} // namespace
+
+
+/*
+ * ColumnTextFile::ColumnTextFile
+ */
+ColumnTextFile::ColumnTextFile(void) : data(), lineStart() {}
+
+
+/*
+ * ColumnTextFile::~ColumnTextFile
+ */
+ColumnTextFile::~ColumnTextFile(void) {}
+
+
+/*
+ * ColumnTextFile::Load
+ */
+bool ColumnTextFile::Load(const std::filesystem::path& filename) {
+    this->Clear();
+
+    std::ifstream in(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    const auto size = static_cast<size_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    this->data.resize(size);
+    if (size > 0 && !in.read(this->data.data(), size)) {
+        this->data.clear();
+        return false;
+    }
+    if (size == 0)
+        return true;
+
+    // find the line breaks per block in parallel and concatenate them in block order
+    const auto blockCnt = static_cast<int64_t>((size + IndexBlockSize - 1) / IndexBlockSize);
+    std::vector<std::vector<size_t>> blockBreaks(blockCnt);
+#pragma omp parallel for schedule(static)
+    for (int64_t b = 0; b < blockCnt; ++b) {
+        const size_t begin = static_cast<size_t>(b) * IndexBlockSize;
+        const size_t end = std::min(begin + IndexBlockSize, size);
+        auto& breaks = blockBreaks[b];
+        const char* ptr = this->data.data() + begin;
+        const char* last = this->data.data() + end;
+        while ((ptr = static_cast<const char*>(std::memchr(ptr, '\n', last - ptr))) != nullptr) {
+            ++ptr;
+            breaks.push_back(ptr - this->data.data());
+        }
+    }
+
+    size_t lineCnt = 1;
+    for (const auto& breaks : blockBreaks) {
+        lineCnt += breaks.size();
+    }
+    this->lineStart.reserve(lineCnt + 1);
+    this->lineStart.push_back(0);
+    for (const auto& breaks : blockBreaks) {
+        this->lineStart.insert(this->lineStart.end(), breaks.begin(), breaks.end());
+    }
+    // a final line break does not start another line
+    if (this->lineStart.back() != size) {
+        this->lineStart.push_back(size);
+    }
+
+    return true;
+}
+
+
+/*
+ * ColumnTextFile::Clear
+ */
+void ColumnTextFile::Clear(void) {
+    this->data.clear();
+    this->data.shrink_to_fit();
+    this->lineStart.clear();
+    this->lineStart.shrink_to_fit();
+}
+
+
+/*
+ * ColumnTextFile::Trim
+ */
+std::string_view ColumnTextFile::Trim(std::string_view field) {
+    size_t begin = 0;
+    size_t end = field.size();
+    while (begin < end && isSpace(field[begin]))
+        ++begin;
+    while (end > begin && isSpace(field[end - 1]))
+        --end;
+    return field.substr(begin, end - begin);
+}
+
+
+/*
+ * ColumnTextFile::ParseFloat
+ */
+float ColumnTextFile::ParseFloat(std::string_view field) {
+    const char* ptr = field.data();
+    const char* end = ptr + field.size();
+    while (ptr < end && isSpace(*ptr))
+        ++ptr;
+
+    bool negative = false;
+    if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+        negative = (*ptr == '-');
+        ++ptr;
+    }
+
+    // the mantissa is exact as long as it has at most 15 significant digits
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    while (ptr < end && isDigit(*ptr)) {
+        if (mantissa > 0 || *ptr != '0') {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*ptr - '0');
+            ++digits;
+        }
+        any = true;
+        ++ptr;
+    }
+    if (ptr < end && *ptr == '.') {
+        ++ptr;
+        while (ptr < end && isDigit(*ptr)) {
+            if (mantissa > 0 || *ptr != '0') {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*ptr - '0');
+                ++digits;
+            }
+            --exponent;
+            any = true;
+            ++ptr;
+        }
+    }
+    if (!any) {
+        // no digits, e.g. empty fields, 'inf' or 'nan'
+        return parseFloatSlow(field);
+    }
+    if (ptr < end && (*ptr == 'e' || *ptr == 'E' || *ptr == 'x' || *ptr == 'X')) {
+        // exponents and hexadecimal numbers are rare in fixed-column formats
+        return parseFloatSlow(field);
+    }
+    if (digits > 15 || exponent < -22) {
+        return parseFloatSlow(field);
+    }
+
+    // both operands are exact, so the result is correctly rounded like the one of 'atof'
+    double value = static_cast<double>(mantissa) / pow10[-exponent];
+    return static_cast<float>(negative ? -value : value);
+}
+
+
+/*
+ * ColumnTextFile::ParseInt
+ */
+int ColumnTextFile::ParseInt(std::string_view field) {
+    field = Trim(field);
+    if (field.size() > 1 && field[0] == '+' && field[1] != '-') {
+        field.remove_prefix(1);
+    }
+    int value = 0;
+    std::from_chars(field.data(), field.data() + field.size(), value);
+    return value;
+}
@@ -0,0 +1,142 @@
+/*
+ * ColumnTextFile.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Text file held in memory as one block with an index of its lines, for parsing fixed-column formats like PDB and
+ * GRO without copying every line into a string of its own.
+ *
+ * The line index is built in parallel over blocks of the file. Fields are picked by column and parsed in place.
+ */
+class ColumnTextFile {
+public:
+    /** Ctor */
+    ColumnTextFile(void);
+
+    /** Dtor */
+    ~ColumnTextFile(void);
+
+    /**
+     * Loads a whole file and builds the line index.
+     *
+     * @param filename The file to load
+     *
+     * @return 'true' on success
+     */
+    bool Load(const std::filesystem::path& filename);
+
+    /**
+     * Releases the file data.
+     */
+    void Clear(void);
+
+    /**
+     * Answer the number of lines.
+     *
+     * @return The number of lines
+     */
+    inline size_t Count(void) const {
+        return this->lineStart.empty() ? 0 : this->lineStart.size() - 1;
+    }
+
+    /**
+     * Answer the size of the loaded file.
+     *
+     * @return The size in bytes
+     */
+    inline size_t Size(void) const {
+        return this->data.size();
+    }
+
+    /**
+     * Answer one line without its line break.
+     *
+     * @param idx The line index
+     *
+     * @return The line
+     */
+    inline std::string_view Line(size_t idx) const {
+        size_t begin = this->lineStart[idx];
+        size_t end = this->lineStart[idx + 1];
+        while (end > begin && (this->data[end - 1] == '\n' || this->data[end - 1] == '\r')) {
+            --end;
+        }
+        return std::string_view(this->data.data() + begin, end - begin);
+    }
+
+    /**
+     * Answer a field of a line. Columns beyond the end of the line are cut off.
+     *
+     * @param line The line
+     * @param col The first (zero-based) column of the field
+     * @param width The width of the field
+     *
+     * @return The field, possibly empty
+     */
+    static inline std::string_view Field(std::string_view line, size_t col, size_t width) {
+        return (col < line.size()) ? line.substr(col, width) : std::string_view();
+    }
+
+    /**
+     * Answer whether a line starts with the given record name.
+     *
+     * @param line The line
+     * @param prefix The record name
+     *
+     * @return 'true' if the line starts with 'prefix'
+     */
+    static inline bool StartsWith(std::string_view line, std::string_view prefix) {
+        return line.substr(0, prefix.size()) == prefix;
+    }
+
+    /**
+     * Removes leading and trailing white space.
+     *
+     * @param field The field
+     *
+     * @return The trimmed field
+     */
+    static std::string_view Trim(std::string_view field);
+
+    /**
+     * Parses a decimal number like 'atof' does, i.e. leading white space is skipped, parsing stops at the first
+     * character not belonging to the number and an empty field yields zero. The result is identical to 'atof'.
+     *
+     * @param field The field
+     *
+     * @return The number
+     */
+    static float ParseFloat(std::string_view field);
+
+    /**
+     * Parses an integer like 'atoi' does.
+     *
+     * @param field The field
+     *
+     * @return The number
+     */
+    static int ParseInt(std::string_view field);
+
+private:
+    /** The file content */
+    std::vector<char> data;
+
+    /** The offset of every line, followed by the size of the file */
+    std::vector<size_t> lineStart;
+};
+
+} /* end namespace protein */
+} /* end namespace megamol */
@@ -17,13 +17,14 @@
 #include "vislib/StringConverter.h"
 #include "vislib/StringTokeniser.h"
 #include "vislib/math/mathfunctions.h"
-#include "vislib/sys/ASCIIFileBuffer.h"
 #include "vislib/sys/MemmappedFile.h"
 #include "vislib/sys/sysfunctions.h"
 #include "vislib/types.h"
+#include <algorithm>
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <string_view>
 
 using namespace megamol;
 using namespace megamol::core;
@@ -1151,15 +1152,17 @@ void GROLoader::loadFile(const vislib::TString& filename) {
 
     t = clock(); // DEBUG
 
-    vislib::sys::ASCIIFileBuffer file;
+    ColumnTextFile file;
     SIZE_T frameCapacity = 10000;
 
     // try to load the file
-    if (file.LoadFile(T2A(filename))) {
+    if (file.Load(std::filesystem::path(T2A(filename).PeekBuffer()))) {
         // file successfully loaded
+        totalAtomCnt = 0;
         if (file.Count() > 2) {
-            // read number of atoms
-            totalAtomCnt = atoi(file[1]);
+            // read number of atoms, at most as many as there are lines
+            totalAtomCnt = static_cast<unsigned int>(std::max(0, ColumnTextFile::ParseInt(file.Line(1))));
+            totalAtomCnt = std::min(totalAtomCnt, static_cast<unsigned int>(file.Count() - 2));
         }
         Log::DefaultLog.WriteInfo("Atom count: %i", totalAtomCnt); // DEBUG
 
@@ -1199,9 +1202,11 @@ void GROLoader::loadFile(const vislib::TString& filename) {
         // parse all atoms
         vislib::StringA line;
         for (atomCnt = 0; atomCnt < totalAtomCnt; ++atomCnt) {
-            line = file[atomCnt + 2];
+            const std::string_view entry = file.Line(atomCnt + 2);
+            line = vislib::StringA(entry.data(), static_cast<vislib::StringA::Size>(entry.size()));
             this->parseAtomEntry(line, atomCnt, frameCnt, solventResidueNames);
         }
+        file.Clear();
         Log::DefaultLog.WriteInfo("Time for parsing first frame: %f",
             (double(clock() - t) / double(CLOCKS_PER_SEC))); // DEBUG
 
@@ -1357,9 +1362,11 @@ void GROLoader::parseAtomEntry(vislib::StringA& atomEntry, unsigned int atom, un
     // temp variables
     vislib::StringA tmpStr;
     vislib::math::Vector<float, 3> pos;
+    const std::string_view entry(atomEntry.PeekBuffer(), atomEntry.Length());
     // set atom position
-    pos.Set(float(atof(atomEntry.Substring(20, 8))), float(atof(atomEntry.Substring(28, 8))),
-        float(atof(atomEntry.Substring(36, 8))));
+    pos.Set(ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 20, 8)),
+        ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 28, 8)),
+        ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 36, 8)));
     // TOOD: do we really need the nm to Angstrom conversion?
     //pos *= 10.0f;
     this->data[frame]->SetAtomPosition(atom, pos.X(), pos.Y(), pos.Z());
@@ -11,6 +11,7 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include "ColumnTextFile.h"
 #include "MDDriverConnector.h"
 #include "Stride.h"
 #include "mmcore/CalleeSlot.h"
@@ -21,11 +21,16 @@
 #include "vislib/sys/MemmappedFile.h"
 #include "vislib/sys/sysfunctions.h"
 #include "vislib/types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 
 // this is needed to get curl working under windows
 #ifdef _MSC_VER
@@ -55,12 +60,22 @@ size_t CurlWriteMemoryCallback(char* buf, size_t size, size_t nmemb, void* up) {
     return size * nmemb;
 }
 
+/*
+ * Answer whether an ATOM entry is not an alternate location, i.e. whether its
+ * alternate location indicator is blank or 'A'.
+ */
+static inline bool isMainLocation(std::string_view atomEntry) {
+    const std::string_view altLoc = ColumnTextFile::Field(atomEntry, 16, 1);
+    return altLoc == " " || altLoc == "A" || altLoc == "a";
+}
+
 /*
  * PDBLoader::Frame::Frame
  */
 PDBLoader::Frame::Frame(view::AnimDataModule& owner)
         : view::AnimDataModule::Frame(owner)
         , atomCount(0)
+        , valid(false)
         , maxBFactor(0)
         , minBFactor(0)
         , maxCharge(0)
@@ -83,68 +98,6 @@ bool PDBLoader::Frame::operator==(const PDBLoader::Frame& rhs) {
     return true;
 }
 
-/*
- * interpret a given bit array as an integer
- */
-int PDBLoader::Frame::decodebits(char* buff, int offset, int bitsize) {
-
-    int num = 0;
-    int mask = (1 << bitsize) - 1; // '1'^bitsize
-
-    // change byte order
-    char tmpBuff[] = {buff[3], buff[2], buff[1], buff[0]};
-
-    // interprete char-array as an integer
-    num = *(int*)tmpBuff;
-    // cut off right offset
-    num = num >> (32 - (offset + bitsize));
-
-    // cut off left offset by using only 'bitsize' first bits
-    num = num & mask;
-
-    return num;
-}
-
-/*
- * decodeints
- */
-void PDBLoader::Frame::decodeints(char* buff, int offset, int num_of_bits, unsigned int sizes[], int nums[]) {
-
-
-    int bytes[32];
-    int i, j, num_of_bytes, p, num;
-
-    bytes[1] = bytes[2] = bytes[3] = 0;
-    num_of_bytes = 0;
-
-    while (num_of_bits > 8) {
-        // note: bit-offset stays the same
-        bytes[num_of_bytes] = decodebits(buff, offset, 8);
-        buff++;
-        num_of_bytes++;
-        num_of_bits -= 8;
-    }
-    if (num_of_bits > 0) {
-        bytes[num_of_bytes++] = decodebits(buff, offset, num_of_bits);
-    }
-
-    // get num[2] and num[1]
-    for (i = 2; i > 0; i--) {
-
-        num = 0;
-        for (j = num_of_bytes - 1; j >= 0; j--) {
-            num = (num << 8) | bytes[j];
-            p = num / sizes[i];
-            bytes[j] = p;
-            num = num - p * sizes[i];
-        }
-        nums[i] = num;
-    }
-
-    // get num[0]
-    nums[0] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
-}
-
 /*
  * sizeofints
  */
@@ -437,264 +390,12 @@ void PDBLoader::Frame::encodebits(char* outbuff, int bitsize, int bitoffset, uns
 /*
  * read frame-data from a given xtc-file
  */
-void PDBLoader::Frame::readFrame(std::fstream* file) {
-
-    int* buffer;
-    char* buffPt;
-    int thiscoord[3], prevcoord[3], tempCoord;
-    int run = 0;
-    unsigned int i = 0;
-    int bit_offset = 0;
-
-    unsigned int sizeint[3], sizesmall[3], bitsizeint[3];
-    int flag;
-    int smallnum, smaller, larger, is_smaller;
-    unsigned int bitsize;
-    unsigned int size;
-
-    int minint[3], maxint[3];
-    int smallidx;
-    float precision;
-
-    // note that magicints[FIRSTIDX-1] == 0
-    const int magicints[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64, 80, 101, 128, 161, 203,
-        256, 322, 406, 512, 645, 812, 1024, 1290, 1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003, 16384,
-        20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031, 131072, 165140, 208063, 262144, 330280, 416127, 524287,
-        660561, 832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021, 4194304, 5284491, 6658042, 8388607,
-        10568983, 13316085, 16777216};
-
-    const int FIRSTIDX = 9;
-    const int LASTIDX = (sizeof(magicints) / sizeof(*magicints));
-
-
-    // skip header data:
-    // + version number     ( 4 Bytes)
-    // + number of atoms    ( 4 Bytes)
-    // + simulation step    ( 4 Bytes)
-    // + simulation time    ( 4 Bytes)
-    // + bounding box       (36 Bytes)
-    // + number of atoms    ( 4 Bytes)
-    file->seekg(56, std::ios_base::cur);
-
-
-    // no compression is used for three atoms or less
-    if (atomCount <= 3) {
-        float posX, posY, posZ;
-        for (i = 0; i < atomCount; i++) {
-            file->read((char*)&posX, 4);
-            changeByteOrder((char*)&posX);
-            file->read((char*)&posY, 4);
-            changeByteOrder((char*)&posY);
-            file->read((char*)&posZ, 4);
-            changeByteOrder((char*)&posZ);
-            this->SetAtomPosition(i, posX, posY, posZ);
-        }
-        return;
-    }
-
-    // read the precision of the float coordinates
-    file->read((char*)&precision, 4);
-    changeByteOrder((char*)&precision);
-    precision /= 10.0f;
-
-    // read the lower bound of 'big' integer-coordinates
-    file->read((char*)&minint, 12);
-
-    changeByteOrder((char*)&minint[0]);
-    changeByteOrder((char*)&minint[1]);
-    changeByteOrder((char*)&minint[2]);
-
-    // read the upper bound of 'big' integer-coordinates
-    file->read((char*)&maxint, 12);
-    changeByteOrder((char*)&maxint[0]);
-    changeByteOrder((char*)&maxint[1]);
-    changeByteOrder((char*)&maxint[2]);
-
-
-    sizeint[0] = maxint[0] - minint[0] + 1;
-    sizeint[1] = maxint[1] - minint[1] + 1;
-    sizeint[2] = maxint[2] - minint[2] + 1;
-
-    // check if one of the sizes is to big to be multiplied
-    if ((sizeint[0] | sizeint[1] | sizeint[2]) > 0xffffff) {
-        bitsizeint[0] = sizeofint(sizeint[0]);
-        bitsizeint[1] = sizeofint(sizeint[1]);
-        bitsizeint[2] = sizeofint(sizeint[2]);
-        bitsize = 0; // flag the use of large sizes
-    } else {
-        bitsizeint[0] = 0;
-        bitsizeint[1] = 0;
-        bitsizeint[2] = 0;
-        bitsize = sizeofints(sizeint);
-    }
-
-    // read number of bits used to encode 'small' integers
-    // note: changes dynamically within one frame
-    file->read((char*)&smallidx, 4);
-    if (*file) {
-        //std::cout << "all characters read successfully.";
-    } else {
-        std::cout << "error: only " << file->gcount() << " could be read";
-    }
-    changeByteOrder((char*)&smallidx);
-
-    // calculate maxidx/minidx
-    int minidx, maxidx;
-    if (LASTIDX < (unsigned int)(smallidx + 8)) {
-        maxidx = LASTIDX;
-    } else {
-        maxidx = smallidx + 8;
-    }
-    minidx = maxidx - 8; // often this equal smallidx
-
-    // if the difference to the last coordinate is smaller than smallnum
-    // the difference is stored instead of the real coordinate
-    smallnum = magicints[smallidx] / 2;
-
-    // range of the 'small' integers
-    sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
-
-    // calculate smaller/larger
-    if (FIRSTIDX > smallidx - 1) {
-        smaller = magicints[FIRSTIDX] / 2;
-    } else {
-        smaller = magicints[smallidx - 1] / 2;
-    }
-    larger = magicints[maxidx];
-
-    // read the size of the compressed data-block
-    file->read((char*)&size, 4);
-    changeByteOrder((char*)&size);
-
-    buffer = new int[(int)(atomCount * 3 * 1.2)];
-
-    // get the compressed data-block
-    file->read((char*)&buffer[0], size);
-
-    buffPt = (char*)buffer;
-    bit_offset = 0;
-
-
-    while (i < atomCount) {
-
-        thiscoord[0] = 0;
-        thiscoord[1] = 0;
-        thiscoord[2] = 0;
-
-
-        // if large numbers are used
-        if (bitsize == 0) {
-            thiscoord[0] = decodebits(buffPt, bit_offset, bitsizeint[0]);
-            buffPt += (bit_offset + bitsizeint[0]) / 8;
-            bit_offset = (bit_offset + bitsizeint[0]) % 8;
-
-            thiscoord[1] = decodebits(buffPt, bit_offset, bitsizeint[1]);
-            buffPt += (bit_offset + bitsizeint[1]) / 8;
-            bit_offset = (bit_offset + bitsizeint[1]) % 8;
-
-            thiscoord[2] = decodebits(buffPt, bit_offset, bitsizeint[2]);
-            buffPt += (bit_offset + bitsizeint[2]) / 8;
-            bit_offset = (bit_offset + bitsizeint[2]) % 8;
-        } else {
-            decodeints(buffPt, bit_offset, bitsize, sizeint, thiscoord);
-            buffPt += (bit_offset + bitsize) / 8;
-            bit_offset = (bit_offset + bitsize) % 8;
-        }
-
-        // transform to unsigned ints
-        thiscoord[0] += minint[0];
-        thiscoord[1] += minint[1];
-        thiscoord[2] += minint[2];
-
-        // flag has been set if runlength changed while compression
-        // runlength is encoded in run/3
-        // is_smaller is encoded in run%3 (-1,0,1)
-        flag = decodebits(buffPt, bit_offset, 1);
-        buffPt += (bit_offset + 1) / 8;
-        bit_offset = (bit_offset + 1) % 8;
-
-        is_smaller = 0;
-        if (flag == 1) {
-            run = decodebits(buffPt, bit_offset, 5);
-            buffPt += (bit_offset + 5) / 8;
-            bit_offset = (bit_offset + 5) % 8;
-            is_smaller = run % 3;
-            run -= is_smaller;
-            is_smaller--;
-        }
-
-        // run = the number of coordinates following the current coordinate that
-        // have bin stored as differences to there previous coordinate
-        if (run > 0) {
-            // save the current coordinate
-            prevcoord[0] = thiscoord[0];
-            prevcoord[1] = thiscoord[1];
-            prevcoord[2] = thiscoord[2];
-
-            for (int k = 0; k < run; k += 3) {
-                decodeints(buffPt, bit_offset, smallidx, sizesmall, thiscoord);
-
-                buffPt += (bit_offset + smallidx) / 8;
-                bit_offset = (bit_offset + smallidx) % 8;
-
-                thiscoord[0] += prevcoord[0] - smallnum;
-                thiscoord[1] += prevcoord[1] - smallnum;
-                thiscoord[2] += prevcoord[2] - smallnum;
-
-                if (k == 0) {
-                    // interchange first with second atom for better
-                    // compression of water molecules
-                    tempCoord = thiscoord[0];
-                    thiscoord[0] = prevcoord[0];
-                    prevcoord[0] = tempCoord;
-                    tempCoord = thiscoord[1];
-                    thiscoord[1] = prevcoord[1];
-                    prevcoord[1] = tempCoord;
-                    tempCoord = thiscoord[2];
-                    thiscoord[2] = prevcoord[2];
-                    prevcoord[2] = tempCoord;
-
-                    // calculate float-value of the old coordinate
-                    this->SetAtomPosition(i, (float)prevcoord[0] / precision, (float)prevcoord[1] / precision,
-                        (float)prevcoord[2] / precision);
-                    i++;
-                } else {
-                    prevcoord[0] = thiscoord[0];
-                    prevcoord[1] = thiscoord[1];
-                    prevcoord[2] = thiscoord[2];
-                }
-
-                this->SetAtomPosition(i, (float)thiscoord[0] / precision, (float)thiscoord[1] / precision,
-                    (float)thiscoord[2] / precision);
-                i++;
-            }
-        } else {
-            this->SetAtomPosition(
-                i, (float)thiscoord[0] / precision, (float)thiscoord[1] / precision, (float)thiscoord[2] / precision);
-            i++;
-        }
-
-
-        // update smallidx etc
-        smallidx += is_smaller;
-        if (is_smaller < 0) {
-            smallnum = smaller;
-            if (smallidx > FIRSTIDX) {
-                smaller = magicints[smallidx - 1] / 2;
-            } else {
-                smaller = 0;
-            }
-        } else if (is_smaller > 0) {
-            smaller = smallnum;
-            smallnum = magicints[smallidx] / 2;
-        }
-        sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
-    }
-
-    delete[] buffer;
-
-    // set file pointer to the beginning of the next frame
-    file->seekg((4 - size % 4) % 4, std::ios_base::cur);
+bool PDBLoader::Frame::readFrame(XTCReader& reader, unsigned int idx) {
+    this->valid = false;
+    if (reader.AtomCount() != this->atomCount || this->atomCount == 0)
+        return false;
+    this->valid = reader.ReadFrame(idx, &this->atomPosition[0]);
+    return this->valid;
 }
 
 /*
@@ -758,12 +459,14 @@ PDBLoader::PDBLoader(void)
         , calcBondsSlot("calculateBonds", "Calculate covalent bonds when loading the file")
         , recomputeStridePerFrameSlot(
               "recomputeSTRIDEeachFrame", "If STRIDE is used, should it be recomputed each frame?")
+        , strideCacheSizeSlot("STRIDEframeCacheSize",
+              "The number of frames whose STRIDE results are kept if STRIDE is recomputed each frame")
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , datahash(0)
         , stride(0)
         , secStructAvailable(false)
         , numXTCFrames(0)
-        , XTCFrameOffset(0)
+        , xtcReader()
         , xtcFileValid(false) {
 
     this->pdbFilenameSlot << new param::FilePathParam("", param::FilePathParam::FilePathFlags_::Flag_Any_ToBeCreated);
@@ -799,6 +502,9 @@ PDBLoader::PDBLoader(void)
     this->recomputeStridePerFrameSlot << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->recomputeStridePerFrameSlot);
 
+    this->strideCacheSizeSlot << new param::IntParam(64, 1);
+    this->MakeSlotAvailable(&this->strideCacheSizeSlot);
+
     mdd = NULL; // no mdd object
 }
 
@@ -923,6 +629,10 @@ bool PDBLoader::getData(core::Call& call) {
             }
         }
 
+        if (!fr->IsValid()) {
+            dc->Unlock();
+            return false;
+        }
 
         dc->SetAtoms(this->data[0]->AtomCount(), static_cast<unsigned int>(this->atomType.Count()),
             this->atomTypeIdx.PeekElements(), fr->AtomPositions(), this->atomType.PeekElements(),
@@ -949,7 +659,33 @@ bool PDBLoader::getData(core::Call& call) {
     dc->SetChains(
         static_cast<unsigned int>(this->chain.Count()), (MolecularDataCall::Chain*)this->chain.PeekElements());
 
-    if ((!this->secStructAvailable || this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value()) &&
+    if (this->recomputeStridePerFrameSlot.Param<param::BoolParam>()->Value() &&
+        this->strideFlagSlot.Param<param::BoolParam>()->Value()) {
+        // the secondary structure of each frame is computed once and kept until the cache runs full
+        auto it = this->strideFrameCache.find(dc->FrameID());
+        if (it == this->strideFrameCache.end()) {
+            auto t = std::chrono::steady_clock::now();
+            Stride::Result res;
+            Stride frameStride(dc);
+            frameStride.GetResult(dc, res);
+            const size_t maxCached = static_cast<size_t>(this->strideCacheSizeSlot.Param<param::IntParam>()->Value());
+            while (this->strideFrameCache.size() >= maxCached) {
+                // evict the frame farthest away from the requested one
+                auto victim = this->strideFrameCache.begin();
+                auto last = std::prev(this->strideFrameCache.end());
+                const int64_t frame = dc->FrameID();
+                if (std::abs(frame - victim->first) < std::abs(frame - last->first)) {
+                    victim = last;
+                }
+                this->strideFrameCache.erase(victim);
+            }
+            it = this->strideFrameCache.emplace(dc->FrameID(), std::move(res)).first;
+            Log::DefaultLog.WriteInfo("Secondary Structure of frame %u computed via STRIDE in %f seconds.",
+                dc->FrameID(), std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count());
+        }
+        Stride::WriteToInterface(it->second, dc);
+        this->secStructAvailable = true;
+    } else if ((!this->secStructAvailable || !this->stride) &&
         this->strideFlagSlot.Param<param::BoolParam>()->Value()) {
         time_t t = clock(); // DEBUG
         if (this->stride)
@@ -1068,15 +804,11 @@ void PDBLoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
                                 data[0]->AtomPositions()[i+2]);
         }
     } else {*/
-    std::fstream xtcFile;
-
-    xtcFile.open(this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
-
-    xtcFile.seekg(this->XTCFrameOffset[idx]);
-
-    fr->readFrame(&xtcFile);
-
-    xtcFile.close();
+    // the reader keeps the file open and is safe to use from several loader threads
+    if (!fr->readFrame(this->xtcReader, idx)) {
+        // the frame stays invalid, so requests for it fail
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Could not read frame %u of the XTC file", idx);
+    }
     //}
 
     //megamol::core::utility::log::Log::DefaultLog.WriteMsg( megamol::core::utility::log::Log::LEVEL_INFO,
@@ -1084,6 +816,15 @@ void PDBLoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
     //( double( clock() - t) / double( CLOCKS_PER_SEC) )); // DEBUG
 }
 
+/*
+ * PDBLoader::maxConcurrentFrameLoads
+ */
+unsigned int PDBLoader::maxConcurrentFrameLoads() const {
+    if (!this->xtcFileValid)
+        return 1;
+    return vislib::math::Max(1U, std::thread::hardware_concurrency());
+}
+
 /*
  * PDBLoader::loadFile
  */
@@ -1107,12 +848,11 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
 
     time_t t = clock(); // DEBUG
 
-    vislib::StringA line;
     unsigned int idx, atomCnt, lineCnt, frameCnt, resCnt, chainCnt;
 
     t = clock(); // DEBUG
 
-    vislib::sys::ASCIIFileBuffer file;
+    ColumnTextFile file;
     vislib::Array<vislib::StringA> atomEntries;
     SIZE_T atomEntriesCapacity = 10000;
     SIZE_T frameCapacity = 10000;
@@ -1122,11 +862,12 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
     // try to load the file
     bool file_loaded = false;
 
-    if (file.LoadFile(filename.c_str())) {
+    if (file.Load(filename)) {
         // file successfully loaded, read first frame
         file_loaded = true;
         lineCnt = 0;
-        while (lineCnt < file.Count() && !line.StartsWith("END")) {
+        std::string_view line;
+        while (lineCnt < file.Count() && !ColumnTextFile::StartsWith(line, "END")) {
             // get the current line from the file
             line = file.Line(lineCnt);
             // Store bounding box if provided
@@ -1142,13 +883,11 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
             //                        this->bboxPDB.Front()); // DEBUG
             //            }
             // store all atom entries
-            if (line.StartsWith("ATOM")) {
+            if (ColumnTextFile::StartsWith(line, "ATOM")) {
                 // ignore alternate locations
-                if (line.Substring(16, 1).Equals(" ", false) || line.Substring(16, 1).Equals("A", false)) {
+                if (isMainLocation(line)) {
                     // check if the atom belongs to a cap and needs to be removed
-                    auto res_string = line.Substring(23, 4);
-                    res_string.TrimSpaces();
-                    int res_id = std::atoi(res_string.PeekBuffer());
+                    int res_id = ColumnTextFile::ParseInt(ColumnTextFile::Field(line, 23, 4));
                     bool found = false;
                     for (size_t i = 0; i < this->cap_chain.Count(); i++) {
                         if (res_id >= this->cap_chain[i].first && res_id <= this->cap_chain[i].second) {
@@ -1164,7 +903,7 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
                             atomEntries.AssertCapacity(atomEntriesCapacity);
                         }
                         // add atom entry
-                        atomEntries.Add(line);
+                        atomEntries.Add(vislib::StringA(line.data(), static_cast<vislib::StringA::Size>(line.size())));
                     }
                 }
             }
@@ -1367,41 +1106,9 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
 
     // if no xtc-filename has been set
     if (this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value().empty()) {
+        this->xtcReader.Close();
         // parsed first frame - load all other frames now
-        atomCnt = 0;
-        while (lineCnt < file.Count()) {
-            // get the current line from the file
-            line = file.Line(lineCnt);
-            // store all atom entries
-            if (line.StartsWith("ATOM")) {
-                // found new frame, resize data array
-                if (atomCnt == 0) {
-                    frameCnt++;
-                    // check if max frame count is reached
-                    if (frameCnt > static_cast<unsigned int>(this->maxFramesSlot.Param<param::IntParam>()->Value())) {
-                        break;
-                    }
-                    if (this->data.Count() == frameCapacity) {
-                        frameCapacity += 10000;
-                        this->data.AssertCapacity(frameCapacity);
-                    }
-                    this->data.SetCount(frameCnt + 1);
-                    this->data[frameCnt] = new Frame(*const_cast<PDBLoader*>(this));
-                    this->data[frameCnt]->SetAtomCount(static_cast<unsigned int>(atomEntries.Count()));
-                    this->data[frameCnt]->setFrameIdx(frameCnt);
-                }
-                // ignore alternate locations
-                if (line.Substring(16, 1).Equals(" ", false) || line.Substring(16, 1).Equals("A", false)) {
-                    // add atom position to the current frame
-                    this->setAtomPositionToFrame(line, atomCnt, frameCnt);
-                    atomCnt++;
-                }
-            } else if (line.StartsWith("END")) {
-                atomCnt = 0;
-            }
-            // next line
-            lineCnt++;
-        }
+        this->parseFrames(file, lineCnt);
 
         Log::DefaultLog.WriteInfo("Time for parsing %i frames: %f", this->data.Count(),
             (double(clock() - t) / double(CLOCKS_PER_SEC))); // DEBUG
@@ -1421,56 +1128,28 @@ void PDBLoader::loadFile(const std::filesystem::path& filename) {
 
         Log::DefaultLog.WriteInfo("Number of XTC-frames: %u", this->numXTCFrames); // DEBUG
 
-        //float box[3][3];
-        char tmpByte;
-        std::fstream xtcFile;
-        char* num;
-        unsigned int nAtoms;
-
-        // try to open the xtc-file
-        xtcFile.open(
-            this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
-
-        if (!xtcFile) {
+        if (!this->xtcReader.IsOpen()) {
             Log::DefaultLog.WriteError("Could not load XTC-file."); // DEBUG
             xtcFileValid = false;
-        } else {
-
-
-            xtcFile.seekg(4, std::ios_base::cur);
-            // read number of atoms
-            xtcFile.read((char*)&nAtoms, 4);
-            // change byte order
-            num = (char*)&nAtoms;
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
-
+        } else if (this->xtcReader.AtomCount() != atomEntries.Count()) {
             // check whether the pdb-file and the xtc-file contain the
             // same number of atoms
-            if (nAtoms != atomEntries.Count()) {
-                Log::DefaultLog.WriteError("XTC-File and given PDB-file not matching (XTC-file has"
-                                           "%i atom entries, PDB-file has %i atom entries).",
-                    nAtoms, atomEntries.Count()); // DEBUG
-                xtcFileValid = false;
-                xtcFile.close();
-            } else {
-                xtcFile.close();
-
-                xtcFileValid = true;
+            Log::DefaultLog.WriteError("XTC-File and given PDB-file not matching (XTC-file has"
+                                       "%i atom entries, PDB-file has %i atom entries).",
+                this->xtcReader.AtomCount(), atomEntries.Count()); // DEBUG
+            xtcFileValid = false;
+            this->xtcReader.Close();
+        } else {
+            xtcFileValid = true;
 
-                int maxFrames = vislib::math::Min<int>(
-                    this->maxFramesSlot.Param<core::param::IntParam>()->Value(), static_cast<int>(this->numXTCFrames));
+            int maxFrames = vislib::math::Min<int>(
+                this->maxFramesSlot.Param<core::param::IntParam>()->Value(), static_cast<int>(this->numXTCFrames));
 
-                // frames in xtc-file - 1 (without the last frame)
-                this->setFrameCount(this->numXTCFrames);
+            // frames in xtc-file - 1 (without the last frame)
+            this->setFrameCount(this->numXTCFrames);
 
-                // start the loading thread
-                this->initFrameCache(maxFrames);
-            }
+            // start the loading thread
+            this->initFrameCache(maxFrames);
         }
     }
 }
@@ -1526,9 +1205,11 @@ void PDBLoader::parseAtomEntry(vislib::StringA& atomEntry, unsigned int atom, un
     // temp variables
     vislib::StringA tmpStr;
     vislib::math::Vector<float, 3> pos;
+    const std::string_view entry(atomEntry.PeekBuffer(), atomEntry.Length());
     // set atom position
-    pos.Set(float(atof(atomEntry.Substring(30, 8))), float(atof(atomEntry.Substring(38, 8))),
-        float(atof(atomEntry.Substring(46, 8))));
+    pos.Set(ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 30, 8)),
+        ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 38, 8)),
+        ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 46, 8)));
     this->data[frame]->SetAtomPosition(atom, pos.X(), pos.Y(), pos.Z());
 
     // get the atom index of the current ATOM entry
@@ -1673,9 +1354,7 @@ void PDBLoader::parseAtomEntry(vislib::StringA& atomEntry, unsigned int atom, un
     this->atomResidueIdx[atom] = static_cast<int>(this->residue.Count() - 1);
 
     // get the temperature factor (b-factor)
-    tmpStr = atomEntry.Substring(60, 6);
-    tmpStr.TrimSpaces();
-    float tempFactor = float(atof(tmpStr));
+    float tempFactor = ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 60, 6));
     if (atom == 0) {
         this->data[frame]->SetBFactorRange(tempFactor, tempFactor);
     } else {
@@ -1687,9 +1366,7 @@ void PDBLoader::parseAtomEntry(vislib::StringA& atomEntry, unsigned int atom, un
     this->data[frame]->SetAtomBFactor(atom, tempFactor);
 
     // get the occupancy
-    tmpStr = atomEntry.Substring(54, 6);
-    tmpStr.TrimSpaces();
-    float occupancy = float(atof(tmpStr));
+    float occupancy = ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 54, 6));
     if (atom == 0) {
         this->data[frame]->SetOccupancyRange(occupancy, occupancy);
     } else {
@@ -1701,9 +1378,7 @@ void PDBLoader::parseAtomEntry(vislib::StringA& atomEntry, unsigned int atom, un
     this->data[frame]->SetAtomOccupancy(atom, occupancy);
 
     // get the charge
-    tmpStr = atomEntry.Substring(78, 2);
-    tmpStr.TrimSpaces();
-    float charge = float(atof(tmpStr));
+    float charge = ColumnTextFile::ParseFloat(ColumnTextFile::Field(entry, 78, 2));
     if (atom == 0) {
         this->data[frame]->SetChargeRange(charge, charge);
     } else {
@@ -1836,70 +1511,163 @@ vislib::math::Vector<unsigned char, 3> PDBLoader::getElementColor(vislib::String
 }
 
 /*
- * set the position of the current atom entry to the frame
+ * parse the atom entries of all frames following the first one
  */
-void PDBLoader::setAtomPositionToFrame(vislib::StringA& atomEntry, unsigned int atom, unsigned int frame) {
-    // temp variables
-    vislib::StringA tmpStr;
-    vislib::math::Vector<float, 3> pos;
-    // set atom position
-    pos.Set(float(atof(atomEntry.Substring(30, 8))), float(atof(atomEntry.Substring(38, 8))),
-        float(atof(atomEntry.Substring(46, 8))));
-    this->data[frame]->SetAtomPosition(atom, pos.X(), pos.Y(), pos.Z());
-
-    // update bounding box
-    vislib::math::Cuboid<float> atomBBox(pos.X() - this->atomType[this->atomTypeIdx[atom]].Radius(),
-        pos.Y() - this->atomType[this->atomTypeIdx[atom]].Radius(),
-        pos.Z() - this->atomType[this->atomTypeIdx[atom]].Radius(),
-        pos.X() + this->atomType[this->atomTypeIdx[atom]].Radius(),
-        pos.Y() + this->atomType[this->atomTypeIdx[atom]].Radius(),
-        pos.Z() + this->atomType[this->atomTypeIdx[atom]].Radius());
-    this->bbox.Union(atomBBox);
+void PDBLoader::parseFrames(const ColumnTextFile& file, size_t firstLine) {
+    using megamol::core::utility::log::Log;
 
-    if (atom == 0) {
-        this->bboxPerFrame.Add(atomBBox);
-    } else {
-        this->bboxPerFrame[frame].Union(atomBBox);
+    // lines per block when classifying and atoms per block when parsing
+    const size_t lineBlockSize = 1 << 16;
+    const size_t atomBlockSize = 1 << 12;
+
+    const auto start = std::chrono::steady_clock::now();
+    const unsigned int atomCount = this->data[0]->AtomCount();
+    const SIZE_T firstFrame = this->data.Count();
+    const size_t lineCnt = (firstLine < file.Count()) ? (file.Count() - firstLine) : 0;
+
+    // 1. collect the atom entries and frame ends of every block of lines in parallel;
+    // 'SIZE_MAX' marks the end of a frame
+    const auto lineBlockCnt = static_cast<int64_t>((lineCnt + lineBlockSize - 1) / lineBlockSize);
+    std::vector<std::vector<size_t>> blockEntries(lineBlockCnt);
+#pragma omp parallel for schedule(static)
+    for (int64_t b = 0; b < lineBlockCnt; ++b) {
+        const size_t begin = firstLine + static_cast<size_t>(b) * lineBlockSize;
+        const size_t end = std::min(begin + lineBlockSize, file.Count());
+        for (size_t l = begin; l < end; ++l) {
+            const std::string_view line = file.Line(l);
+            if (ColumnTextFile::StartsWith(line, "ATOM")) {
+                // ignore alternate locations
+                if (isMainLocation(line)) {
+                    blockEntries[b].push_back(l);
+                }
+            } else if (ColumnTextFile::StartsWith(line, "END")) {
+                blockEntries[b].push_back(SIZE_MAX);
+            }
+        }
     }
 
-    // get the temperature factor (b-factor)
-    tmpStr = atomEntry.Substring(60, 6);
-    tmpStr.TrimSpaces();
-    float tempFactor = float(atof(tmpStr));
-    if (atom == 0) {
-        this->data[frame]->SetBFactorRange(tempFactor, tempFactor);
-    } else {
-        if (this->data[frame]->MinBFactor() > tempFactor)
-            this->data[frame]->SetMinBFactor(tempFactor);
-        else if (this->data[frame]->MaxBFactor() < tempFactor)
-            this->data[frame]->SetMaxBFactor(tempFactor);
+    // 2. split the atom entries into frames in file order
+    const auto maxFrames = static_cast<SIZE_T>(this->maxFramesSlot.Param<param::IntParam>()->Value());
+    std::vector<size_t> atomLines;      // the line of every atom entry of the new frames
+    std::vector<size_t> frameFirstAtom; // the first atom entry of every new frame
+    unsigned int atomCnt = 0;
+    bool maxFramesReached = false;
+    for (size_t b = 0; b < blockEntries.size() && !maxFramesReached; ++b) {
+        for (const size_t l : blockEntries[b]) {
+            if (l == SIZE_MAX) {
+                atomCnt = 0;
+                continue;
+            }
+            // found new frame
+            if (atomCnt == 0) {
+                // check if max frame count is reached
+                if (firstFrame + frameFirstAtom.size() > maxFrames) {
+                    maxFramesReached = true;
+                    break;
+                }
+                frameFirstAtom.push_back(atomLines.size());
+            }
+            // surplus atoms have no place in the frame
+            if (atomCnt < atomCount) {
+                atomLines.push_back(l);
+            }
+            atomCnt++;
+        }
+        blockEntries[b].clear();
+        blockEntries[b].shrink_to_fit();
+    }
+    const SIZE_T frameCnt = frameFirstAtom.size();
+    frameFirstAtom.push_back(atomLines.size());
+
+    this->data.AssertCapacity(firstFrame + frameCnt);
+    this->data.SetCount(firstFrame + frameCnt);
+    this->bboxPerFrame.SetCount(firstFrame + frameCnt);
+    std::vector<std::pair<size_t, size_t>> atomBlocks;
+    for (SIZE_T f = 0; f < frameCnt; ++f) {
+        this->data[firstFrame + f] = new Frame(*const_cast<PDBLoader*>(this));
+        this->data[firstFrame + f]->SetAtomCount(atomCount);
+        this->data[firstFrame + f]->setFrameIdx(static_cast<int>(firstFrame + f));
+        this->bboxPerFrame[firstFrame + f] = this->bbox;
+        for (size_t a = frameFirstAtom[f]; a < frameFirstAtom[f + 1]; a += atomBlockSize) {
+            atomBlocks.emplace_back(f, a);
+        }
     }
 
-    // get the occupancy
-    tmpStr = atomEntry.Substring(54, 6);
-    tmpStr.TrimSpaces();
-    float occupancy = float(atof(tmpStr));
-    if (atom == 0) {
-        this->data[frame]->SetOccupancyRange(occupancy, occupancy);
-    } else {
-        if (this->data[frame]->MinOccupancy() > occupancy)
-            this->data[frame]->SetMinOccupancy(occupancy);
-        else if (this->data[frame]->MaxOccupancy() < occupancy)
-            this->data[frame]->SetMaxOccupancy(occupancy);
+    // 3. parse the atom entries in parallel, every block belongs to one frame
+    struct BlockResult {
+        vislib::math::Cuboid<float> bbox;
+        float bfactor[2], occupancy[2], charge[2];
+    };
+    std::vector<BlockResult> blockResults(atomBlocks.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t b = 0; b < static_cast<int64_t>(atomBlocks.size()); ++b) {
+        const size_t f = atomBlocks[b].first;
+        const size_t begin = atomBlocks[b].second;
+        const size_t end = std::min(begin + atomBlockSize, frameFirstAtom[f + 1]);
+        Frame* frame = this->data[firstFrame + f];
+        BlockResult& result = blockResults[b];
+        for (size_t a = begin; a < end; ++a) {
+            const std::string_view line = file.Line(atomLines[a]);
+            const unsigned int atom = static_cast<unsigned int>(a - frameFirstAtom[f]);
+
+            // set atom position
+            const float x = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 30, 8));
+            const float y = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 38, 8));
+            const float z = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 46, 8));
+            frame->SetAtomPosition(atom, x, y, z);
+
+            // get the temperature factor (b-factor), the occupancy and the charge
+            const float tempFactor = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 60, 6));
+            const float occupancy = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 54, 6));
+            const float charge = ColumnTextFile::ParseFloat(ColumnTextFile::Field(line, 78, 2));
+
+            // update bounding box
+            const float radius = this->atomType[this->atomTypeIdx[atom]].Radius();
+            vislib::math::Cuboid<float> atomBBox(
+                x - radius, y - radius, z - radius, x + radius, y + radius, z + radius);
+            if (a == begin) {
+                result.bbox = atomBBox;
+                result.bfactor[0] = result.bfactor[1] = tempFactor;
+                result.occupancy[0] = result.occupancy[1] = occupancy;
+                result.charge[0] = result.charge[1] = charge;
+            } else {
+                result.bbox.Union(atomBBox);
+                result.bfactor[0] = std::min(result.bfactor[0], tempFactor);
+                result.bfactor[1] = std::max(result.bfactor[1], tempFactor);
+                result.occupancy[0] = std::min(result.occupancy[0], occupancy);
+                result.occupancy[1] = std::max(result.occupancy[1], occupancy);
+                result.charge[0] = std::min(result.charge[0], charge);
+                result.charge[1] = std::max(result.charge[1], charge);
+            }
+        }
     }
 
-    // get the charge
-    tmpStr = atomEntry.Substring(78, 2);
-    tmpStr.TrimSpaces();
-    float charge = float(atof(tmpStr));
-    if (atom == 0) {
-        this->data[frame]->SetChargeRange(charge, charge);
-    } else {
-        if (this->data[frame]->MinCharge() > charge)
-            this->data[frame]->SetMinCharge(charge);
-        else if (this->data[frame]->MaxCharge() < charge)
-            this->data[frame]->SetMaxCharge(charge);
+    // 4. merge the block results in order
+    for (size_t b = 0; b < atomBlocks.size(); ++b) {
+        const size_t f = atomBlocks[b].first;
+        const BlockResult& result = blockResults[b];
+        Frame* frame = this->data[firstFrame + f];
+        this->bbox.Union(result.bbox);
+        if (atomBlocks[b].second == frameFirstAtom[f]) {
+            this->bboxPerFrame[firstFrame + f] = result.bbox;
+            frame->SetBFactorRange(result.bfactor[0], result.bfactor[1]);
+            frame->SetOccupancyRange(result.occupancy[0], result.occupancy[1]);
+            frame->SetChargeRange(result.charge[0], result.charge[1]);
+        } else {
+            this->bboxPerFrame[firstFrame + f].Union(result.bbox);
+            frame->SetBFactorRange(
+                std::min(frame->MinBFactor(), result.bfactor[0]), std::max(frame->MaxBFactor(), result.bfactor[1]));
+            frame->SetOccupancyRange(std::min(frame->MinOccupancy(), result.occupancy[0]),
+                std::max(frame->MaxOccupancy(), result.occupancy[1]));
+            frame->SetChargeRange(
+                std::min(frame->MinCharge(), result.charge[0]), std::max(frame->MaxCharge(), result.charge[1]));
+        }
     }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Log::DefaultLog.WriteInfo("Parsed %u frames with %u atom entries in %f s (%.1f MB/s)",
+        static_cast<unsigned int>(frameCnt), static_cast<unsigned int>(atomLines.size()), seconds,
+        (seconds > 0.0) ? static_cast<double>(file.Size()) / (1024.0 * 1024.0) / seconds : 0.0);
 }
 
 /*
@@ -2033,6 +1801,7 @@ void PDBLoader::resetAllData() {
     this->connectivity.Clear();
     delete stride;
     this->stride = 0;
+    this->strideFrameCache.clear();
     secStructAvailable = false;
     this->chainFirstRes.Clear();
     this->chainResCount.Clear();
@@ -2083,119 +1852,24 @@ bool PDBLoader::readNumXTCFrames() {
 
     // reset values
     this->numXTCFrames = 0;
-    this->XTCFrameOffset.Clear();
 
-    // try to open xtc file
-    std::fstream xtcFile;
-    xtcFile.open(this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
-
-    // check if file could be opened
-    if (!xtcFile)
+    // open the xtc file and load or build its frame directory
+    if (!this->xtcReader.Open(this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value()))
         return false;
 
-    this->XTCFrameOffset.SetCapacityIncrement(1000);
-    int size;
-    char tmpByte;
-    char* num;
-
-    int minint[3];
-    int maxint[3];
-
-    unsigned int i;
-
-    float precision;
-
-    xtcFile.seekg(0, std::ios_base::beg);
-
-    vislib::math::Cuboid<float> tmpBBox(this->bbox);
-
-    //std::fstream::iostate st = 0;
-
-    // get length of file:
-    xtcFile.seekg(0, xtcFile.end);
-    int xtcFileLength = (int)xtcFile.tellg();
-    xtcFile.seekg(0, xtcFile.beg);
-
-    // read until eof
-    while (!xtcFile.eof() && xtcFile.tellg() < xtcFileLength) {
-        // add the offset to the offset array
-        this->XTCFrameOffset.Add((unsigned int)xtcFile.tellg());
-
-        // skip some header data
-        xtcFile.seekg(56, std::ios_base::cur);
-        // read precision
-        xtcFile.read((char*)&precision, 4);
-        // change byte-order
-        num = (char*)&precision;
-        tmpByte = num[0];
-        num[0] = num[3];
-        num[3] = tmpByte;
-        tmpByte = num[1];
-        num[1] = num[2];
-        num[2] = tmpByte;
-        precision /= 10.0f;
-
-        // get the lower bound
-        xtcFile.read((char*)&minint, 12);
-        // get the upper bound
-        xtcFile.read((char*)&maxint, 12);
-        // change byte-order
-        for (i = 0; i < 3; i++) {
-            num = (char*)&minint[i];
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
-            num = (char*)&maxint[i];
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
-        }
+    // remove the last frame
+    this->numXTCFrames = this->xtcReader.FrameCount() - 1;
 
-        // update the bounding box by uniting it with the last frames box
-        this->bbox.Union(tmpBBox);
+    // update the bounding box by uniting it with the frames boxes
+    for (unsigned int i = 0; i < this->numXTCFrames; i++) {
+        const XTCReader::FrameInfo& info = this->xtcReader.Info(i);
         // get the current frames bounding box including the atom radius
         // note: atom radius is divided by 10
-        tmpBBox = vislib::math::Cuboid<float>((float)minint[0] / precision - 0.3f, (float)minint[1] / precision - 0.3f,
-            (float)minint[2] / precision - 0.3f,
-
-            (float)maxint[0] / precision + 0.3f, (float)maxint[1] / precision + 0.3f,
-            (float)maxint[2] / precision + 0.3f);
-
-        // skip some header data
-        xtcFile.seekg(4, std::ios_base::cur);
-
-        // read size of the compressed block of data
-        xtcFile.read((char*)&size, 4);
-        // change byte-order
-        num = (char*)&size;
-        tmpByte = num[0];
-        num[0] = num[3];
-        num[3] = tmpByte;
-        tmpByte = num[1];
-        num[1] = num[2];
-        num[2] = tmpByte;
-
-        // skip the compressed block of data except for the last byte and
-        // ignore the remaining bytes to prevent skipping over the end
-        // of the file
-        xtcFile.seekg(size - 1, std::ios_base::cur);
-        xtcFile.ignore(((4 - size % 4) % 4) + 1);
-
-        // add this frame to the frame count
-        this->numXTCFrames++;
-        auto xtc_state = xtcFile.rdstate();
+        this->bbox.Union(vislib::math::Cuboid<float>((float)info.minint[0] / info.precision - 0.3f,
+            (float)info.minint[1] / info.precision - 0.3f, (float)info.minint[2] / info.precision - 0.3f,
+            (float)info.maxint[0] / info.precision + 0.3f, (float)info.maxint[1] / info.precision + 0.3f,
+            (float)info.maxint[2] / info.precision + 0.3f));
     }
-    xtcFile.close();
-
-    // remove the last frame
-    this->XTCFrameOffset.RemoveLast();
-    this->numXTCFrames--;
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("Time for parsing the XTC-file: %f",
         (double(clock() - t) / double(CLOCKS_PER_SEC))); // DEBUG
@@ -11,8 +11,10 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include "ColumnTextFile.h"
 #include "MDDriverConnector.h"
 #include "Stride.h"
+#include "XTCReader.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
@@ -22,8 +24,10 @@
 #include "vislib/math/Cuboid.h"
 #include "vislib/math/Vector.h"
 #include "vislib/sys/RunnableThread.h"
+#include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <map>
 
 #ifdef WITH_CURL
 #include <curl/curl.h>
@@ -136,6 +140,14 @@ protected:
      */
     virtual void loadFrame(Frame* frame, unsigned int idx);
 
+    /**
+     * Answer how many frames may be loaded at the same time. XTC frames
+     * are independent, so they are decoded in parallel.
+     *
+     * @return The maximum number of concurrent calls to 'loadFrame'.
+     */
+    virtual unsigned int maxConcurrentFrameLoads() const;
+
 private:
     /**
      * Storage of frame data
@@ -179,9 +191,22 @@ private:
          * Reads and decodes one frame of the data set from a given
          * xtc-file.
          *
-         * @param file Pointer to the current frame in the xtc-file
+         * @param reader The opened xtc-file
+         * @param idx The index of the frame in the xtc-file
+         *
+         * @return 'true' if the frame could be read
+         */
+        bool readFrame(XTCReader& reader, unsigned int idx);
+
+        /**
+         * Answer whether the atom positions have been read successfully
+         * by the last call of 'readFrame'.
+         *
+         * @return 'true' if the frame holds valid positions
          */
-        void readFrame(std::fstream* file);
+        inline bool IsValid() const {
+            return this->valid;
+        }
 
         /**
          * Calculates the number of bits needed to represent a given
@@ -202,29 +227,6 @@ private:
          */
         unsigned int sizeofints(unsigned int sizes[]);
 
-        /**
-         * Decodes integers from a given byte-array by calculating the
-         * remainder and doing divisions with the maximum range.
-         *
-         * @param buff pointer to the byte buffer
-         * @param offset the bit-offset within the first byte
-         * @param num_of_bits the total number of bits to decode
-         * @param sizes the range of the integers
-         * @param nums array of the decoded integers
-         */
-        void decodeints(char* buff, int offset, int num_of_bits, unsigned int sizes[], int nums[]);
-
-        /**
-         * Interprets a given bit array as an integer.
-         *
-         * @param buff pointer to the byte buffer
-         * @param offset the bit-offset within the first byte
-         * @param bitsize the total number of bits
-         *
-         * @return the decoded integer
-         */
-        int decodebits(char* buff, int offset, int bitsize);
-
         /**
          * Reverse the order of bytes in a given char-array of 4 elements.
          *
@@ -471,6 +473,9 @@ private:
         /** The atom count */
         unsigned int atomCount;
 
+        /** Flag whether the last call of 'readFrame' succeeded */
+        bool valid;
+
         /** The atom positions */
         vislib::Array<float> atomPosition;
 
@@ -596,14 +601,14 @@ private:
     vislib::math::Vector<unsigned char, 3> getElementColor(vislib::StringA name);
 
     /**
-     * Parse one atom entry and set the position of the current atom entry
-     * to the frame.
+     * Parse the atom entries of all frames following the first one and
+     * add them as new frames. The lines are classified and parsed in
+     * parallel, the frames are identical to the ones of a serial parse.
      *
-     * @param atomEntry The atom entry string.
-     * @param atom      The number of the current atom.
-     * @param frame     The number of the current frame.
+     * @param file      The PDB file.
+     * @param firstLine The first line following the first frame.
      */
-    void setAtomPositionToFrame(vislib::StringA& atomEntry, unsigned int atom, unsigned int frame);
+    void parseFrames(const ColumnTextFile& file, size_t firstLine);
 
     /**
      * Search for connections in the given residue and add them to the
@@ -680,6 +685,8 @@ private:
     core::param::ParamSlot calcBondsSlot;
     /** Determine whether to recompute STRIDE each frame */
     core::param::ParamSlot recomputeStridePerFrameSlot;
+    /** The number of frames whose STRIDE results are cached */
+    core::param::ParamSlot strideCacheSizeSlot;
 
     /** The data */
     vislib::Array<Frame*> data;
@@ -735,6 +742,8 @@ private:
 
     /** Stride secondary structure computation */
     Stride* stride;
+    /** STRIDE results per frame if STRIDE is recomputed each frame */
+    std::map<unsigned int, Stride::Result> strideFrameCache;
     /** Flag whether secondary structure is available */
     bool secStructAvailable;
 
@@ -747,10 +756,10 @@ private:
 
     /** the number of frames */
     unsigned int numXTCFrames;
-    /** the byte offset of all frames */
-    vislib::Array<unsigned int> XTCFrameOffset;
-    /** Flag whether the current xtc-filename is valid */
-    bool xtcFileValid;
+    /** the opened xtc-file and its frame directory */
+    XTCReader xtcReader;
+    /** Flag whether the current xtc-filename is valid, also read by the frame loader threads */
+    std::atomic<bool> xtcFileValid;
 
     /** MDDriverLoader object for connecting to MDDriver */
     vislib::sys::RunnableThread<MDDriverConnector>* mdd;
@@ -14,6 +14,7 @@
 #include <ctime>
 #include <iostream>
 #include <math.h>
+#include <numeric>
 
 using namespace megamol;
 using namespace megamol::core;
@@ -45,15 +46,7 @@ ReducedSurface::ReducedSurface(MolecularDataCall* mol, float probeRad)
     this->countCutEdges = 0;
 
     // copy the atom data
-    if (this->molecule && this->numberOfAtoms > 0) {
-        this->atoms.resize(this->molecule->AtomCount() * 4);
-        for (unsigned int i = 0; i < this->molecule->AtomCount(); ++i) {
-            this->atoms[4 * i + 0] = this->molecule->AtomPositions()[3 * i + 0];
-            this->atoms[4 * i + 1] = this->molecule->AtomPositions()[3 * i + 1];
-            this->atoms[4 * i + 2] = this->molecule->AtomPositions()[3 * i + 2];
-            this->atoms[4 * i + 3] = this->molecule->AtomTypes()[this->molecule->AtomTypeIndices()[i]].Radius();
-        }
-    }
+    this->ReadAtoms();
 }
 
 ReducedSurface::ReducedSurface(unsigned int molId, MolecularDataCall* mol, float probeRad)
@@ -86,18 +79,8 @@ ReducedSurface::ReducedSurface(unsigned int molId, MolecularDataCall* mol, float
     // set number of cut edges to 0
     this->countCutEdges = 0;
 
-    // compute the reduced surface
-    if (this->molecule && this->numberOfAtoms > 0) {
-        // this->ComputeReducedSurfaceMolecule();
-
-        this->atoms.resize(this->molecule->AtomCount() * 4);
-        for (unsigned int i = 0; i < this->molecule->AtomCount(); ++i) {
-            this->atoms[4 * i + 0] = this->molecule->AtomPositions()[3 * i + 0];
-            this->atoms[4 * i + 1] = this->molecule->AtomPositions()[3 * i + 1];
-            this->atoms[4 * i + 2] = this->molecule->AtomPositions()[3 * i + 2];
-            this->atoms[4 * i + 3] = this->molecule->AtomTypes()[this->molecule->AtomTypeIndices()[i]].Radius();
-        }
-    }
+    // copy the atom data of the molecule
+    this->ReadAtoms();
 }
 
 
@@ -110,6 +93,48 @@ ReducedSurface::~ReducedSurface(void) {
 }
 
 
+/*
+ * ReducedSurface::ReadAtoms
+ */
+void ReducedSurface::ReadAtoms() {
+    this->atoms.clear();
+    if (this->molecule == NULL || this->numberOfAtoms == 0 ||
+        this->molecule->AtomCount() < (this->firstAtomIdx + this->numberOfAtoms)) {
+        return;
+    }
+    this->atoms.resize(this->numberOfAtoms * 4);
+    for (unsigned int i = 0; i < this->numberOfAtoms; ++i) {
+        const unsigned int idx = this->firstAtomIdx + i;
+        this->atoms[4 * i + 0] = this->molecule->AtomPositions()[3 * idx + 0];
+        this->atoms[4 * i + 1] = this->molecule->AtomPositions()[3 * idx + 1];
+        this->atoms[4 * i + 2] = this->molecule->AtomPositions()[3 * idx + 2];
+        this->atoms[4 * i + 3] = this->molecule->AtomTypes()[this->molecule->AtomTypeIndices()[idx]].Radius();
+    }
+}
+
+
+/*
+ * ReducedSurface::BuildVoxelMap
+ */
+void ReducedSurface::BuildVoxelMap() {
+    const size_t voxelCount =
+        static_cast<size_t>(this->voxelMapSize[0]) * this->voxelMapSize[1] * this->voxelMapSize[2];
+    // counting sort of the RS-vertices by their cells, which keeps the order of the RS-vertices within each cell
+    std::vector<size_t> cells(this->rsVertex.size());
+    this->voxelMapOffsets.assign(voxelCount + 1, 0);
+    for (size_t cnt = 0; cnt < this->rsVertex.size(); ++cnt) {
+        cells[cnt] = this->VoxelCellAt(this->rsVertex[cnt]->GetPosition());
+        ++this->voxelMapOffsets[cells[cnt] + 1];
+    }
+    std::partial_sum(this->voxelMapOffsets.begin(), this->voxelMapOffsets.end(), this->voxelMapOffsets.begin());
+    std::vector<unsigned int> next(this->voxelMapOffsets.begin(), this->voxelMapOffsets.end() - 1);
+    this->voxelMapVertices.resize(this->rsVertex.size());
+    for (size_t cnt = 0; cnt < this->rsVertex.size(); ++cnt) {
+        this->voxelMapVertices[next[cells[cnt]]++] = this->rsVertex[cnt];
+    }
+}
+
+
 /*
  * Compute the reduced surface of a molecule
  */
@@ -150,43 +175,30 @@ void ReducedSurface::ComputeReducedSurface() {
     this->bBox = this->molecule->AccessBoundingBoxes().ObjectSpaceBBox();
     // set voxel lenght --> diameter of the probe + maximum atom diameter
     this->voxelLength = 2 * this->probeRadius + 2 * 3.0f;
-    unsigned int tmpSize = (unsigned int)ceilf(this->bBox.Width() / this->voxelLength);
-    this->voxelMap.clear();
+    this->voxelMapSize[0] = std::max(1u, (unsigned int)ceilf(this->bBox.Width() / this->voxelLength));
+    this->voxelMapSize[1] = std::max(1u, (unsigned int)ceilf(this->bBox.Height() / this->voxelLength));
+    this->voxelMapSize[2] = std::max(1u, (unsigned int)ceilf(this->bBox.Depth() / this->voxelLength));
+    const size_t voxelCount =
+        static_cast<size_t>(this->voxelMapSize[0]) * this->voxelMapSize[1] * this->voxelMapSize[2];
     this->voxelMapProbes.clear();
-    this->voxelMap.resize(tmpSize);
-    this->voxelMapProbes.resize(tmpSize);
-    for (cnt1 = 0; cnt1 < this->voxelMap.size(); ++cnt1) {
-        this->voxelMap[cnt1].resize((unsigned int)ceilf(this->bBox.Height() / this->voxelLength));
-        this->voxelMapProbes[cnt1].resize((unsigned int)ceilf(this->bBox.Height() / this->voxelLength));
-        for (cnt2 = 0; cnt2 < this->voxelMap[cnt1].size(); ++cnt2) {
-            this->voxelMap[cnt1][cnt2].resize((unsigned int)ceilf(this->bBox.Depth() / this->voxelLength));
-            this->voxelMapProbes[cnt1][cnt2].resize((unsigned int)ceilf(this->bBox.Depth() / this->voxelLength));
-        }
-    }
+    this->voxelMapProbes.resize(voxelCount);
     std::cout << "time for resizing voxel maps:  " << (double(clock() - t) / double(CLOCKS_PER_SEC)) << std::endl;
     t = clock();
 
     // get all molecule atom positions
     for (cnt1 = firstAtomIdx; cnt1 < (firstAtomIdx + numberOfAtoms); ++cnt1) {
+        cnt2 = cnt1 - firstAtomIdx;
         // get position of current atom
-        tmpVec1.SetX(this->atoms[4 * cnt1 + 0]);
-        tmpVec1.SetY(this->atoms[4 * cnt1 + 1]);
-        tmpVec1.SetZ(this->atoms[4 * cnt1 + 2]);
+        tmpVec1.SetX(this->atoms[4 * cnt2 + 0]);
+        tmpVec1.SetY(this->atoms[4 * cnt2 + 1]);
+        tmpVec1.SetZ(this->atoms[4 * cnt2 + 2]);
 
         // get the radius of current atom
-        radius = this->atoms[4 * cnt1 + 3];
+        radius = this->atoms[4 * cnt2 + 3];
 
         // add new RS-vertex to the list
         this->rsVertex.push_back(new RSVertex(tmpVec1, radius, cnt1));
 
-        // add RS-vertex to voxel map cell
-        this->voxelMap[(unsigned int)std::min((unsigned int)this->voxelMap.size() - 1,
-            (unsigned int)std::max(0, (int)floorf((tmpVec1.GetX() - bBox.Left()) / voxelLength)))]
-                      [(unsigned int)std::min((unsigned int)this->voxelMap[0].size() - 1,
-                          (unsigned int)std::max(0, (int)floorf((tmpVec1.GetY() - bBox.Bottom()) / voxelLength)))]
-                      [(unsigned int)std::min((unsigned int)this->voxelMap[0][0].size() - 1,
-                           (unsigned int)std::max(0, (int)floorf((tmpVec1.GetZ() - bBox.Back()) / voxelLength)))]
-                          .push_back(this->rsVertex.back());
         // if this is the first atom OR the x-value is larger than the current smallest x
         // --> store cnt as xIdx
         if (this->rsVertex.size() > 0 ||
@@ -209,6 +221,7 @@ void ReducedSurface::ComputeReducedSurface() {
             zIdx = (unsigned int)this->rsVertex.size() - 1;
         }
     }
+    this->BuildVoxelMap();
 
     std::cout << "time for reading all atoms: " << (double(clock() - t) / double(CLOCKS_PER_SEC)) << std::endl;
     t = clock();
@@ -635,16 +648,10 @@ void ReducedSurface::ComputeRSFace(unsigned int edgeIdx) {
                 face->SetDualFace(dualFace);
             }
             // add probe position to voxel map cell
-            face->SetProbeIndex(
-                std::min((unsigned int)this->voxelMapProbes.size() - 1,
-                    (unsigned int)std::max(0, (int)floorf((probeCenterNewFace.GetX() - bBox.Left()) / voxelLength))),
-                std::min((unsigned int)this->voxelMapProbes[0].size() - 1,
-                    (unsigned int)std::max(0, (int)floorf((probeCenterNewFace.GetY() - bBox.Bottom()) / voxelLength))),
-                std::min((unsigned int)this->voxelMapProbes[0][0].size() - 1,
-                    (unsigned int)std::max(0, (int)floorf((probeCenterNewFace.GetZ() - bBox.Back()) / voxelLength))));
-            this->voxelMapProbes[face->GetProbeIndex().GetX()][face->GetProbeIndex().GetY()]
-                                [face->GetProbeIndex().GetZ()]
-                                    .push_back(face);
+            face->SetProbeIndex(this->VoxelCoord(probeCenterNewFace.GetX(), bBox.Left(), 0),
+                this->VoxelCoord(probeCenterNewFace.GetY(), bBox.Bottom(), 1),
+                this->VoxelCoord(probeCenterNewFace.GetZ(), bBox.Back(), 2));
+            this->voxelMapProbes[this->VoxelCell(face->GetProbeIndex())].push_back(face);
         } else {
             // delete temporary edges
             delete tmpEdge1;
@@ -796,16 +803,9 @@ bool ReducedSurface::ComputeFirstFixedProbePos(RSVertex* vI, RSVertex* vJ, RSVer
         this->rsFace.push_back(new RSFace(vI, vJ, vK, this->rsEdge[this->rsEdge.size() - 3],
             this->rsEdge[this->rsEdge.size() - 2], this->rsEdge[this->rsEdge.size() - 1], uijk, pijk1));
         // add probe position to voxel map cell
-        this->rsFace.back()->SetProbeIndex(
-            std::min((unsigned int)this->voxelMapProbes.size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk1.GetX() - bBox.Left()) / voxelLength))),
-            std::min((unsigned int)this->voxelMapProbes[0].size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk1.GetY() - bBox.Bottom()) / voxelLength))),
-            std::min((unsigned int)this->voxelMapProbes[0][0].size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk1.GetZ() - bBox.Back()) / voxelLength))));
-        this->voxelMapProbes[this->rsFace.back()->GetProbeIndex().GetX()][this->rsFace.back()->GetProbeIndex().GetY()]
-                            [this->rsFace.back()->GetProbeIndex().GetZ()]
-                                .push_back(this->rsFace.back());
+        this->rsFace.back()->SetProbeIndex(this->VoxelCoord(pijk1.GetX(), bBox.Left(), 0),
+            this->VoxelCoord(pijk1.GetY(), bBox.Bottom(), 1), this->VoxelCoord(pijk1.GetZ(), bBox.Back(), 2));
+        this->voxelMapProbes[this->VoxelCell(this->rsFace.back()->GetProbeIndex())].push_back(this->rsFace.back());
 
         this->rsEdge[this->rsEdge.size() - 3]->SetRSFace(this->rsFace.back());
         this->rsEdge[this->rsEdge.size() - 2]->SetRSFace(this->rsFace.back());
@@ -830,16 +830,9 @@ bool ReducedSurface::ComputeFirstFixedProbePos(RSVertex* vI, RSVertex* vJ, RSVer
         this->rsFace.push_back(new RSFace(vI, vJ, vK, this->rsEdge[this->rsEdge.size() - 3],
             this->rsEdge[this->rsEdge.size() - 2], this->rsEdge[this->rsEdge.size() - 1], uijk * (-1.0f), pijk2));
         // add probe position to voxel map cell
-        this->rsFace.back()->SetProbeIndex(
-            std::min((unsigned int)this->voxelMapProbes.size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk2.GetX() - bBox.Left()) / voxelLength))),
-            std::min((unsigned int)this->voxelMapProbes[0].size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk2.GetY() - bBox.Bottom()) / voxelLength))),
-            std::min((unsigned int)this->voxelMapProbes[0][0].size() - 1,
-                (unsigned int)std::max(0, (int)floorf((pijk2.GetZ() - bBox.Back()) / voxelLength))));
-        this->voxelMapProbes[this->rsFace.back()->GetProbeIndex().GetX()][this->rsFace.back()->GetProbeIndex().GetY()]
-                            [this->rsFace.back()->GetProbeIndex().GetZ()]
-                                .push_back(this->rsFace.back());
+        this->rsFace.back()->SetProbeIndex(this->VoxelCoord(pijk2.GetX(), bBox.Left(), 0),
+            this->VoxelCoord(pijk2.GetY(), bBox.Bottom(), 1), this->VoxelCoord(pijk2.GetZ(), bBox.Back(), 2));
+        this->voxelMapProbes[this->VoxelCell(this->rsFace.back()->GetProbeIndex())].push_back(this->rsFace.back());
 
         this->rsEdge[this->rsEdge.size() - 3]->SetRSFace(this->rsFace.back());
         this->rsEdge[this->rsEdge.size() - 2]->SetRSFace(this->rsFace.back());
@@ -861,9 +854,9 @@ void ReducedSurface::ComputeVicinity(vislib::math::Vector<float, 3> m, float rad
     // maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
     // maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
     // maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-    maxXId = (unsigned int)this->voxelMap.size() - 1;
-    maxYId = (unsigned int)this->voxelMap[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMap[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     xId = (unsigned int)std::max(0, (int)floorf((m.GetX() - bBox.Left()) / voxelLength));
@@ -881,9 +874,12 @@ void ReducedSurface::ComputeVicinity(vislib::math::Vector<float, 3> m, float rad
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMap[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
+                const size_t cellIdx = this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ);
+                RSVertex* const* cell = this->voxelMapVertices.data() + this->voxelMapOffsets[cellIdx];
+                const unsigned int cellSize = this->voxelMapOffsets[cellIdx + 1] - this->voxelMapOffsets[cellIdx];
+                for (cnt = 0; cnt < cellSize; ++cnt) {
                     // compute distance
-                    distance = (this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetPosition() - m).Length();
+                    distance = (cell[cnt]->GetPosition() - m).Length();
                     // don't check self --> continue if distance is zero
                     if (distance < epsilon)
                         continue;
@@ -895,7 +891,7 @@ void ReducedSurface::ComputeVicinity(vislib::math::Vector<float, 3> m, float rad
                     //{
                     //    this->vicinity.push_back( this->voxelMap[xId+cntX][yId+cntY][zId+cntZ][cnt]);
                     //}
-                    this->vicinity.push_back(this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                    this->vicinity.push_back(cell[cnt]);
                 }
             }
         }
@@ -931,9 +927,9 @@ void ReducedSurface::ComputeVicinity(vislib::math::Vector<float, 3> m, float rad
 void ReducedSurface::ComputeVicinityEdge(RSEdge* edge) {
     unsigned int cnt, xId, yId, zId, maxXId, maxYId, maxZId;
 
-    maxXId = (unsigned int)this->voxelMap.size() - 1;
-    maxYId = (unsigned int)this->voxelMap[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMap[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     xId = std::min(
@@ -950,23 +946,22 @@ void ReducedSurface::ComputeVicinityEdge(RSEdge* edge) {
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMap[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
+                const size_t cellIdx = this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ);
+                RSVertex* const* cell = this->voxelMapVertices.data() + this->voxelMapOffsets[cellIdx];
+                const unsigned int cellSize = this->voxelMapOffsets[cellIdx + 1] - this->voxelMapOffsets[cellIdx];
+                for (cnt = 0; cnt < cellSize; ++cnt) {
                     // don't check vertices of the edge --> continue
-                    if (*(this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]) == *(edge->GetVertex1()) ||
-                        *(this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]) == *(edge->GetVertex2()))
+                    if (*(cell[cnt]) == *(edge->GetVertex1()) || *(cell[cnt]) == *(edge->GetVertex2()))
                         continue;
                     // --> the following is not necessary, because real vicinity is checked when RS-face is computed
                     // --> but it results in a considerable speedup!
                     // compute distance
-                    distance = (this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetPosition() -
-                                edge->GetTorusCenter())
-                                   .Length();
+                    distance = (cell[cnt]->GetPosition() - edge->GetTorusCenter()).Length();
                     // compute threshold
-                    threshold = this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetRadius() +
-                                edge->GetTorusRadius() + this->probeRadius;
+                    threshold = cell[cnt]->GetRadius() + edge->GetTorusRadius() + this->probeRadius;
                     // if distance < threshold --> add atom 'cnt' to vicinity
                     if (distance <= threshold) {
-                        this->vicinity.push_back(this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                        this->vicinity.push_back(cell[cnt]);
                     }
                 }
             }
@@ -984,9 +979,9 @@ void ReducedSurface::ComputeVicinityVertex(RSVertex* vertex) {
     // maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
     // maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
     // maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-    maxXId = (unsigned int)this->voxelMap.size() - 1;
-    maxYId = (unsigned int)this->voxelMap[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMap[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     xId = (unsigned int)std::max(0, (int)floorf((vertex->GetPosition().GetX() - bBox.Left()) / voxelLength));
@@ -1003,20 +998,20 @@ void ReducedSurface::ComputeVicinityVertex(RSVertex* vertex) {
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMap[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
+                const size_t cellIdx = this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ);
+                RSVertex* const* cell = this->voxelMapVertices.data() + this->voxelMapOffsets[cellIdx];
+                const unsigned int cellSize = this->voxelMapOffsets[cellIdx + 1] - this->voxelMapOffsets[cellIdx];
+                for (cnt = 0; cnt < cellSize; ++cnt) {
                     // don't check vertices of the edge --> continue
-                    if (this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetIndex() == vertex->GetIndex())
+                    if (cell[cnt]->GetIndex() == vertex->GetIndex())
                         continue;
                     // compute distance
-                    distance =
-                        (this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetPosition() - vertex->GetPosition())
-                            .Length();
+                    distance = (cell[cnt]->GetPosition() - vertex->GetPosition()).Length();
                     // compute threshold
-                    threshold = this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetRadius() +
-                                vertex->GetRadius() + 2.0f * this->probeRadius;
+                    threshold = cell[cnt]->GetRadius() + vertex->GetRadius() + 2.0f * this->probeRadius;
                     // if distance < threshold --> add atom 'cnt' to vicinity
                     if (distance <= threshold) {
-                        this->vicinity.push_back(this->voxelMap[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                        this->vicinity.push_back(cell[cnt]);
                     }
                 }
             }
@@ -1033,9 +1028,9 @@ std::vector<ReducedSurface::RSFace*> ReducedSurface::GetProbesCutEdge(RSEdge* ed
     // maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
     // maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
     // maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-    maxXId = (unsigned int)this->voxelMapProbes.size() - 1;
-    maxYId = (unsigned int)this->voxelMapProbes[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMapProbes[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     vislib::math::Vector<float, 3> v1, v2, center, probe, dir21;
@@ -1062,8 +1057,9 @@ std::vector<ReducedSurface::RSFace*> ReducedSurface::GetProbesCutEdge(RSEdge* ed
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
-                    probe = this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetProbeCenter();
+                auto const& cell = this->voxelMapProbes[this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ)];
+                for (cnt = 0; cnt < cell.size(); ++cnt) {
+                    probe = cell[cnt]->GetProbeCenter();
                     // distances between probe and edges
                     dist1 = (probe - v1).Length();
                     dist2 = (probe - v2).Length();
@@ -1076,7 +1072,7 @@ std::vector<ReducedSurface::RSFace*> ReducedSurface::GetProbesCutEdge(RSEdge* ed
                     if ((dir21 * lenH + v2 - probe).Length() > this->probeRadius)
                         continue;
                     // add probe to the list of cutting probes
-                    cuttingProbes.push_back(this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                    cuttingProbes.push_back(cell[cnt]);
                 }
             }
         }
@@ -1093,9 +1089,9 @@ void ReducedSurface::WriteProbesCutEdge(RSEdge* edge) {
     // maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
     // maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
     // maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-    maxXId = (unsigned int)this->voxelMapProbes.size() - 1;
-    maxYId = (unsigned int)this->voxelMapProbes[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMapProbes[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     vislib::math::Vector<float, 3> v1, v2, center, probe, dir21;
@@ -1121,8 +1117,9 @@ void ReducedSurface::WriteProbesCutEdge(RSEdge* edge) {
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
-                    probe = this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetProbeCenter();
+                auto const& cell = this->voxelMapProbes[this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ)];
+                for (cnt = 0; cnt < cell.size(); ++cnt) {
+                    probe = cell[cnt]->GetProbeCenter();
                     // distances between probe and edges
                     dist1 = (probe - v1).Length();
                     dist2 = (probe - v2).Length();
@@ -1135,7 +1132,7 @@ void ReducedSurface::WriteProbesCutEdge(RSEdge* edge) {
                     if ((dir21 * lenH + v2 - probe).Length() > this->probeRadius)
                         continue;
                     // add probe to the list of cutting probes
-                    edge->cuttingProbes.push_back(this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                    edge->cuttingProbes.push_back(cell[cnt]);
                 }
             }
         }
@@ -1151,9 +1148,9 @@ void ReducedSurface::ComputeProbeCutVertex(RSVertex* vertex) {
     // maxXId = (unsigned int)floorf( this->bBox.Width() / this->voxelLength);
     // maxYId = (unsigned int)floorf( this->bBox.Height() / this->voxelLength);
     // maxZId = (unsigned int)floorf( this->bBox.Depth() / this->voxelLength);
-    maxXId = (unsigned int)this->voxelMap.size() - 1;
-    maxYId = (unsigned int)this->voxelMap[0].size() - 1;
-    maxZId = (unsigned int)this->voxelMap[0][0].size() - 1;
+    maxXId = this->voxelMapSize[0] - 1;
+    maxYId = this->voxelMapSize[1] - 1;
+    maxZId = this->voxelMapSize[2] - 1;
     int cntX, cntY, cntZ;
 
     vislib::math::Vector<float, 3> v1, probe;
@@ -1171,15 +1168,16 @@ void ReducedSurface::ComputeProbeCutVertex(RSVertex* vertex) {
     for (cntX = ((xId > 0) ? (-1) : 0); cntX < ((xId < maxXId) ? 2 : 1); ++cntX) {
         for (cntY = ((yId > 0) ? (-1) : 0); cntY < ((yId < maxYId) ? 2 : 1); ++cntY) {
             for (cntZ = ((zId > 0) ? (-1) : 0); cntZ < ((zId < maxZId) ? 2 : 1); ++cntZ) {
-                for (cnt = 0; cnt < this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ].size(); ++cnt) {
+                auto const& cell = this->voxelMapProbes[this->VoxelCell(xId + cntX, yId + cntY, zId + cntZ)];
+                for (cnt = 0; cnt < cell.size(); ++cnt) {
                     // store probe center
-                    probe = this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]->GetProbeCenter();
+                    probe = cell[cnt]->GetProbeCenter();
                     // compute distance between probe and vertex
                     dist = (probe - v1).Length();
                     // if the distance is smaller than the two radii, the probe is cut
                     if (dist < (vertex->GetRadius() + probeRadius - epsilon)) {
                         // add RS-face to the list of cut faces
-                        cutFaces.push_back(this->voxelMapProbes[xId + cntX][yId + cntY][zId + cntZ][cnt]);
+                        cutFaces.push_back(cell[cnt]);
                     }
                 }
             }
@@ -1230,7 +1228,7 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
     // update changed parts
     ///////////////////////////////////////////////////////////////////
 
-    if (this->numberOfAtoms < 0)
+    if (this->numberOfAtoms == 0 || this->rsVertex.size() != this->numberOfAtoms)
         return false;
 
     if (this->rsEdge.size() > (this->rsVertex.size() + this->rsVertex.size() + 1000)) {
@@ -1241,7 +1239,6 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
     unsigned int cnt1, cnt2, cnt3;
     // boolean variables: store exceedance of thresholds
     bool lowerThresholdExceeded = false;
-    bool upperThresholdExceeded = false;
     // set of pointers to RS-vertices whose atom positions differ more than 'lowerThreshold'
     std::set<RSVertex*> changedRSVertices;
     // set of pointers to RS-edges which has to be removed
@@ -1255,7 +1252,9 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
     unsigned int yIdx = 0;
     unsigned int zIdx = 0;
     // indices of voxel map entries
-    unsigned int oldVoxelMapIdxX, oldVoxelMapIdxY, oldVoxelMapIdxZ, newVoxelMapIdxX, newVoxelMapIdxY, newVoxelMapIdxZ;
+    size_t oldVoxelMapCell, newVoxelMapCell;
+    // flag whether an RS-vertex moved to another voxel map cell
+    bool voxelMapChanged = false;
     // difference between the current and the subsequent atom position
     float difference;
     // temporary vector for RS-edges
@@ -1267,6 +1266,18 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
         return false;
     }
 
+    // recompute everything if any atom moved further than the upper threshold, the local update would touch most of
+    // the reduced surface anyway
+    for (cnt1 = firstAtomIdx; cnt1 < (firstAtomIdx + numberOfAtoms); ++cnt1) {
+        tmpVec1.Set(this->molecule->AtomPositions()[cnt1 * 3 + 0], this->molecule->AtomPositions()[cnt1 * 3 + 1],
+            this->molecule->AtomPositions()[cnt1 * 3 + 2]);
+        if ((this->rsVertex[cnt1 - firstAtomIdx]->GetPosition() - tmpVec1).Length() > upperThreshold) {
+            this->ReadAtoms();
+            this->ComputeReducedSurface();
+            return true;
+        }
+    }
+
     // check each atom position and update if necessary
     for (cnt1 = firstAtomIdx; cnt1 < (firstAtomIdx + numberOfAtoms); ++cnt1) {
         cnt3 = cnt1 - firstAtomIdx;
@@ -1277,62 +1288,16 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
         // compute the difference
         difference = (this->rsVertex[cnt3]->GetPosition() - tmpVec1).Length();
 
-        // check, if difference exceeds the upper threshold
-        if (difference > upperThreshold) {
-            // std::cout << "INFO: upper threshold exceeded --> recompute everything new!" << std::endl;
-            upperThresholdExceeded = true;
-            /*
-            // recompute the reduced surface
-            this->ComputeReducedSurface( molecule);
-
-            // recompute geometry
-            if( this->currentRendermode == GPU_RAYCASTING )
-                    this->ComputeRaycastingArrays();
-            else if( this->currentRendermode == POLYGONAL_GPU )
-                    this->ComputePolygonalArraysGPU( 0.5f);
-            else if( this->currentRendermode == POLYGONAL )
-                    this->ComputePolygonalArrays( 0.5f, 1.0f);
-
-            // exit update function
-            return true;
-            */
-        }
-
         // check, if difference exceeds the lower threshold
         if (difference > lowerThreshold) {
             // the lower threshold is exceeded
             lowerThresholdExceeded = true;
-            // compute old voxel map index
-            oldVoxelMapIdxX = (unsigned int)std::max(
-                0, (int)floorf((this->rsVertex[cnt3]->GetPosition().GetX() - bBox.Left()) / voxelLength));
-            oldVoxelMapIdxX = std::min(oldVoxelMapIdxX, (unsigned int)this->voxelMap.size() - 1);
-            oldVoxelMapIdxY = (unsigned int)std::max(
-                0, (int)floorf((this->rsVertex[cnt3]->GetPosition().GetY() - bBox.Bottom()) / voxelLength));
-            oldVoxelMapIdxY = std::min(oldVoxelMapIdxY, (unsigned int)this->voxelMap[oldVoxelMapIdxX].size() - 1);
-            oldVoxelMapIdxZ = (unsigned int)std::max(
-                0, (int)floorf((this->rsVertex[cnt3]->GetPosition().GetZ() - bBox.Back()) / voxelLength));
-            oldVoxelMapIdxZ =
-                std::min(oldVoxelMapIdxZ, (unsigned int)this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY].size() - 1);
-            // compute new voxel map index --> make sure the index is within bounds
-            newVoxelMapIdxX =
-                (unsigned int)std::max(0, (int)floorf((tmpVec1.GetX() - bBox.Left()) / this->voxelLength));
-            newVoxelMapIdxX = std::min(newVoxelMapIdxX, (unsigned int)this->voxelMap.size() - 1);
-            newVoxelMapIdxY =
-                (unsigned int)std::max(0, (int)floorf((tmpVec1.GetY() - bBox.Bottom()) / this->voxelLength));
-            newVoxelMapIdxY = std::min(newVoxelMapIdxY, (unsigned int)this->voxelMap[newVoxelMapIdxX].size() - 1);
-            newVoxelMapIdxZ =
-                (unsigned int)std::max(0, (int)floorf((tmpVec1.GetZ() - bBox.Back()) / this->voxelLength));
-            newVoxelMapIdxZ =
-                std::min(newVoxelMapIdxZ, (unsigned int)this->voxelMap[newVoxelMapIdxX][newVoxelMapIdxY].size() - 1);
-            // if the new atom position lies in another voxel --> remove old and add new position
-            if ((oldVoxelMapIdxX != newVoxelMapIdxX) || (oldVoxelMapIdxY != newVoxelMapIdxY) ||
-                (oldVoxelMapIdxZ != newVoxelMapIdxZ)) {
-                // add the rsVertex-pointer to the new voxel
-                this->voxelMap[newVoxelMapIdxX][newVoxelMapIdxY][newVoxelMapIdxZ].push_back(this->rsVertex[cnt3]);
-                // remove the rsVertex-pointer from the old voxel
-                this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].erase(
-                    std::find(this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].begin(),
-                        this->voxelMap[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].end(), this->rsVertex[cnt3]));
+            // compute old and new voxel map cell
+            oldVoxelMapCell = this->VoxelCellAt(this->rsVertex[cnt3]->GetPosition());
+            newVoxelMapCell = this->VoxelCellAt(tmpVec1);
+            // if the new atom position lies in another voxel --> the voxel map is rebuilt below
+            if (oldVoxelMapCell != newVoxelMapCell) {
+                voxelMapChanged = true;
             }
             // set new atom position
             this->rsVertex[cnt3]->SetPosition(tmpVec1);
@@ -1360,6 +1325,9 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
             zIdx = cnt3;
         }
     }
+    if (voxelMapChanged) {
+        this->BuildVoxelMap();
+    }
 
     // std::cout << "INFO: found all changed RS-vertices (" << changedRSVertices.size() << ")" << std::endl;
     if (changedRSVertices.empty()) {
@@ -1404,19 +1372,14 @@ bool ReducedSurface::UpdateData(const float lowerThreshold, const float upperThr
     for (itFace = changedRSFaces.begin(); itFace != changedRSFaces.end(); ++itFace) {
         face = *itFace;
         // remove RS-face from probe voxel map
-        oldVoxelMapIdxX = face->GetProbeIndex().GetX();
-        oldVoxelMapIdxY = face->GetProbeIndex().GetY();
-        oldVoxelMapIdxZ = face->GetProbeIndex().GetZ();
+        oldVoxelMapCell = this->VoxelCell(face->GetProbeIndex());
         // find and remove old probe position
-        itProbe = std::find(this->voxelMapProbes[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].begin(),
-            this->voxelMapProbes[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].end(), face);
-        if (itProbe != this->voxelMapProbes[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].end()) {
-            this->voxelMapProbes[oldVoxelMapIdxX][oldVoxelMapIdxY][oldVoxelMapIdxZ].erase(itProbe);
-            ////std::cout << "SUCCESS: probe found in voxel map! ["<< oldVoxelMapIdxX << "][" << oldVoxelMapIdxY << "]["
-            ///<< oldVoxelMapIdxZ << "]" << std::endl;
+        itProbe = std::find(
+            this->voxelMapProbes[oldVoxelMapCell].begin(), this->voxelMapProbes[oldVoxelMapCell].end(), face);
+        if (itProbe != this->voxelMapProbes[oldVoxelMapCell].end()) {
+            this->voxelMapProbes[oldVoxelMapCell].erase(itProbe);
         } else {
-            std::cout << "ERROR: probe not found in voxel map! [" << oldVoxelMapIdxX << "][" << oldVoxelMapIdxY << "]["
-                      << oldVoxelMapIdxZ << "]" << std::endl;
+            std::cout << "ERROR: probe not found in voxel map! [" << oldVoxelMapCell << "]" << std::endl;
         }
 
         // remove RS-face from all RS-edges which belong to one of its three RS-vertices
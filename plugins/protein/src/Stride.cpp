@@ -1,7 +1,11 @@
 #include "Stride.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 
 using namespace megamol::protein;
@@ -247,6 +251,13 @@ bool Stride::ComputeSecondaryStructure() {
 }
 
 bool Stride::WriteToInterface(MolecularDataCall* mol) {
+    if (!this->GetResult(mol, this->result))
+        return false;
+    WriteToInterface(this->result, mol);
+    return true;
+}
+
+bool Stride::GetResult(MolecularDataCall* mol, Result& res) {
     if (mol) {
         int Cn, i;
         char type;
@@ -254,7 +265,10 @@ bool Stride::WriteToInterface(MolecularDataCall* mol) {
         int resCnt;
         int idx = 0;
 
-        std::vector<MolecularDataCall::SecStructure> sec;
+        std::vector<MolecularDataCall::SecStructure>& sec = res.secStructs;
+        sec.clear();
+        res.moleculeSecStructs.clear();
+        res.hydrogenBonds.clear();
 
         if (!ExistsSecStr(ProteinChain, ProteinChainCnt))
             return false;
@@ -300,17 +314,13 @@ bool Stride::WriteToInterface(MolecularDataCall* mol) {
                 sec.back().SetType(MolecularDataCall::SecStructure::TYPE_SHEET);
             else
                 sec.back().SetType(MolecularDataCall::SecStructure::TYPE_COIL);
-            mol->SetMoleculeSecondaryStructure(Cn, idx, (unsigned int)sec.size() - idx);
+            res.moleculeSecStructs.push_back({static_cast<unsigned int>(Cn), static_cast<unsigned int>(idx),
+                static_cast<unsigned int>(sec.size() - idx)});
             idx = (int)sec.size();
         }
-        // handled all residues of current chain, copy sec struct to interface
-        mol->SetSecondaryStructureCount((unsigned int)sec.size());
-        for (i = 0; i < (int)sec.size(); ++i) {
-            mol->SetSecondaryStructure(i, sec[i]);
-        }
 
-        // set the found hydrogen bonds
-        mol->SetHydrogenBonds(this->ownHydroBonds.data(), static_cast<unsigned int>(HydroBondCnt));
+        // copy the found hydrogen bonds
+        res.hydrogenBonds = this->ownHydroBonds;
 
     } else {
         return false;
@@ -318,6 +328,20 @@ bool Stride::WriteToInterface(MolecularDataCall* mol) {
     return true;
 }
 
+void Stride::WriteToInterface(const Result& res, MolecularDataCall* mol) {
+    for (auto const& molSec : res.moleculeSecStructs) {
+        mol->SetMoleculeSecondaryStructure(molSec[0], molSec[1], molSec[2]);
+    }
+    // copy sec struct to interface
+    mol->SetSecondaryStructureCount(static_cast<unsigned int>(res.secStructs.size()));
+    for (unsigned int i = 0; i < static_cast<unsigned int>(res.secStructs.size()); ++i) {
+        mol->SetSecondaryStructure(i, res.secStructs[i]);
+    }
+
+    // set the found hydrogen bonds
+    mol->SetHydrogenBonds(res.hydrogenBonds.data(), static_cast<unsigned int>(res.hydrogenBonds.size() / 2));
+}
+
 void Stride::DefaultCmd(COMMAND* Cmd) {
 
     Cmd->SideChainHBond = STRIDE_NO;
@@ -678,158 +702,125 @@ int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND*
     for (i = 0; i < NAcc; i++)
         BondedAcceptor[i] = STRIDE_NO;
 
-    for (dc = 0; dc < NDnr; dc++) {
+    // sort the acceptors into a grid whose cells are at least as large as the distance cut-off, so each donor only
+    // has to be tested against the acceptors in the 27 cells around it
+    float GridMin[3] = {0.0f, 0.0f, 0.0f}, GridMax[3] = {0.0f, 0.0f, 0.0f};
+    for (ac = 0; ac < NAcc; ac++) {
+        float* A = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+        for (i = 0; i < 3; i++) {
+            GridMin[i] = (ac == 0) ? A[i] : std::min(GridMin[i], A[i]);
+            GridMax[i] = (ac == 0) ? A[i] : std::max(GridMax[i], A[i]);
+        }
+    }
+    float CellSize = 1.01f * Cmd->DistCutOff + Eps;
+    for (i = 0; i < 3; i++)
+        CellSize = std::max(CellSize, (GridMax[i] - GridMin[i]) / 128.0f);
+    int GridDim[3];
+    for (i = 0; i < 3; i++)
+        GridDim[i] = static_cast<int>((GridMax[i] - GridMin[i]) / CellSize) + 1;
+    auto GridCoord = [&](float* Coord, int Axis) {
+        return std::min(GridDim[Axis], std::max(-1, static_cast<int>(floor((Coord[Axis] - GridMin[Axis]) / CellSize))));
+    };
+    auto GridCell = [&](float* Coord) {
+        return GridCoord(Coord, 0) + GridDim[0] * (GridCoord(Coord, 1) + GridDim[1] * GridCoord(Coord, 2));
+    };
+    std::vector<int> CellStart(GridDim[0] * GridDim[1] * GridDim[2] + 1, 0);
+    std::vector<int> CellAcc(NAcc);
+    for (ac = 0; ac < NAcc; ac++) {
+        float* A = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+        CellStart[GridCell(A) + 1]++;
+    }
+    for (i = 0; i < GridDim[0] * GridDim[1] * GridDim[2]; i++)
+        CellStart[i + 1] += CellStart[i];
+    {
+        std::vector<int> CellFill(CellStart.begin(), CellStart.end() - 1);
+        for (ac = 0; ac < NAcc; ac++) {
+            float* A = Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At];
+            CellAcc[CellFill[GridCell(A)]++] = ac;
+        }
+    }
 
-        if (Dnr[dc]->Group != Peptide && !Cmd->SideChainHBond)
+    // evaluate the donor/acceptor pairs in parallel; the bonds of each donor are kept in the order of the acceptors,
+    // so the bonds are numbered exactly as if all pairs were tested serially
+    std::vector<std::vector<std::pair<int, HBOND>>> Found(NDnr);
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int64_t d = 0; d < NDnr; d++) {
+        if (Dnr[d]->Group != Peptide && !Cmd->SideChainHBond)
             continue;
 
-        for (ac = 0; ac < NAcc; ac++) {
+        float* D = Dnr[d]->Chain->Rsd[Dnr[d]->D_Res]->Coord[Dnr[d]->D_At];
+        const int CX = GridCoord(D, 0), CY = GridCoord(D, 1), CZ = GridCoord(D, 2);
+        std::vector<int> Candidates;
+        for (int z = std::max(0, CZ - 1); z <= std::min(GridDim[2] - 1, CZ + 1); z++) {
+            for (int y = std::max(0, CY - 1); y <= std::min(GridDim[1] - 1, CY + 1); y++) {
+                for (int x = std::max(0, CX - 1); x <= std::min(GridDim[0] - 1, CX + 1); x++) {
+                    const int Cell = x + GridDim[0] * (y + GridDim[1] * z);
+                    Candidates.insert(
+                        Candidates.end(), CellAcc.begin() + CellStart[Cell], CellAcc.begin() + CellStart[Cell + 1]);
+                }
+            }
+        }
+        std::sort(Candidates.begin(), Candidates.end());
 
-            if (abs(Acc[ac]->A_Res - Dnr[dc]->D_Res) < 2 && Acc[ac]->Chain->Id == Dnr[dc]->Chain->Id)
+        for (int a : Candidates) {
+            if (abs(Acc[a]->A_Res - Dnr[d]->D_Res) < 2 && Acc[a]->Chain->Id == Dnr[d]->Chain->Id)
                 continue;
 
-            if (Acc[ac]->Group != Peptide && !Cmd->SideChainHBond)
+            if (Acc[a]->Group != Peptide && !Cmd->SideChainHBond)
                 continue;
 
+            HBOND Bond;
+            if (EvaluateHBond(Dnr[d], Acc[a], Cmd, &Bond)) {
+                Bond.Dnr = Dnr[d];
+                Bond.Acc = Acc[a];
+                Found[d].emplace_back(a, Bond);
+            }
+        }
+    }
+
+    for (dc = 0; dc < NDnr; dc++) {
+        for (auto const& Bond : Found[dc]) {
+            ac = Bond.first;
+
             if (hc == MAXHYDRBOND)
                 die("Number of hydrogen bonds exceeds current limit of %d in %s\n", MAXHYDRBOND, Chain[0]->File);
             HBond[hc] = (HBOND*)ckalloc(sizeof(HBOND));
-
-            HBond[hc]->ExistHydrBondRose = STRIDE_NO;
-            HBond[hc]->ExistHydrBondBaker = STRIDE_NO;
-            HBond[hc]->ExistPolarInter = STRIDE_NO;
-
-            if ((HBond[hc]->AccDonDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                     Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= Cmd->DistCutOff) {
-
-
-                if (Cmd->MainChainPolarInt && Dnr[dc]->Group == Peptide && Acc[ac]->Group == Peptide &&
-                    Dnr[dc]->H != ERR) {
-                    GRID_Energy(Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At], Cmd, HBond[hc]);
-
-                    if (HBond[hc]->Energy < -10.0 &&
-                        ((Cmd->EnergyType == 'G' && fabs(HBond[hc]->Et) > Eps && fabs(HBond[hc]->Ep) > Eps) ||
-                            Cmd->EnergyType != 'G'))
-                        HBond[hc]->ExistPolarInter = STRIDE_YES;
-                }
-
-                if (Cmd->MainChainHBond &&
-                    (HBond[hc]->OHDist = Dist(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) <= 2.5 &&
-                    (HBond[hc]->AngNHO = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At])) >= 90.0 &&
-                    HBond[hc]->AngNHO <= 180.0 &&
-                    (HBond[hc]->AngCOH = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                         Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                         Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->H])) >= 90.0 &&
-
-                    HBond[hc]->AngCOH <= 180.0)
-                    HBond[hc]->ExistHydrBondBaker = STRIDE_YES;
-
-                if (Cmd->MainChainHBond && HBond[hc]->AccDonDist <= Dnr[dc]->HB_Radius + Acc[ac]->HB_Radius) {
-
-                    HBond[hc]->AccAng = Ang(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At]);
-
-                    if (((Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP2 && HBond[hc]->AccAng <= MAXACCANG_SP2)) ||
-                        ((Acc[ac]->Hybrid == Ssp3 || Acc[ac]->Hybrid == Osp3) &&
-                            (HBond[hc]->AccAng >= MINACCANG_SP3 && HBond[hc]->AccAng <= MAXACCANG_SP3))) {
-
-                        HBond[hc]->DonAng = Ang(Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                            Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At]);
-
-                        if (((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP2 && HBond[hc]->DonAng <= MAXDONANG_SP2)) ||
-                            ((Dnr[dc]->Hybrid == Nsp3 || Dnr[dc]->Hybrid == Osp3) &&
-                                (HBond[hc]->DonAng >= MINDONANG_SP3 && HBond[hc]->DonAng <= MAXDONANG_SP3))) {
-
-                            if (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) {
-                                HBond[hc]->AccDonAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->DDI_Res]->Coord[Dnr[dc]->DDI_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Dnr[dc]->Chain->Rsd[Dnr[dc]->DD_Res]->Coord[Dnr[dc]->DD_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At]));
-
-                                if (HBond[hc]->AccDonAng > 90.0f && HBond[hc]->AccDonAng < 270.0f)
-                                    HBond[hc]->AccDonAng = fabs(180.0f - HBond[hc]->AccDonAng);
-                            }
-
-                            if (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) {
-                                HBond[hc]->DonAccAng =
-                                    fabs(Torsion(Dnr[dc]->Chain->Rsd[Dnr[dc]->D_Res]->Coord[Dnr[dc]->D_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->A_Res]->Coord[Acc[ac]->A_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA_Res]->Coord[Acc[ac]->AA_At],
-                                        Acc[ac]->Chain->Rsd[Acc[ac]->AA2_Res]->Coord[Acc[ac]->AA2_At]));
-
-                                if (HBond[hc]->DonAccAng > 90.0f && HBond[hc]->DonAccAng < 270.0f)
-                                    HBond[hc]->DonAccAng = fabs(180.0f - HBond[hc]->DonAccAng);
-                            }
-
-                            if ((Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 && Acc[ac]->Hybrid != Nsp2 &&
-                                    Acc[ac]->Hybrid != Osp2) ||
-                                (Acc[ac]->Hybrid != Nsp2 && Acc[ac]->Hybrid != Osp2 &&
-                                    (Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG) ||
-                                (Dnr[dc]->Hybrid != Nsp2 && Dnr[dc]->Hybrid != Osp2 &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->DonAccAng <= DONACCANG) ||
-                                ((Dnr[dc]->Hybrid == Nsp2 || Dnr[dc]->Hybrid == Osp2) &&
-                                    (Acc[ac]->Hybrid == Nsp2 || Acc[ac]->Hybrid == Osp2) &&
-                                    HBond[hc]->AccDonAng <= ACCDONANG && HBond[hc]->DonAccAng <= DONACCANG))
-                                HBond[hc]->ExistHydrBondRose = STRIDE_YES;
-                        }
-                    }
-                }
+            *HBond[hc] = Bond.second;
+
+            BondedDonor[dc] = STRIDE_YES;
+            BondedAcceptor[ac] = STRIDE_YES;
+            if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
+                if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
+                    Chain[ccd]
+                        ->Rsd[Dnr[dc]->D_Res]
+                        ->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
+                        Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
             }
-
-            if ((HBond[hc]->ExistPolarInter && HBond[hc]->Energy < 0.0) || HBond[hc]->ExistHydrBondRose ||
-                HBond[hc]->ExistHydrBondBaker) {
-                HBond[hc]->Dnr = Dnr[dc];
-                HBond[hc]->Acc = Acc[ac];
-                BondedDonor[dc] = STRIDE_YES;
-                BondedAcceptor[ac] = STRIDE_YES;
-                if ((ccd = FindChain(Chain, NChain, Dnr[dc]->Chain->Id)) != ERR) {
-                    if (Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr < MAXRESDNR)
-                        Chain[ccd]
-                            ->Rsd[Dnr[dc]->D_Res]
-                            ->Inv->HBondDnr[Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[ccd]->Rsd[Dnr[dc]->D_Res]->ResType, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->PDB_ResNumb,
-                            Chain[ccd]->ChainId, MAXRESDNR, Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->NBondDnr);
-                }
-                if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
-                    if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
-                        Chain[cca]
-                            ->Rsd[Acc[ac]->A_Res]
-                            ->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
-                    else
-                        printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
-                            Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
-                            Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
-                }
-                if (ccd != cca && ccd != ERR) {
-                    Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
-                    if (HBond[hc]->ExistHydrBondRose) {
-                        Chain[0]->NHydrBondInterchain++;
-                        Chain[0]->NHydrBondTotal++;
-                    }
-                } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
-                    Chain[ccd]->NHydrBond++;
+            if ((cca = FindChain(Chain, NChain, Acc[ac]->Chain->Id)) != ERR) {
+                if (Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc < MAXRESACC)
+                    Chain[cca]
+                        ->Rsd[Acc[ac]->A_Res]
+                        ->Inv->HBondAcc[Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc++] = hc;
+                else
+                    printf("Residue %s %s of chain %i is involved in more than %d hydrogen bonds (%d)\n",
+                        Chain[cca]->Rsd[Acc[ac]->A_Res]->ResType, Chain[cca]->Rsd[Acc[ac]->A_Res]->PDB_ResNumb,
+                        Chain[cca]->ChainId, MAXRESDNR, Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->NBondAcc);
+            }
+            if (ccd != cca && ccd != ERR) {
+                Chain[ccd]->Rsd[Dnr[dc]->D_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                Chain[cca]->Rsd[Acc[ac]->A_Res]->Inv->InterchainHBonds = STRIDE_YES;
+                if (HBond[hc]->ExistHydrBondRose) {
+                    Chain[0]->NHydrBondInterchain++;
                     Chain[0]->NHydrBondTotal++;
                 }
-                hc++;
-            } else
-                free(HBond[hc]);
+            } else if (ccd == cca && ccd != ERR && HBond[hc]->ExistHydrBondRose) {
+                Chain[ccd]->NHydrBond++;
+                Chain[0]->NHydrBondTotal++;
+            }
+            hc++;
         }
     }
 
@@ -851,6 +842,87 @@ int Stride::FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND*
     return (hc);
 }
 
+Stride::BOOLEAN Stride::EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond) {
+    HBond->ExistHydrBondRose = STRIDE_NO;
+    HBond->ExistHydrBondBaker = STRIDE_NO;
+    HBond->ExistPolarInter = STRIDE_NO;
+
+    if ((HBond->AccDonDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) > Cmd->DistCutOff)
+        return (STRIDE_NO);
+
+    if (Cmd->MainChainPolarInt && Dnr->Group == Peptide && Acc->Group == Peptide && Dnr->H != ERR) {
+        GRID_Energy(Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At], Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+            Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Cmd, HBond);
+
+        if (HBond->Energy < -10.0 &&
+            ((Cmd->EnergyType == 'G' && fabs(HBond->Et) > Eps && fabs(HBond->Ep) > Eps) || Cmd->EnergyType != 'G'))
+            HBond->ExistPolarInter = STRIDE_YES;
+    }
+
+    if (Cmd->MainChainHBond &&
+        (HBond->OHDist = Dist(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) <= 2.5 &&
+        (HBond->AngNHO = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At])) >= 90.0 &&
+        HBond->AngNHO <= 180.0 &&
+        (HBond->AngCOH = Ang(Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+             Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->H])) >= 90.0 &&
+        HBond->AngCOH <= 180.0)
+        HBond->ExistHydrBondBaker = STRIDE_YES;
+
+    if (Cmd->MainChainHBond && HBond->AccDonDist <= Dnr->HB_Radius + Acc->HB_Radius) {
+
+        HBond->AccAng = Ang(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+            Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At]);
+
+        if (((Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                (HBond->AccAng >= MINACCANG_SP2 && HBond->AccAng <= MAXACCANG_SP2)) ||
+            ((Acc->Hybrid == Ssp3 || Acc->Hybrid == Osp3) &&
+                (HBond->AccAng >= MINACCANG_SP3 && HBond->AccAng <= MAXACCANG_SP3))) {
+
+            HBond->DonAng = Ang(Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At],
+                Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At]);
+
+            if (((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                    (HBond->DonAng >= MINDONANG_SP2 && HBond->DonAng <= MAXDONANG_SP2)) ||
+                ((Dnr->Hybrid == Nsp3 || Dnr->Hybrid == Osp3) &&
+                    (HBond->DonAng >= MINDONANG_SP3 && HBond->DonAng <= MAXDONANG_SP3))) {
+
+                if (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) {
+                    HBond->AccDonAng = fabs(Torsion(Dnr->Chain->Rsd[Dnr->DDI_Res]->Coord[Dnr->DDI_At],
+                        Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At], Dnr->Chain->Rsd[Dnr->DD_Res]->Coord[Dnr->DD_At],
+                        Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At]));
+
+                    if (HBond->AccDonAng > 90.0f && HBond->AccDonAng < 270.0f)
+                        HBond->AccDonAng = fabs(180.0f - HBond->AccDonAng);
+                }
+
+                if (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) {
+                    HBond->DonAccAng = fabs(Torsion(Dnr->Chain->Rsd[Dnr->D_Res]->Coord[Dnr->D_At],
+                        Acc->Chain->Rsd[Acc->A_Res]->Coord[Acc->A_At], Acc->Chain->Rsd[Acc->AA_Res]->Coord[Acc->AA_At],
+                        Acc->Chain->Rsd[Acc->AA2_Res]->Coord[Acc->AA2_At]));
+
+                    if (HBond->DonAccAng > 90.0f && HBond->DonAccAng < 270.0f)
+                        HBond->DonAccAng = fabs(180.0f - HBond->DonAccAng);
+                }
+
+                if ((Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 && Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2) ||
+                    (Acc->Hybrid != Nsp2 && Acc->Hybrid != Osp2 && (Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) &&
+                        HBond->AccDonAng <= ACCDONANG) ||
+                    (Dnr->Hybrid != Nsp2 && Dnr->Hybrid != Osp2 && (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                        HBond->DonAccAng <= DONACCANG) ||
+                    ((Dnr->Hybrid == Nsp2 || Dnr->Hybrid == Osp2) && (Acc->Hybrid == Nsp2 || Acc->Hybrid == Osp2) &&
+                        HBond->AccDonAng <= ACCDONANG && HBond->DonAccAng <= DONACCANG))
+                    HBond->ExistHydrBondRose = STRIDE_YES;
+            }
+        }
+    }
+
+    return ((HBond->ExistPolarInter && HBond->Energy < 0.0) || HBond->ExistHydrBondRose || HBond->ExistHydrBondBaker);
+}
+
 int Stride::NoDoubleHBond(HBOND** HBond, int NHBond) {
 
     int i, j, NExcl = 0;
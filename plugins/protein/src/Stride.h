@@ -15,6 +15,7 @@
 #include "protein_calls/MolecularDataCall.h"
 #include "vislib/String.h"
 #include "vislib/math/Vector.h"
+#include <array>
 #include <cstdio>
 #include <ctype.h>
 #include <math.h>
@@ -277,11 +278,40 @@ public:
         BUFFER Type;
     } PATTERN;
 
+    /** The secondary structure and hydrogen bonds found by STRIDE, which can outlive the Stride object */
+    struct Result {
+        /** The secondary structure elements of all molecules */
+        std::vector<megamol::protein_calls::MolecularDataCall::SecStructure> secStructs;
+        /** The molecule index, the first element and the element count in 'secStructs' of all valid molecules */
+        std::vector<std::array<unsigned int, 3>> moleculeSecStructs;
+        /** The donor and acceptor atom indices of the hydrogen bonds */
+        std::vector<unsigned int> hydrogenBonds;
+    };
+
     Stride(megamol::protein_calls::MolecularDataCall* mol);
     virtual ~Stride(void);
 
     bool WriteToInterface(megamol::protein_calls::MolecularDataCall* mol);
 
+    /**
+     * Copies the secondary structure and the hydrogen bonds into 'res'.
+     *
+     * @param mol The call the secondary structure was computed for
+     * @param res Receives the result
+     *
+     * @return 'false' if no secondary structure was found, 'true' otherwise
+     */
+    bool GetResult(megamol::protein_calls::MolecularDataCall* mol, Result& res);
+
+    /**
+     * Writes a result to the call. The call references the hydrogen bonds of 'res', so 'res' must stay alive as long
+     * as the call is used.
+     *
+     * @param res The result
+     * @param mol The call
+     */
+    static void WriteToInterface(const Result& res, megamol::protein_calls::MolecularDataCall* mol);
+
 protected:
     typedef struct // OWNBOND
     {
@@ -305,6 +335,7 @@ protected:
     float** DefaultSheetMap(COMMAND* Cmd);
     int PlaceHydrogens(CHAIN* Chain);
     int FindHydrogenBonds(CHAIN** Chain, int NChain, HBOND** HBond, COMMAND* Cmd);
+    BOOLEAN EvaluateHBond(DONOR* Dnr, ACCEPTOR* Acc, COMMAND* Cmd, HBOND* HBond);
     int NoDoubleHBond(HBOND** HBond, int NHBond);
     void DiscrPhiPsi(CHAIN** Chain, int NChain, COMMAND* Cmd);
     void Helix(CHAIN** Chain, int Cn, HBOND** HBond, COMMAND* Cmd, float** PhiPsiMap);
@@ -385,6 +416,8 @@ private:
     HBOND** HydroBond;
     int HydroBondCnt;
     std::vector<unsigned int> ownHydroBonds;
+    // the result written by WriteToInterface
+    Result result;
 
     // was the computation successful?
     bool Successful;
@@ -22,10 +22,15 @@
 #include "vislib/sys/File.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <ctime>
 #include <ctype.h>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <zlib.h>
 
 using namespace megamol;
 using namespace megamol::core;
@@ -37,6 +42,75 @@ using namespace megamol::core::utility::log;
 #pragma push_macro("max")
 #undef max
 
+namespace {
+
+/** Size of the chunks in which the XML part of a file is read */
+constexpr vislib::sys::File::FileSize XMLChunkSize = 1 << 16;
+
+/**
+ * Reads the XML part of a VTK file. If the file has appended data, reading
+ * stops after the start tag of the 'AppendedData' element, so the data itself
+ * can later be read directly into the data arrays.
+ *
+ * @param file   The opened file
+ * @param buffer Receives the XML part, terminated by a zero byte
+ *
+ * @return The file offset of the appended data or 0 if there is none
+ */
+vislib::sys::File::FileSize readXMLPart(vislib::sys::File& file, std::vector<char>& buffer) {
+    static const std::string_view tag("<AppendedData");
+    buffer.clear();
+    size_t searchPos = 0;
+    size_t tagPos = std::string_view::npos;
+    for (;;) {
+        const size_t oldSize = buffer.size();
+        buffer.resize(oldSize + XMLChunkSize);
+        const auto cnt = static_cast<size_t>(file.Read(buffer.data() + oldSize, XMLChunkSize));
+        buffer.resize(oldSize + cnt);
+
+        const std::string_view xml(buffer.data(), buffer.size());
+        if (tagPos == std::string_view::npos) {
+            tagPos = xml.find(tag, searchPos);
+            searchPos = (xml.size() > tag.size()) ? xml.size() - tag.size() : 0;
+        }
+        if (tagPos != std::string_view::npos) {
+            // The data starts after the '_' following the start tag
+            const size_t tagEnd = xml.find('>', tagPos);
+            const size_t marker = (tagEnd != std::string_view::npos) ? xml.find('_', tagEnd) : tagEnd;
+            if (marker != std::string_view::npos) {
+                buffer.resize(tagEnd + 1);
+                buffer.push_back(0);
+                return marker + 1;
+            }
+        }
+        if (cnt == 0) {
+            buffer.push_back(0);
+            return 0;
+        }
+    }
+}
+
+/**
+ * Decodes an unsigned integer of the header of an appended data array.
+ *
+ * @param ptr       The encoded integer
+ * @param header64  'true' for UInt64, 'false' for UInt32
+ * @param bigEndian 'true' if the integer is stored in big endian order
+ *
+ * @return The integer
+ */
+uint64_t decodeHeaderInt(const unsigned char* ptr, bool header64, bool bigEndian) {
+    const int size = header64 ? 8 : 4;
+    uint64_t value = 0;
+    for (int i = 0; i < size; ++i) {
+        const int byteIdx = bigEndian ? i : (size - 1 - i);
+        value = (value << 8) | ptr[byteIdx];
+    }
+    return value;
+}
+
+} // namespace
+
 /*
  * VTILoader::VTILoader
  */
@@ -383,29 +457,33 @@ bool VTILoader::loadFile(const vislib::StringA& filename) {
         fileSize); // DEBUG
 #endif
 
-    // Read data file to char buffer
-    char* buffer = new char[(unsigned int)fileSize];
+    // Read the XML part of the data file to a char buffer
+    std::vector<char> buffer;
     if (!file.Open(this->filenameSlot.Param<core::param::FilePathParam>()->Value().native().c_str(),
-            vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_EXCLUSIVE, vislib::sys::File::OPEN_ONLY))
+            vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::OPEN_ONLY))
         return false;
-    file.Read(buffer, fileSize);
+    readXMLPart(file, buffer);
     file.Close();
 
     this->nPieces = 0;
 
     // Parse buffer
-    char *pt = buffer, *pt_end;
+    char *pt = buffer.data(), *pt_end;
+    char* const buffer_end = buffer.data() + buffer.size() - 1;
     vislib::StringA entity;
-    while (pt < buffer + fileSize - 2) {
+    while (pt < buffer_end - 2) {
 
         // Get next xml entity string
-        while (*pt != '<') {
+        while (pt < buffer_end && *pt != '<') {
             pt++;
         }
         pt_end = pt;
-        while (*pt_end != '>') {
+        while (pt_end < buffer_end && *pt_end != '>') {
             pt_end++;
         }
+        if (pt_end >= buffer_end) {
+            break;
+        }
         entity = vislib::StringA(pt + 1, (int)(pt_end - pt));
 
         // Parse and store relevant attributes
@@ -515,7 +593,6 @@ bool VTILoader::loadFile(const vislib::StringA& filename) {
         pt = pt_end + 1;
         entity.Clear();
     }
-    delete[] buffer;
 
 #ifdef VERBOSE
     Log::DefaultLog.WriteInfo("%s: ... done (%f s), found %u pieces", this->ClassName(),
@@ -578,6 +655,74 @@ void VTILoader::readDataBinary2Float(char* buffIn, float* buffOut, // TODO Other
 }
 
 
+/*
+ * VTILoader::readDataAppended
+ */
+bool VTILoader::readDataAppended(vislib::sys::File& file, vislib::sys::File::FileSize pos, bool header64,
+    bool compressed, bool bigEndian, char* buffOut, SIZE_T sizeOut) {
+
+    const vislib::sys::File::FileSize intSize = header64 ? 8 : 4;
+    unsigned char header[3 * 8];
+
+    if (file.Seek(static_cast<vislib::sys::File::FileOffset>(pos), vislib::sys::File::BEGIN) != pos) {
+        return false;
+    }
+
+    if (!compressed) {
+        // [number of bytes][data]
+        if (file.Read(header, intSize) != intSize) {
+            return false;
+        }
+        if (decodeHeaderInt(header, header64, bigEndian) != sizeOut) {
+            return false;
+        }
+        return file.Read(buffOut, sizeOut) == sizeOut;
+    }
+
+    // [number of blocks][block size][size of last block][compressed block sizes][compressed blocks]
+    if (file.Read(header, 3 * intSize) != 3 * intSize) {
+        return false;
+    }
+    const uint64_t blockCnt = decodeHeaderInt(header, header64, bigEndian);
+    const uint64_t blockSize = decodeHeaderInt(header + intSize, header64, bigEndian);
+    const uint64_t lastBlockSize = decodeHeaderInt(header + 2 * intSize, header64, bigEndian);
+    if (blockCnt == 0) {
+        return sizeOut == 0;
+    }
+    if ((blockSize == 0) ||
+        ((blockCnt - 1) * blockSize + ((lastBlockSize != 0) ? lastBlockSize : blockSize) != sizeOut)) {
+        return false;
+    }
+
+    std::vector<unsigned char> sizes(static_cast<size_t>(blockCnt * intSize));
+    if (file.Read(sizes.data(), sizes.size()) != sizes.size()) {
+        return false;
+    }
+    std::vector<uint64_t> blockOffsets(static_cast<size_t>(blockCnt + 1), 0);
+    for (size_t b = 0; b < blockCnt; ++b) {
+        blockOffsets[b + 1] = blockOffsets[b] + decodeHeaderInt(sizes.data() + b * intSize, header64, bigEndian);
+    }
+
+    // All blocks are read at once and inflated in parallel
+    std::vector<unsigned char> blocks(static_cast<size_t>(blockOffsets.back()));
+    if (file.Read(blocks.data(), blocks.size()) != blocks.size()) {
+        return false;
+    }
+    bool success = true;
+#pragma omp parallel for schedule(dynamic) reduction(&& : success)
+    for (int64_t b = 0; b < static_cast<int64_t>(blockCnt); ++b) {
+        const uint64_t outOffset = static_cast<uint64_t>(b) * blockSize;
+        const uLongf expected = static_cast<uLongf>(std::min<uint64_t>(blockSize, sizeOut - outOffset));
+        uLongf outSize = expected;
+        const int res = uncompress(reinterpret_cast<Bytef*>(buffOut + outOffset), &outSize,
+            blocks.data() + blockOffsets[b], static_cast<uLong>(blockOffsets[b + 1] - blockOffsets[b]));
+        success = success && (res == Z_OK) && (outSize == expected);
+    }
+
+    return success;
+}
+
+
 /*
  * VTILoader::constructFrame
  */
@@ -627,32 +772,56 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
     time_t t = clock();
 #endif // defined(VERBOSE)
 
-    // Read data file to char buffer
-    char* buffer = new char[(unsigned int)fileSize];
-    file.Open(
-        frameFile, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_EXCLUSIVE, vislib::sys::File::OPEN_ONLY);
-    file.Read(buffer, fileSize);
-    file.Close();
+    // Read the XML part of the data file to a char buffer, the file stays
+    // open to read appended data directly into the data arrays
+    std::vector<char> buffer;
+    if (!file.Open(
+            frameFile, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::OPEN_ONLY)) {
+        Log::DefaultLog.WriteError("%s: Unable to open file '%s'", this->ClassName(), frameFile.PeekBuffer());
+        return;
+    }
+    const vislib::sys::File::FileSize appendedStart = readXMLPart(file, buffer);
 
     uint pieceCounter = 0;
+    bool header64 = false, compressed = false, bigEndian = false, appendedRaw = false;
 
     // Parse buffer
-    char *pt = buffer, *pt_end;
+    char *pt = buffer.data(), *pt_end;
+    char* const buffer_end = buffer.data() + buffer.size() - 1;
     vislib::StringA entity;
-    while (pt < buffer + fileSize - 2) {
+    while (pt < buffer_end - 2) {
 
         // Get next xml entity string
-        while (*pt != '<') {
+        while (pt < buffer_end && *pt != '<') {
             pt++;
         }
         pt_end = pt;
-        while (*pt_end != '>') {
+        while (pt_end < buffer_end && *pt_end != '>') {
             pt_end++;
         }
-        entity = vislib::StringA(std::string(pt + 1, pt_end - pt).c_str());
+        if (pt_end >= buffer_end) {
+            break;
+        }
+        entity = vislib::StringA(pt + 1, (int)(pt_end - pt));
 
         // Parse and store pieces
-        if (entity.StartsWith("ImageData")) {
+        if (entity.StartsWith("VTKFile")) {
+
+            // Layout of binary data, the defaults are those of VTK
+            bigEndian = (entity.Find("byte_order=\"BigEndian\"", 0) != StringA::INVALID_POS);
+            header64 = (entity.Find("header_type=\"UInt64\"", 0) != StringA::INVALID_POS);
+            compressed = (entity.Find("compressor=\"vtkZLibDataCompressor\"", 0) != StringA::INVALID_POS);
+            if (!compressed && (entity.Find("compressor=", 0) != StringA::INVALID_POS)) {
+                Log::DefaultLog.WriteError(
+                    "%s: Unable to load file '%s' (unsupported compressor)", this->ClassName(), frameFile.PeekBuffer());
+                return;
+            }
+
+        } else if (entity.StartsWith("AppendedData")) {
+
+            appendedRaw = (entity.Find("encoding=\"raw\"", 0) != StringA::INVALID_POS);
+
+        } else if (entity.StartsWith("ImageData")) {
 
             vislib::StringA extendStr, originStr, spacingStr;
             unsigned int extent[6];
@@ -774,6 +943,8 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
                 f = protein_calls::VTKImageData::VTISOURCE_ASCII;
             } else if (format == vislib::StringA("binary")) {
                 f = protein_calls::VTKImageData::VTISOURCE_BINARY;
+            } else if (format == vislib::StringA("appended")) {
+                f = protein_calls::VTKImageData::VTISOURCE_APPENDED;
             } else {
                 Log::DefaultLog.WriteError("%s: Unable to load file '%s' (unsupported data format %s)",
                     this->ClassName(),
@@ -812,6 +983,18 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
             if (numComponents == 0)
                 numComponents = 1;
 
+            // Offset of appended data relative to the '_' marker
+            vislib::sys::File::FileSize offset = 0;
+            if (f == protein_calls::VTKImageData::VTISOURCE_APPENDED) {
+                StringA::Size offsetIdx = entity.Find(" offset=\"", 0);
+                if ((offsetIdx == StringA::INVALID_POS) || (appendedStart == 0) || !appendedRaw) {
+                    Log::DefaultLog.WriteError("%s: Unable to load file '%s' (only raw appended data is supported)",
+                        this->ClassName(), frameFile.PeekBuffer());
+                    return;
+                }
+                offset = std::strtoull(entity.PeekBuffer() + offsetIdx + 9, NULL, 10);
+            }
+
             pt_end++; // Omit next '>'
 
             // Get overall grid size of the current piece
@@ -837,6 +1020,22 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
                 //                    printf("%i: %.16f\n", i, data[i]);
                 //                }
                 //                // END DEBUG
+            } else if (f == protein_calls::VTKImageData::VTISOURCE_APPENDED) {
+                // Allocate the array and read the data in place
+                fr->SetPointData(NULL, min, max, protein_calls::VTKImageData::DataArray::VTI_FLOAT, name,
+                    numComponents, pieceCounter - 1);
+                char* dst = fr->PeekPointData(name, pieceCounter - 1)->PeekData();
+                if (!this->readDataAppended(file, appendedStart + offset, header64, compressed, bigEndian, dst,
+                        gridSize * sizeof(float))) {
+                    Log::DefaultLog.WriteError("%s: Unable to load file '%s' (corrupt data array '%s')",
+                        this->ClassName(), frameFile.PeekBuffer(), name.PeekBuffer());
+                    return;
+                }
+                if (bigEndian) {
+                    for (uint i = 0; i < gridSize; ++i) {
+                        std::reverse(dst + i * sizeof(float), dst + (i + 1) * sizeof(float));
+                    }
+                }
             }
             if (data)
                 delete[] data;
@@ -845,7 +1044,7 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
         pt = pt_end + 1;
         entity.Clear();
     }
-    delete[] buffer;
+    file.Close();
 
 #if defined(VERBOSE)
     vislib::StringA frameFileShortPath;
@@ -869,6 +1068,16 @@ void VTILoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
 }
 
 
+/*
+ * VTILoader::maxConcurrentFrameLoads
+ */
+unsigned int VTILoader::maxConcurrentFrameLoads() const {
+    if (this->filenamesDigits == 0)
+        return 1;
+    return std::min(2U, std::max(1U, std::thread::hardware_concurrency()));
+}
+
+
 /*
  * VTILoader::string2int
  */
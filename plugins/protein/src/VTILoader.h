@@ -24,6 +24,7 @@
 #include "vislib/String.h"
 #include "vislib/math/Cuboid.h"
 #include "vislib/math/Vector.h"
+#include "vislib/sys/File.h"
 
 #include <fstream>
 #include <map>
@@ -142,6 +143,23 @@ protected:
      */
     void readDataBinary2Float(char* buffIn, float* buffOut, SIZE_T sizeOut);
 
+    /**
+     * Reads raw appended data directly from the file to the output buffer.
+     * Data compressed with zlib is inflated block by block in parallel.
+     *
+     * @param file       The opened VTI file
+     * @param pos        The file offset of the data array's header
+     * @param header64   'true' if the headers use UInt64 instead of UInt32
+     * @param compressed 'true' if the data is compressed with zlib
+     * @param bigEndian  'true' if the headers are stored in big endian order
+     * @param buffOut    The output buffer
+     * @param sizeOut    The size of the output buffer in bytes
+     *
+     * @return 'true' on success, 'false' if the data could not be read
+     */
+    bool readDataAppended(vislib::sys::File& file, vislib::sys::File::FileSize pos, bool header64, bool compressed,
+        bool bigEndian, char* buffOut, SIZE_T sizeOut);
+
     /**
      * Creates a frame to be used in the frame cache. This method will be
      * called from within 'initFrameCache'.
@@ -161,6 +179,15 @@ protected:
      */
     virtual void loadFrame(Frame* frame, unsigned int idx);
 
+    /**
+     * Answer how many frames may be loaded at the same time. The files of a
+     * series are independent, so the next file is read while the current one
+     * is still being decoded.
+     *
+     * @return The maximum number of concurrent calls to 'loadFrame'.
+     */
+    virtual unsigned int maxConcurrentFrameLoads() const;
+
 private:
     /**
      * Storage of frame data
@@ -382,7 +409,7 @@ private:
         /**
          * Adds a data array to the point data or updates a current one.
          *
-         * @param data        The actual data.
+         * @param data        The actual data or NULL to only allocate it.
          * @param min         The minimum data value.
          * @param max         The maximum data value.
          * @param t           The data type of the data array.
@@ -0,0 +1,523 @@
+/*
+ * XTCReader.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "XTCReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::protein;
+
+namespace {
+
+/** Magic id and version of the cached frame directory */
+constexpr char IndexMagic[8] = {'M', 'M', 'X', 'T', 'C', 'I', 'D', 'X'};
+constexpr uint32_t IndexVersion = 1;
+
+/** Size of the frame header up to and including the second atom count */
+constexpr uint64_t HeaderSize = 56;
+
+/** Size of precision, integer bounds, smallidx and block size following the header */
+constexpr uint64_t CompressedHeaderSize = 36;
+
+/**
+ * Zero padding behind the compressed data. One atom (run) consumes at most 103 bytes and the decoder stops as soon as
+ * the end of the data is passed, so bit reads never leave the buffer even for corrupt data.
+ */
+constexpr uint64_t BufferPadding = 128;
+
+// note that magicints[FIRSTIDX-1] == 0
+constexpr int magicints[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64, 80, 101, 128, 161, 203,
+    256, 322, 406, 512, 645, 812, 1024, 1290, 1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003, 16384,
+    20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031, 131072, 165140, 208063, 262144, 330280, 416127, 524287,
+    660561, 832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021, 4194304, 5284491, 6658042, 8388607,
+    10568983, 13316085, 16777216};
+
+constexpr int FIRSTIDX = 9;
+constexpr int LASTIDX = static_cast<int>(sizeof(magicints) / sizeof(*magicints));
+
+/** Reads a big-endian 32 bit value */
+inline uint32_t readBE32(const uint8_t* ptr) {
+    return (static_cast<uint32_t>(ptr[0]) << 24) | (static_cast<uint32_t>(ptr[1]) << 16) |
+           (static_cast<uint32_t>(ptr[2]) << 8) | static_cast<uint32_t>(ptr[3]);
+}
+
+inline float readBEFloat(const uint8_t* ptr) {
+    uint32_t bits = readBE32(ptr);
+    float val;
+    std::memcpy(&val, &bits, 4);
+    return val;
+}
+
+/**
+ * Sequential reader of the big-endian bit stream, 'data' must be readable 8 bytes behind the current position.
+ */
+class BitReader {
+public:
+    explicit BitReader(const uint8_t* data) : data(data), pos(0) {}
+
+    /** Reads up to 32 bits */
+    inline unsigned int Read(int bits) {
+        if (bits <= 0)
+            return 0;
+        const uint8_t* ptr = this->data + (this->pos >> 3);
+        uint64_t word = 0;
+        for (int b = 0; b < 8; ++b) {
+            word = (word << 8) | ptr[b];
+        }
+        word <<= (this->pos & 7);
+        this->pos += static_cast<uint64_t>(bits);
+        return static_cast<unsigned int>(word >> (64 - bits));
+    }
+
+    /**
+     * Reads three integers packed into one big number with the given ranges.
+     */
+    inline void ReadInts(int num_of_bits, const unsigned int sizes[], int nums[]) {
+        unsigned int bytes[32];
+        int num_of_bytes = 0;
+
+        bytes[1] = bytes[2] = bytes[3] = 0;
+        while (num_of_bits > 8) {
+            bytes[num_of_bytes++] = this->Read(8);
+            num_of_bits -= 8;
+        }
+        if (num_of_bits > 0) {
+            bytes[num_of_bytes++] = this->Read(num_of_bits);
+        }
+
+        for (int i = 2; i > 0; --i) {
+            unsigned int num = 0;
+            for (int j = num_of_bytes - 1; j >= 0; --j) {
+                num = (num << 8) | bytes[j];
+                const unsigned int p = num / sizes[i];
+                bytes[j] = p;
+                num = num - p * sizes[i];
+            }
+            nums[i] = static_cast<int>(num);
+        }
+        nums[0] = static_cast<int>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24));
+    }
+
+private:
+    const uint8_t* data;
+    uint64_t pos;
+};
+
+/** Number of bits needed to represent 'size' */
+int sizeofint(unsigned int size) {
+    unsigned int num = 1;
+    int num_of_bits = 0;
+    while (size >= num && num_of_bits < 32) {
+        num_of_bits++;
+        num <<= 1;
+    }
+    return num_of_bits;
+}
+
+/** Number of bits needed to represent three integers with the given ranges */
+unsigned int sizeofints(const unsigned int sizes[]) {
+    unsigned int bytes[32];
+    unsigned int num_of_bytes = 1, num_of_bits = 0, bytecnt, tmp;
+    bytes[0] = 1;
+    for (int i = 0; i < 3; i++) {
+        tmp = 0;
+        for (bytecnt = 0; bytecnt < num_of_bytes; bytecnt++) {
+            tmp = bytes[bytecnt] * sizes[i] + tmp;
+            bytes[bytecnt] = tmp & 0xff;
+            tmp >>= 8;
+        }
+        while (tmp != 0) {
+            bytes[bytecnt++] = tmp & 0xff;
+            tmp >>= 8;
+        }
+        num_of_bytes = bytecnt;
+    }
+    unsigned int num = 1;
+    num_of_bytes--;
+    while (bytes[num_of_bytes] >= num) {
+        num_of_bits++;
+        num *= 2;
+    }
+    return num_of_bits + num_of_bytes * 8;
+}
+
+} // namespace
+
+
+/*
+ * XTCReader::XTCReader
+ */
+XTCReader::XTCReader(void) : filename(), atomCount(0), frames(), handles(), handleLock() {}
+
+
+/*
+ * XTCReader::~XTCReader
+ */
+XTCReader::~XTCReader(void) {
+    this->Close();
+}
+
+
+/*
+ * XTCReader::Open
+ */
+bool XTCReader::Open(const std::filesystem::path& filename) {
+    using megamol::core::utility::log::Log;
+
+    this->Close();
+
+    std::error_code ec;
+    const auto fileSize = static_cast<uint64_t>(std::filesystem::file_size(filename, ec));
+    if (ec) {
+        Log::DefaultLog.WriteError("[XTCReader] Could not open \"%s\".", filename.generic_u8string().c_str());
+        return false;
+    }
+    const auto fileTime =
+        static_cast<int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+
+    auto indexFile = filename;
+    indexFile += ".mmxtcidx";
+    if (!this->loadIndex(indexFile, fileSize, fileTime)) {
+        std::ifstream in(filename, std::ios::in | std::ios::binary);
+        if (!in || !this->buildIndex(in, fileSize)) {
+            Log::DefaultLog.WriteError("[XTCReader] Could not parse \"%s\".", filename.generic_u8string().c_str());
+            this->frames.clear();
+            return false;
+        }
+        this->saveIndex(indexFile, fileSize, fileTime);
+    }
+
+    this->filename = filename;
+    return true;
+}
+
+
+/*
+ * XTCReader::Close
+ */
+void XTCReader::Close(void) {
+    std::lock_guard<std::mutex> lock(this->handleLock);
+    this->handles.clear();
+    this->frames.clear();
+    this->atomCount = 0;
+    this->filename.clear();
+}
+
+
+/*
+ * XTCReader::ReadFrame
+ */
+bool XTCReader::ReadFrame(unsigned int idx, float* positions) {
+    if (idx >= this->frames.size())
+        return false;
+    const auto& info = this->frames[idx];
+
+    auto handle = this->acquireHandle();
+    if (handle == nullptr)
+        return false;
+    auto& in = handle->stream;
+    bool ok = true;
+
+    if (this->atomCount <= 3) {
+        // no compression is used for three atoms or less
+        handle->buffer.resize(this->atomCount * 12);
+        in.seekg(info.offset + HeaderSize);
+        in.read(reinterpret_cast<char*>(handle->buffer.data()), handle->buffer.size());
+        ok = static_cast<bool>(in);
+        for (unsigned int i = 0; ok && i < this->atomCount * 3; ++i) {
+            positions[i] = readBEFloat(handle->buffer.data() + i * 4);
+        }
+    } else {
+        handle->buffer.resize(info.size + BufferPadding);
+        std::fill(handle->buffer.end() - BufferPadding, handle->buffer.end(), 0);
+        in.seekg(info.offset + HeaderSize + CompressedHeaderSize);
+        in.read(reinterpret_cast<char*>(handle->buffer.data()), info.size);
+        ok = static_cast<bool>(in) && decode(handle->buffer.data(), info, this->atomCount, positions);
+    }
+
+    if (!ok) {
+        in.clear();
+        megamol::core::utility::log::Log::DefaultLog.WriteError("[XTCReader] Could not read frame %u.", idx);
+    }
+    this->releaseHandle(std::move(handle));
+    return ok;
+}
+
+
+/*
+ * XTCReader::decode
+ */
+bool XTCReader::decode(const uint8_t* data, const FrameInfo& info, unsigned int atomCount, float* positions) {
+    const float precision = info.precision;
+    int smallidx = info.smallidx;
+    if (smallidx < FIRSTIDX || smallidx >= LASTIDX)
+        return false;
+
+    unsigned int sizeint[3], sizesmall[3], bitsizeint[3];
+    unsigned int bitsize;
+    for (int d = 0; d < 3; ++d) {
+        sizeint[d] = static_cast<unsigned int>(info.maxint[d] - info.minint[d] + 1);
+    }
+
+    // check if one of the sizes is to big to be multiplied
+    if ((sizeint[0] | sizeint[1] | sizeint[2]) > 0xffffff) {
+        bitsizeint[0] = sizeofint(sizeint[0]);
+        bitsizeint[1] = sizeofint(sizeint[1]);
+        bitsizeint[2] = sizeofint(sizeint[2]);
+        bitsize = 0; // flag the use of large sizes
+    } else {
+        bitsizeint[0] = bitsizeint[1] = bitsizeint[2] = 0;
+        bitsize = sizeofints(sizeint);
+    }
+
+    // if the difference to the last coordinate is smaller than smallnum
+    // the difference is stored instead of the real coordinate
+    int smallnum = magicints[smallidx] / 2;
+    int smaller = (FIRSTIDX > smallidx - 1) ? magicints[FIRSTIDX] / 2 : magicints[smallidx - 1] / 2;
+    sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
+
+    const auto setPosition = [positions, atomCount, precision](unsigned int i, const int coord[3]) {
+        if (i < atomCount) {
+            positions[i * 3 + 0] = static_cast<float>(coord[0]) / precision;
+            positions[i * 3 + 1] = static_cast<float>(coord[1]) / precision;
+            positions[i * 3 + 2] = static_cast<float>(coord[2]) / precision;
+        }
+    };
+
+    BitReader bits(data);
+    const uint64_t maxBits = static_cast<uint64_t>(info.size) * 8;
+    uint64_t readBits = 0;
+    int thiscoord[3], prevcoord[3];
+    int run = 0;
+    unsigned int i = 0;
+
+    while (i < atomCount) {
+        if (bitsize == 0) {
+            thiscoord[0] = static_cast<int>(bits.Read(bitsizeint[0]));
+            thiscoord[1] = static_cast<int>(bits.Read(bitsizeint[1]));
+            thiscoord[2] = static_cast<int>(bits.Read(bitsizeint[2]));
+            readBits += bitsizeint[0] + bitsizeint[1] + bitsizeint[2];
+        } else {
+            bits.ReadInts(bitsize, sizeint, thiscoord);
+            readBits += bitsize;
+        }
+
+        thiscoord[0] += info.minint[0];
+        thiscoord[1] += info.minint[1];
+        thiscoord[2] += info.minint[2];
+
+        // flag has been set if runlength changed while compression
+        // runlength is encoded in run/3
+        // is_smaller is encoded in run%3 (-1,0,1)
+        int is_smaller = 0;
+        if (bits.Read(1) == 1) {
+            run = static_cast<int>(bits.Read(5));
+            is_smaller = run % 3;
+            run -= is_smaller;
+            is_smaller--;
+            readBits += 5;
+        }
+        readBits += 1;
+
+        // run = the number of coordinates following the current coordinate that
+        // have been stored as differences to their previous coordinate
+        if (run > 0) {
+            prevcoord[0] = thiscoord[0];
+            prevcoord[1] = thiscoord[1];
+            prevcoord[2] = thiscoord[2];
+
+            for (int k = 0; k < run; k += 3) {
+                bits.ReadInts(smallidx, sizesmall, thiscoord);
+                readBits += smallidx;
+
+                thiscoord[0] += prevcoord[0] - smallnum;
+                thiscoord[1] += prevcoord[1] - smallnum;
+                thiscoord[2] += prevcoord[2] - smallnum;
+
+                if (k == 0) {
+                    // interchange first with second atom for better
+                    // compression of water molecules
+                    std::swap(thiscoord[0], prevcoord[0]);
+                    std::swap(thiscoord[1], prevcoord[1]);
+                    std::swap(thiscoord[2], prevcoord[2]);
+                    setPosition(i++, prevcoord);
+                } else {
+                    prevcoord[0] = thiscoord[0];
+                    prevcoord[1] = thiscoord[1];
+                    prevcoord[2] = thiscoord[2];
+                }
+                setPosition(i++, thiscoord);
+            }
+        } else {
+            setPosition(i++, thiscoord);
+        }
+
+        // update smallidx etc
+        smallidx += is_smaller;
+        if (smallidx < FIRSTIDX || smallidx >= LASTIDX || readBits > maxBits)
+            return false;
+        if (is_smaller < 0) {
+            smallnum = smaller;
+            if (smallidx > FIRSTIDX) {
+                smaller = magicints[smallidx - 1] / 2;
+            } else {
+                smaller = 0;
+            }
+        } else if (is_smaller > 0) {
+            smaller = smallnum;
+            smallnum = magicints[smallidx] / 2;
+        }
+        sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
+    }
+
+    return true;
+}
+
+
+/*
+ * XTCReader::buildIndex
+ */
+bool XTCReader::buildIndex(std::istream& in, uint64_t fileSize) {
+    this->frames.clear();
+    this->atomCount = 0;
+
+    uint8_t header[HeaderSize + CompressedHeaderSize];
+    uint64_t offset = 0;
+    while (offset + HeaderSize <= fileSize) {
+        in.seekg(offset);
+        in.read(reinterpret_cast<char*>(header), HeaderSize);
+        if (!in)
+            return false;
+
+        const auto natoms = readBE32(header + 4);
+        if (this->frames.empty()) {
+            this->atomCount = natoms;
+        } else if (natoms != this->atomCount) {
+            return false;
+        }
+
+        FrameInfo info;
+        std::memset(&info, 0, sizeof(FrameInfo));
+        info.offset = offset;
+        if (natoms <= 3) {
+            offset += HeaderSize + natoms * 12;
+        } else {
+            in.read(reinterpret_cast<char*>(header + HeaderSize), CompressedHeaderSize);
+            if (!in)
+                return false;
+            const uint8_t* ptr = header + HeaderSize;
+            info.precision = readBEFloat(ptr) / 10.0f;
+            for (int d = 0; d < 3; ++d) {
+                info.minint[d] = static_cast<int32_t>(readBE32(ptr + 4 + d * 4));
+                info.maxint[d] = static_cast<int32_t>(readBE32(ptr + 16 + d * 4));
+            }
+            info.smallidx = static_cast<int32_t>(readBE32(ptr + 28));
+            info.size = readBE32(ptr + 32);
+            offset += HeaderSize + CompressedHeaderSize + info.size + (4 - info.size % 4) % 4;
+        }
+        if (offset > fileSize)
+            break; // truncated frame
+        this->frames.push_back(info);
+    }
+
+    return !this->frames.empty();
+}
+
+
+/*
+ * XTCReader::loadIndex
+ */
+bool XTCReader::loadIndex(const std::filesystem::path& indexFile, uint64_t fileSize, int64_t fileTime) {
+    std::ifstream in(indexFile, std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+
+    char magic[8];
+    uint32_t version = 0, natoms = 0;
+    uint64_t size = 0, count = 0;
+    int64_t time = 0;
+    in.read(magic, 8);
+    in.read(reinterpret_cast<char*>(&version), 4);
+    in.read(reinterpret_cast<char*>(&size), 8);
+    in.read(reinterpret_cast<char*>(&time), 8);
+    in.read(reinterpret_cast<char*>(&natoms), 4);
+    in.read(reinterpret_cast<char*>(&count), 8);
+    if (!in || std::memcmp(magic, IndexMagic, 8) != 0 || version != IndexVersion || size != fileSize ||
+        time != fileTime || count == 0) {
+        return false;
+    }
+
+    this->frames.resize(count);
+    in.read(reinterpret_cast<char*>(this->frames.data()), count * sizeof(FrameInfo));
+    if (!in) {
+        this->frames.clear();
+        return false;
+    }
+    this->atomCount = natoms;
+    return true;
+}
+
+
+/*
+ * XTCReader::saveIndex
+ */
+void XTCReader::saveIndex(const std::filesystem::path& indexFile, uint64_t fileSize, int64_t fileTime) const {
+    std::ofstream out(indexFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        // the trajectory directory might be read-only, the index is rebuilt next time then
+        return;
+    }
+
+    const uint64_t count = this->frames.size();
+    out.write(IndexMagic, 8);
+    out.write(reinterpret_cast<const char*>(&IndexVersion), 4);
+    out.write(reinterpret_cast<const char*>(&fileSize), 8);
+    out.write(reinterpret_cast<const char*>(&fileTime), 8);
+    out.write(reinterpret_cast<const char*>(&this->atomCount), 4);
+    out.write(reinterpret_cast<const char*>(&count), 8);
+    out.write(reinterpret_cast<const char*>(this->frames.data()), count * sizeof(FrameInfo));
+    if (!out) {
+        out.close();
+        std::error_code ec;
+        std::filesystem::remove(indexFile, ec);
+    }
+}
+
+
+/*
+ * XTCReader::acquireHandle
+ */
+std::unique_ptr<XTCReader::Handle> XTCReader::acquireHandle(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->handleLock);
+        if (!this->handles.empty()) {
+            auto handle = std::move(this->handles.back());
+            this->handles.pop_back();
+            return handle;
+        }
+    }
+
+    auto handle = std::make_unique<Handle>();
+    handle->stream.open(this->filename, std::ios::in | std::ios::binary);
+    if (!handle->stream)
+        return nullptr;
+    return handle;
+}
+
+
+/*
+ * XTCReader::releaseHandle
+ */
+void XTCReader::releaseHandle(std::unique_ptr<Handle> handle) {
+    std::lock_guard<std::mutex> lock(this->handleLock);
+    this->handles.push_back(std::move(handle));
+}
@@ -0,0 +1,162 @@
+/*
+ * XTCReader.h
+ *
+ * Copyright (C) 2022 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Random access reader for GROMACS XTC trajectories.
+ *
+ * The trajectory stays open as long as the reader is open. Every concurrent caller of 'ReadFrame' gets its own
+ * stream and read buffer from a pool, so independent frames can be decoded by several threads at once. The frame
+ * directory is cached in a file next to the trajectory and only rebuilt if the trajectory changed.
+ */
+class XTCReader {
+public:
+    /** Header data of one frame */
+    struct FrameInfo {
+        /** Byte offset of the frame in the file */
+        uint64_t offset;
+        /** Precision of the integer coordinates (already divided by 10) */
+        float precision;
+        /** Lower bound of the integer coordinates */
+        int32_t minint[3];
+        /** Upper bound of the integer coordinates */
+        int32_t maxint[3];
+        /** Initial number of bits of the small integers */
+        int32_t smallidx;
+        /** Size of the compressed data block in bytes */
+        uint32_t size;
+    };
+
+    /** Ctor */
+    XTCReader(void);
+
+    /** Dtor */
+    ~XTCReader(void);
+
+    /**
+     * Opens a trajectory and loads or builds its frame directory.
+     *
+     * @param filename The XTC file
+     *
+     * @return 'true' on success
+     */
+    bool Open(const std::filesystem::path& filename);
+
+    /**
+     * Closes the trajectory. Must not be called while frames are being read.
+     */
+    void Close(void);
+
+    /**
+     * Answer whether a trajectory is open.
+     *
+     * @return 'true' if a trajectory is open
+     */
+    inline bool IsOpen(void) const {
+        return !this->filename.empty();
+    }
+
+    /**
+     * Answer the number of atoms per frame.
+     *
+     * @return The number of atoms
+     */
+    inline unsigned int AtomCount(void) const {
+        return this->atomCount;
+    }
+
+    /**
+     * Answer the number of frames.
+     *
+     * @return The number of frames
+     */
+    inline unsigned int FrameCount(void) const {
+        return static_cast<unsigned int>(this->frames.size());
+    }
+
+    /**
+     * Answer the header data of a frame.
+     *
+     * @param idx The frame index
+     *
+     * @return The header data
+     */
+    inline const FrameInfo& Info(unsigned int idx) const {
+        return this->frames[idx];
+    }
+
+    /**
+     * Reads and decodes one frame. This method is thread-safe.
+     *
+     * @param idx The frame index
+     * @param positions Receives 3 * AtomCount() coordinates
+     *
+     * @return 'true' on success
+     */
+    bool ReadFrame(unsigned int idx, float* positions);
+
+private:
+    /** An open stream and its read buffer */
+    struct Handle {
+        std::ifstream stream;
+        std::vector<uint8_t> buffer;
+    };
+
+    /**
+     * Decodes the compressed coordinates of a frame.
+     *
+     * @param data The compressed data block, padded with zero bytes
+     * @param info The frame header
+     * @param atomCount The number of atoms
+     * @param positions Receives the coordinates
+     *
+     * @return 'true' on success, 'false' if the data is corrupt
+     */
+    static bool decode(const uint8_t* data, const FrameInfo& info, unsigned int atomCount, float* positions);
+
+    /** Builds the frame directory by scanning all frame headers */
+    bool buildIndex(std::istream& in, uint64_t fileSize);
+
+    /** Loads the cached frame directory if it matches the trajectory */
+    bool loadIndex(const std::filesystem::path& indexFile, uint64_t fileSize, int64_t fileTime);
+
+    /** Writes the frame directory next to the trajectory */
+    void saveIndex(const std::filesystem::path& indexFile, uint64_t fileSize, int64_t fileTime) const;
+
+    std::unique_ptr<Handle> acquireHandle(void);
+
+    void releaseHandle(std::unique_ptr<Handle> handle);
+
+    /** The trajectory */
+    std::filesystem::path filename;
+
+    /** The number of atoms per frame */
+    unsigned int atomCount;
+
+    /** The frame directory */
+    std::vector<FrameInfo> frames;
+
+    /** Idle handles */
+    std::vector<std::unique_ptr<Handle>> handles;
+
+    /** Guards 'handles' */
+    std::mutex handleLock;
+};
+
+} /* end namespace protein */
+} /* end namespace megamol */
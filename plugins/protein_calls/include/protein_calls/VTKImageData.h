@@ -103,8 +103,10 @@ public:
 
         /**
          * Updates the data stored in the array. Allocates memory if necessary.
+         * If 'data' is NULL, the memory is only allocated and can be filled
+         * via 'PeekData' afterwards.
          *
-         * @param data        The data to be stored.
+         * @param data        The data to be stored or NULL.
          * @param min         The minimum data value.
          * @param max         The maximum data value.
          * @param t           The data's data type.
@@ -145,7 +147,9 @@ public:
             }
 
             // Copy data
-            memcpy(this->data, data, this->allocated);
+            if (data != NULL) {
+                memcpy(this->data, data, gridSize * nBytesPerElement);
+            }
         }
 
         /**
@@ -33,6 +33,7 @@
 #include "vislib_gl/graphics/gl/AbstractOpenGLShader.h"
 #include "vislib_gl/graphics/gl/IncludeAllGL.h"
 #include "vislib_gl/graphics/gl/ShaderSource.h"
+#include <cstdint>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -65,6 +66,11 @@ MoleculeSESRenderer::MoleculeSESRenderer(void)
         , molIdxListParam("molIdxList", "The list of molecule indices for RS computation:")
         , colorTableFileParam("color::colorTableFilename", "The filename of the color table.")
         , probeRadiusSlot("probeRadius", "The probe radius for the surface computation")
+        , updateThresholdSlot("updateThreshold",
+              "Atoms moving less than this distance between two frames do not update the reduced surface")
+        , recomputeThresholdSlot("recomputeThreshold",
+              "The reduced surface is recomputed from scratch if any atom moves further than this distance between two "
+              "frames, otherwise only the parts around the moved atoms are updated")
         , computeSesPerMolecule(false)
         , vertexArraySphere_(0)
         , vertexArrayTorus_(0)
@@ -105,6 +111,12 @@ MoleculeSESRenderer::MoleculeSESRenderer(void)
     this->probeRadiusSlot.SetParameter(new param::FloatParam(1.4f, 0.1f));
     this->MakeSlotAvailable(&this->probeRadiusSlot);
 
+    this->updateThresholdSlot.SetParameter(new param::FloatParam(1.0f, 0.0f));
+    this->MakeSlotAvailable(&this->updateThresholdSlot);
+
+    this->recomputeThresholdSlot.SetParameter(new param::FloatParam(5.0f, 0.0f));
+    this->MakeSlotAvailable(&this->recomputeThresholdSlot);
+
     // coloring modes
     this->currentColoringMode0 = ProteinColor::ColoringMode::CHAIN;
     this->currentColoringMode1 = ProteinColor::ColoringMode::ELEMENT;
@@ -448,29 +460,38 @@ bool MoleculeSESRenderer::Render(mmstd_gl::CallRender3DGL& call) {
         unsigned int chainIds;
         if (!this->computeSesPerMolecule) {
             this->reducedSurface.push_back(new ReducedSurface(mol, this->probeRadius));
-            this->reducedSurface.back()->ComputeReducedSurface();
         } else {
             // if no molecule indices are given, compute the SES for all molecules
             if (this->molIdxList.IsEmpty()) {
                 for (chainIds = 0; chainIds < mol->MoleculeCount(); ++chainIds) {
                     this->reducedSurface.push_back(new ReducedSurface(chainIds, mol, this->probeRadius));
-                    this->reducedSurface.back()->ComputeReducedSurface();
                 }
             } else {
                 // else compute the SES for all selected molecules
                 for (chainIds = 0; chainIds < this->molIdxList.Count(); ++chainIds) {
                     this->reducedSurface.push_back(
                         new ReducedSurface(atoi(this->molIdxList[chainIds]), mol, this->probeRadius));
-                    this->reducedSurface.back()->ComputeReducedSurface();
                 }
             }
         }
+        // the reduced surfaces of different molecules are independent of each other
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < static_cast<int64_t>(this->reducedSurface.size()); ++i) {
+            this->reducedSurface[i]->ComputeReducedSurface();
+        }
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "%s: RS computed in: %f s\n", this->ClassName(), (double(clock() - t) / double(CLOCKS_PER_SEC)));
     }
     // update the data / the RS
+    const float updateThreshold = this->updateThresholdSlot.Param<param::FloatParam>()->Value();
+    const float recomputeThreshold = this->recomputeThresholdSlot.Param<param::FloatParam>()->Value();
+    std::vector<char> rsChanged(this->reducedSurface.size(), 0);
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < static_cast<int64_t>(this->reducedSurface.size()); ++i) {
+        rsChanged[i] = this->reducedSurface[i]->UpdateData(updateThreshold, recomputeThreshold);
+    }
     for (cntRS = 0; cntRS < this->reducedSurface.size(); ++cntRS) {
-        if (this->reducedSurface[cntRS]->UpdateData(1.0f, 5.0f)) {
+        if (rsChanged[cntRS]) {
             this->ComputeRaycastingArrays(cntRS);
         }
     }
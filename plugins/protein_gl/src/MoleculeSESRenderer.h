@@ -246,6 +246,10 @@ private:
     megamol::core::param::ParamSlot colorTableFileParam;
 
     megamol::core::param::ParamSlot probeRadiusSlot;
+    /** parameter slot for the distance an atom has to move before the reduced surface around it is updated */
+    megamol::core::param::ParamSlot updateThresholdSlot;
+    /** parameter slot for the distance an atom has to move before the whole reduced surface is recomputed */
+    megamol::core::param::ParamSlot recomputeThresholdSlot;
 
 
     bool drawSES;
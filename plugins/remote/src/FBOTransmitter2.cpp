@@ -42,6 +42,7 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
         , toggle_aggregate_slot_{"aggregate", "Toggle whether to aggregate and composite FBOs prior to transmission"}
         , render_comp_img_slot_("renderCompImage", "Renders the complete composited image on the broadcast master")
+        , composite_radix_slot_("compositeRadix", "Maximum group size per compositing round (2 is binary-swap)")
 #endif // MEGAMOL_USE_MPI
         , aggregate_{false}
         , frame_id_{0}
@@ -83,6 +84,8 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     render_comp_img_slot_ << new megamol::core::param::BoolParam{false};
     this->render_comp_img_slot_.SetUpdateCallback(&FBOTransmitter2::renderCompChanged);
     this->MakeSlotAvailable(&render_comp_img_slot_);
+    composite_radix_slot_ << new megamol::core::param::IntParam(2, 2);
+    this->MakeSlotAvailable(&composite_radix_slot_);
 #endif // MEGAMOL_USE_MPI
     reconnect_slot_ << new megamol::core::param::ButtonParam{};
     reconnect_slot_.SetUpdateCallback(&FBOTransmitter2::reconnectCallback);
@@ -154,6 +157,10 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
         glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf.data());
         glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buf.data());
     } else {
+        // pixels outside of the tile must not win the depth test during compositing
+        auto const depth_ptr = reinterpret_cast<float*>(depth_buf.data());
+        std::fill(depth_ptr, depth_ptr + width * height, 1.0f);
+
         std::vector<char> col_buf_tile(tile_width * tile_height * col_buf_el_size_);
         std::vector<char> depth_buf_tile(tile_width * tile_height * depth_buf_el_size_);
 
@@ -182,38 +189,26 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
 
 
 #ifdef MEGAMOL_USE_MPI
-    IceTUByte* icet_col_buf = reinterpret_cast<IceTUByte*>(col_buf.data());
-    IceTFloat* icet_depth_buf = reinterpret_cast<IceTFloat*>(depth_buf.data());
-
-    if (aggregate_) {
+    if (aggregate_ && this->compositor_ != nullptr) {
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "FBOTransmitter2: Simple IceT commit at rank %d\n", mpiRank);
+            "FBOTransmitter2: Sort-last compositing at rank %d\n", mpiRank);
 #endif
         std::array<float, 4> backgroundColor = {0.0f, 0.0f, 0.0f, 1.0f};
         this->extractBackgroundColor(backgroundColor);
 
-        int tilevp[4] = {xoff, yoff, tile_width, tile_height}; // define current valid pixel viewport for icet
+        this->compositor_->SetMaxRadix(this->composite_radix_slot_.Param<core::param::IntParam>()->Value());
+        if (!this->compositor_->Composite(col_buf, depth_buf, width * height, backgroundColor, 0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "FBOTransmitter2: Compositing failed at rank %d\n", mpiRank);
+        }
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "IceT gets image with xoff: %d, yoff: %d, tile_width: %d, tile_height: %d\n", xoff, yoff, tile_width,
-            tile_height);
-#endif
-        auto const icet_comp_image = icetCompositeImage(col_buf.data(), depth_buf.data(), tilevp, nullptr, nullptr,
-            static_cast<const IceTFloat*>(backgroundColor.data()));
-#if _DEBUG
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - Composite Image Done\n");
+            "FBOTransmitter2: Compositing done, skipped %zu empty tiles\n", this->compositor_->GetSkippedTiles());
 #endif
 
-        if (mpiRank == 0) {
-            icet_col_buf = icetImageGetColorub(icet_comp_image);
-            icet_depth_buf = icetImageGetDepthf(icet_comp_image);
-#if _DEBUG
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: IceT - ImageGet Done\n");
-#endif
-            if (this->render_comp_img_slot_.Param<core::param::BoolParam>()->Value()) {
-                glDrawPixels(tile_width, tile_height, GL_RGBA, GL_UNSIGNED_BYTE, icet_col_buf);
-            }
+        if (mpiRank == 0 && this->render_comp_img_slot_.Param<core::param::BoolParam>()->Value()) {
+            glDrawPixels(width, height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf.data());
         }
     }
 
@@ -261,15 +256,8 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
             this->color_buf_read_->resize(col_buf.size());
             this->depth_buf_read_->resize(depth_buf.size());
 
-#ifdef MEGAMOL_USE_MPI
-            // std::copy(col_buf.begin(),   col_buf.end(),   this->color_buf_read_->begin());
-            memcpy(this->color_buf_read_->data(), icet_col_buf, width * height * col_buf_el_size_);
-            // std::copy(depth_buf.begin(), depth_buf.end(), this->depth_buf_read_->begin());
-            memcpy(this->depth_buf_read_->data(), icet_depth_buf, width * height * depth_buf_el_size_);
-#else
-        std::copy(col_buf.begin(), col_buf.end(), this->color_buf_read_->begin());
-        std::copy(depth_buf.begin(), depth_buf.end(), this->depth_buf_read_->begin());
-#endif // MEGAMOL_USE_MPI
+            std::copy(col_buf.begin(), col_buf.end(), this->color_buf_read_->begin());
+            std::copy(depth_buf.begin(), depth_buf.end(), this->depth_buf_read_->begin());
 
             this->fbo_msg_read_->frame_id = this->frame_id_.fetch_add(1);
         }
@@ -320,43 +308,16 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
             {
                 std::lock_guard<std::mutex> send_lock(this->buffer_send_guard_);
 
-                //#ifdef MEGAMOL_USE_MPI
-                //            IceTUByte* icet_col_buf = nullptr;
-                //            IceTFloat* icet_depth_buf = nullptr;
-                //            if (aggregate_) {
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Complex IceT commit at rank
-                //                %d\n", rank_);
-                //#endif
-                //                std::array<IceTFloat, 4> backgroundColor = {0, 0, 0, 0};
-                //                auto const icet_comp_image = icetCompositeImage(this->color_buf_send_->data(),
-                //                    this->depth_buf_send_->data(), nullptr, nullptr, nullptr, backgroundColor.data());
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Recieved IceT image at rank
-                //                %d\n", rank_);
-                //#endif
-                //                icet_col_buf = icetImageGetColorub(icet_comp_image);
-                //                icet_depth_buf = icetImageGetDepthf(icet_comp_image);
-                //            }
-                //#endif
-
                 // snappy compression
                 std::vector<char> col_comp_buf(snappy::MaxCompressedLength(this->color_buf_send_->size()));
                 std::vector<char> depth_comp_buf(snappy::MaxCompressedLength(this->depth_buf_send_->size()));
                 size_t col_comp_size = 0;
                 size_t depth_comp_size = 0;
 
-                // if (aggregate_) {
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_col_buf), this->color_buf_send_->size(),
-                //        col_comp_buf.data(), &col_comp_size);
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_depth_buf), this->depth_buf_send_->size(),
-                //        depth_comp_buf.data(), &depth_comp_size);
-                //} else {
                 snappy::RawCompress(
                     this->color_buf_send_->data(), this->color_buf_send_->size(), col_comp_buf.data(), &col_comp_size);
                 snappy::RawCompress(this->depth_buf_send_->data(), this->depth_buf_send_->size(), depth_comp_buf.data(),
                     &depth_comp_size);
-                //}
 
                 fbo_msg_send_->color_buf_size = col_comp_size;
                 fbo_msg_send_->depth_buf_size = depth_comp_size;
@@ -405,7 +366,7 @@ bool megamol::remote::FBOTransmitter2::triggerButtonClicked(megamol::core::param
     using megamol::core::utility::log::Log;
 
 #ifdef MEGAMOL_USE_MPI
-    initIceT();
+    initCompositor();
 #endif
 
     bool success = true;
@@ -732,13 +693,6 @@ bool megamol::remote::FBOTransmitter2::shutdownThreads() {
     if (this->transmitter_thread_.joinable())
         this->transmitter_thread_.join();
 
-#ifdef MEGAMOL_USE_MPI
-    if (useMpi) {
-        icetDestroyMPICommunicator(icet_comm_);
-        icetDestroyContext(icet_ctx_);
-    }
-#endif // MEGAMOL_USE_MPI
-
     connected_ = false;
     return true;
 }
@@ -746,7 +700,7 @@ bool megamol::remote::FBOTransmitter2::shutdownThreads() {
 bool megamol::remote::FBOTransmitter2::renderCompChanged(core::param::ParamSlot& slot) {
     using megamol::core::utility::log::Log;
 
-    initIceT();
+    initCompositor();
 
     bool success = true;
     std::string mvn(view_name_slot_.Param<megamol::core::param::StringParam>()->Value());
@@ -763,7 +717,7 @@ bool megamol::remote::FBOTransmitter2::renderCompChanged(core::param::ParamSlot&
     return true;
 }
 
-void megamol::remote::FBOTransmitter2::initIceT() {
+void megamol::remote::FBOTransmitter2::initCompositor() {
 #ifdef MEGAMOL_USE_MPI
 
     useMpi = initMPI();
@@ -771,40 +725,29 @@ void megamol::remote::FBOTransmitter2::initIceT() {
     if (aggregate_ && !useMpi) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("Cannot aggregate without MPI!\n");
         this->toggle_aggregate_slot_.Param<megamol::core::param::BoolParam>()->SetValue(false);
+        aggregate_ = false;
     }
 
     if (aggregate_) {
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "FBOTransmitter2: Initializing IceT at rank %d\n", mpiRank);
+            "FBOTransmitter2: Initializing compositor at rank %d\n", mpiRank);
 #endif
-        // icet setup
-
-        icet_comm_ = icetCreateMPICommunicator(this->mpi_comm_);
-        icet_ctx_ = icetCreateContext(icet_comm_);
-        icetStrategy(ICET_STRATEGY_SEQUENTIAL);
-        icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
-        icetCompositeMode(ICET_COMPOSITE_MODE_Z_BUFFER);
-        icetSetColorFormat(ICET_IMAGE_COLOR_RGBA_UBYTE);
-        icetSetDepthFormat(ICET_IMAGE_DEPTH_FLOAT);
-        icetDisable(ICET_COMPOSITE_ONE_BUFFER);
+        this->compositor_ = std::make_unique<SortLastCompositor>(
+            this->mpi_comm_, this->composite_radix_slot_.Param<core::param::IntParam>()->Value());
 
         // extract viewport or get if from opengl context
-        auto width = 0;
-        auto height = 0;
         if (!this->tiled_slot_.Param<core::param::BoolParam>()->Value()) {
             GLint glvp[4];
             glGetIntegerv(GL_VIEWPORT, glvp);
             for (int i = 0; i < 4; ++i) {
                 this->viewport[i] = glvp[i];
             }
-            width = this->viewport[4] = glvp[2];
-            height = this->viewport[5] = glvp[3];
+            this->viewport[4] = glvp[2];
+            this->viewport[5] = glvp[3];
         } else {
             if (this->extractViewport(this->viewport)) {
                 this->validViewport = true;
-                width = this->viewport[4];
-                height = this->viewport[5];
             } else {
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "FBOTransmitter2: ViewPortExtraction - extractViewport failed\n");
@@ -814,19 +757,9 @@ void megamol::remote::FBOTransmitter2::initIceT() {
 
 #ifdef _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "FBOTransmitter2: IceT viewport for rank %d extracted from %s: (%d, %d, %d, %d, %d, %d).", this->mpiRank,
-            ((this->validViewport) ? ("View") : ("OpenGL")), this->viewport[0], this->viewport[1], this->viewport[2],
-            this->viewport[3], this->viewport[4], this->viewport[5]);
-#endif
-
-        int displayRank = 0;
-        icetPhysicalRenderSize(width, height);
-        icetResetTiles();
-        icetAddTile(0, 0, width, height, displayRank);
-
-#ifdef _DEBUG
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "FBOTransmitter2: Initialized IceT at rank %d\n", mpiRank);
+            "FBOTransmitter2: Compositing viewport for rank %d extracted from %s: (%d, %d, %d, %d, %d, %d).",
+            this->mpiRank, ((this->validViewport) ? ("View") : ("OpenGL")), this->viewport[0], this->viewport[1],
+            this->viewport[2], this->viewport[3], this->viewport[4], this->viewport[5]);
 #endif
     }
 #endif // MEGAMOL_USE_MPI
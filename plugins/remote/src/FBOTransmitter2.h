@@ -12,15 +12,11 @@
 
 #include "FBOCommFabric.h"
 #include "FBOProto.h"
+#include "SortLastCompositor.h"
 #include "mmcore/CallerSlot.h"
 #include "mmstd/view/AbstractView.h"
 #include "vislib/graphics/gl/FramebufferObject.h"
 
-#ifdef MEGAMOL_USE_MPI
-#include "IceT.h"
-#include "IceTMPI.h"
-#endif // MEGAMOL_USE_MPI
-
 namespace megamol {
 namespace remote {
 
@@ -133,20 +129,19 @@ private:
 
     megamol::core::param::ParamSlot render_comp_img_slot_;
 
+    megamol::core::param::ParamSlot composite_radix_slot_;
 
     bool useMpi = false;
     int mpiRank = -1, mpiSize = -1;
 
-    IceTContext icet_ctx_;
-
-    IceTCommunicator icet_comm_;
+    std::unique_ptr<SortLastCompositor> compositor_;
 
     MPI_Comm mpi_comm_ = MPI_COMM_NULL;
 #endif // MEGAMOL_USE_MPI
 
     bool renderCompChanged(core::param::ParamSlot& slot);
 
-    void initIceT();
+    void initCompositor();
 
     std::mutex buffer_read_guard_;
 
@@ -0,0 +1,233 @@
+#include "SortLastCompositor.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MEGAMOL_REMOTE_SSE2
+#endif
+
+
+void megamol::remote::SortLastCompositor::MergeDepthMin(
+    uint32_t* dst_col, float* dst_depth, uint32_t const* src_col, float const* src_depth, std::size_t count) {
+    std::size_t i = 0;
+#ifdef MEGAMOL_REMOTE_SSE2
+    for (; i + 4 <= count; i += 4) {
+        auto const d = _mm_loadu_ps(dst_depth + i);
+        auto const s = _mm_loadu_ps(src_depth + i);
+        auto const mask = _mm_castps_si128(_mm_cmplt_ps(s, d));
+        auto const dc = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst_col + i));
+        auto const sc = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src_col + i));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst_col + i), _mm_or_si128(_mm_and_si128(mask, sc), _mm_andnot_si128(mask, dc)));
+        _mm_storeu_ps(dst_depth + i, _mm_min_ps(s, d));
+    }
+#endif // MEGAMOL_REMOTE_SSE2
+    for (; i < count; ++i) {
+        if (src_depth[i] < dst_depth[i]) {
+            dst_depth[i] = src_depth[i];
+            dst_col[i] = src_col[i];
+        }
+    }
+}
+
+
+std::vector<int> megamol::remote::SortLastCompositor::ComputeSchedule(int num_ranks, int max_radix) {
+    max_radix = std::max(max_radix, 2);
+    std::vector<int> schedule;
+    int rem = num_ranks;
+    while (rem > 1) {
+        // prefer the largest factor within the radix limit
+        int radix = 1;
+        for (int d = std::min(rem, max_radix); d >= 2; --d) {
+            if (rem % d == 0) {
+                radix = d;
+                break;
+            }
+        }
+        // otherwise the remainder has a prime factor larger than the limit, use the smallest one
+        if (radix == 1) {
+            for (radix = max_radix + 1; rem % radix != 0; ++radix)
+                ;
+        }
+        schedule.push_back(radix);
+        rem /= radix;
+    }
+    return schedule;
+}
+
+
+#ifdef MEGAMOL_USE_MPI
+
+megamol::remote::SortLastCompositor::SortLastCompositor(MPI_Comm comm, int max_radix)
+        : comm_{comm}
+        , rank_{0}
+        , size_{1}
+        , skipped_tiles_{0} {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    this->SetMaxRadix(max_radix);
+}
+
+
+void megamol::remote::SortLastCompositor::SetMaxRadix(int max_radix) {
+    this->schedule_ = ComputeSchedule(this->size_, max_radix);
+}
+
+
+bool megamol::remote::SortLastCompositor::Composite(std::vector<char>& color, std::vector<char>& depth,
+    std::size_t num_pixels, std::array<float, 4> const& bg_color, int root) {
+    if (color.size() < num_pixels * sizeof(uint32_t) || depth.size() < num_pixels * sizeof(float)) {
+        return false;
+    }
+
+    auto col = reinterpret_cast<uint32_t*>(color.data());
+    auto dep = reinterpret_cast<float*>(depth.data());
+    this->skipped_tiles_ = 0;
+
+    // radix-k rounds: each group shares a common range and rank digits select the part kept by a member
+    std::vector<Range> final_ranges(this->size_, Range{0, num_pixels});
+    int stride = 1;
+    for (std::size_t round = 0; round < this->schedule_.size(); ++round) {
+        int const k = this->schedule_[round];
+        int const digit = (this->rank_ / stride) % k;
+        int const base = this->rank_ - digit * stride;
+        int const tag = static_cast<int>(round);
+        auto const& region = final_ranges[this->rank_];
+
+        this->send_bufs_.resize(k);
+        std::vector<MPI_Request> reqs;
+        reqs.reserve(k - 1);
+        for (int j = 0; j < k; ++j) {
+            if (j == digit)
+                continue;
+            this->packRange(col, dep, splitRange(region, k, j), this->send_bufs_[j]);
+            reqs.emplace_back();
+            if (MPI_Isend(this->send_bufs_[j].data(), static_cast<int>(this->send_bufs_[j].size()), MPI_BYTE,
+                    base + j * stride, tag, this->comm_, &reqs.back()) != MPI_SUCCESS) {
+                return false;
+            }
+        }
+
+        auto const own = splitRange(region, k, digit);
+        for (int j = 0; j < k; ++j) {
+            if (j == digit)
+                continue;
+            MPI_Status stat;
+            int count = 0;
+            MPI_Probe(base + j * stride, tag, this->comm_, &stat);
+            MPI_Get_count(&stat, MPI_BYTE, &count);
+            this->recv_buf_.resize(count);
+            if (MPI_Recv(this->recv_buf_.data(), count, MPI_BYTE, base + j * stride, tag, this->comm_,
+                    MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+                return false;
+            }
+            this->unpackAndMerge(this->recv_buf_, own, col, dep);
+        }
+        MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+
+        // every rank tracks the ranges of all others to set up the final gather
+        for (int r = 0; r < this->size_; ++r) {
+            final_ranges[r] = splitRange(final_ranges[r], k, (r / stride) % k);
+        }
+        stride *= k;
+    }
+
+    // gather the partial images on root
+    std::vector<int> col_counts(this->size_), col_displs(this->size_), dep_counts(this->size_),
+        dep_displs(this->size_);
+    for (int r = 0; r < this->size_; ++r) {
+        col_counts[r] = static_cast<int>((final_ranges[r].end - final_ranges[r].begin) * sizeof(uint32_t));
+        col_displs[r] = static_cast<int>(final_ranges[r].begin * sizeof(uint32_t));
+        dep_counts[r] = static_cast<int>((final_ranges[r].end - final_ranges[r].begin) * sizeof(float));
+        dep_displs[r] = static_cast<int>(final_ranges[r].begin * sizeof(float));
+    }
+    auto const& own = final_ranges[this->rank_];
+    if (this->rank_ == root) {
+        MPI_Gatherv(MPI_IN_PLACE, 0, MPI_BYTE, color.data(), col_counts.data(), col_displs.data(), MPI_BYTE, root,
+            this->comm_);
+        MPI_Gatherv(MPI_IN_PLACE, 0, MPI_BYTE, depth.data(), dep_counts.data(), dep_displs.data(), MPI_BYTE, root,
+            this->comm_);
+
+        uint8_t bg[4];
+        for (int i = 0; i < 4; ++i) {
+            bg[i] = static_cast<uint8_t>(std::clamp(bg_color[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        uint32_t bg_packed;
+        std::memcpy(&bg_packed, bg, sizeof(bg_packed));
+        for (std::size_t i = 0; i < num_pixels; ++i) {
+            if (dep[i] >= 1.0f) {
+                col[i] = bg_packed;
+            }
+        }
+    } else {
+        MPI_Gatherv(col + own.begin, col_counts[this->rank_], MPI_BYTE, nullptr, nullptr, nullptr, MPI_BYTE, root,
+            this->comm_);
+        MPI_Gatherv(dep + own.begin, dep_counts[this->rank_], MPI_BYTE, nullptr, nullptr, nullptr, MPI_BYTE, root,
+            this->comm_);
+    }
+
+    return true;
+}
+
+
+megamol::remote::SortLastCompositor::Range megamol::remote::SortLastCompositor::splitRange(
+    Range const& range, int parts, int idx) {
+    auto const len = range.end - range.begin;
+    return Range{range.begin + (len * idx) / parts, range.begin + (len * (idx + 1)) / parts};
+}
+
+
+void megamol::remote::SortLastCompositor::packRange(
+    uint32_t const* col, float const* depth, Range const& range, std::vector<char>& msg) {
+    // layout: uint32 tile count, one flag byte per tile, then colour and depth of every non-empty tile
+    auto const len = range.end - range.begin;
+    auto const num_tiles = static_cast<uint32_t>((len + TileSize - 1) / TileSize);
+    msg.resize(sizeof(uint32_t) + num_tiles + len * (sizeof(uint32_t) + sizeof(float)));
+    std::memcpy(msg.data(), &num_tiles, sizeof(uint32_t));
+    auto flags = msg.data() + sizeof(uint32_t);
+    auto payload = flags + num_tiles;
+
+    for (uint32_t t = 0; t < num_tiles; ++t) {
+        auto const b = range.begin + t * TileSize;
+        auto const e = std::min(b + TileSize, range.end);
+        bool const empty = std::all_of(depth + b, depth + e, [](float d) { return d >= 1.0f; });
+        flags[t] = empty ? 0 : 1;
+        if (empty) {
+            ++this->skipped_tiles_;
+            continue;
+        }
+        std::memcpy(payload, col + b, (e - b) * sizeof(uint32_t));
+        payload += (e - b) * sizeof(uint32_t);
+        std::memcpy(payload, depth + b, (e - b) * sizeof(float));
+        payload += (e - b) * sizeof(float);
+    }
+    msg.resize(payload - msg.data());
+}
+
+
+void megamol::remote::SortLastCompositor::unpackAndMerge(
+    std::vector<char> const& msg, Range const& range, uint32_t* col, float* depth) {
+    uint32_t num_tiles = 0;
+    std::memcpy(&num_tiles, msg.data(), sizeof(uint32_t));
+    auto flags = msg.data() + sizeof(uint32_t);
+    auto payload = flags + num_tiles;
+
+    // tile payloads are not aligned, stage them before merging
+    std::vector<uint32_t> tile_col(TileSize);
+    std::vector<float> tile_depth(TileSize);
+    for (uint32_t t = 0; t < num_tiles; ++t) {
+        if (flags[t] == 0)
+            continue;
+        auto const b = range.begin + t * TileSize;
+        auto const cnt = std::min(b + TileSize, range.end) - b;
+        std::memcpy(tile_col.data(), payload, cnt * sizeof(uint32_t));
+        payload += cnt * sizeof(uint32_t);
+        std::memcpy(tile_depth.data(), payload, cnt * sizeof(float));
+        payload += cnt * sizeof(float);
+        MergeDepthMin(col + b, depth + b, tile_col.data(), tile_depth.data(), cnt);
+    }
+}
+
+#endif // MEGAMOL_USE_MPI
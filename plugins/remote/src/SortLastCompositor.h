@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#ifdef MEGAMOL_USE_MPI
+#include <mpi.h>
+#endif // MEGAMOL_USE_MPI
+
+namespace megamol {
+namespace remote {
+
+/**
+ * CPU-only sort-last depth compositor using the radix-k schedule.
+ *
+ * Every rank contributes a full-size RGBA8 colour buffer and a float depth buffer. In each round the ranks of a
+ * group split their common pixel range into k parts, exchange the parts with the other group members and merge them
+ * by depth. With k = 2 and a power-of-two number of ranks this degenerates into binary-swap. Pixel tiles that contain
+ * only background depth are not transmitted. After the last round the partial images are gathered on the root rank.
+ */
+class SortLastCompositor {
+public:
+    /** Number of pixels per tile used for empty-tile skipping */
+    static constexpr std::size_t TileSize = 1024;
+
+    /**
+     * Merges the pixels of 'src' into 'dst' keeping the fragment nearest to the viewer.
+     *
+     * @param dst_col RGBA8 colour of the destination, one uint32 per pixel.
+     * @param dst_depth Depth of the destination.
+     * @param src_col RGBA8 colour of the source.
+     * @param src_depth Depth of the source.
+     * @param count Number of pixels to merge.
+     */
+    static void MergeDepthMin(uint32_t* dst_col, float* dst_depth, uint32_t const* src_col, float const* src_depth,
+        std::size_t count);
+
+    /**
+     * Answer the factorization of 'num_ranks' into the radices of the individual rounds, using factors not larger
+     * than 'max_radix' wherever possible.
+     *
+     * @param num_ranks Number of participating ranks.
+     * @param max_radix Preferred maximum group size per round (2 yields binary-swap).
+     *
+     * @return The radices of all rounds, their product equals 'num_ranks'.
+     */
+    static std::vector<int> ComputeSchedule(int num_ranks, int max_radix);
+
+#ifdef MEGAMOL_USE_MPI
+    /**
+     * Ctor.
+     *
+     * @param comm The communicator of all participating ranks.
+     * @param max_radix Preferred maximum group size per round.
+     */
+    SortLastCompositor(MPI_Comm comm, int max_radix = 2);
+
+    /**
+     * Composites the images of all ranks.
+     *
+     * @param color RGBA8 colour buffer of this rank, replaced by the final image on 'root'.
+     * @param depth Float depth buffer of this rank, replaced by the final depth on 'root'.
+     * @param num_pixels Number of pixels in both buffers.
+     * @param bg_color Colour that is written to all pixels not covered by any rank on 'root'.
+     * @param root Rank that receives the composited image.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool Composite(std::vector<char>& color, std::vector<char>& depth, std::size_t num_pixels,
+        std::array<float, 4> const& bg_color, int root = 0);
+
+    /**
+     * Sets the preferred maximum group size per round.
+     *
+     * @param max_radix The new radix, values smaller than 2 are clamped.
+     */
+    void SetMaxRadix(int max_radix);
+
+    /**
+     * Answer the number of tiles that have been skipped during the last call to Composite.
+     *
+     * @return The number of skipped tiles.
+     */
+    std::size_t GetSkippedTiles() const {
+        return this->skipped_tiles_;
+    }
+
+private:
+    /** Half-open pixel range */
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    static Range splitRange(Range const& range, int parts, int idx);
+
+    void packRange(uint32_t const* col, float const* depth, Range const& range, std::vector<char>& msg);
+
+    void unpackAndMerge(std::vector<char> const& msg, Range const& range, uint32_t* col, float* depth);
+
+    MPI_Comm comm_;
+
+    int rank_;
+
+    int size_;
+
+    std::vector<int> schedule_;
+
+    std::vector<std::vector<char>> send_bufs_;
+
+    std::vector<char> recv_buf_;
+
+    std::size_t skipped_tiles_;
+#endif // MEGAMOL_USE_MPI
+};
+
+} // end namespace remote
+} // end namespace megamol
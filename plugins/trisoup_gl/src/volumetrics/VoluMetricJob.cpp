@@ -24,6 +24,7 @@
 #include "vislib/sys/sysfunctions.h"
 #include <cfloat>
 #include <climits>
+#include <filesystem>
 
 using namespace megamol::trisoup_gl::volumetrics;
 
@@ -129,6 +130,15 @@ void VoluMetricJob::release(void) {
 }
 
 
+/*
+ * VoluMetricJob::Start
+ */
+bool VoluMetricJob::Start(void) {
+    this->jobParams = core::param::ParamSnapshot::Capture(*this);
+    return core::job::AbstractThreadedJob::Start();
+}
+
+
 /*
  * VoluMetricJob::Run
  */
@@ -148,9 +158,9 @@ DWORD VoluMetricJob::Run(void* userData) {
     unsigned int frameCnt = datacall->FrameCount();
     Log::DefaultLog.WriteInfo("Data source with %u frame(s)", frameCnt);
 
-    if (!metricsFilenameSlot.Param<core::param::FilePathParam>()->Value().empty()) {
-        if (!this->statisticsFile.Open(
-                metricsFilenameSlot.Param<core::param::FilePathParam>()->Value().native().c_str(),
+    const auto metricsFilename = std::filesystem::u8path(this->jobParams->Get<std::string>("metricsFilenameSlot"));
+    if (!metricsFilename.empty()) {
+        if (!this->statisticsFile.Open(metricsFilename.native().c_str(),
                 vislib::sys::File::WRITE_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::CREATE_OVERWRITE)) {
             Log::DefaultLog.WriteError("Could not open statistics file for writing");
             return -3;
@@ -218,12 +228,10 @@ DWORD VoluMetricJob::Run(void* userData) {
             }
         }
 
-        trisoup::volumetrics::VoxelizerFloat RadMult =
-            this->radiusMultiplierSlot.Param<megamol::core::param::FloatParam>()->Value();
+        trisoup::volumetrics::VoxelizerFloat RadMult = this->jobParams->Get<float>("radiusMultiplierSlot");
         MaxRad *= RadMult;
         MinRad *= RadMult;
-        trisoup::volumetrics::VoxelizerFloat cellSize =
-            MinRad * this->cellSizeRatioSlot.Param<megamol::core::param::FloatParam>()->Value();
+        trisoup::volumetrics::VoxelizerFloat cellSize = MinRad * this->jobParams->Get<float>("cellSizeRatioSlot");
         int bboxBytes = 8 * 3 * sizeof(trisoup::volumetrics::VoxelizerFloat);
         int bboxIdxes = 12 * 2 * sizeof(unsigned int);
         int vertSize = bboxBytes * partListCnt;
@@ -241,7 +249,7 @@ DWORD VoluMetricJob::Run(void* userData) {
             b = datacall->AccessBoundingBoxes().ObjectSpaceBBox();
         }
 
-        int subVolCells = this->subVolumeResolutionSlot.Param<megamol::core::param::IntParam>()->Value();
+        int subVolCells = this->jobParams->Get<int>("subVolumeResolutionSlot");
 #if 1 // ndef _DEBUG
         int resX = (int)((trisoup::volumetrics::VoxelizerFloat)b.Width() / cellSize) + 2;
         int resY = (int)((trisoup::volumetrics::VoxelizerFloat)b.Height() / cellSize) + 2;
@@ -315,7 +323,7 @@ DWORD VoluMetricJob::Run(void* userData) {
                     sjd->datacall = datacall;
                     sjd->Bounds = bx;
                     sjd->CellSize = (trisoup::volumetrics::VoxelizerFloat)MinRad *
-                                    this->cellSizeRatioSlot.Param<megamol::core::param::FloatParam>()->Value();
+                                    this->jobParams->Get<float>("cellSizeRatioSlot");
                     sjd->resX = restX;
                     sjd->resY = restY;
                     sjd->resZ = restZ;
@@ -392,7 +400,7 @@ DWORD VoluMetricJob::Run(void* userData) {
         // new code to eliminate enclosed surfaces
     }
 
-    if (!metricsFilenameSlot.Param<core::param::FilePathParam>()->Value().empty()) {
+    if (!metricsFilename.empty()) {
         statisticsFile.Close();
     }
     return 0;
@@ -1034,7 +1042,7 @@ void VoluMetricJob::outputStatistics(unsigned int frameNumber, vislib::Array<uns
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "surface %u: %u triangles, surface %f, volume %f, voidVol %f, entire volume %f", uniqueIDs[i],
             countPerID[i], surfPerID[i], volPerID[i], voidVolPerID[i], volPerID[i] + voidVolPerID[i]);
-        if (!metricsFilenameSlot.Param<core::param::FilePathParam>()->Value().empty()) {
+        if (!this->jobParams->Get<std::string>("metricsFilenameSlot").empty()) {
             vislib::sys::WriteFormattedLineToFile(this->statisticsFile, "%u\t%u\t%u\t%f\t%f\n", frameNumber,
                 uniqueIDs[i], countPerID[i], surfPerID[i], volPerID[i]);
         }
@@ -1087,7 +1095,7 @@ void VoluMetricJob::copyMeshesToBackbuffer(vislib::Array<unsigned int>& uniqueID
     SIZE_T triOffset = 0;
     SIZE_T idxOffset = 0;
 
-    if (this->showBorderGeometrySlot.Param<megamol::core::param::BoolParam>()->Value()) {
+    if (this->jobParams->Get<bool>("showBorderGeometrySlot")) {
 
         for (unsigned int i = 0; i < uniqueIDs.Count(); i++) {
             vislib::graphics::ColourRGBAu8 c(rand() * 255, rand() * 255, rand() * 255, 255);
@@ -18,6 +18,7 @@
 #include "mmcore/Module.h"
 #include "mmcore/job/AbstractThreadedJob.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmcore/param/ParamSnapshot.h"
 #include "trisoup/trisoupVolumetricDataCall.h"
 #include "trisoup/volumetrics/JobStructures.h"
 #include "vislib/math/Cuboid.h"
@@ -67,6 +68,13 @@ public:
     /** Dtor. */
     virtual ~VoluMetricJob(void);
 
+    /**
+     * Captures the parameters for the job and starts the job thread.
+     *
+     * @return true if the job has been successfully started.
+     */
+    virtual bool Start(void);
+
     bool areSurfacesJoinable(int sjdIdx1, int surfIdx1, int sjdIdx2, int surfIdx2);
 
     // thomasbm: full enclosing test for two surfaces specified by global-id
@@ -234,6 +242,12 @@ private:
 
     core::param::ParamSlot resetContinueSlot;
 
+    /**
+     * the parameters the job runs with, captured when it is started, as the
+     * job thread must not read the parameter slots.
+     */
+    std::shared_ptr<const core::param::ParamSnapshot> jobParams;
+
     core::CalleeSlot outLineDataSlot;
 
     core::CalleeSlot outTriDataSlot;